@@ -1,69 +1,166 @@
 #include "aStar.h"
 
 #include <assert.h>
+#include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
 
-#include "dataStructs/skipPQ.h"
+#include "dataStructs/searchGrid.h"
+#include "searchStats.h"
 
 
-// integer approximation of moving cost cardinally = 1 and diagonally = sqrt(2)
-static const int COST_CARDINAL = 70;
-static const int COST_DIAGONAL = 99;
-
-// 8 directional movement system
-static const point_t MOVES[] = {
-    { 0, -1},  // north
-    { 1, -1},  // north-east
-    { 1,  0},  // east
-    { 1,  1},  // south-east
-    { 0,  1},  // south
-    {-1,  1},  // south-west
-    {-1,  0},  // west
-    {-1, -1}   // north-west
-};
+struct aStarContext_s
+{
+    dungeon_t *dungeon;
 
-static const int N_MOVES = sizeof(MOVES) / sizeof(point_t);
+    // cell indices between rows of tiles (see `getMoveIndex`)
+    int64_t rowStride;
 
+    searchGrid_t *grid;
+    openList_t *open;
 
-typedef struct pointData_s pointData_t;
+    // points expanded in the last search
+    cell_t nExpanded;
 
+    // distance tables tightening the heuristic - `NULL` for Octile distance
+    // alone - and whether the last search started could use them
+    landmarks_t *landmarks;
+    bool isLandmarked;
 
-struct pointData_s {
-    point_t prev;
-    uint32_t gScore;
-    bool isClosed;
-};
+    // query of the last search - its path is kept in `grid` until the next
+    point_t target;
+    cell_t sourceIndex;
+    cell_t targetIndex;
+    bool isFound;
 
+    // search started by `startContextPath` is not finished or cancelled
+    bool isSearching;
 
-static pointData_t **initPointData(uint16_t width,
-                                   uint16_t height);
+    // statistics of the last search - only gathered with `SEARCH_STATS`
+    searchStats_t stats;
+};
 
-static void freePointData(pointData_t **pointData,
-                          uint16_t      width);
 
-static void exploreNeighbours(dungeon_t    *dungeon,
-                              skipPQ_t     *open,
-                              pointData_t **pointData,
-                              point_t       current,
-                              point_t       target);
+static bool searchPath(aStarContext_t *context,
+                       point_t         source,
+                       point_t         target);
+static void exploreNeighbours(aStarContext_t *context,
+                              point_t         current,
+                              cell_t          currentIndex);
 
 static uint16_t cost(point_t move);
+static score_t heuristic(aStarContext_t *context,
+                         point_t         point,
+                         cell_t          index);
 
-static point_t *reconstructPath(pointData_t **pointData,
-                                point_t       source,
-                                point_t       target);
+static point_t *reconstructPath(aStarContext_t *context,
+                                cell_t          sourceIndex,
+                                cell_t          targetIndex);
+static cell_t writePath(aStarContext_t *context,
+                        point_t        *path,
+                        cell_t          capacity);
 
 
 /* ------------------------------ START PUBLIC ------------------------------ */
 
 
+/*
+@context
+    * Initialises a search context to find paths in `dungeon`.
+    * Holds the search state of each point and the open list between searches.
+        * Neither are reallocated when finding a path with the context.
+    * `dungeon` can be regenerated but must not be resized or freed while the
+      context is in use.
+
+@parameters
+    * dungeon
+        * Dungeon to find paths in.
+    * openType
+        * Priority queue used as the open list.
+        * All types pop equal f-scores newest first so they expand the same
+          points and find the same path - only speed differs.
+
+@return
+    * Search context ready to find paths in `dungeon`.
+*/
+aStarContext_t *initAStarContext(dungeon_t      *dungeon,
+                                 openListType_t  openType)
+{
+    aStarContext_t *context;
+
+    context = malloc(sizeof(aStarContext_t));
+    assert(context != NULL);
+
+    context->dungeon = dungeon;
+    context->rowStride = getDungeonRowStride(dungeon);
+    context->grid = initSearchGrid(getDungeonSize(dungeon));
+    // f-scores pushed are never more than 2 moves above the f-score popped
+    context->open = initOpenList(openType, 2 * COST_DIAGONAL);
+    context->nExpanded = 0;
+    context->landmarks = NULL;
+    context->isLandmarked = false;
+    context->isFound = false;
+    context->isSearching = false;
+    resetSearchStats(&context->stats);
+
+    return context;
+}
+
+
+/*
+@context
+    * Frees `context`.
+    * The dungeon of `context` is not freed.
+
+@parameters
+    * context
+        * Search context to free.
+*/
+void freeAStarContext(aStarContext_t *context)
+{
+    freeSearchGrid(context->grid);
+    freeOpenList(context->open);
+    free(context);
+}
+
+
+/*
+@context
+    * Sets the landmark distance tables searches of `context` use to tighten
+      the Octile distance heuristic (ALT).
+        * The heuristic of a point is the larger of its Octile distance and
+          its landmark bound to the target - both are consistent so the path
+          found still costs the same and any open list type can be used.
+    * Takes effect from the next search started.
+        * Searches fall back to Octile distance alone while the tables are
+          not current for the dungeon (see `isLandmarksCurrent`).
+
+@parameters
+    * context
+        * Search context to set landmarks of.
+    * landmarks
+        * Landmark distance tables of the dungeon of `context` - `NULL` to
+          only use Octile distance.
+        * Must not be freed while set.
+*/
+void setAStarLandmarks(aStarContext_t *context,
+                       landmarks_t    *landmarks)
+{
+    context->landmarks = landmarks;
+}
+
+
 /*
 @context
     * Finds shortest path from `source` and `target` in `dungeon` if possible.
     * Uses the A* algorithm with an Octile distance heuristic.
         * The heuristic will never overestimate the actual path cost making it
           admissible.
+    * Rejects queries between different connected components (see
+      `isDungeonConnected`) without searching or allocating.
+    * Sets up and tears down a search context for this single search.
+        * Uses the `OPEN_LIST_DEFAULT` open list type.
+        * Use `findContextPath` to reuse one context between searches.
 
 @parameters
     * dungeon
@@ -83,116 +180,447 @@ point_t *findPath(dungeon_t *dungeon,
                   point_t    source,
                   point_t    target)
 {
-    skipPQ_t *open;
-    pointData_t **pointData;
+    aStarContext_t *context;
     point_t *path;
-    point_t current;
 
-    open = initSkipPQ();
-    pointData = initPointData(getDungeonWidth(dungeon),
-                              getDungeonHeight(dungeon));
-    path = NULL;
+    // nothing is allocated for queries between different components
+    if (!isDungeonConnected(dungeon, source, target))
+    {
+        return NULL;
+    }
 
-    // add `source` to `open` - will be the first node explored
-    pointData[source.x][source.y].gScore = 0;
-    initSkipNode(open, source, 0);
+    context = initAStarContext(dungeon, OPEN_LIST_DEFAULT);
+    path = findContextPath(context, source, target);
+    freeAStarContext(context);
 
-    // search for `target` or until no more points to explore
-    while (!isSkipPQEmpty(open))
-    {
-        // grab next point based on the lowest f-score
-        current = getSkipNodeData(getMinSkipNode(open));
-        freeMinSkipNode(open);
+    return path;
+}
 
-        // if `current` already seen then skip it
-        if (pointData[current.x][current.y].isClosed)
-        {
-            continue;
-        }
 
-        pointData[current.x][current.y].isClosed = true;
+/*
+@context
+    * Finds shortest path from `source` and `target` in the dungeon of
+      `context` if possible.
+    * Uses the A* algorithm with an Octile distance heuristic.
+    * Resetting the search state of `context` is O(1) and the open list reuses
+      nodes from previous searches.
+    * F-scores popped never decrease so any open list type can be used.
+        * Only the returned path is allocated once `context` is warmed up.
 
-        // path found - reconstruct path
-        if (isEqualPoints(current, target))
-        {
-            path = reconstructPath(pointData, source, target);
-            break;
-        }
+@parameters
+    * context
+        * Search context holding the dungeon to find path in.
+    * source
+        * Location to start from.
+    * target
+        * Location to find from `source`.
 
-        // explore all neighbouring points around `current`
-        exploreNeighbours(dungeon, open, pointData, current, target);
+@return
+    * Shortest path (sequence of points) from `source` to `target`.
+        * `source` is not included.
+        * `target` is included as the last point.
+    * `NULL` if no path is possible.
+*/
+point_t *findContextPath(aStarContext_t *context,
+                         point_t         source,
+                         point_t         target)
+{
+    point_t *path;
+#ifdef SEARCH_STATS
+    uint64_t start;
+#endif
+
+    if (!searchPath(context, source, target))
+    {
+        return NULL;
     }
 
-    freeSkipPQ(open);
-    freePointData(pointData, getDungeonWidth(dungeon));
+    STATS(start = getStatsTimeNs());
+    path = reconstructPath(context, context->sourceIndex, context->targetIndex);
+    STATS(context->stats.reconstructNs = getStatsTimeNs() - start);
 
     return path;
 }
 
 
-/* ------------------------------- END PUBLIC ------------------------------- */
-/* ----------------------------- START  PRIVATE ----------------------------- */
+/*
+@context
+    * Finds shortest path from `source` and `target` in the dungeon of
+      `context` if possible and writes it to `path`.
+    * Searches the same as `findContextPath` but nothing is allocated once
+      `context` is warmed up.
+    * The search is not repeated if `path` is too small.
+        * The length needed is returned and the path can be read again with
+          `getAStarPath` until the next search of `context`.
+
+@parameters
+    * context
+        * Search context holding the dungeon to find path in.
+    * source
+        * Location to start from.
+    * target
+        * Location to find from `source`.
+    * path
+        * Buffer to write the path (sequence of points) to.
+            * `source` is not included.
+            * `target` is included as the last point.
+        * Can be `NULL` when `capacity` is `0` to only find length and cost.
+    * capacity
+        * Number of points `path` can hold.
+
+@return
+    * Status, length and cost of the path found.
+*/
+pathResult_t findContextPathBuffer(aStarContext_t *context,
+                                   point_t         source,
+                                   point_t         target,
+                                   point_t        *path,
+                                   cell_t          capacity)
+{
+    pathResult_t result;
+#ifdef SEARCH_STATS
+    uint64_t start;
+#endif
+
+    searchPath(context, source, target);
+
+    STATS(start = getStatsTimeNs());
+    result = getAStarPath(context, path, capacity);
+#ifdef SEARCH_STATS
+    if (result.status != PATH_NOT_FOUND)
+    {
+        context->stats.reconstructNs = getStatsTimeNs() - start;
+    }
+#endif
+
+    return result;
+}
 
 
 /*
 @context
-    * Initialises a 2D status array of each point within a dungeon.
+    * Starts a search for the shortest path from `source` to `target` in the
+      dungeon of `context` without expanding any points.
+    * Points are expanded by `stepContextPath` in slices of bounded size.
+        * The search state and open list are kept in `context` between slices
+          so each query interleaved needs its own context.
+    * Any search of `context` still in progress is abandoned.
+    * A query between different connected components (see
+      `isDungeonConnected`) finishes as `PATH_NOT_FOUND` on its first slice
+      without expanding any points.
 
 @parameters
-    * width
-        * Width of dungeon.
-    * height
-        * Height of dungeon.
+    * context
+        * Search context holding the dungeon to find path in.
+    * source
+        * Location to start from.
+    * target
+        * Location to find from `source`.
+*/
+void startContextPath(aStarContext_t *context,
+                      point_t         source,
+                      point_t         target)
+{
+    pointData_t *sourceData;
+#ifdef SEARCH_STATS
+    uint64_t start, openBytes;
+#endif
+
+    resetSearchGrid(context->grid);
+    clearOpenList(context->open);
+    context->nExpanded = 0;
+    context->isFound = false;
+    context->isSearching = true;
+
+#ifdef SEARCH_STATS
+    resetSearchStats(&context->stats);
+    openBytes = getOpenListBytes(context->open);
+    start = getStatsTimeNs();
+#endif
+
+    context->target = target;
+    context->sourceIndex = getDungeonIndex(context->dungeon, source);
+    context->targetIndex = getDungeonIndex(context->dungeon, target);
+    context->isLandmarked = context->landmarks != NULL
+                         && isLandmarksCurrent(context->landmarks);
+
+    // add `source` to `open` - will be the first node explored - unless
+    // `target` is unreachable, leaving nothing to expand
+    if (isDungeonConnected(context->dungeon, source, target))
+    {
+        sourceData = getSearchGridCell(context->grid, context->sourceIndex);
+        sourceData->gScore = 0;
+        openSearchGridCell(sourceData,
+                           context->open,
+                           source,
+                           heuristic(context, source, context->sourceIndex));
+        STATS(context->stats.nPushed += 1);
+    }
+
+#ifdef SEARCH_STATS
+    context->stats.searchNs += getStatsTimeNs() - start;
+    context->stats.bytesAllocated += getOpenListBytes(context->open)
+                                   - openBytes;
+#endif
+}
+
+
+/*
+@context
+    * Continues the search started by `startContextPath` for at most
+      `maxExpansions` expansions.
+    * Expands points in the same order as `findContextPath` so the path found
+      is the same however the search is sliced.
+    * Callers choose how much of each frame every query gets - a query can be
+      prioritised with a larger slice or cancelled with `cancelContextPath`.
+
+@parameters
+    * context
+        * Search context of the search to continue.
+    * maxExpansions
+        * Most points to expand in this slice - `CELL_MAX` for no limit.
 
 @return
-    * 2D status array of each point within a dungeon.
+    * `PATH_SEARCHING` if the search needs more slices.
+    * `PATH_FOUND` or `PATH_NOT_FOUND` once it has finished (also returned
+      for a finished search without expanding any more points).
+        * The path can then be read with `getAStarPath`.
+    * `PATH_NOT_FOUND` if no search was started or it was cancelled.
 */
-static pointData_t **initPointData(uint16_t width,
-                                   uint16_t height)
+pathStatus_t stepContextPath(aStarContext_t *context,
+                             cell_t          maxExpansions)
 {
-    uint16_t x, y;
-    pointData_t **pointData;
+    cell_t nExpanded;
+    cell_t currentIndex;
+    pointData_t *currentData;
+    point_t current;
+#ifdef SEARCH_STATS
+    uint64_t start, openBytes;
 
-    pointData = malloc(sizeof(pointData_t*) * width);
-    assert(pointData != NULL);
+    openBytes = getOpenListBytes(context->open);
+    start = getStatsTimeNs();
+#endif
 
-    for (x = 0; x < width; x += 1)
+    // search for `target` or until no more points to explore
+    for (nExpanded = 0;
+         context->isSearching && nExpanded < maxExpansions;
+         nExpanded += 1)
     {
-        pointData[x] = malloc(sizeof(pointData_t) * height);
-        assert(pointData[x] != NULL);
+        if (isOpenListEmpty(context->open))
+        {
+            context->isSearching = false;
+            break;
+        }
+
+        // grab next point based on the lowest f-score
+        current = getMinOpenData(context->open);
+        freeMinOpenNode(context->open);
+
+        // each point is only in `open` once so `current` is never closed yet
+        currentIndex = getDungeonIndex(context->dungeon, current);
+        currentData = getSearchGridCell(context->grid, currentIndex);
+        currentData->isClosed = true;
+        context->nExpanded += 1;
 
-        for (y = 0; y < height; y += 1)
+        // path found - left in `grid` for the caller to reconstruct
+        if (currentIndex == context->targetIndex)
         {
-            // g-score starts at the max distance possible
-            pointData[x][y].gScore = UINT32_MAX;
-            pointData[x][y].isClosed = false;
+            context->isFound = true;
+            context->isSearching = false;
+            break;
         }
+
+        // explore all neighbouring points around `current`
+        exploreNeighbours(context, current, currentIndex);
+
+#ifdef SEARCH_STATS
+        if (getOpenListSize(context->open) > context->stats.peakOpenSize)
+        {
+            context->stats.peakOpenSize = getOpenListSize(context->open);
+        }
+#endif
+    }
+
+#ifdef SEARCH_STATS
+    context->stats.searchNs += getStatsTimeNs() - start;
+    context->stats.nExpanded = context->nExpanded;
+    context->stats.peakSkipLevel = getOpenListPeakLevel(context->open);
+    context->stats.bytesAllocated += getOpenListBytes(context->open)
+                                   - openBytes;
+#endif
+
+    if (context->isSearching)
+    {
+        return PATH_SEARCHING;
     }
+    return context->isFound ? PATH_FOUND : PATH_NOT_FOUND;
+}
+
+
+/*
+@context
+    * Finishes the search started by `startContextPath` without a limit on
+      expansions and writes the path found to `path`.
+    * Used when a query must be answered now (e.g. at the end of its budget
+      of frames) - a finished search is not continued.
+
+@parameters
+    * context
+        * Search context of the search to finish.
+    * path
+        * Buffer to write the path (sequence of points) to.
+            * `source` is not included.
+            * `target` is included as the last point.
+        * Can be `NULL` when `capacity` is `0` to only find length and cost.
+    * capacity
+        * Number of points `path` can hold.
+
+@return
+    * Status, length and cost of the path found.
+        * `PATH_NOT_FOUND` if no search was started or it was cancelled.
+*/
+pathResult_t finishContextPath(aStarContext_t *context,
+                               point_t        *path,
+                               cell_t          capacity)
+{
+    stepContextPath(context, CELL_MAX);
+
+    return getAStarPath(context, path, capacity);
+}
+
+
+/*
+@context
+    * Cancels the search started by `startContextPath`.
+    * Its search state is kept until the next search of `context` but no path
+      can be read from it.
 
-    return pointData;
+@parameters
+    * context
+        * Search context of the search to cancel.
+*/
+void cancelContextPath(aStarContext_t *context)
+{
+    context->isSearching = false;
+    context->isFound = false;
 }
 
 
 /*
 @context
-    * Frees a 2D status array of each point within a dungeon.
+    * Writes the path found by the last search of `context` to `path`.
+    * Used to read a path again after `path` was too small - the search state
+      of `context` is kept until its next search.
+    * Walks the path once - points are written from `target` backwards then
+      put in order.
 
 @parameters
-    * pointData
-        * 2D status array to free.
-    * width
-        * Width of the dungeon - also the width of the array.
+    * context
+        * Search context to get path of.
+    * path
+        * Buffer to write the path (sequence of points) to.
+            * `source` is not included.
+            * `target` is included as the last point.
+        * Can be `NULL` when `capacity` is `0` to only find length and cost.
+    * capacity
+        * Number of points `path` can hold.
+
+@return
+    * Status, length and cost of the path.
+        * `PATH_NOT_FOUND` if the last search found no path or `context` has
+          not searched yet.
+        * `PATH_SEARCHING` if the last search has not finished (see
+          `stepContextPath`).
 */
-static void freePointData(pointData_t **pointData,
-                          uint16_t      width)
+pathResult_t getAStarPath(aStarContext_t *context,
+                          point_t        *path,
+                          cell_t          capacity)
 {
-    uint16_t x;
+    pathResult_t result;
 
-    for (x = 0; x < width; x += 1)
+    result.status = context->isSearching ? PATH_SEARCHING : PATH_NOT_FOUND;
+    result.length = 0;
+    result.cost = 0;
+    if (!context->isFound)
     {
-        free(pointData[x]);
+        return result;
     }
-    free(pointData);
+
+    result.cost = getSearchGridCell(context->grid,
+                                    context->targetIndex)->gScore;
+    result.length = writePath(context, path, capacity);
+    result.status = result.length <= capacity
+                  ? PATH_FOUND
+                  : PATH_BUFFER_TOO_SMALL;
+
+    return result;
+}
+
+
+/*
+@context
+    * Gets the number of points expanded in the last search of `context`.
+    * A point is expanded when it is closed (including the target).
+
+@parameters
+    * context
+        * Search context to get number of expansions of.
+
+@return
+    * Number of points expanded.
+*/
+cell_t getAStarExpansions(aStarContext_t *context)
+{
+    return context->nExpanded;
+}
+
+
+/*
+@context
+    * Gets the statistics of the last search of `context`.
+    * Only gathered when built with `SEARCH_STATS` - otherwise all are `0`.
+
+@parameters
+    * context
+        * Search context to get statistics of.
+
+@return
+    * Statistics of the last search.
+*/
+searchStats_t getAStarStats(aStarContext_t *context)
+{
+    return context->stats;
+}
+
+
+/* ------------------------------- END PUBLIC ------------------------------- */
+/* ----------------------------- START  PRIVATE ----------------------------- */
+
+
+/*
+@context
+    * Searches for the shortest path from `source` to `target` in the dungeon
+      of `context` in a single slice.
+    * The path found is left in the search state of `context` to be read by
+      `reconstructPath` or `writePath`.
+
+@parameters
+    * context
+        * Search context holding the dungeon to find path in.
+    * source
+        * Location to start from.
+    * target
+        * Location to find from `source`.
+
+@return
+    * Indication if a path was found.
+*/
+static bool searchPath(aStarContext_t *context,
+                       point_t         source,
+                       point_t         target)
+{
+    startContextPath(context, source, target);
+    return stepContextPath(context, CELL_MAX) == PATH_FOUND;
 }
 
 
@@ -200,57 +628,74 @@ static void freePointData(pointData_t **pointData,
 @context
     * Explores the 8 neighbouring points around `current`.
     * Only valid neighbours are explored.
+        * Uses the precomputed move mask of `current` instead of checking each
+          move with `isValidMove`.
     * Once explored (g/h/f-score found) neighbours are added to `open` to later
       be expanded.
+        * The h-score is only found for neighbours whose g-score is lowered as
+          the landmark bound costs more than Octile distance.
+        * Neighbours already in `open` have their f-score lowered instead.
 
 @parameters
-    * dungeon
-        * Dungeon describing the layout to traverse and find path in.
-    * open
-        * Priority queue to add neighbouring points to explore later.
-        * The priority is a point's f-score.
-    * pointData
-        * 2D status array of each point within `dungeon`.
+    * context
+        * Search context holding the dungeon, search state and open list.
+        * The open list priority is a point's f-score.
     * current
         * Location to expand neighbours around.
-    * target
-        * Location to find from `current`.
+    * currentIndex
+        * Cell index of `current`.
 */
-static void exploreNeighbours(dungeon_t    *dungeon,
-                              skipPQ_t     *open,
-                              pointData_t **pointData,
-                              point_t       current,
-                              point_t       target)
+static void exploreNeighbours(aStarContext_t *context,
+                              point_t         current,
+                              cell_t          currentIndex)
 {
-    uint8_t i;
-    uint32_t gScore, hScore, fScore;
+    uint8_t i, moves;
+    score_t gScore, hScore, fScore;
+    cell_t neighbourIndex;
+    pointData_t *currentData, *neighbourData;
     point_t neighbour;
 
-    // explore neighbouring points around `current`
-    for (i = 0; i < N_MOVES; i += 1)
-    {
-        neighbour = addPoints(current, MOVES[i]);
+    currentData = getSearchGridCell(context->grid, currentIndex);
 
-        // skip invalid moves
-        if (!isValidMove(dungeon, current, neighbour))
+    // explore neighbouring points around `current` - only valid moves are set
+    moves = getDungeonPointMoves(context->dungeon, current);
+    for (i = 0; moves != 0; i += 1, moves >>= 1)
+    {
+        if (!(moves & 1))
         {
             continue;
         }
 
-        gScore = pointData[current.x][current.y].gScore + cost(MOVES[i]);
-        hScore = distancePoints(current, target, COST_CARDINAL, COST_DIAGONAL);
-        fScore = gScore + hScore;
+        neighbour = addPoints(current, MOVES[i]);
+        gScore = currentData->gScore + cost(MOVES[i]);
 
         // check if this is the new shortest path to `neighbour` from the source
-        if (gScore < pointData[neighbour.x][neighbour.y].gScore)
+        neighbourIndex = getMoveIndex(context->rowStride,
+                                      currentIndex,
+                                      MOVES[i]);
+        neighbourData = getSearchGridCell(context->grid, neighbourIndex);
+        if (gScore < neighbourData->gScore)
         {
-            pointData[neighbour.x][neighbour.y].prev = current;
-            pointData[neighbour.x][neighbour.y].gScore = gScore;
+            neighbourData->prev = currentIndex;
+            neighbourData->gScore = gScore;
 
             // add `neighbour` to `open` if not closed (expanded its neighbours)
-            if (!pointData[neighbour.x][neighbour.y].isClosed)
+            if (!neighbourData->isClosed)
             {
-                initSkipNode(open, neighbour, fScore);
+                hScore = heuristic(context, neighbour, neighbourIndex);
+                fScore = gScore + hScore;
+
+                if (openSearchGridCell(neighbourData,
+                                       context->open,
+                                       neighbour,
+                                       fScore))
+                {
+                    STATS(context->stats.nPushed += 1);
+                }
+                else
+                {
+                    STATS(context->stats.nDecreased += 1);
+                }
             }
         }
     }
@@ -280,6 +725,46 @@ static uint16_t cost(point_t move)
 }
 
 
+/*
+@context
+    * Estimates the cost of the shortest path from `point` to the target of
+      the search of `context`.
+    * Octile distance, raised to the landmark bound when the search uses
+      landmarks - never overestimates so the path found stays shortest.
+
+@parameters
+    * context
+        * Search context of the search.
+    * point
+        * Location to estimate from.
+    * index
+        * Cell index of `point`.
+
+@return
+    * H-score of `point`.
+*/
+static score_t heuristic(aStarContext_t *context,
+                         point_t         point,
+                         cell_t          index)
+{
+    score_t hScore, bound;
+
+    hScore = distancePoints(point,
+                            context->target,
+                            COST_CARDINAL,
+                            COST_DIAGONAL);
+    if (context->isLandmarked)
+    {
+        bound = getLandmarkBound(context->landmarks,
+                                 index,
+                                 context->targetIndex);
+        hScore = bound > hScore ? bound : hScore;
+    }
+
+    return hScore;
+}
+
+
 /*
 @context
     * Creates an array of points to represent a found path.
@@ -287,47 +772,102 @@ static uint16_t cost(point_t move)
         * Function only called once a path has been found.
 
 @parameters
-    * pointData
-        * 2D status array of each point within a dungeon.
-    * source
-        * Location to stop reconstructing path when moving backwards.
-    * target
-        * Location to start reconstructing path when moving backwards.
+    * context
+        * Search context holding the search state of each point.
+    * sourceIndex
+        * Cell index to stop reconstructing path when moving backwards.
+    * targetIndex
+        * Cell index to start reconstructing path when moving backwards.
 
 @return
     * Shortest path (sequence of points) from `source` to `target`.
 */
-static point_t *reconstructPath(pointData_t **pointData,
-                                point_t       source,
-                                point_t       target)
+static point_t *reconstructPath(aStarContext_t *context,
+                                cell_t          sourceIndex,
+                                cell_t          targetIndex)
 {
     point_t *path;
-    point_t current;
-    uint16_t length;
-    int32_t i;
+    cell_t current, length, i;
 
     // find length of `path`
     length = 0;
-    current = target;
-    while (!isEqualPoints(current, source))
+    current = targetIndex;
+    while (current != sourceIndex)
     {
         length += 1;
-        current = pointData[current.x][current.y].prev;
+        current = getSearchGridCell(context->grid, current)->prev;
     }
 
-    path = malloc(sizeof(point_t) * length);
+    path = malloc(sizeof(point_t) * (size_t)length);
     assert(path != NULL);
+    STATS(context->stats.bytesAllocated += sizeof(point_t) * length);
 
     // reconstruct `path` in reverse (from `target` to `source`)
-    current = target;
-    for (i = length - 1; i >= 0; i -= 1)
+    current = targetIndex;
+    for (i = length; i > 0; i -= 1)
     {
-        path[i] = current;
-        current = pointData[current.x][current.y].prev;
+        path[i - 1] = getDungeonIndexPoint(context->dungeon, current);
+        current = getSearchGridCell(context->grid, current)->prev;
     }
 
     return path;
 }
 
 
+/*
+@context
+    * Writes the path found by the last search of `context` to `path`.
+    * Walks the path once - points are written from `target` backwards while
+      counting its length then put in order if they all fit.
+    * Assumes path to `target` from `source` has been found.
+
+@parameters
+    * context
+        * Search context holding the search state of each point.
+    * path
+        * Buffer to write the path to.
+        * Its contents are undefined if the path is longer than `capacity`.
+    * capacity
+        * Number of points `path` can hold.
+
+@return
+    * Length of the path - more than `capacity` if `path` is too small.
+*/
+static cell_t writePath(aStarContext_t *context,
+                        point_t        *path,
+                        cell_t          capacity)
+{
+    cell_t current, length, i;
+    point_t swap;
+
+    // write `path` in reverse (from `target` to `source`) while it fits
+    length = 0;
+    current = context->targetIndex;
+    while (current != context->sourceIndex)
+    {
+        if (length < capacity)
+        {
+            path[length] = getDungeonIndexPoint(context->dungeon, current);
+        }
+        length += 1;
+        current = getSearchGridCell(context->grid, current)->prev;
+    }
+
+    if (length > capacity)
+    {
+        return length;
+    }
+
+    // put `path` in order (from after `source` to `target`)
+    for (i = 0; i < length / 2; i += 1)
+    {
+        swap = path[i];
+        path[i] = path[length - 1 - i];
+        path[length - 1 - i] = swap;
+    }
+
+    return length;
+}
+
+
 /* ------------------------------ END  PRIVATE ------------------------------ */
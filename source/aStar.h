@@ -7,18 +7,111 @@
           admissible.
     * Uses an 8 directional movement system.
     * The path found is dynamically allocated so it must be freed.
+        * `findContextPathBuffer` instead writes it to a buffer of the caller
+          so searching with a warmed up context allocates nothing.
+    * A search context can be reused between searches on the same dungeon.
+        * Avoids allocating the search state and open list for every search.
+        * The open list type is chosen when creating the context.
+        * Statistics of its last search are kept when built with
+          `SEARCH_STATS` (see `searchStats.h`).
+        * Landmark distance tables can be given to tighten the heuristic
+          (see `landmarks.h`).
+    * A search of a context can be split into slices of a bounded number of
+      expansions (`startContextPath`, `stepContextPath` then
+      `finishContextPath`).
+        * The open list and search state of the context survive between
+          slices so a context per query lets many queries be interleaved.
 */
 
 
 #ifndef _A_STAR_H
     #define _A_STAR_H
 
+    #include <stdbool.h>
+    #include <stdint.h>
+
     #include "dataStructs/dungeon.h"
+    #include "dataStructs/openList.h"
     #include "dataTypes/point.h"
+    #include "landmarks.h"
+    #include "searchStats.h"
+
+
+    // integer approximation of moving cardinally (1) and diagonally (sqrt 2)
+    static const int COST_CARDINAL = 70;
+    static const int COST_DIAGONAL = 99;
+
+
+    typedef enum pathStatus_e pathStatus_t;
+    typedef struct pathResult_s pathResult_t;
+    typedef struct aStarContext_s aStarContext_t;
+
+
+    enum pathStatus_e
+    {
+        PATH_FOUND,
+        PATH_NOT_FOUND,
+
+        // path found but longer than the buffer given - its contents are
+        // undefined and the path can be read again with `getAStarPath`
+        PATH_BUFFER_TOO_SMALL,
+
+        // search started with `startContextPath` has not finished yet
+        PATH_SEARCHING
+    };
+
+
+    struct pathResult_s
+    {
+        pathStatus_t status;
+
+        // points in the path (`source` excluded) and the cost of its moves
+        // - both `0` if no path is possible
+        cell_t length;
+        score_t cost;
+    };
 
 
+    aStarContext_t *initAStarContext(dungeon_t      *dungeon,
+                                     openListType_t  openType);
+
+    void freeAStarContext(aStarContext_t *context);
+
+    void setAStarLandmarks(aStarContext_t *context,
+                           landmarks_t    *landmarks);
+
     point_t *findPath(dungeon_t *dungeon,
                       point_t    source,
                       point_t    target);
 
+    point_t *findContextPath(aStarContext_t *context,
+                             point_t         source,
+                             point_t         target);
+
+    pathResult_t findContextPathBuffer(aStarContext_t *context,
+                                       point_t         source,
+                                       point_t         target,
+                                       point_t        *path,
+                                       cell_t          capacity);
+
+    void startContextPath(aStarContext_t *context,
+                          point_t         source,
+                          point_t         target);
+
+    pathStatus_t stepContextPath(aStarContext_t *context,
+                                 cell_t          maxExpansions);
+
+    pathResult_t finishContextPath(aStarContext_t *context,
+                                   point_t        *path,
+                                   cell_t          capacity);
+
+    void cancelContextPath(aStarContext_t *context);
+
+    pathResult_t getAStarPath(aStarContext_t *context,
+                              point_t        *path,
+                              cell_t          capacity);
+
+    cell_t getAStarExpansions(aStarContext_t *context);
+    searchStats_t getAStarStats(aStarContext_t *context);
+
 #endif
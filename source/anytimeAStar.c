@@ -0,0 +1,870 @@
+#include "anytimeAStar.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "dataStructs/searchGrid.h"
+#include "searchStats.h"
+
+
+// amount the weight is lowered by between iterations of `findAnytimePath`
+static const double WEIGHT_STEP = 0.5;
+
+// expansions between checks of the deadline of `findAnytimePath`
+static const uint32_t DEADLINE_INTERVAL = 256;
+
+// initial capacity of each list of cells - grown by doubling
+static const cell_t CELL_LIST_CAPACITY = 256;
+
+// initial capacity of the iterations of a search - grown by doubling
+static const uint32_t ITERATION_CAPACITY = 8;
+
+
+typedef struct cellList_s cellList_t;
+
+
+// growable list of cell indices kept between searches
+struct cellList_s
+{
+    cell_t *cells;
+    cell_t size;
+    cell_t capacity;
+};
+
+
+struct araContext_s
+{
+    dungeon_t *dungeon;
+
+    // cell indices between rows of tiles (see `getMoveIndex`)
+    int64_t rowStride;
+
+    searchGrid_t *grid;
+    openList_t *open;
+
+    // cells closed with the current weight - opened again for the next
+    cellList_t closed;
+
+    // cells to insert into the open list of the next weight - the open list
+    // once drained and closed cells whose g-score was lowered (may repeat)
+    cellList_t reopen;
+
+    // query of the last search - its path is kept in `grid` until the next
+    point_t target;
+    cell_t sourceIndex;
+    cell_t targetIndex;
+    double weight;
+
+    // every weight searched by the last search in order
+    araIteration_t *iterations;
+    uint32_t nIterations;
+    uint32_t iterationCapacity;
+};
+
+
+static void searchWeights(araContext_t *context,
+                          point_t       source,
+                          point_t       target,
+                          double        weight,
+                          uint64_t      deadline);
+static bool improvePath(araContext_t *context,
+                        uint64_t      deadline);
+static void exploreNeighbours(araContext_t *context,
+                              point_t       current,
+                              cell_t        currentIndex);
+static double findBound(araContext_t *context);
+static void reopenCells(araContext_t *context);
+static void addIteration(araContext_t *context,
+                         double        bound,
+                         cell_t        nExpanded);
+
+static score_t getFScore(araContext_t *context,
+                         point_t       point,
+                         score_t       gScore);
+
+static void initCellList(cellList_t *list);
+static void pushCellList(cellList_t *list,
+                         cell_t      index);
+
+
+/* ------------------------------ START PUBLIC ------------------------------ */
+
+
+/*
+@context
+    * Initialises a search context to find bounded-suboptimal paths in
+      `dungeon`.
+    * Holds the search state of each point, the open list and the lists of
+      cells reopened between weights.
+        * None are reallocated once grown by earlier searches.
+    * `dungeon` can be regenerated but must not be resized or freed while the
+      context is in use.
+
+@parameters
+    * dungeon
+        * Dungeon to find paths in.
+    * openType
+        * Priority queue used as the open list.
+        * Must not be `OPEN_LIST_BUCKET` as weighted f-scores can decrease.
+
+@return
+    * Search context ready to find paths in `dungeon`.
+*/
+araContext_t *initAraContext(dungeon_t      *dungeon,
+                             openListType_t  openType)
+{
+    araContext_t *context;
+
+    assert(openType != OPEN_LIST_BUCKET);
+
+    context = malloc(sizeof(araContext_t));
+    assert(context != NULL);
+
+    context->dungeon = dungeon;
+    context->rowStride = getDungeonRowStride(dungeon);
+    context->grid = initSearchGrid(getDungeonSize(dungeon));
+    context->open = initOpenList(openType, 0);
+    initCellList(&context->closed);
+    initCellList(&context->reopen);
+    context->weight = 1;
+
+    context->nIterations = 0;
+    context->iterationCapacity = ITERATION_CAPACITY;
+    context->iterations = malloc(sizeof(araIteration_t)
+                                 * context->iterationCapacity);
+    assert(context->iterations != NULL);
+
+    return context;
+}
+
+
+/*
+@context
+    * Frees `context`.
+    * The dungeon of `context` is not freed.
+
+@parameters
+    * context
+        * Search context to free.
+*/
+void freeAraContext(araContext_t *context)
+{
+    freeSearchGrid(context->grid);
+    freeOpenList(context->open);
+    free(context->closed.cells);
+    free(context->reopen.cells);
+    free(context->iterations);
+    free(context);
+}
+
+
+/*
+@context
+    * Finds a path from `source` to `target` costing at most `weight` times
+      the shortest path and writes it to `path`.
+    * Uses weighted A* - f-score is the g-score plus `weight` times the
+      Octile distance to `target`.
+        * A closed point is never expanded again even if a cheaper path to it
+          is found later - the bound still holds.
+    * A single iteration of `findAnytimePath` (see `getAraIteration`).
+    * The search is not repeated if `path` is too small.
+        * The length needed is returned and the path can be read again with
+          `getAraPath` until the next search of `context`.
+
+@parameters
+    * context
+        * Search context holding the dungeon to find path in.
+    * source
+        * Location to start from.
+    * target
+        * Location to find from `source`.
+    * weight
+        * Inflation of the heuristic - must be at least `1`.
+        * `1` finds a shortest path the same as `findContextPathBuffer`.
+    * path
+        * Buffer to write the path (sequence of points) to.
+            * `source` is not included.
+            * `target` is included as the last point.
+        * Can be `NULL` when `capacity` is `0` to only find length and cost.
+    * capacity
+        * Number of points `path` can hold.
+
+@return
+    * Status, length and cost of the path found.
+*/
+pathResult_t findWeightedPath(araContext_t *context,
+                              point_t       source,
+                              point_t       target,
+                              double        weight,
+                              point_t      *path,
+                              cell_t        capacity)
+{
+    // a deadline already passed stops after the first weight
+    searchWeights(context, source, target, weight, 0);
+
+    return getAraPath(context, path, capacity);
+}
+
+
+/*
+@context
+    * Finds a path from `source` to `target` costing at most `weight` times
+      the shortest path then improves it until `budgetNs` has passed or it is
+      a shortest path, and writes it to `path`.
+    * Uses ARA* - weighted A* is searched with `weight` then the weight is
+      lowered by `WEIGHT_STEP` (or to the bound achieved) for each repair.
+        * A repair opens the points left open by the last weight and the
+          closed points whose g-score was lowered since they were closed.
+    * The first weight is always searched to completion.
+        * A repair cut short by the deadline may still lower the cost of the
+          path but the bound is kept from the last complete weight.
+    * The search is not repeated if `path` is too small.
+        * The length needed is returned and the path can be read again with
+          `getAraPath` until the next search of `context`.
+
+@parameters
+    * context
+        * Search context holding the dungeon to find path in.
+    * source
+        * Location to start from.
+    * target
+        * Location to find from `source`.
+    * weight
+        * Initial inflation of the heuristic - must be at least `1`.
+    * budgetNs
+        * Time after which no more repairs are started (nanoseconds).
+    * path
+        * Buffer to write the path (sequence of points) to.
+            * `source` is not included.
+            * `target` is included as the last point.
+        * Can be `NULL` when `capacity` is `0` to only find length and cost.
+    * capacity
+        * Number of points `path` can hold.
+
+@return
+    * Status, length and cost of the best path found.
+*/
+pathResult_t findAnytimePath(araContext_t *context,
+                             point_t       source,
+                             point_t       target,
+                             double        weight,
+                             uint64_t      budgetNs,
+                             point_t      *path,
+                             cell_t        capacity)
+{
+    uint64_t deadline;
+
+    deadline = getStatsTimeNs();
+    deadline = budgetNs > UINT64_MAX - deadline
+             ? UINT64_MAX
+             : deadline + budgetNs;
+
+    searchWeights(context, source, target, weight, deadline);
+
+    return getAraPath(context, path, capacity);
+}
+
+
+/*
+@context
+    * Writes the path found by the last search of `context` to `path`.
+    * Used to read a path again after `path` was too small - the search state
+      of `context` is kept until its next search.
+    * The cost is summed along the path written.
+        * Can be below the g-score of the target when a repair lowered the
+          g-score of a point on the path after the target was reached.
+
+@parameters
+    * context
+        * Search context to get path of.
+    * path
+        * Buffer to write the path (sequence of points) to.
+            * `source` is not included.
+            * `target` is included as the last point.
+        * Can be `NULL` when `capacity` is `0` to only find length and cost.
+    * capacity
+        * Number of points `path` can hold.
+
+@return
+    * Status, length and cost of the path.
+        * `PATH_NOT_FOUND` if the last search found no path or `context` has
+          not searched yet.
+*/
+pathResult_t getAraPath(araContext_t *context,
+                        point_t      *path,
+                        cell_t        capacity)
+{
+    cell_t current, previous, i;
+    point_t currentPoint, previousPoint, swap;
+    pathResult_t result;
+
+    result.status = PATH_NOT_FOUND;
+    result.length = 0;
+    result.cost = 0;
+    if (context->nIterations == 0
+        || context->iterations[0].cost == SCORE_MAX)
+    {
+        return result;
+    }
+
+    // write `path` in reverse (from `target` to `source`) while it fits
+    current = context->targetIndex;
+    currentPoint = getDungeonIndexPoint(context->dungeon, current);
+    while (current != context->sourceIndex)
+    {
+        if (result.length < capacity)
+        {
+            path[result.length] = currentPoint;
+        }
+        result.length += 1;
+
+        previous = getSearchGridCell(context->grid, current)->prev;
+        previousPoint = getDungeonIndexPoint(context->dungeon, previous);
+        result.cost += distancePoints(previousPoint,
+                                      currentPoint,
+                                      COST_CARDINAL,
+                                      COST_DIAGONAL);
+        current = previous;
+        currentPoint = previousPoint;
+    }
+
+    if (result.length > capacity)
+    {
+        result.status = PATH_BUFFER_TOO_SMALL;
+        return result;
+    }
+
+    // put `path` in order (from after `source` to `target`)
+    for (i = 0; i < result.length / 2; i += 1)
+    {
+        swap = path[i];
+        path[i] = path[result.length - 1 - i];
+        path[result.length - 1 - i] = swap;
+    }
+    result.status = PATH_FOUND;
+
+    return result;
+}
+
+
+/*
+@context
+    * Gets the suboptimality bound achieved by the last search of `context`.
+    * The bound of its last complete weight.
+
+@parameters
+    * context
+        * Search context to get bound of.
+
+@return
+    * Bound on the cost of the path over the cost of a shortest path.
+        * `1` when the path is a shortest path.
+        * `0` if the last search found no path or `context` has not searched
+          yet.
+*/
+double getAraBound(araContext_t *context)
+{
+    if (context->nIterations == 0
+        || context->iterations[0].cost == SCORE_MAX)
+    {
+        return 0;
+    }
+
+    return context->iterations[context->nIterations - 1].bound;
+}
+
+
+/*
+@context
+    * Gets the number of points expanded in the last search of `context`.
+    * Summed over every weight - a point reopened is counted each time.
+
+@parameters
+    * context
+        * Search context to get number of expansions of.
+
+@return
+    * Number of points expanded.
+*/
+cell_t getAraExpansions(araContext_t *context)
+{
+    uint32_t i;
+    cell_t nExpanded;
+
+    nExpanded = 0;
+    for (i = 0; i < context->nIterations; i += 1)
+    {
+        nExpanded += context->iterations[i].nExpanded;
+    }
+
+    return nExpanded;
+}
+
+
+/*
+@context
+    * Gets the number of weights searched by the last search of `context`.
+
+@parameters
+    * context
+        * Search context to get number of iterations of.
+
+@return
+    * Number of iterations - `1` after `findWeightedPath`.
+*/
+uint32_t getAraIterations(araContext_t *context)
+{
+    return context->nIterations;
+}
+
+
+/*
+@context
+    * Gets iteration `index` of the last search of `context`.
+    * Iterations are in the order searched (decreasing weight).
+
+@parameters
+    * context
+        * Search context to get iteration of.
+    * index
+        * Index of the iteration.
+        * Must be `< getAraIterations(context)`.
+
+@return
+    * Weight, bound, expansions and cost of iteration `index`.
+*/
+araIteration_t getAraIteration(araContext_t *context,
+                               uint32_t      index)
+{
+    assert(index < context->nIterations);
+    return context->iterations[index];
+}
+
+
+/* ------------------------------- END PUBLIC ------------------------------- */
+/* ----------------------------- START  PRIVATE ----------------------------- */
+
+
+/*
+@context
+    * Searches `weight` then lowers the weight and repairs the path until it
+      is a shortest path or `deadline` has passed.
+    * The path found is left in the search state of `context` to be read by
+      `getAraPath`.
+
+@parameters
+    * context
+        * Search context holding the dungeon to find path in.
+    * source
+        * Location to start from.
+    * target
+        * Location to find from `source`.
+    * weight
+        * Initial inflation of the heuristic - must be at least `1`.
+    * deadline
+        * Time after which no more weights are searched (nanoseconds).
+*/
+static void searchWeights(araContext_t *context,
+                          point_t       source,
+                          point_t       target,
+                          double        weight,
+                          uint64_t      deadline)
+{
+    cell_t nExpanded;
+    double bound;
+    pointData_t *sourceData;
+    bool isComplete;
+
+    assert(weight >= 1);
+
+    resetSearchGrid(context->grid);
+    clearOpenList(context->open);
+    context->closed.size = 0;
+    context->reopen.size = 0;
+    context->nIterations = 0;
+
+    context->target = target;
+    context->sourceIndex = getDungeonIndex(context->dungeon, source);
+    context->targetIndex = getDungeonIndex(context->dungeon, target);
+    context->weight = weight;
+
+    sourceData = getSearchGridCell(context->grid, context->sourceIndex);
+    sourceData->gScore = 0;
+    openSearchGridCell(sourceData,
+                       context->open,
+                       source,
+                       getFScore(context, source, 0));
+
+    // the first weight is searched to completion so a path is always found
+    improvePath(context, UINT64_MAX);
+    bound = findBound(context);
+    addIteration(context, bound, context->closed.size);
+
+    while (bound > 1
+           && context->iterations[0].cost != SCORE_MAX
+           && getStatsTimeNs() < deadline)
+    {
+        // never search a weight above the bound already achieved
+        context->weight = context->weight - WEIGHT_STEP < bound
+                        ? context->weight - WEIGHT_STEP
+                        : bound;
+        if (context->weight < 1)
+        {
+            context->weight = 1;
+        }
+
+        reopenCells(context);
+        isComplete = improvePath(context, deadline);
+        nExpanded = context->closed.size;
+
+        // a repair cut short keeps the last bound (its cost is no higher)
+        if (isComplete)
+        {
+            bound = findBound(context);
+        }
+        addIteration(context, bound, nExpanded);
+
+        if (!isComplete)
+        {
+            break;
+        }
+    }
+}
+
+
+/*
+@context
+    * Expands points in f-score order until no open point can lead to a path
+      cheaper than the target's weighted f-score (its g-score).
+    * Points whose g-score is lowered after being closed are added to the
+      cells to reopen instead of the open list.
+
+@parameters
+    * context
+        * Search context holding the search state, open list and weight.
+    * deadline
+        * Time after which the search stops early (nanoseconds).
+        * Only checked every `DEADLINE_INTERVAL` expansions.
+
+@return
+    * Indication the search completed before `deadline`.
+*/
+static bool improvePath(araContext_t *context,
+                        uint64_t      deadline)
+{
+    cell_t currentIndex;
+    pointData_t *currentData, *targetData;
+    point_t current;
+
+    targetData = getSearchGridCell(context->grid, context->targetIndex);
+    while (!isOpenListEmpty(context->open)
+           && getMinOpenPriority(context->open) < targetData->gScore)
+    {
+        if (context->closed.size % DEADLINE_INTERVAL == DEADLINE_INTERVAL - 1
+            && getStatsTimeNs() >= deadline)
+        {
+            return false;
+        }
+
+        current = getMinOpenData(context->open);
+        freeMinOpenNode(context->open);
+
+        currentIndex = getDungeonIndex(context->dungeon, current);
+        currentData = getSearchGridCell(context->grid, currentIndex);
+        currentData->isClosed = true;
+        currentData->openNode = OPEN_NODE_NONE;
+        pushCellList(&context->closed, currentIndex);
+
+        exploreNeighbours(context, current, currentIndex);
+    }
+
+    return true;
+}
+
+
+/*
+@context
+    * Explores the valid neighbouring points around `current`.
+    * Neighbours reached by a cheaper path are added to the open list (or
+      have their f-score lowered) unless closed.
+        * Closed neighbours are added to the cells to reopen for the next
+          weight instead.
+
+@parameters
+    * context
+        * Search context holding the search state, open list and weight.
+    * current
+        * Location to expand neighbours around.
+    * currentIndex
+        * Cell index of `current`.
+*/
+static void exploreNeighbours(araContext_t *context,
+                              point_t       current,
+                              cell_t        currentIndex)
+{
+    uint8_t i, moves;
+    score_t gScore;
+    cell_t neighbourIndex;
+    pointData_t *currentData, *neighbourData;
+    point_t neighbour;
+
+    currentData = getSearchGridCell(context->grid, currentIndex);
+
+    moves = getDungeonPointMoves(context->dungeon, current);
+    for (i = 0; moves != 0; i += 1, moves >>= 1)
+    {
+        if (!(moves & 1))
+        {
+            continue;
+        }
+
+        neighbour = addPoints(current, MOVES[i]);
+        gScore = currentData->gScore
+               + distancePoints(current,
+                                neighbour,
+                                COST_CARDINAL,
+                                COST_DIAGONAL);
+
+        neighbourIndex = getMoveIndex(context->rowStride,
+                                      currentIndex,
+                                      MOVES[i]);
+        neighbourData = getSearchGridCell(context->grid, neighbourIndex);
+        if (gScore >= neighbourData->gScore)
+        {
+            continue;
+        }
+
+        neighbourData->prev = currentIndex;
+        neighbourData->gScore = gScore;
+        if (neighbourData->isClosed)
+        {
+            pushCellList(&context->reopen, neighbourIndex);
+        }
+        else
+        {
+            openSearchGridCell(neighbourData,
+                               context->open,
+                               neighbour,
+                               getFScore(context, neighbour, gScore));
+        }
+    }
+}
+
+
+/*
+@context
+    * Finds the suboptimality bound of the path found with the current weight.
+    * No shortest path costs less than the lowest unweighted f-score of the
+      open points and the points to reopen.
+        * Drains the open list into the cells to reopen to find it - they are
+          inserted again by `reopenCells` with the next weight.
+    * Never above the current weight.
+
+@parameters
+    * context
+        * Search context whose weight was just searched.
+
+@return
+    * Bound on the cost of the path over the cost of a shortest path.
+        * `1` when no point is left to open (the path is a shortest path).
+*/
+static double findBound(araContext_t *context)
+{
+    cell_t i, index;
+    score_t fScore, fScoreMin, cost;
+    double bound;
+    pointData_t *pointData;
+    point_t point;
+
+    while (!isOpenListEmpty(context->open))
+    {
+        point = getMinOpenData(context->open);
+        freeMinOpenNode(context->open);
+
+        index = getDungeonIndex(context->dungeon, point);
+        pointData = getSearchGridCell(context->grid, index);
+        pointData->openNode = OPEN_NODE_NONE;
+        pushCellList(&context->reopen, index);
+    }
+
+    cost = getSearchGridCell(context->grid, context->targetIndex)->gScore;
+    fScoreMin = cost;
+    for (i = 0; i < context->reopen.size; i += 1)
+    {
+        point = getDungeonIndexPoint(context->dungeon,
+                                     context->reopen.cells[i]);
+        fScore = getSearchGridCell(context->grid,
+                                   context->reopen.cells[i])->gScore
+               + distancePoints(point,
+                                context->target,
+                                COST_CARDINAL,
+                                COST_DIAGONAL);
+        if (fScore < fScoreMin)
+        {
+            fScoreMin = fScore;
+        }
+    }
+
+    if (cost == SCORE_MAX || fScoreMin == cost)
+    {
+        return 1;
+    }
+
+    bound = (double)cost / fScoreMin;
+    return bound < context->weight ? bound : context->weight;
+}
+
+
+/*
+@context
+    * Opens every cell closed by the last weight again and inserts the cells
+      to reopen into the open list with the f-scores of the current weight.
+
+@parameters
+    * context
+        * Search context holding the search state and open list.
+*/
+static void reopenCells(araContext_t *context)
+{
+    cell_t i;
+    pointData_t *pointData;
+    point_t point;
+
+    for (i = 0; i < context->closed.size; i += 1)
+    {
+        pointData = getSearchGridCell(context->grid, context->closed.cells[i]);
+        pointData->isClosed = false;
+        pointData->openNode = OPEN_NODE_NONE;
+    }
+    context->closed.size = 0;
+
+    // cells can be in the list more than once but are only inserted once
+    for (i = 0; i < context->reopen.size; i += 1)
+    {
+        pointData = getSearchGridCell(context->grid, context->reopen.cells[i]);
+        if (pointData->openNode == OPEN_NODE_NONE)
+        {
+            point = getDungeonIndexPoint(context->dungeon,
+                                         context->reopen.cells[i]);
+            openSearchGridCell(pointData,
+                               context->open,
+                               point,
+                               getFScore(context, point, pointData->gScore));
+        }
+    }
+    context->reopen.size = 0;
+}
+
+
+/*
+@context
+    * Records the current weight as the next iteration of the last search.
+    * The iterations are grown when full.
+
+@parameters
+    * context
+        * Search context whose weight was just searched.
+    * bound
+        * Suboptimality bound achieved by the weight.
+    * nExpanded
+        * Points expanded with the weight.
+*/
+static void addIteration(araContext_t *context,
+                         double        bound,
+                         cell_t        nExpanded)
+{
+    if (context->nIterations == context->iterationCapacity)
+    {
+        context->iterationCapacity *= 2;
+        context->iterations = realloc(context->iterations,
+                                      sizeof(araIteration_t)
+                                      * context->iterationCapacity);
+        assert(context->iterations != NULL);
+    }
+
+    context->iterations[context->nIterations] = (araIteration_t){
+        .weight = context->weight,
+        .bound = bound,
+        .nExpanded = nExpanded,
+        .cost = getSearchGridCell(context->grid, context->targetIndex)->gScore
+    };
+    context->nIterations += 1;
+}
+
+
+/*
+@context
+    * Finds the weighted f-score of `point` with the current weight.
+    * The weighted heuristic is rounded down so it never exceeds the weight
+      times the Octile distance.
+
+@parameters
+    * context
+        * Search context holding the target and weight.
+    * point
+        * Location to find f-score of.
+    * gScore
+        * Cost of the path found to `point`.
+
+@return
+    * G-score plus the weighted Octile distance to the target.
+*/
+static score_t getFScore(araContext_t *context,
+                         point_t       point,
+                         score_t       gScore)
+{
+    return gScore + (score_t)(context->weight
+                              * distancePoints(point,
+                                               context->target,
+                                               COST_CARDINAL,
+                                               COST_DIAGONAL));
+}
+
+
+/*
+@context
+    * Initialises an empty list of cells with `CELL_LIST_CAPACITY` capacity.
+
+@parameters
+    * list
+        * List to initialise.
+*/
+static void initCellList(cellList_t *list)
+{
+    list->size = 0;
+    list->capacity = CELL_LIST_CAPACITY;
+    list->cells = malloc(sizeof(cell_t) * (size_t)list->capacity);
+    assert(list->cells != NULL);
+}
+
+
+/*
+@context
+    * Adds cell `index` to the end of `list`.
+    * The list is grown when full.
+
+@parameters
+    * list
+        * List to add to.
+    * index
+        * Cell index to add.
+*/
+static void pushCellList(cellList_t *list,
+                         cell_t      index)
+{
+    if (list->size == list->capacity)
+    {
+        list->capacity *= 2;
+        list->cells = realloc(list->cells,
+                              sizeof(cell_t) * (size_t)list->capacity);
+        assert(list->cells != NULL);
+    }
+
+    list->cells[list->size] = index;
+    list->size += 1;
+}
+
+
+/* ------------------------------ END  PRIVATE ------------------------------ */
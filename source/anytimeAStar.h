@@ -0,0 +1,86 @@
+/*
+@context
+    * Provides bounded-suboptimal searches for callers with a latency budget.
+        * Weighted A* inflates the Octile distance heuristic by a weight so
+          fewer points are expanded - its path costs at most the weight times
+          the shortest path.
+        * Anytime Repairing A* (ARA*) finds a weighted path then repeatedly
+          lowers the weight and repairs the path while time remains.
+            * Each repair reuses the search state of the last instead of
+              searching again - only points whose g-score was lowered after
+              they were closed are reopened.
+    * Both report the suboptimality bound achieved - the path found costs at
+      most the bound times the shortest path.
+        * The bound is never above the weight searched with and is often
+          lower (the g-score of the target over the lowest f-score left).
+    * Follows the same movement rules as `isValidMove`.
+    * Writes the path to a buffer of the caller in the same format as
+      `findContextPathBuffer`.
+    * A search context can be reused between searches on the same dungeon.
+        * F-scores popped decrease when the weight is above 1 so the bucket
+          queue cannot be the open list.
+*/
+
+
+#ifndef _ANYTIME_A_STAR_H
+    #define _ANYTIME_A_STAR_H
+
+    #include <stdint.h>
+
+    #include "aStar.h"
+    #include "dataStructs/dungeon.h"
+    #include "dataStructs/openList.h"
+    #include "dataTypes/point.h"
+
+
+    typedef struct araIteration_s araIteration_t;
+    typedef struct araContext_s araContext_t;
+
+
+    // result of one weight searched by the last search of a context
+    struct araIteration_s
+    {
+        double weight;
+
+        // path found costs at most `bound` times the shortest path
+        double bound;
+
+        // points closed (including points reopened from earlier weights)
+        cell_t nExpanded;
+
+        // g-score of the target - `SCORE_MAX` if no path is possible
+        score_t cost;
+    };
+
+
+    araContext_t *initAraContext(dungeon_t      *dungeon,
+                                 openListType_t  openType);
+
+    void freeAraContext(araContext_t *context);
+
+    pathResult_t findWeightedPath(araContext_t *context,
+                                  point_t       source,
+                                  point_t       target,
+                                  double        weight,
+                                  point_t      *path,
+                                  cell_t        capacity);
+
+    pathResult_t findAnytimePath(araContext_t *context,
+                                 point_t       source,
+                                 point_t       target,
+                                 double        weight,
+                                 uint64_t      budgetNs,
+                                 point_t      *path,
+                                 cell_t        capacity);
+
+    pathResult_t getAraPath(araContext_t *context,
+                            point_t      *path,
+                            cell_t        capacity);
+
+    double getAraBound(araContext_t *context);
+    cell_t getAraExpansions(araContext_t *context);
+    uint32_t getAraIterations(araContext_t *context);
+    araIteration_t getAraIteration(araContext_t *context,
+                                   uint32_t      index);
+
+#endif
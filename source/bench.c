@@ -0,0 +1,2572 @@
+/*
+@context
+    * Benchmarks the A* search stack without the text interface.
+    * Generates seeded dungeon configurations and times finding the path
+      between each source and target.
+        * `findPath` sets up and tears down its search state on every call.
+        * `findContextPath` reuses one search context between calls.
+        * `findContextPathBuffer` with landmark distance tables (ALT) is
+          followed by a `landmarks` line with the expansions saved and the
+          memory and build time of the tables.
+        * `stepContextPath` interleaves the queries of every dungeon in
+          slices of a fixed number of expansions, as a game loop spreading
+          searches over frames would - each slice is timed.
+        * `findPath` and `findContextPathBuffer` reject a target walled off
+          from its source, and `setDungeonPoint` walls it off and opens it
+          again (updating the connected component labels).
+        * `findJumpPath` reuses one Jump Point Search context between calls.
+        * `findHpaPath` searches a cluster graph built before timing and is
+          followed by a `suboptimality` line comparing its costs with
+          `findPath`.
+        * `findBidirectionalPath` reuses one bidirectional A* context between
+          calls.
+        * `findWeightedPath` and `findAnytimePath` (run until its path is a
+          shortest path) reuse one context between calls and each is followed
+          by a `suboptimality` line comparing its costs with `findPath`.
+        * `findPoolPaths` solves each dungeon's queries as one batch across a
+          pool of threads.
+        * `findLpaPath` replans after walls are placed on the path and is
+          compared with `findPath` searching the same edited dungeon - each
+          pair is followed by a `replan` line showing which is faster.
+        * `findFlowPath` follows a flow field built once per dungeon and
+          `setFlowPoint` updating it after a wall is placed is compared with
+          `rebuildFlowField`.
+        * `findCachedPath` answers repeated queries from a path cache while
+          `setCachedPoint` places and removes walls - hits, misses and edits
+          are timed apart.
+    * Each open list type is timed within `findContextPath` and on its own
+      with a push/pop workload shaped like A* (f-scores never decrease).
+    * Microbenchmarks time `skipPQ` pushes and pops, `isValidMove` and
+      `generateDungeon` on their own.
+    * The bytes of the tiles, navigation data (walkable bits and cached
+      moves) and connected component labels of a dungeon are printed first.
+    * `tile_side` of the `config` line is the side of the tiles cells are laid
+      out in (1 when row-major) so runs of `make bench` and `make bench
+      TILED=1` can be compared.
+    * Each benchmark prints one line of space separated `key=value` fields.
+        * `ops`, `total_ns`, `ns_per_op` and `ops_per_s` are always printed.
+        * `p50_ns` and `p99_ns` are printed when each operation is timed.
+        * `expanded_per_op` is printed when the search counts expansions.
+        * `allocs_per_op` counts `malloc`, `calloc` and `realloc` calls
+          (wrapped by the linker - see `Makefile`).
+    * Built with `make bench STATS=1`, a `stats=` line follows each
+      `findContextPath` benchmark with its per-search statistics.
+    * Usage: `./benchmark [nDungeons] [width] [height] [seed]`.
+        * `./benchmark <file.scen> [file.map]` instead runs a MovingAI
+          scenario and checks each cost found is optimal.
+*/
+
+
+#include <assert.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "anytimeAStar.h"
+#include "aStar.h"
+#include "bidirectionalAStar.h"
+#include "flowField.h"
+#include "hierarchicalAStar.h"
+#include "jumpPointSearch.h"
+#include "landmarks.h"
+#include "lifelongAStar.h"
+#include "movingAI.h"
+#include "pathCache.h"
+#include "pathPool.h"
+#include "dataStructs/dungeon.h"
+#include "dataStructs/openList.h"
+#include "dataStructs/skipPQ.h"
+#include "dataTypes/point.h"
+#include "searchStats.h"
+
+
+static const int SEED = 7907;
+
+// default benchmark size - the dungeon size matches the interface canvas
+static const int N_DUNGEONS = 2000;
+static const int WIDTH = 69;
+static const int HEIGHT = 16;
+
+// number of times each dungeon configuration is searched
+static const int N_REPEATS = 20;
+
+// width and height of each cluster timed by `benchFindHpaPath`
+static const uint16_t HPA_CLUSTER_SIZE = 16;
+
+// tile placed on the path by `benchReplan` - the wall tile of a dungeon
+static const char TILE_WALL = '#';
+
+// blocks of walls placed by `benchReplan` - a single tile and a 3x3 region
+static const int EDIT_RADII[] = {0, 1};
+static const int N_EDIT_RADII = sizeof(EDIT_RADII) / sizeof(int);
+
+// weights timed by `benchFindBoundedPath` - each searched on its own then as
+// the initial weight of an anytime search
+static const double WEIGHTS[] = {1.5, 2, 3};
+static const int N_WEIGHTS = sizeof(WEIGHTS) / sizeof(double);
+
+// most iterations of an anytime search whose expansions are reported
+#define ITERATIONS_REPORTED 8
+
+// landmarks of the distance tables timed by `benchFindLandmarkPath`
+static const uint32_t LANDMARK_COUNTS[] = {2, 4, 8};
+static const int N_LANDMARK_COUNTS = sizeof(LANDMARK_COUNTS)
+                                   / sizeof(uint32_t);
+
+// expansions per slice timed by `benchStepContextPath`
+static const uint32_t SLICE_SIZES[] = {16, 256};
+static const int N_SLICE_SIZES = sizeof(SLICE_SIZES) / sizeof(uint32_t);
+
+// cache timed by `benchPathCache` - distinct queries of each dungeon and the
+// byte cap of its cache (enough for every query of a default dungeon)
+static const int N_CACHE_QUERIES = 16;
+static const uint64_t CACHE_BYTES = 64 * 1024;
+
+// thread pool sizes timed by `benchFindPoolPaths`
+static const uint8_t POOL_SIZES[] = {1, 2, 4};
+static const int N_POOL_SIZES = sizeof(POOL_SIZES) / sizeof(uint8_t);
+
+// open list workload - each pop is followed by up to `PUSHES_MAX` pushes
+static const long N_OPEN_OPS = 2000000;
+static const int PUSHES_MAX = 3;
+static const uint32_t OPEN_SIZE_MAX = 4096;
+static const score_t OPEN_SPREAD = 198;
+
+// skip list workload - `N_SKIP_NODES` pushes then as many pops, repeated
+static const long N_SKIP_NODES = 4096;
+static const int N_SKIP_ROUNDS = 100;
+static const uint32_t SKIP_PRIORITY_MAX = 8192;
+
+static const long NS_PER_S = 1000000000;
+
+// extension of MovingAI scenario files
+static const char SCENARIO_EXTENSION[] = ".scen";
+
+// longest location of a map found next to its scenario (including terminator)
+#define MAP_PATH_SIZE 4096
+
+
+// finds a path with the searcher built for a dungeon (e.g. a search context)
+typedef point_t *(*find_t)(void *searcher, point_t source, point_t target);
+
+// gets the points expanded by the last search of a searcher
+typedef cell_t (*expansions_t)(void *searcher);
+
+typedef struct bufferSearcher_s bufferSearcher_t;
+
+
+// search context writing paths to a buffer reused between searches
+struct bufferSearcher_s
+{
+    aStarContext_t *context;
+    point_t *path;
+    cell_t capacity;
+};
+
+
+// allocations made since the benchmark started - shared by all threads
+static atomic_long nAllocs;
+
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t count,
+                    size_t size);
+void *__real_realloc(void   *pointer,
+                     size_t  size);
+
+void *__wrap_malloc(size_t size);
+void *__wrap_calloc(size_t count,
+                    size_t size);
+void *__wrap_realloc(void   *pointer,
+                     size_t  size);
+
+
+static long long timeNs();
+
+static point_t *findPathAdapter(void    *searcher,
+                                point_t  source,
+                                point_t  target);
+static point_t *findContextPathAdapter(void    *searcher,
+                                       point_t  source,
+                                       point_t  target);
+static point_t *findContextPathBufferAdapter(void    *searcher,
+                                             point_t  source,
+                                             point_t  target);
+static point_t *findJumpPathAdapter(void    *searcher,
+                                    point_t  source,
+                                    point_t  target);
+static point_t *findHpaPathAdapter(void    *searcher,
+                                   point_t  source,
+                                   point_t  target);
+static point_t *findBidirectionalPathAdapter(void    *searcher,
+                                             point_t  source,
+                                             point_t  target);
+static cell_t getAStarExpansionsAdapter(void *searcher);
+static cell_t getBufferExpansionsAdapter(void *searcher);
+static cell_t getBidirectionalExpansionsAdapter(void *searcher);
+
+static void benchSearch(const char    *name,
+                        dungeon_t    **dungeons,
+                        void         **searchers,
+                        int            nDungeons,
+                        find_t         find,
+                        expansions_t   expansions);
+static void benchFindPath(dungeon_t **dungeons,
+                          int         nDungeons);
+static void benchFindContextPath(dungeon_t      **dungeons,
+                                 int              nDungeons,
+                                 openListType_t   openType);
+static void benchFindContextPathBuffer(dungeon_t      **dungeons,
+                                       int              nDungeons,
+                                       openListType_t   openType);
+static void benchFindLandmarkPath(dungeon_t **dungeons,
+                                  int         nDungeons,
+                                  uint32_t    nLandmarks);
+static void benchStepContextPath(dungeon_t **dungeons,
+                                 int         nDungeons,
+                                 uint32_t    sliceSize);
+static void benchUnreachablePath(dungeon_t **dungeons,
+                                 int         nDungeons);
+#ifdef SEARCH_STATS
+static void reportStats(const char      *name,
+                        dungeon_t      **dungeons,
+                        aStarContext_t **contexts,
+                        int              nDungeons);
+#endif
+static void benchFindJumpPath(dungeon_t      **dungeons,
+                              int              nDungeons,
+                              openListType_t   openType);
+static void benchFindHpaPath(dungeon_t **dungeons,
+                             int         nDungeons);
+static score_t getPathCost(point_t  source,
+                           point_t  target,
+                           point_t *path);
+static void benchFindBidirectionalPath(dungeon_t      **dungeons,
+                                       int              nDungeons,
+                                       openListType_t   openType);
+static void benchFindBoundedPath(dungeon_t **dungeons,
+                                 int         nDungeons,
+                                 double      weight,
+                                 bool        isAnytime);
+static void benchFindPoolPaths(dungeon_t **dungeons,
+                               int         nDungeons,
+                               uint8_t     nThreads);
+static void benchReplan(dungeon_t **dungeons,
+                        int         nDungeons,
+                        int         radius);
+static int setBlock(lpaPlanner_t *planner,
+                    dungeon_t    *dungeon,
+                    point_t       centre,
+                    int           radius,
+                    char         *tiles,
+                    bool          isRestoring);
+static void benchFlowField(dungeon_t **dungeons,
+                           int         nDungeons);
+static void benchPathCache(dungeon_t **dungeons,
+                           int         nDungeons);
+static point_t findWalkablePoint(dungeon_t *dungeon,
+                                 cell_t     index);
+static int benchScenario(const char *scenarioPath,
+                         const char *mapPath);
+static void findMapPath(char       *path,
+                        const char *scenarioPath,
+                        const char *mapName);
+static void benchOpenList(int            seed,
+                          openListType_t openType);
+
+static void benchSkipPQ(int seed);
+static void benchIsValidMove(dungeon_t **dungeons,
+                             int         nDungeons);
+static void benchGenerateDungeon(int      nDungeons,
+                                 uint32_t width,
+                                 uint32_t height);
+
+static int compareLatencies(const void *a,
+                            const void *b);
+static void report(const char *name,
+                   long        nOps,
+                   long long   elapsed,
+                   long long  *latencies,
+                   long long   nExpanded,
+                   long        allocs);
+
+
+/*
+@context
+    * Entry point of benchmark.
+
+@parameters
+    * argc
+        * Number of command line arguments.
+    * argv
+        * Optional number of dungeons, width, height and seed (in that order).
+        * Or a MovingAI `.scen` file and optionally its `.map` file.
+
+@return
+    * Indicates benchmark successfully terminates.
+*/
+int main(int argc, char **argv)
+{
+    int i, nDungeons, seed;
+    uint32_t width, height;
+    openListType_t openType;
+    dungeon_t **dungeons;
+
+    // a scenario file is run on its map instead of random dungeons
+    if (argc > 1 && strlen(argv[1]) > strlen(SCENARIO_EXTENSION)
+        && strcmp(argv[1] + strlen(argv[1]) - strlen(SCENARIO_EXTENSION),
+                  SCENARIO_EXTENSION) == 0)
+    {
+        return benchScenario(argv[1], argc > 2 ? argv[2] : NULL);
+    }
+
+    nDungeons = argc > 1 ? atoi(argv[1]) : N_DUNGEONS;
+    width = argc > 2 ? atoi(argv[2]) : WIDTH;
+    height = argc > 3 ? atoi(argv[3]) : HEIGHT;
+    seed = argc > 4 ? atoi(argv[4]) : SEED;
+
+    srand(seed);
+
+    // generate every dungeon configuration up front so only searching is timed
+    dungeons = malloc(sizeof(dungeon_t*) * nDungeons);
+    assert(dungeons != NULL);
+    for (i = 0; i < nDungeons; i += 1)
+    {
+        dungeons[i] = initDungeon(width, height);
+    }
+
+    // side of the tiles cells are laid out in - 1 when cells are row-major
+    printf("config dungeons=%d width=%u height=%u repeats=%d seed=%d"
+           " tile_side=%lld\n",
+           nDungeons, width, height, N_REPEATS, seed, (long long)TILE_SIDE);
+
+    // tiles take 1 byte each - navigation is packed bits and cached moves
+    printf("memory map_bytes=%llu navigation_bytes=%llu"
+           " navigation_bits_per_tile=%.2f component_bytes=%llu\n",
+           (unsigned long long)getDungeonSize(dungeons[0]),
+           (unsigned long long)getDungeonNavigationBytes(dungeons[0]),
+           8.0 * getDungeonNavigationBytes(dungeons[0])
+           / getDungeonSize(dungeons[0]),
+           (unsigned long long)getDungeonComponentBytes(dungeons[0]));
+
+    benchFindPath(dungeons, nDungeons);
+    for (openType = 0; openType < N_OPEN_LIST_TYPES; openType += 1)
+    {
+        benchFindContextPath(dungeons, nDungeons, openType);
+    }
+    benchFindContextPathBuffer(dungeons, nDungeons, OPEN_LIST_DEFAULT);
+    for (i = 0; i < N_LANDMARK_COUNTS; i += 1)
+    {
+        benchFindLandmarkPath(dungeons, nDungeons, LANDMARK_COUNTS[i]);
+    }
+    for (i = 0; i < N_SLICE_SIZES; i += 1)
+    {
+        benchStepContextPath(dungeons, nDungeons, SLICE_SIZES[i]);
+    }
+    benchUnreachablePath(dungeons, nDungeons);
+
+    // bucket queue is skipped as jumps need a bucket per f-score in a dungeon
+    for (openType = OPEN_LIST_BINARY_HEAP;
+         openType < N_OPEN_LIST_TYPES;
+         openType += 1)
+    {
+        benchFindJumpPath(dungeons, nDungeons, openType);
+    }
+
+    benchFindHpaPath(dungeons, nDungeons);
+
+    for (openType = 0; openType < N_OPEN_LIST_TYPES; openType += 1)
+    {
+        benchFindBidirectionalPath(dungeons, nDungeons, openType);
+    }
+
+    for (i = 0; i < N_WEIGHTS; i += 1)
+    {
+        benchFindBoundedPath(dungeons, nDungeons, WEIGHTS[i], false);
+        benchFindBoundedPath(dungeons, nDungeons, WEIGHTS[i], true);
+    }
+
+    for (i = 0; i < N_POOL_SIZES; i += 1)
+    {
+        benchFindPoolPaths(dungeons, nDungeons, POOL_SIZES[i]);
+    }
+
+    for (i = 0; i < N_EDIT_RADII; i += 1)
+    {
+        benchReplan(dungeons, nDungeons, EDIT_RADII[i]);
+    }
+
+    benchFlowField(dungeons, nDungeons);
+    benchPathCache(dungeons, nDungeons);
+
+    for (openType = 0; openType < N_OPEN_LIST_TYPES; openType += 1)
+    {
+        benchOpenList(seed, openType);
+    }
+
+    benchSkipPQ(seed);
+    benchIsValidMove(dungeons, nDungeons);
+    benchGenerateDungeon(nDungeons, width, height);
+
+    for (i = 0; i < nDungeons; i += 1)
+    {
+        freeDungeon(dungeons[i]);
+    }
+    free(dungeons);
+
+    return EXIT_SUCCESS;
+}
+
+
+/*
+@context
+    * Counts then forwards every `malloc` of the benchmark and search stack.
+    * Linked in place of `malloc` with `-Wl,--wrap=malloc`.
+
+@parameters
+    * size
+        * Number of bytes to allocate.
+
+@return
+    * Allocated memory.
+*/
+void *__wrap_malloc(size_t size)
+{
+    atomic_fetch_add_explicit(&nAllocs, 1, memory_order_relaxed);
+    return __real_malloc(size);
+}
+
+
+/*
+@context
+    * Counts then forwards every `calloc` of the benchmark and search stack.
+    * Linked in place of `calloc` with `-Wl,--wrap=calloc`.
+
+@parameters
+    * count
+        * Number of elements to allocate.
+    * size
+        * Number of bytes of each element.
+
+@return
+    * Allocated zeroed memory.
+*/
+void *__wrap_calloc(size_t count,
+                    size_t size)
+{
+    atomic_fetch_add_explicit(&nAllocs, 1, memory_order_relaxed);
+    return __real_calloc(count, size);
+}
+
+
+/*
+@context
+    * Counts then forwards every `realloc` of the benchmark and search stack.
+    * Linked in place of `realloc` with `-Wl,--wrap=realloc`.
+
+@parameters
+    * pointer
+        * Memory to resize.
+    * size
+        * New number of bytes.
+
+@return
+    * Resized memory.
+*/
+void *__wrap_realloc(void   *pointer,
+                     size_t  size)
+{
+    atomic_fetch_add_explicit(&nAllocs, 1, memory_order_relaxed);
+    return __real_realloc(pointer, size);
+}
+
+
+/*
+@context
+    * Gets the current calendar time.
+
+@return
+    * Current time in nanoseconds.
+*/
+static long long timeNs()
+{
+    struct timespec now;
+
+    timespec_get(&now, TIME_UTC);
+    return (long long)now.tv_sec * NS_PER_S + now.tv_nsec;
+}
+
+
+/*
+@context
+    * Adapters giving each search method the signature of `find_t` or
+      `expansions_t`.
+    * The searcher is the search state built for the dungeon searched.
+        * `findPath` builds its own so its searcher is the dungeon.
+*/
+static point_t *findPathAdapter(void    *searcher,
+                                point_t  source,
+                                point_t  target)
+{
+    return findPath(searcher, source, target);
+}
+
+static point_t *findContextPathAdapter(void    *searcher,
+                                       point_t  source,
+                                       point_t  target)
+{
+    return findContextPath(searcher, source, target);
+}
+
+static point_t *findContextPathBufferAdapter(void    *searcher,
+                                             point_t  source,
+                                             point_t  target)
+{
+    bufferSearcher_t *buffer;
+
+    // the path stays in the buffer so there is nothing for the caller to free
+    buffer = searcher;
+    findContextPathBuffer(buffer->context,
+                          source,
+                          target,
+                          buffer->path,
+                          buffer->capacity);
+    return NULL;
+}
+
+static point_t *findJumpPathAdapter(void    *searcher,
+                                    point_t  source,
+                                    point_t  target)
+{
+    return findJumpPath(searcher, source, target);
+}
+
+static point_t *findHpaPathAdapter(void    *searcher,
+                                   point_t  source,
+                                   point_t  target)
+{
+    return findHpaPath(searcher, source, target);
+}
+
+static point_t *findBidirectionalPathAdapter(void    *searcher,
+                                             point_t  source,
+                                             point_t  target)
+{
+    return findBidirectionalPath(searcher, source, target);
+}
+
+static cell_t getAStarExpansionsAdapter(void *searcher)
+{
+    return getAStarExpansions(searcher);
+}
+
+static cell_t getBufferExpansionsAdapter(void *searcher)
+{
+    return getAStarExpansions(((bufferSearcher_t*)searcher)->context);
+}
+
+static cell_t getBidirectionalExpansionsAdapter(void *searcher)
+{
+    return getBidirectionalExpansions(searcher);
+}
+
+
+/*
+@context
+    * Times `find` on the source to target query of every dungeon.
+    * Each query is timed on its own - freeing the path found is not timed.
+    * Each dungeon is searched `N_REPEATS` times.
+
+@parameters
+    * name
+        * Name of benchmark.
+    * dungeons
+        * Dungeon configurations to search.
+    * searchers
+        * Search state of each dungeon passed to `find`.
+    * nDungeons
+        * Number of `dungeons`.
+    * find
+        * Search method to time.
+    * expansions
+        * Gets the points expanded by a search - `NULL` if not counted.
+*/
+static void benchSearch(const char    *name,
+                        dungeon_t    **dungeons,
+                        void         **searchers,
+                        int            nDungeons,
+                        find_t         find,
+                        expansions_t   expansions)
+{
+    int i, j;
+    long nQueries, allocs;
+    long long start, elapsed, nExpanded, *latencies;
+    point_t *path;
+
+    nQueries = (long)nDungeons * N_REPEATS;
+    latencies = malloc(sizeof(long long) * nQueries);
+    assert(latencies != NULL);
+
+    elapsed = 0;
+    nExpanded = expansions == NULL ? -1 : 0;
+    allocs = atomic_load(&nAllocs);
+    for (i = 0; i < nDungeons; i += 1)
+    {
+        for (j = 0; j < N_REPEATS; j += 1)
+        {
+            start = timeNs();
+            path = find(searchers[i],
+                        getDungeonSource(dungeons[i]),
+                        getDungeonTarget(dungeons[i]));
+            latencies[i * N_REPEATS + j] = timeNs() - start;
+            elapsed += latencies[i * N_REPEATS + j];
+
+            free(path);
+            if (expansions != NULL)
+            {
+                nExpanded += expansions(searchers[i]);
+            }
+        }
+    }
+    allocs = atomic_load(&nAllocs) - allocs;
+
+    report(name, nQueries, elapsed, latencies, nExpanded, allocs);
+
+    free(latencies);
+}
+
+
+/*
+@context
+    * Times `findPath` (search state set up per call) on every dungeon.
+    * `findPath` does not keep its search context so expansions are reported
+      by `findContextPath` instead.
+
+@parameters
+    * dungeons
+        * Dungeon configurations to search.
+    * nDungeons
+        * Number of `dungeons`.
+*/
+static void benchFindPath(dungeon_t **dungeons,
+                          int         nDungeons)
+{
+    benchSearch("findPath",
+                dungeons,
+                (void**)dungeons,
+                nDungeons,
+                findPathAdapter,
+                NULL);
+}
+
+
+/*
+@context
+    * Times `findContextPath` (search state reused) on every dungeon.
+    * Contexts are set up before timing as they are reused in practice.
+
+@parameters
+    * dungeons
+        * Dungeon configurations to search.
+    * nDungeons
+        * Number of `dungeons`.
+    * openType
+        * Open list type of each search context.
+*/
+static void benchFindContextPath(dungeon_t      **dungeons,
+                                 int              nDungeons,
+                                 openListType_t   openType)
+{
+    int i;
+    char name[64];
+    aStarContext_t **contexts;
+
+    // one context per dungeon as a context is bound to its dungeon
+    contexts = malloc(sizeof(aStarContext_t*) * nDungeons);
+    assert(contexts != NULL);
+    for (i = 0; i < nDungeons; i += 1)
+    {
+        contexts[i] = initAStarContext(dungeons[i], openType);
+    }
+
+    snprintf(name, sizeof(name), "findContextPath/%s",
+             getOpenListTypeName(openType));
+    benchSearch(name,
+                dungeons,
+                (void**)contexts,
+                nDungeons,
+                findContextPathAdapter,
+                getAStarExpansionsAdapter);
+    STATS(reportStats(name, dungeons, contexts, nDungeons));
+
+    for (i = 0; i < nDungeons; i += 1)
+    {
+        freeAStarContext(contexts[i]);
+    }
+    free(contexts);
+}
+
+
+/*
+@context
+    * Times `findContextPathBuffer` (search state and path buffer reused) on
+      every dungeon.
+    * Each buffer holds a point for every cell so no path is too long.
+
+@parameters
+    * dungeons
+        * Dungeon configurations to search.
+    * nDungeons
+        * Number of `dungeons`.
+    * openType
+        * Open list type of each search context.
+*/
+static void benchFindContextPathBuffer(dungeon_t      **dungeons,
+                                       int              nDungeons,
+                                       openListType_t   openType)
+{
+    int i;
+    char name[64];
+    bufferSearcher_t *searchers;
+    void **searcherPointers;
+
+    searchers = malloc(sizeof(bufferSearcher_t) * nDungeons);
+    assert(searchers != NULL);
+    searcherPointers = malloc(sizeof(void*) * nDungeons);
+    assert(searcherPointers != NULL);
+    for (i = 0; i < nDungeons; i += 1)
+    {
+        searchers[i].context = initAStarContext(dungeons[i], openType);
+        searchers[i].capacity = getDungeonSize(dungeons[i]);
+        searchers[i].path = malloc(sizeof(point_t)
+                                   * (size_t)searchers[i].capacity);
+        assert(searchers[i].path != NULL);
+        searcherPointers[i] = &searchers[i];
+    }
+
+    snprintf(name, sizeof(name), "findContextPathBuffer/%s",
+             getOpenListTypeName(openType));
+    benchSearch(name,
+                dungeons,
+                searcherPointers,
+                nDungeons,
+                findContextPathBufferAdapter,
+                getBufferExpansionsAdapter);
+
+    for (i = 0; i < nDungeons; i += 1)
+    {
+        freeAStarContext(searchers[i].context);
+        free(searchers[i].path);
+    }
+    free(searchers);
+    free(searcherPointers);
+}
+
+
+/*
+@context
+    * Times `findContextPathBuffer` with landmark distance tables (ALT) on
+      every dungeon.
+    * Tables are built before timing as they are reused in practice.
+    * Prints a `landmarks` line after the benchmark with the bytes of a table
+      for each landmark, the time to build the tables of a dungeon and the
+      expansions of each query with Octile distance alone and with the
+      landmarks.
+
+@parameters
+    * dungeons
+        * Dungeon configurations to search.
+    * nDungeons
+        * Number of `dungeons`.
+    * nLandmarks
+        * Landmarks of each dungeon.
+*/
+static void benchFindLandmarkPath(dungeon_t **dungeons,
+                                  int         nDungeons,
+                                  uint32_t    nLandmarks)
+{
+    int i;
+    char name[64];
+    long long start, buildElapsed, nOctile, nLandmarked;
+    bufferSearcher_t *searchers;
+    void **searcherPointers;
+    landmarks_t **landmarks;
+    aStarContext_t *octile;
+    point_t source, target;
+
+    searchers = malloc(sizeof(bufferSearcher_t) * nDungeons);
+    assert(searchers != NULL);
+    searcherPointers = malloc(sizeof(void*) * nDungeons);
+    assert(searcherPointers != NULL);
+    landmarks = malloc(sizeof(landmarks_t*) * nDungeons);
+    assert(landmarks != NULL);
+
+    buildElapsed = 0;
+    nOctile = 0;
+    nLandmarked = 0;
+    for (i = 0; i < nDungeons; i += 1)
+    {
+        start = timeNs();
+        landmarks[i] = initLandmarks(dungeons[i], nLandmarks);
+        buildElapsed += timeNs() - start;
+
+        searchers[i].context = initAStarContext(dungeons[i],
+                                                OPEN_LIST_DEFAULT);
+        setAStarLandmarks(searchers[i].context, landmarks[i]);
+        searchers[i].capacity = getDungeonSize(dungeons[i]);
+        searchers[i].path = malloc(sizeof(point_t)
+                                   * (size_t)searchers[i].capacity);
+        assert(searchers[i].path != NULL);
+        searcherPointers[i] = &searchers[i];
+
+        // expansions of the same query without the landmarks
+        source = getDungeonSource(dungeons[i]);
+        target = getDungeonTarget(dungeons[i]);
+        octile = initAStarContext(dungeons[i], OPEN_LIST_DEFAULT);
+        findContextPathBuffer(octile, source, target, NULL, 0);
+        nOctile += getAStarExpansions(octile);
+        freeAStarContext(octile);
+
+        findContextPathBuffer(searchers[i].context, source, target, NULL, 0);
+        nLandmarked += getAStarExpansions(searchers[i].context);
+    }
+
+    snprintf(name, sizeof(name), "findContextPathBuffer/alt%u", nLandmarks);
+    benchSearch(name,
+                dungeons,
+                searcherPointers,
+                nDungeons,
+                findContextPathBufferAdapter,
+                getBufferExpansionsAdapter);
+
+    printf("landmarks bench=%s count=%u bytes_per_landmark=%llu"
+           " build_ns_per_dungeon=%.0f expanded_octile=%.1f"
+           " expanded_alt=%.1f expanded_reduction=%.3f\n",
+           name,
+           nLandmarks,
+           (unsigned long long)getLandmarkBytes(landmarks[0]) / nLandmarks,
+           (double)buildElapsed / nDungeons,
+           (double)nOctile / nDungeons,
+           (double)nLandmarked / nDungeons,
+           nOctile > 0 ? 1 - (double)nLandmarked / nOctile : 0);
+
+    for (i = 0; i < nDungeons; i += 1)
+    {
+        freeAStarContext(searchers[i].context);
+        free(searchers[i].path);
+        freeLandmarks(landmarks[i]);
+    }
+    free(searchers);
+    free(searcherPointers);
+    free(landmarks);
+}
+
+
+/*
+@context
+    * Times `stepContextPath` interleaving the queries of every dungeon.
+    * Every query is started then each unfinished query is stepped in turn
+      for `sliceSize` expansions until all have finished.
+        * Repeated `N_REPEATS` times.
+    * Each slice is an operation - `p99_ns` is the worst time a frame spends
+      on one query.
+    * Prints a `sliced` line after the benchmark with the number of slices
+      each query took.
+
+@parameters
+    * dungeons
+        * Dungeon configurations to search.
+    * nDungeons
+        * Number of `dungeons`.
+    * sliceSize
+        * Most points expanded by each slice.
+*/
+static void benchStepContextPath(dungeon_t **dungeons,
+                                 int         nDungeons,
+                                 uint32_t    sliceSize)
+{
+    int i, j, nSearching;
+    long nSlices, capacity, allocs, totalAllocs;
+    long long start, elapsed, nExpanded, *latencies;
+    char name[64];
+    aStarContext_t **contexts;
+    pathStatus_t status;
+
+    contexts = malloc(sizeof(aStarContext_t*) * nDungeons);
+    assert(contexts != NULL);
+    for (i = 0; i < nDungeons; i += 1)
+    {
+        contexts[i] = initAStarContext(dungeons[i], OPEN_LIST_DEFAULT);
+
+        // warm up each context so only searching is timed
+        findContextPathBuffer(contexts[i],
+                              getDungeonSource(dungeons[i]),
+                              getDungeonTarget(dungeons[i]),
+                              NULL,
+                              0);
+    }
+
+    capacity = (long)nDungeons * N_REPEATS;
+    latencies = malloc(sizeof(long long) * capacity);
+    assert(latencies != NULL);
+
+    nSlices = 0;
+    elapsed = 0;
+    nExpanded = 0;
+    totalAllocs = 0;
+    for (j = 0; j < N_REPEATS; j += 1)
+    {
+        allocs = atomic_load(&nAllocs);
+        start = timeNs();
+        for (i = 0; i < nDungeons; i += 1)
+        {
+            startContextPath(contexts[i],
+                             getDungeonSource(dungeons[i]),
+                             getDungeonTarget(dungeons[i]));
+        }
+        elapsed += timeNs() - start;
+        totalAllocs += atomic_load(&nAllocs) - allocs;
+
+        // each round steps every unfinished query once (one frame)
+        nSearching = nDungeons;
+        while (nSearching > 0)
+        {
+            nSearching = 0;
+            for (i = 0; i < nDungeons; i += 1)
+            {
+                if (getAStarPath(contexts[i], NULL, 0).status
+                    != PATH_SEARCHING)
+                {
+                    continue;
+                }
+
+                // grown outside of timing
+                if (nSlices == capacity)
+                {
+                    capacity *= 2;
+                    latencies = realloc(latencies,
+                                        sizeof(long long) * capacity);
+                    assert(latencies != NULL);
+                }
+
+                allocs = atomic_load(&nAllocs);
+                start = timeNs();
+                status = stepContextPath(contexts[i], sliceSize);
+                latencies[nSlices] = timeNs() - start;
+                totalAllocs += atomic_load(&nAllocs) - allocs;
+                elapsed += latencies[nSlices];
+                nSlices += 1;
+
+                if (status == PATH_SEARCHING)
+                {
+                    nSearching += 1;
+                }
+            }
+        }
+
+        for (i = 0; i < nDungeons; i += 1)
+        {
+            nExpanded += getAStarExpansions(contexts[i]);
+        }
+    }
+
+    snprintf(name, sizeof(name), "stepContextPath/slice%u", sliceSize);
+    report(name, nSlices, elapsed, latencies, nExpanded, totalAllocs);
+    printf("sliced bench=%s queries=%ld slices_per_query=%.2f\n",
+           name,
+           (long)nDungeons * N_REPEATS,
+           (double)nSlices / ((long)nDungeons * N_REPEATS));
+
+    for (i = 0; i < nDungeons; i += 1)
+    {
+        freeAStarContext(contexts[i]);
+    }
+    free(contexts);
+    free(latencies);
+}
+
+
+#ifdef SEARCH_STATS
+/*
+@context
+    * Prints the statistics of searching every dungeon once as one line of
+      `key=value` fields.
+    * Counts and times are averaged per search - peaks are the maximum of any
+      search.
+    * Only compiled when built with `SEARCH_STATS`.
+
+@parameters
+    * name
+        * Name of benchmark the statistics belong to.
+    * dungeons
+        * Dungeon configurations to search.
+    * contexts
+        * Search context of each dungeon.
+    * nDungeons
+        * Number of `dungeons`.
+*/
+static void reportStats(const char      *name,
+                        dungeon_t      **dungeons,
+                        aStarContext_t **contexts,
+                        int              nDungeons)
+{
+    int i;
+    searchStats_t stats, total;
+
+    resetSearchStats(&total);
+    for (i = 0; i < nDungeons; i += 1)
+    {
+        free(findContextPath(contexts[i],
+                             getDungeonSource(dungeons[i]),
+                             getDungeonTarget(dungeons[i])));
+        stats = getAStarStats(contexts[i]);
+
+        total.nExpanded += stats.nExpanded;
+        total.nPushed += stats.nPushed;
+        total.nDecreased += stats.nDecreased;
+        total.bytesAllocated += stats.bytesAllocated;
+        total.searchNs += stats.searchNs;
+        total.reconstructNs += stats.reconstructNs;
+        if (stats.peakOpenSize > total.peakOpenSize)
+        {
+            total.peakOpenSize = stats.peakOpenSize;
+        }
+        if (stats.peakSkipLevel > total.peakSkipLevel)
+        {
+            total.peakSkipLevel = stats.peakSkipLevel;
+        }
+    }
+
+    printf("stats=%s expanded=%.1f pushed=%.1f decreased=%.1f"
+           " peak_open=%llu peak_skip_level=%u bytes=%.1f"
+           " search_ns=%.1f reconstruct_ns=%.1f\n",
+           name,
+           (double)total.nExpanded / nDungeons,
+           (double)total.nPushed / nDungeons,
+           (double)total.nDecreased / nDungeons,
+           (unsigned long long)total.peakOpenSize,
+           total.peakSkipLevel,
+           (double)total.bytesAllocated / nDungeons,
+           (double)total.searchNs / nDungeons,
+           (double)total.reconstructNs / nDungeons);
+}
+#endif
+
+
+/*
+@context
+    * Times `findPath` and `findContextPathBuffer` on queries with no path.
+    * The 8 neighbours of each dungeon's target are walled with
+      `setDungeonPoint` then its source to target query is searched
+      `N_REPEATS` times by each before the neighbours are restored.
+        * Both reject the query by its connected component labels instead of
+          expanding every point reachable from the source.
+    * Placing and removing the walls is timed as `setDungeonPoint` - it
+      includes updating the labels (the wall closing off the target floods
+      the rest of its component with a new label).
+
+@parameters
+    * dungeons
+        * Dungeon configurations to search.
+    * nDungeons
+        * Number of `dungeons`.
+*/
+static void benchUnreachablePath(dungeon_t **dungeons,
+                                 int         nDungeons)
+{
+    int i, j, k, nOps, nEdits;
+    long allocs, pathAllocs, bufferAllocs, editAllocs;
+    long long start, pathElapsed, bufferElapsed, editElapsed;
+    long long *pathLatencies, *bufferLatencies, *editLatencies;
+    long long nExpanded;
+    char tiles[8];
+    pathResult_t result;
+    aStarContext_t *context;
+    point_t *path;
+    point_t source, target, point;
+
+    pathLatencies = malloc(sizeof(long long) * nDungeons * N_REPEATS);
+    assert(pathLatencies != NULL);
+    bufferLatencies = malloc(sizeof(long long) * nDungeons * N_REPEATS);
+    assert(bufferLatencies != NULL);
+    editLatencies = malloc(sizeof(long long) * nDungeons * 2 * N_MOVES);
+    assert(editLatencies != NULL);
+
+    nOps = 0;
+    nEdits = 0;
+    nExpanded = 0;
+    pathElapsed = 0;
+    bufferElapsed = 0;
+    editElapsed = 0;
+    pathAllocs = 0;
+    bufferAllocs = 0;
+    editAllocs = 0;
+    for (i = 0; i < nDungeons; i += 1)
+    {
+        source = getDungeonSource(dungeons[i]);
+        target = getDungeonTarget(dungeons[i]);
+        context = initAStarContext(dungeons[i], OPEN_LIST_DEFAULT);
+        path = malloc(sizeof(point_t) * (size_t)getDungeonSize(dungeons[i]));
+        assert(path != NULL);
+
+        // wall off `target` - generated targets are never on the border
+        for (k = 0; k < N_MOVES; k += 1)
+        {
+            point = addPoints(target, MOVES[k]);
+            tiles[k] = getDungeonPoint(dungeons[i], point);
+
+            allocs = atomic_load(&nAllocs);
+            start = timeNs();
+            setDungeonPoint(dungeons[i], point, TILE_WALL);
+            editLatencies[nEdits] = timeNs() - start;
+            editAllocs += atomic_load(&nAllocs) - allocs;
+            editElapsed += editLatencies[nEdits];
+            nEdits += 1;
+        }
+
+        for (j = 0; j < N_REPEATS; j += 1)
+        {
+            allocs = atomic_load(&nAllocs);
+            start = timeNs();
+            free(findPath(dungeons[i], source, target));
+            pathLatencies[nOps] = timeNs() - start;
+            pathAllocs += atomic_load(&nAllocs) - allocs;
+            pathElapsed += pathLatencies[nOps];
+
+            allocs = atomic_load(&nAllocs);
+            start = timeNs();
+            result = findContextPathBuffer(context,
+                                           source,
+                                           target,
+                                           path,
+                                           getDungeonSize(dungeons[i]));
+            bufferLatencies[nOps] = timeNs() - start;
+            bufferAllocs += atomic_load(&nAllocs) - allocs;
+            bufferElapsed += bufferLatencies[nOps];
+            nExpanded += getAStarExpansions(context);
+            nOps += 1;
+
+            assert(result.status == PATH_NOT_FOUND);
+        }
+
+        for (k = 0; k < N_MOVES; k += 1)
+        {
+            allocs = atomic_load(&nAllocs);
+            start = timeNs();
+            setDungeonPoint(dungeons[i],
+                            addPoints(target, MOVES[k]),
+                            tiles[k]);
+            editLatencies[nEdits] = timeNs() - start;
+            editAllocs += atomic_load(&nAllocs) - allocs;
+            editElapsed += editLatencies[nEdits];
+            nEdits += 1;
+        }
+
+        free(path);
+        freeAStarContext(context);
+    }
+
+    report("findPath/unreachable", nOps, pathElapsed, pathLatencies, -1,
+           pathAllocs);
+    report("findContextPathBuffer/unreachable", nOps, bufferElapsed,
+           bufferLatencies, nExpanded, bufferAllocs);
+    report("setDungeonPoint", nEdits, editElapsed, editLatencies, -1,
+           editAllocs);
+
+    free(pathLatencies);
+    free(bufferLatencies);
+    free(editLatencies);
+}
+
+
+/*
+@context
+    * Times `findJumpPath` (Jump Point Search context reused) on every dungeon.
+
+@parameters
+    * dungeons
+        * Dungeon configurations to search.
+    * nDungeons
+        * Number of `dungeons`.
+    * openType
+        * Open list type of each search context.
+*/
+static void benchFindJumpPath(dungeon_t      **dungeons,
+                              int              nDungeons,
+                              openListType_t   openType)
+{
+    int i;
+    char name[64];
+    jumpContext_t **contexts;
+
+    contexts = malloc(sizeof(jumpContext_t*) * nDungeons);
+    assert(contexts != NULL);
+    for (i = 0; i < nDungeons; i += 1)
+    {
+        contexts[i] = initJumpContext(dungeons[i], openType);
+    }
+
+    snprintf(name, sizeof(name), "findJumpPath/%s",
+             getOpenListTypeName(openType));
+    benchSearch(name,
+                dungeons,
+                (void**)contexts,
+                nDungeons,
+                findJumpPathAdapter,
+                NULL);
+
+    for (i = 0; i < nDungeons; i += 1)
+    {
+        freeJumpContext(contexts[i]);
+    }
+    free(contexts);
+}
+
+
+/*
+@context
+    * Times `findHpaPath` on every dungeon.
+    * Cluster graphs are built before timing as they are reused in practice.
+    * Prints a `suboptimality` line after the benchmark with the mean and max
+      cost over the shortest cost.
+
+@parameters
+    * dungeons
+        * Dungeon configurations to search.
+    * nDungeons
+        * Number of `dungeons`.
+*/
+static void benchFindHpaPath(dungeon_t **dungeons,
+                             int         nDungeons)
+{
+    int i, nCompared;
+    double ratio, ratioTotal, ratioMax;
+    hpaGraph_t **graphs;
+    aStarContext_t *exactContext;
+    point_t *path;
+    point_t source, target;
+    pathResult_t exact;
+
+    graphs = malloc(sizeof(hpaGraph_t*) * nDungeons);
+    assert(graphs != NULL);
+    for (i = 0; i < nDungeons; i += 1)
+    {
+        graphs[i] = initHpaGraph(dungeons[i], HPA_CLUSTER_SIZE);
+    }
+
+    benchSearch("findHpaPath",
+                dungeons,
+                (void**)graphs,
+                nDungeons,
+                findHpaPathAdapter,
+                NULL);
+
+    // only searches finding a path of non-zero cost are compared
+    nCompared = 0;
+    ratioTotal = 0;
+    ratioMax = 0;
+    for (i = 0; i < nDungeons; i += 1)
+    {
+        source = getDungeonSource(dungeons[i]);
+        target = getDungeonTarget(dungeons[i]);
+
+        exactContext = initAStarContext(dungeons[i], OPEN_LIST_DEFAULT);
+        exact = findContextPathBuffer(exactContext, source, target, NULL, 0);
+        freeAStarContext(exactContext);
+
+        path = findHpaPath(graphs[i], source, target);
+        if (path != NULL && exact.status != PATH_NOT_FOUND && exact.cost > 0)
+        {
+            ratio = (double)getPathCost(source, target, path) / exact.cost;
+            ratioTotal += ratio;
+            ratioMax = ratio > ratioMax ? ratio : ratioMax;
+            nCompared += 1;
+        }
+        free(path);
+    }
+
+    printf("suboptimality bench=findHpaPath mean_cost_ratio=%.4f"
+           " max_cost_ratio=%.4f\n",
+           nCompared > 0 ? ratioTotal / nCompared : 0,
+           ratioMax);
+
+    for (i = 0; i < nDungeons; i += 1)
+    {
+        freeHpaGraph(graphs[i]);
+    }
+    free(graphs);
+}
+
+
+/*
+@context
+    * Gets the cost of moving along `path` from `source`.
+
+@parameters
+    * source
+        * Location `path` starts from (not included in `path`).
+    * target
+        * Last point of `path`.
+    * path
+        * Path (sequence of points) from `source` to `target`.
+
+@return
+    * Sum of the cost of each move of `path`.
+*/
+static score_t getPathCost(point_t  source,
+                           point_t  target,
+                           point_t *path)
+{
+    cell_t i;
+    score_t cost;
+    point_t from;
+
+    cost = 0;
+    from = source;
+    for (i = 0; !isEqualPoints(from, target); i += 1)
+    {
+        cost += from.x != path[i].x && from.y != path[i].y
+              ? COST_DIAGONAL
+              : COST_CARDINAL;
+        from = path[i];
+    }
+
+    return cost;
+}
+
+
+/*
+@context
+    * Times `findBidirectionalPath` (search state reused) on every dungeon.
+
+@parameters
+    * dungeons
+        * Dungeon configurations to search.
+    * nDungeons
+        * Number of `dungeons`.
+    * openType
+        * Open list type of both directions of each search context.
+*/
+static void benchFindBidirectionalPath(dungeon_t      **dungeons,
+                                       int              nDungeons,
+                                       openListType_t   openType)
+{
+    int i;
+    char name[64];
+    bidirectionalContext_t **contexts;
+
+    contexts = malloc(sizeof(bidirectionalContext_t*) * nDungeons);
+    assert(contexts != NULL);
+    for (i = 0; i < nDungeons; i += 1)
+    {
+        contexts[i] = initBidirectionalContext(dungeons[i], openType);
+    }
+
+    snprintf(name, sizeof(name), "findBidirectionalPath/%s",
+             getOpenListTypeName(openType));
+    benchSearch(name,
+                dungeons,
+                (void**)contexts,
+                nDungeons,
+                findBidirectionalPathAdapter,
+                getBidirectionalExpansionsAdapter);
+
+    for (i = 0; i < nDungeons; i += 1)
+    {
+        freeBidirectionalContext(contexts[i]);
+    }
+    free(contexts);
+}
+
+
+/*
+@context
+    * Times `findWeightedPath` (or `findAnytimePath` when `isAnytime`) with
+      `weight` on every dungeon.
+    * The anytime search has no time budget so it runs until its path is a
+      shortest path - its expansions are reported per iteration.
+    * A shortest path of each dungeon is found before timing to compare the
+      cost of each path found with.
+    * Prints a `suboptimality` line after the benchmark with the mean bound
+      reported, the mean and max cost over the shortest cost and the mean
+      expansions of each iteration (over the searches reaching it).
+
+@parameters
+    * dungeons
+        * Dungeon configurations to search.
+    * nDungeons
+        * Number of `dungeons`.
+    * weight
+        * Inflation of the heuristic (the initial one when `isAnytime`).
+    * isAnytime
+        * Indicates `findAnytimePath` is timed instead of `findWeightedPath`.
+*/
+static void benchFindBoundedPath(dungeon_t **dungeons,
+                                 int         nDungeons,
+                                 double      weight,
+                                 bool        isAnytime)
+{
+    int i, j, nOps;
+    uint32_t k, nIterations;
+    long allocs, totalAllocs;
+    long long start, elapsed, nExpanded;
+    long long *latencies;
+    long long iterationExpanded[ITERATIONS_REPORTED];
+    long iterationCounts[ITERATIONS_REPORTED];
+    double ratio, ratioTotal, ratioMax, boundTotal;
+    char name[64];
+    araContext_t *context;
+    aStarContext_t *exactContext;
+    point_t *path;
+    point_t source, target;
+    pathResult_t exact, result;
+
+    latencies = malloc(sizeof(long long) * nDungeons * N_REPEATS);
+    assert(latencies != NULL);
+
+    for (k = 0; k < ITERATIONS_REPORTED; k += 1)
+    {
+        iterationExpanded[k] = 0;
+        iterationCounts[k] = 0;
+    }
+
+    nOps = 0;
+    elapsed = 0;
+    nExpanded = 0;
+    totalAllocs = 0;
+    nIterations = 0;
+    ratioTotal = 0;
+    ratioMax = 0;
+    boundTotal = 0;
+    for (i = 0; i < nDungeons; i += 1)
+    {
+        source = getDungeonSource(dungeons[i]);
+        target = getDungeonTarget(dungeons[i]);
+
+        exactContext = initAStarContext(dungeons[i], OPEN_LIST_DEFAULT);
+        exact = findContextPathBuffer(exactContext, source, target, NULL, 0);
+        freeAStarContext(exactContext);
+
+        context = initAraContext(dungeons[i], OPEN_LIST_BINARY_HEAP);
+        path = malloc(sizeof(point_t) * (size_t)getDungeonSize(dungeons[i]));
+        assert(path != NULL);
+
+        // warm up the context so only searching is timed
+        findWeightedPath(context, source, target, weight, NULL, 0);
+
+        for (j = 0; j < N_REPEATS; j += 1)
+        {
+            allocs = atomic_load(&nAllocs);
+            start = timeNs();
+            result = isAnytime
+                   ? findAnytimePath(context, source, target, weight,
+                                     UINT64_MAX, path,
+                                     getDungeonSize(dungeons[i]))
+                   : findWeightedPath(context, source, target, weight, path,
+                                      getDungeonSize(dungeons[i]));
+            latencies[nOps] = timeNs() - start;
+            totalAllocs += atomic_load(&nAllocs) - allocs;
+            elapsed += latencies[nOps];
+            nExpanded += getAraExpansions(context);
+            nOps += 1;
+
+            if (result.status != PATH_FOUND || exact.cost == 0)
+            {
+                continue;
+            }
+
+            ratio = (double)result.cost / exact.cost;
+            ratioTotal += ratio;
+            ratioMax = ratio > ratioMax ? ratio : ratioMax;
+            boundTotal += getAraBound(context);
+
+            nIterations += getAraIterations(context);
+            for (k = 0;
+                 k < getAraIterations(context) && k < ITERATIONS_REPORTED;
+                 k += 1)
+            {
+                iterationExpanded[k] += getAraIteration(context, k).nExpanded;
+                iterationCounts[k] += 1;
+            }
+        }
+
+        free(path);
+        freeAraContext(context);
+    }
+
+    snprintf(name, sizeof(name), "%s/w%.1f",
+             isAnytime ? "findAnytimePath" : "findWeightedPath", weight);
+    report(name, nOps, elapsed, latencies, nExpanded, totalAllocs);
+
+    // only searches finding a path of non-zero cost are compared
+    printf("suboptimality bench=%s mean_bound=%.4f mean_cost_ratio=%.4f"
+           " max_cost_ratio=%.4f iterations_per_op=%.2f"
+           " expanded_per_iteration=",
+           name,
+           iterationCounts[0] > 0 ? boundTotal / iterationCounts[0] : 0,
+           iterationCounts[0] > 0 ? ratioTotal / iterationCounts[0] : 0,
+           ratioMax,
+           iterationCounts[0] > 0
+           ? (double)nIterations / iterationCounts[0]
+           : 0);
+    for (k = 0; k < ITERATIONS_REPORTED && iterationCounts[k] > 0; k += 1)
+    {
+        printf("%s%.1f",
+               k > 0 ? "," : "",
+               (double)iterationExpanded[k] / iterationCounts[k]);
+    }
+    printf("\n");
+
+    free(latencies);
+}
+
+
+/*
+@context
+    * Times `findPoolPaths` with `nThreads` threads on every dungeon.
+    * Each dungeon's source to target query is repeated `N_REPEATS` times and
+      solved as a single batch.
+    * Pools are set up before timing as their threads are reused in practice.
+
+@parameters
+    * dungeons
+        * Dungeon configurations to search.
+    * nDungeons
+        * Number of `dungeons`.
+    * nThreads
+        * Number of threads in each pool.
+*/
+static void benchFindPoolPaths(dungeon_t **dungeons,
+                               int         nDungeons,
+                               uint8_t     nThreads)
+{
+    int i, j;
+    long allocs;
+    long long start, elapsed;
+    char name[64];
+    pathQuery_t *queries;
+    point_t **paths;
+    pathPool_t *pool;
+
+    queries = malloc(sizeof(pathQuery_t) * N_REPEATS);
+    assert(queries != NULL);
+    paths = malloc(sizeof(point_t*) * N_REPEATS);
+    assert(paths != NULL);
+
+    elapsed = 0;
+    allocs = 0;
+    for (i = 0; i < nDungeons; i += 1)
+    {
+        for (j = 0; j < N_REPEATS; j += 1)
+        {
+            queries[j].source = getDungeonSource(dungeons[i]);
+            queries[j].target = getDungeonTarget(dungeons[i]);
+        }
+
+        pool = initPathPool(dungeons[i], nThreads, OPEN_LIST_DEFAULT);
+
+        allocs -= atomic_load(&nAllocs);
+        start = timeNs();
+        findPoolPaths(pool, queries, N_REPEATS, paths);
+        for (j = 0; j < N_REPEATS; j += 1)
+        {
+            free(paths[j]);
+        }
+        elapsed += timeNs() - start;
+        allocs += atomic_load(&nAllocs);
+
+        freePathPool(pool);
+    }
+
+    snprintf(name, sizeof(name), "findPoolPaths/%uthreads", nThreads);
+    report(name, (long)nDungeons * N_REPEATS, elapsed, NULL, -1, allocs);
+
+    free(queries);
+    free(paths);
+}
+
+
+/*
+@context
+    * Times replanning with `findLpaPath` after walls are placed on the path of
+      every dungeon, against `findPath` searching the same edited dungeon.
+    * Each dungeon is edited `N_REPEATS` times at points spread along its
+      original path.
+        * Placing the walls and searching are timed together for both - the
+          walls are placed through `setLpaPoint` for `findLpaPath` and
+          `setDungeonPoint` for `findPath`.
+        * Each edit is undone (not timed) before the next.
+    * Planners are set up and their first path found before timing.
+    * Prints a `replan` line after the benchmarks with the fraction of edits
+      `findLpaPath` was faster for and its mean expansions over those of a
+      search from scratch - it only wins when few points need repairing.
+
+@parameters
+    * dungeons
+        * Dungeon configurations to edit and search.
+    * nDungeons
+        * Number of `dungeons`.
+    * radius
+        * Walls fill the square within `radius` of each point edited.
+*/
+static void benchReplan(dungeon_t **dungeons,
+                        int         nDungeons,
+                        int         radius)
+{
+    int i, j, nEdits, nFaster;
+    long lpaAllocs, fullAllocs, allocs;
+    long long start, lpaElapsed, fullElapsed, nExpanded, nFullExpanded;
+    long long *lpaLatencies, *fullLatencies;
+    char name[64];
+    char *tiles;
+    cell_t length;
+    lpaPlanner_t *planner;
+    aStarContext_t *context;
+    point_t *path, *original;
+    point_t source, target, centre;
+
+    lpaLatencies = malloc(sizeof(long long) * nDungeons * N_REPEATS);
+    assert(lpaLatencies != NULL);
+    fullLatencies = malloc(sizeof(long long) * nDungeons * N_REPEATS);
+    assert(fullLatencies != NULL);
+    tiles = malloc(sizeof(char) * (2 * radius + 1) * (2 * radius + 1));
+    assert(tiles != NULL);
+
+    nEdits = 0;
+    nFaster = 0;
+    lpaElapsed = 0;
+    fullElapsed = 0;
+    nExpanded = 0;
+    nFullExpanded = 0;
+    lpaAllocs = 0;
+    fullAllocs = 0;
+    for (i = 0; i < nDungeons; i += 1)
+    {
+        source = getDungeonSource(dungeons[i]);
+        target = getDungeonTarget(dungeons[i]);
+        planner = initLpaPlanner(dungeons[i], source, target);
+        original = findLpaPath(planner);
+        context = initAStarContext(dungeons[i], OPEN_LIST_DEFAULT);
+
+        length = 0;
+        while (original != NULL && !isEqualPoints(original[length], target))
+        {
+            length += 1;
+        }
+
+        // only points before `target` are edited
+        for (j = 0; j < N_REPEATS && length > 0; j += 1)
+        {
+            centre = original[(j + 1) * length / (N_REPEATS + 1)];
+
+            allocs = atomic_load(&nAllocs);
+            start = timeNs();
+            setBlock(planner, dungeons[i], centre, radius, tiles, false);
+            path = findLpaPath(planner);
+            lpaLatencies[nEdits] = timeNs() - start;
+            lpaAllocs += atomic_load(&nAllocs) - allocs;
+            lpaElapsed += lpaLatencies[nEdits];
+            nExpanded += getLpaExpansions(planner);
+            free(path);
+
+            setBlock(planner, dungeons[i], centre, radius, tiles, true);
+            free(findLpaPath(planner));
+
+            // the planner sees no change as the tiles are restored after
+            allocs = atomic_load(&nAllocs);
+            start = timeNs();
+            setBlock(NULL, dungeons[i], centre, radius, tiles, false);
+            path = findPath(dungeons[i], source, target);
+            fullLatencies[nEdits] = timeNs() - start;
+            fullAllocs += atomic_load(&nAllocs) - allocs;
+            fullElapsed += fullLatencies[nEdits];
+            free(path);
+
+            findContextPathBuffer(context, source, target, NULL, 0);
+            nFullExpanded += getAStarExpansions(context);
+            setBlock(NULL, dungeons[i], centre, radius, tiles, true);
+
+            nFaster += lpaLatencies[nEdits] < fullLatencies[nEdits];
+            nEdits += 1;
+        }
+
+        free(original);
+        freeLpaPlanner(planner);
+        freeAStarContext(context);
+    }
+
+    snprintf(name, sizeof(name), "findLpaPath/%s",
+             radius == 0 ? "tile" : "region");
+    report(name, nEdits, lpaElapsed, lpaLatencies, nExpanded, lpaAllocs);
+    snprintf(name, sizeof(name), "findPath/%s",
+             radius == 0 ? "tile" : "region");
+    report(name, nEdits, fullElapsed, fullLatencies, -1, fullAllocs);
+
+    printf("replan bench=findLpaPath/%s lpa_faster_fraction=%.2f"
+           " expanded_over_fresh=%.2f\n",
+           radius == 0 ? "tile" : "region",
+           nEdits > 0 ? (double)nFaster / nEdits : 0,
+           nFullExpanded > 0 ? (double)nExpanded / nFullExpanded : 0);
+
+    free(lpaLatencies);
+    free(fullLatencies);
+    free(tiles);
+}
+
+
+/*
+@context
+    * Fills the square within `radius` of `centre` with walls or restores the
+      tiles it held.
+    * The source and target of `dungeon` and points outside it are skipped.
+
+@parameters
+    * planner
+        * Planner of `dungeon` to set tiles through.
+        * `NULL` to set tiles with `setDungeonPoint` instead.
+    * dungeon
+        * Dungeon to edit.
+    * centre
+        * Location at the centre of the square.
+    * radius
+        * Distance from `centre` to the edges of the square.
+    * tiles
+        * Tiles held by the square before it was filled - one per point.
+    * isRestoring
+        * Indication to restore `tiles` instead of filling with walls.
+
+@return
+    * Number of tiles set.
+*/
+static int setBlock(lpaPlanner_t *planner,
+                    dungeon_t    *dungeon,
+                    point_t       centre,
+                    int           radius,
+                    char         *tiles,
+                    bool          isRestoring)
+{
+    int x, y, i, nSet;
+    point_t point;
+
+    nSet = 0;
+    for (y = -radius; y <= radius; y += 1)
+    {
+        for (x = -radius; x <= radius; x += 1)
+        {
+            point = initPoint(centre.x + x, centre.y + y);
+            i = (y + radius) * (2 * radius + 1) + x + radius;
+            if (point.x < 0 || (uint32_t)point.x >= getDungeonWidth(dungeon)
+                || point.y < 0
+                || (uint32_t)point.y >= getDungeonHeight(dungeon)
+                || isEqualPoints(point, getDungeonSource(dungeon))
+                || isEqualPoints(point, getDungeonTarget(dungeon)))
+            {
+                continue;
+            }
+
+            if (!isRestoring)
+            {
+                tiles[i] = getDungeonPoint(dungeon, point);
+            }
+            if (planner != NULL)
+            {
+                setLpaPoint(planner,
+                            point,
+                            isRestoring ? tiles[i] : TILE_WALL);
+            }
+            else
+            {
+                setDungeonPoint(dungeon,
+                                point,
+                                isRestoring ? tiles[i] : TILE_WALL);
+            }
+            nSet += 1;
+        }
+    }
+
+    return nSet;
+}
+
+
+/*
+@context
+    * Times building a flow field to the target of each dungeon then following
+      it from `N_REPEATS` points spread over the dungeon.
+    * Walls are placed on the path of the field one at a time and updating
+      the field is compared with rebuilding it from scratch.
+        * Each wall is removed again untimed.
+
+@parameters
+    * dungeons
+        * Dungeons to build fields of.
+    * nDungeons
+        * Number of dungeons.
+*/
+static void benchFlowField(dungeon_t **dungeons,
+                           int         nDungeons)
+{
+    int i, j, nFollows, nEdits;
+    long initAllocs, followAllocs, editAllocs, rebuildAllocs, allocs;
+    long long start, initElapsed, followElapsed, editElapsed, rebuildElapsed;
+    long long *initLatencies, *followLatencies, *editLatencies;
+    long long *rebuildLatencies;
+    char tile;
+    cell_t length;
+    flowField_t *field;
+    point_t *path, *original;
+    point_t source, target, point;
+
+    initLatencies = malloc(sizeof(long long) * nDungeons);
+    assert(initLatencies != NULL);
+    followLatencies = malloc(sizeof(long long) * nDungeons * N_REPEATS);
+    assert(followLatencies != NULL);
+    editLatencies = malloc(sizeof(long long) * nDungeons * N_REPEATS);
+    assert(editLatencies != NULL);
+    rebuildLatencies = malloc(sizeof(long long) * nDungeons * N_REPEATS);
+    assert(rebuildLatencies != NULL);
+
+    nFollows = 0;
+    nEdits = 0;
+    initElapsed = 0;
+    followElapsed = 0;
+    editElapsed = 0;
+    rebuildElapsed = 0;
+    initAllocs = 0;
+    followAllocs = 0;
+    editAllocs = 0;
+    rebuildAllocs = 0;
+    for (i = 0; i < nDungeons; i += 1)
+    {
+        source = getDungeonSource(dungeons[i]);
+        target = getDungeonTarget(dungeons[i]);
+
+        allocs = atomic_load(&nAllocs);
+        start = timeNs();
+        field = initFlowField(dungeons[i], target);
+        initLatencies[i] = timeNs() - start;
+        initAllocs += atomic_load(&nAllocs) - allocs;
+        initElapsed += initLatencies[i];
+
+        // agents start from walkable points spread evenly over the dungeon
+        for (j = 0; j < N_REPEATS; j += 1)
+        {
+            point = getDungeonIndexPoint(dungeons[i],
+                                         j * getDungeonSize(dungeons[i])
+                                         / N_REPEATS);
+            if (!isDungeonWalkable(dungeons[i], point))
+            {
+                continue;
+            }
+
+            allocs = atomic_load(&nAllocs);
+            start = timeNs();
+            path = findFlowPath(field, point);
+            followLatencies[nFollows] = timeNs() - start;
+            followAllocs += atomic_load(&nAllocs) - allocs;
+            followElapsed += followLatencies[nFollows];
+            free(path);
+            nFollows += 1;
+        }
+
+        original = findFlowPath(field, source);
+        length = 0;
+        while (original != NULL && !isEqualPoints(original[length], target))
+        {
+            length += 1;
+        }
+
+        // only points before `target` are edited
+        for (j = 0; j < N_REPEATS && length > 0; j += 1)
+        {
+            point = original[(j + 1) * length / (N_REPEATS + 1)];
+            tile = getDungeonPoint(dungeons[i], point);
+
+            allocs = atomic_load(&nAllocs);
+            start = timeNs();
+            setFlowPoint(field, point, TILE_WALL);
+            editLatencies[nEdits] = timeNs() - start;
+            editAllocs += atomic_load(&nAllocs) - allocs;
+            editElapsed += editLatencies[nEdits];
+
+            allocs = atomic_load(&nAllocs);
+            start = timeNs();
+            rebuildFlowField(field);
+            rebuildLatencies[nEdits] = timeNs() - start;
+            rebuildAllocs += atomic_load(&nAllocs) - allocs;
+            rebuildElapsed += rebuildLatencies[nEdits];
+
+            setFlowPoint(field, point, tile);
+            nEdits += 1;
+        }
+
+        free(original);
+        freeFlowField(field);
+    }
+
+    report("initFlowField", nDungeons, initElapsed, initLatencies, -1,
+           initAllocs);
+    report("findFlowPath", nFollows, followElapsed, followLatencies, -1,
+           followAllocs);
+    report("setFlowPoint/tile", nEdits, editElapsed, editLatencies, -1,
+           editAllocs);
+    report("rebuildFlowField", nEdits, rebuildElapsed, rebuildLatencies, -1,
+           rebuildAllocs);
+
+    free(initLatencies);
+    free(followLatencies);
+    free(editLatencies);
+    free(rebuildLatencies);
+}
+
+
+/*
+@context
+    * Times `findCachedPath` and `setCachedPoint` on every dungeon.
+    * Each dungeon has `N_CACHE_QUERIES` queries between walkable points
+      spread over it (the first is its source and target).
+    * Every query is looked up `N_REPEATS` times - after each round a wall is
+      placed on a walkable point and removed again through `setCachedPoint`
+      so only the paths the edits can affect are searched again.
+    * Prints a `cache` line after the benchmarks with the hit rate and the
+      bytes cached at the end.
+
+@parameters
+    * dungeons
+        * Dungeon configurations to search.
+    * nDungeons
+        * Number of `dungeons`.
+*/
+static void benchPathCache(dungeon_t **dungeons,
+                           int         nDungeons)
+{
+    int i, j, k, nHits, nMisses, nEdits;
+    uint64_t hits;
+    long allocs, hitAllocs, missAllocs, editAllocs;
+    long long start, latency, hitElapsed, missElapsed, editElapsed;
+    long long *hitLatencies, *missLatencies, *editLatencies;
+    uint64_t bytes;
+    char tile;
+    cell_t size;
+    pathCache_t *cache;
+    aStarContext_t *context;
+    point_t *path, *queries;
+    point_t point;
+
+    hitLatencies = malloc(sizeof(long long) * nDungeons * N_REPEATS
+                          * N_CACHE_QUERIES);
+    assert(hitLatencies != NULL);
+    missLatencies = malloc(sizeof(long long) * nDungeons * N_REPEATS
+                           * N_CACHE_QUERIES);
+    assert(missLatencies != NULL);
+    editLatencies = malloc(sizeof(long long) * nDungeons * N_REPEATS * 2);
+    assert(editLatencies != NULL);
+    queries = malloc(sizeof(point_t) * 2 * N_CACHE_QUERIES);
+    assert(queries != NULL);
+
+    nHits = 0;
+    nMisses = 0;
+    nEdits = 0;
+    hitElapsed = 0;
+    missElapsed = 0;
+    editElapsed = 0;
+    hitAllocs = 0;
+    missAllocs = 0;
+    editAllocs = 0;
+    bytes = 0;
+    for (i = 0; i < nDungeons; i += 1)
+    {
+        size = getDungeonSize(dungeons[i]);
+        cache = initPathCache(dungeons[i], CACHE_BYTES);
+        context = initAStarContext(dungeons[i], OPEN_LIST_DEFAULT);
+        path = malloc(sizeof(point_t) * (size_t)size);
+        assert(path != NULL);
+
+        queries[0] = getDungeonSource(dungeons[i]);
+        queries[1] = getDungeonTarget(dungeons[i]);
+        for (k = 1; k < N_CACHE_QUERIES; k += 1)
+        {
+            queries[2 * k] = findWalkablePoint(dungeons[i],
+                                               k * size / N_CACHE_QUERIES);
+            queries[2 * k + 1] = findWalkablePoint(dungeons[i],
+                                                   (k * size
+                                                    / N_CACHE_QUERIES
+                                                    + size / 2) % size);
+        }
+
+        // warm up the context so a miss only times searching
+        findContextPathBuffer(context, queries[0], queries[1], NULL, 0);
+
+        for (j = 0; j < N_REPEATS; j += 1)
+        {
+            for (k = 0; k < N_CACHE_QUERIES; k += 1)
+            {
+                hits = getPathCacheHits(cache);
+
+                allocs = atomic_load(&nAllocs);
+                start = timeNs();
+                findCachedPath(cache,
+                               context,
+                               queries[2 * k],
+                               queries[2 * k + 1],
+                               path,
+                               size);
+                latency = timeNs() - start;
+                allocs = atomic_load(&nAllocs) - allocs;
+
+                if (getPathCacheHits(cache) > hits)
+                {
+                    hitLatencies[nHits] = latency;
+                    hitElapsed += latency;
+                    hitAllocs += allocs;
+                    nHits += 1;
+                }
+                else
+                {
+                    missLatencies[nMisses] = latency;
+                    missElapsed += latency;
+                    missAllocs += allocs;
+                    nMisses += 1;
+                }
+            }
+
+            // a wall placed then removed evicts the paths near it
+            point = findWalkablePoint(dungeons[i], j * size / N_REPEATS);
+            tile = getDungeonPoint(dungeons[i], point);
+            for (k = 0; k < 2; k += 1)
+            {
+                allocs = atomic_load(&nAllocs);
+                start = timeNs();
+                setCachedPoint(cache, point, k == 0 ? TILE_WALL : tile);
+                editLatencies[nEdits] = timeNs() - start;
+                editAllocs += atomic_load(&nAllocs) - allocs;
+                editElapsed += editLatencies[nEdits];
+                nEdits += 1;
+            }
+        }
+
+        bytes += getPathCacheBytes(cache);
+
+        free(path);
+        freeAStarContext(context);
+        freePathCache(cache);
+    }
+
+    report("findCachedPath/hit", nHits, hitElapsed, hitLatencies, -1,
+           hitAllocs);
+    report("findCachedPath/miss", nMisses, missElapsed, missLatencies, -1,
+           missAllocs);
+    report("setCachedPoint", nEdits, editElapsed, editLatencies, -1,
+           editAllocs);
+    printf("cache queries=%d hit_rate=%.3f bytes_per_cache=%.0f"
+           " max_bytes=%llu\n",
+           nHits + nMisses,
+           (double)nHits / (nHits + nMisses),
+           (double)bytes / nDungeons,
+           (unsigned long long)CACHE_BYTES);
+
+    free(hitLatencies);
+    free(missLatencies);
+    free(editLatencies);
+    free(queries);
+}
+
+
+/*
+@context
+    * Finds the first walkable point of `dungeon` at or after cell `index`
+      (wrapping around).
+    * Assumes `dungeon` has a walkable point.
+
+@parameters
+    * dungeon
+        * Dungeon to search.
+    * index
+        * Cell index to start from.
+
+@return
+    * Walkable point.
+*/
+static point_t findWalkablePoint(dungeon_t *dungeon,
+                                 cell_t     index)
+{
+    point_t point;
+
+    // cells padding the layout to whole tiles are outside the dungeon
+    point = getDungeonIndexPoint(dungeon, index);
+    while (!isDungeonWalkable(dungeon, point))
+    {
+        index = (index + 1) % getDungeonSize(dungeon);
+        point = getDungeonIndexPoint(dungeon, index);
+    }
+
+    return point;
+}
+
+
+/*
+@context
+    * Runs every query of a MovingAI scenario with `findContextPathBuffer`
+      and checks each cost against the optimal length of the query.
+    * Latency and expansions are reported per bucket then over every query.
+    * Queries whose cost is not optimal are printed to `stderr`.
+
+@parameters
+    * scenarioPath
+        * Location of the `.scen` file.
+    * mapPath
+        * Location of the `.map` file.
+        * `NULL` to look for the map named by the scenario next to it.
+
+@return
+    * Indicates every query was run and found optimal.
+*/
+static int benchScenario(const char *scenarioPath,
+                         const char *mapPath)
+{
+    uint32_t i, j, bucket, nBucket, nMismatched;
+    long allocs, bucketAllocs, totalAllocs;
+    long long start, bucketElapsed, totalElapsed, bucketExpanded;
+    long long totalExpanded;
+    long long *latencies, *bucketLatencies;
+    char name[64];
+    char path[MAP_PATH_SIZE];
+    scenario_t *scenario;
+    scenarioQuery_t query;
+    dungeon_t *dungeon;
+    aStarContext_t *context;
+    point_t *buffer;
+    pathResult_t result;
+
+    scenario = loadMovingAiScenario(scenarioPath);
+    if (scenario == NULL)
+    {
+        fprintf(stderr, "cannot load scenario %s\n", scenarioPath);
+        return EXIT_FAILURE;
+    }
+
+    if (mapPath == NULL)
+    {
+        findMapPath(path, scenarioPath, getScenarioMapName(scenario));
+        mapPath = path;
+    }
+
+    dungeon = loadMovingAiMap(mapPath);
+    if (dungeon == NULL
+        || getDungeonWidth(dungeon) != getScenarioMapWidth(scenario)
+        || getDungeonHeight(dungeon) != getScenarioMapHeight(scenario))
+    {
+        fprintf(stderr, "cannot load map %s of scenario\n", mapPath);
+        if (dungeon != NULL)
+        {
+            freeDungeon(dungeon);
+        }
+        freeScenario(scenario);
+        return EXIT_FAILURE;
+    }
+
+    printf("config scenario=%s map=%s width=%u height=%u queries=%u"
+           " tile_side=%lld\n",
+           scenarioPath, mapPath, getDungeonWidth(dungeon),
+           getDungeonHeight(dungeon), getScenarioSize(scenario),
+           (long long)TILE_SIDE);
+
+    context = initAStarContext(dungeon, OPEN_LIST_DEFAULT);
+    buffer = malloc(sizeof(point_t) * getDungeonSize(dungeon));
+    assert(buffer != NULL);
+    latencies = malloc(sizeof(long long) * getScenarioSize(scenario));
+    assert(latencies != NULL);
+
+    // queries are run bucket by bucket so their latencies are contiguous
+    nMismatched = 0;
+    totalElapsed = 0;
+    totalExpanded = 0;
+    totalAllocs = 0;
+    bucketLatencies = latencies;
+    for (i = 0; i < getScenarioSize(scenario); i += nBucket)
+    {
+        bucket = getScenarioQuery(scenario, i).bucket;
+        nBucket = 0;
+        bucketElapsed = 0;
+        bucketExpanded = 0;
+        bucketAllocs = 0;
+        for (j = i;
+             j < getScenarioSize(scenario)
+             && getScenarioQuery(scenario, j).bucket == bucket;
+             j += 1)
+        {
+            query = getScenarioQuery(scenario, j);
+
+            allocs = atomic_load(&nAllocs);
+            start = timeNs();
+            result = findContextPathBuffer(context,
+                                           query.source,
+                                           query.target,
+                                           buffer,
+                                           getDungeonSize(dungeon));
+            bucketLatencies[nBucket] = timeNs() - start;
+            bucketAllocs += atomic_load(&nAllocs) - allocs;
+            bucketElapsed += bucketLatencies[nBucket];
+            bucketExpanded += getAStarExpansions(context);
+            nBucket += 1;
+
+            if (result.status != PATH_FOUND
+                || !isScenarioOptimal(result.cost, query.optimalLength))
+            {
+                fprintf(stderr, "mismatch query=%u cost=%.4f optimal=%.4f\n",
+                        j, (double)result.cost / COST_CARDINAL,
+                        query.optimalLength);
+                nMismatched += 1;
+            }
+        }
+
+        snprintf(name, sizeof(name), "scenario/%u", bucket);
+        report(name, nBucket, bucketElapsed, bucketLatencies, bucketExpanded,
+               bucketAllocs);
+
+        bucketLatencies += nBucket;
+        totalElapsed += bucketElapsed;
+        totalExpanded += bucketExpanded;
+        totalAllocs += bucketAllocs;
+    }
+
+    if (getScenarioSize(scenario) > 0)
+    {
+        report("scenario/all", getScenarioSize(scenario), totalElapsed,
+               latencies, totalExpanded, totalAllocs);
+    }
+    printf("scenario queries=%u mismatched=%u\n",
+           getScenarioSize(scenario), nMismatched);
+
+    free(latencies);
+    free(buffer);
+    freeAStarContext(context);
+    freeDungeon(dungeon);
+    freeScenario(scenario);
+
+    return nMismatched == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+/*
+@context
+    * Finds the map named by a scenario in the directory of the scenario.
+    * Only the last component of `mapName` is used as scenarios usually name
+      maps relative to a directory of maps.
+
+@parameters
+    * path
+        * Output of the map location - `MAP_PATH_SIZE` characters.
+    * scenarioPath
+        * Location of the `.scen` file.
+    * mapName
+        * Name of the map as written in the scenario.
+*/
+static void findMapPath(char       *path,
+                        const char *scenarioPath,
+                        const char *mapName)
+{
+    const char *slash;
+    int directoryLength;
+
+    slash = strrchr(mapName, '/');
+    mapName = slash == NULL ? mapName : slash + 1;
+
+    slash = strrchr(scenarioPath, '/');
+    directoryLength = slash == NULL ? 0 : slash + 1 - scenarioPath;
+
+    snprintf(path, MAP_PATH_SIZE, "%.*s%s",
+             directoryLength, scenarioPath, mapName);
+}
+
+
+/*
+@context
+    * Times pushing and popping an open list of `openType` on its own.
+    * Each pop of minimum priority `f` is followed by pushes of priorities
+      within `[f, f + OPEN_SPREAD]`, like A* with a consistent heuristic.
+    * The same seed is used for every type so all see the same operations.
+
+@parameters
+    * seed
+        * Seed of the pushes made.
+    * openType
+        * Open list type to time.
+*/
+static void benchOpenList(int            seed,
+                          openListType_t openType)
+{
+    long i, allocs;
+    int j, nPushes;
+    uint32_t size;
+    score_t minPriority;
+    long long start;
+    char name[64];
+    openList_t *open;
+
+    open = initOpenList(openType, OPEN_SPREAD);
+    srand(seed);
+
+    allocs = atomic_load(&nAllocs);
+    start = timeNs();
+    initOpenNode(open, initPoint(0, 0), 0);
+    size = 1;
+    for (i = 0; i < N_OPEN_OPS; i += 1)
+    {
+        minPriority = getMinOpenPriority(open);
+        freeMinOpenNode(open);
+        size -= 1;
+
+        // keep the open list from growing without bound or running dry
+        nPushes = size >= OPEN_SIZE_MAX ? 0 : rand() % (PUSHES_MAX + 1);
+        if (size == 0 && nPushes == 0)
+        {
+            nPushes = 1;
+        }
+
+        for (j = 0; j < nPushes; j += 1)
+        {
+            initOpenNode(open,
+                         initPoint(j, 0),
+                         minPriority + rand() % (OPEN_SPREAD + 1));
+        }
+        size += nPushes;
+    }
+
+    snprintf(name, sizeof(name), "openList/%s", getOpenListTypeName(openType));
+    report(name,
+           N_OPEN_OPS,
+           timeNs() - start,
+           NULL,
+           -1,
+           atomic_load(&nAllocs) - allocs);
+
+    freeOpenList(open);
+}
+
+
+/*
+@context
+    * Times pushing into and popping from a `skipPQ` on its own.
+    * Each round pushes `N_SKIP_NODES` random priorities then pops them all.
+        * Pushes and pops are reported separately.
+        * Rounds after the first reuse recycled nodes.
+
+@parameters
+    * seed
+        * Seed of the priorities pushed.
+*/
+static void benchSkipPQ(int seed)
+{
+    int round;
+    long i, allocs;
+    long long start, pushElapsed, popElapsed;
+    skipPQ_t *pq;
+
+    pq = initSkipPQ();
+    srand(seed);
+
+    pushElapsed = 0;
+    popElapsed = 0;
+    allocs = atomic_load(&nAllocs);
+    for (round = 0; round < N_SKIP_ROUNDS; round += 1)
+    {
+        start = timeNs();
+        for (i = 0; i < N_SKIP_NODES; i += 1)
+        {
+            initSkipNode(pq, initPoint(i, 0), rand() % SKIP_PRIORITY_MAX);
+        }
+        pushElapsed += timeNs() - start;
+
+        start = timeNs();
+        while (!isSkipPQEmpty(pq))
+        {
+            freeMinSkipNode(pq);
+        }
+        popElapsed += timeNs() - start;
+    }
+    allocs = atomic_load(&nAllocs) - allocs;
+
+    // allocations are only made by pushes
+    report("skipPQ/push",
+           N_SKIP_NODES * N_SKIP_ROUNDS,
+           pushElapsed,
+           NULL,
+           -1,
+           allocs);
+    report("skipPQ/pop",
+           N_SKIP_NODES * N_SKIP_ROUNDS,
+           popElapsed,
+           NULL,
+           -1,
+           0);
+
+    freeSkipPQ(pq);
+}
+
+
+/*
+@context
+    * Times `isValidMove` from every tile of every dungeon in all 8 directions.
+
+@parameters
+    * dungeons
+        * Dungeon configurations to check moves in.
+    * nDungeons
+        * Number of `dungeons`.
+*/
+static void benchIsValidMove(dungeon_t **dungeons,
+                             int         nDungeons)
+{
+    int i, k;
+    long nOps;
+    uint32_t x, y;
+    long long start;
+    point_t from;
+
+    // counts valid moves so the calls cannot be optimised away
+    volatile long nValid;
+
+    nValid = 0;
+    nOps = 0;
+    start = timeNs();
+    for (i = 0; i < nDungeons; i += 1)
+    {
+        for (y = 0; y < getDungeonHeight(dungeons[i]); y += 1)
+        {
+            for (x = 0; x < getDungeonWidth(dungeons[i]); x += 1)
+            {
+                from = initPoint(x, y);
+                for (k = 0; k < N_MOVES; k += 1)
+                {
+                    nValid += isValidMove(dungeons[i],
+                                          from,
+                                          addPoints(from, MOVES[k]));
+                }
+                nOps += N_MOVES;
+            }
+        }
+    }
+
+    report("isValidMove", nOps, timeNs() - start, NULL, -1, 0);
+}
+
+
+/*
+@context
+    * Times `generateDungeon` regenerating a single dungeon `nDungeons` times.
+
+@parameters
+    * nDungeons
+        * Number of dungeon configurations to generate.
+    * width
+        * Width of dungeon map.
+    * height
+        * Height of dungeon map.
+*/
+static void benchGenerateDungeon(int      nDungeons,
+                                 uint32_t width,
+                                 uint32_t height)
+{
+    int i;
+    long allocs;
+    long long start, elapsed, *latencies;
+    dungeon_t *dungeon;
+
+    latencies = malloc(sizeof(long long) * nDungeons);
+    assert(latencies != NULL);
+    dungeon = initDungeon(width, height);
+
+    elapsed = 0;
+    allocs = atomic_load(&nAllocs);
+    for (i = 0; i < nDungeons; i += 1)
+    {
+        start = timeNs();
+        generateDungeon(dungeon);
+        latencies[i] = timeNs() - start;
+        elapsed += latencies[i];
+    }
+    allocs = atomic_load(&nAllocs) - allocs;
+
+    report("generateDungeon", nDungeons, elapsed, latencies, -1, allocs);
+
+    freeDungeon(dungeon);
+    free(latencies);
+}
+
+
+/*
+@context
+    * Orders 2 latencies in ascending order for `qsort`.
+
+@parameters
+    * a
+        * First latency.
+    * b
+        * Second latency.
+
+@return
+    * Negative, zero or positive as `a` is less, equal or greater than `b`.
+*/
+static int compareLatencies(const void *a,
+                            const void *b)
+{
+    long long x, y;
+
+    x = *(const long long*)a;
+    y = *(const long long*)b;
+    return (x > y) - (x < y);
+}
+
+
+/*
+@context
+    * Prints the results of a single benchmark as one line of `key=value`
+      fields.
+
+@parameters
+    * name
+        * Name of benchmark.
+    * nOps
+        * Number of operations (e.g. searches) performed in `elapsed`.
+    * elapsed
+        * Total time taken in nanoseconds.
+    * latencies
+        * Time of each operation in nanoseconds - `NULL` if not timed.
+        * Sorted in place.
+    * nExpanded
+        * Points expanded by all operations - `-1` if not counted.
+    * allocs
+        * Allocations made by all operations.
+*/
+static void report(const char *name,
+                   long        nOps,
+                   long long   elapsed,
+                   long long  *latencies,
+                   long long   nExpanded,
+                   long        allocs)
+{
+    printf("bench=%s ops=%ld total_ns=%lld ns_per_op=%.1f ops_per_s=%.0f",
+           name,
+           nOps,
+           elapsed,
+           (double)elapsed / nOps,
+           (double)nOps * NS_PER_S / elapsed);
+
+    if (latencies != NULL)
+    {
+        qsort(latencies, nOps, sizeof(long long), compareLatencies);
+        printf(" p50_ns=%lld p99_ns=%lld",
+               latencies[(nOps - 1) * 50 / 100],
+               latencies[(nOps - 1) * 99 / 100]);
+    }
+
+    if (nExpanded >= 0)
+    {
+        printf(" expanded_per_op=%.1f", (double)nExpanded / nOps);
+    }
+
+    printf(" allocs_per_op=%.2f\n", (double)allocs / nOps);
+}
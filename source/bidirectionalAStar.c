@@ -0,0 +1,502 @@
+#include "bidirectionalAStar.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "aStar.h"
+#include "dataStructs/searchGrid.h"
+
+
+typedef struct frontier_s frontier_t;
+
+
+// search state of one direction of the search
+struct frontier_s
+{
+    searchGrid_t *grid;
+    openList_t *open;
+
+    // point the heuristic of this direction estimates the distance to
+    point_t goal;
+
+    // forward moves out of points - backward moves into points
+    bool isForward;
+};
+
+struct bidirectionalContext_s
+{
+    dungeon_t *dungeon;
+
+    // cell indices between rows of tiles (see `getMoveIndex`)
+    int64_t rowStride;
+
+    frontier_t forward;
+    frontier_t backward;
+
+    // cheapest path found where both directions meet
+    score_t bestCost;
+    cell_t meetIndex;
+
+    // points expanded by both directions in the last search
+    cell_t nExpanded;
+};
+
+
+static void initFrontier(frontier_t     *frontier,
+                         dungeon_t      *dungeon,
+                         openListType_t  openType,
+                         bool            isForward);
+
+static void startFrontier(bidirectionalContext_t *context,
+                          frontier_t             *frontier,
+                          point_t                 start,
+                          point_t                 goal);
+
+static void expandFrontier(bidirectionalContext_t *context,
+                           frontier_t             *frontier,
+                           frontier_t             *other);
+static uint16_t cost(point_t move);
+
+static uint8_t getPredecessorMoves(dungeon_t *dungeon,
+                                   point_t    point);
+
+static point_t *reconstructPath(bidirectionalContext_t *context,
+                                cell_t                  sourceIndex,
+                                cell_t                  targetIndex);
+
+
+/* ------------------------------ START PUBLIC ------------------------------ */
+
+
+/*
+@context
+    * Initialises a search context to find bidirectional paths in `dungeon`.
+    * Holds the search state and open list of both directions.
+    * `dungeon` can be regenerated but must not be resized or freed while the
+      context is in use.
+
+@parameters
+    * dungeon
+        * Dungeon to find paths in.
+    * openType
+        * Priority queue used as the open list of both directions.
+
+@return
+    * Search context ready to find paths in `dungeon`.
+*/
+bidirectionalContext_t *initBidirectionalContext(dungeon_t      *dungeon,
+                                                 openListType_t  openType)
+{
+    bidirectionalContext_t *context;
+
+    context = malloc(sizeof(bidirectionalContext_t));
+    assert(context != NULL);
+
+    context->dungeon = dungeon;
+    context->rowStride = getDungeonRowStride(dungeon);
+    initFrontier(&context->forward, dungeon, openType, true);
+    initFrontier(&context->backward, dungeon, openType, false);
+    context->nExpanded = 0;
+
+    return context;
+}
+
+
+/*
+@context
+    * Frees `context`.
+    * The dungeon of `context` is not freed.
+
+@parameters
+    * context
+        * Search context to free.
+*/
+void freeBidirectionalContext(bidirectionalContext_t *context)
+{
+    freeSearchGrid(context->forward.grid);
+    freeOpenList(context->forward.open);
+    freeSearchGrid(context->backward.grid);
+    freeOpenList(context->backward.open);
+    free(context);
+}
+
+
+/*
+@context
+    * Finds shortest path from `source` and `target` in the dungeon of
+      `context` if possible.
+    * Searches forward from `source` and backward from `target`.
+        * The direction with the lower minimum f-score is expanded next.
+        * Every time a direction reaches a point the other has reached, the
+          path through that point is a candidate meeting.
+    * Stops once the minimum f-score of either direction is no lower than the
+      cheapest meeting.
+        * Both heuristics are consistent so every path still open in that
+          direction costs at least its minimum f-score.
+
+@parameters
+    * context
+        * Search context holding the dungeon to find path in.
+    * source
+        * Location to start from.
+    * target
+        * Location to find from `source`.
+
+@return
+    * Shortest path (sequence of points) from `source` to `target`.
+        * `source` is not included.
+        * `target` is included as the last point.
+    * `NULL` if no path is possible.
+*/
+point_t *findBidirectionalPath(bidirectionalContext_t *context,
+                               point_t                 source,
+                               point_t                 target)
+{
+    cell_t sourceIndex, targetIndex;
+    score_t forwardMin, backwardMin;
+
+    context->nExpanded = 0;
+
+    sourceIndex = getDungeonIndex(context->dungeon, source);
+    targetIndex = getDungeonIndex(context->dungeon, target);
+
+    startFrontier(context, &context->forward, source, target);
+    startFrontier(context, &context->backward, target, source);
+
+    // `source` and `target` already meet if they are the same point
+    context->bestCost = sourceIndex == targetIndex ? 0 : SCORE_MAX;
+    context->meetIndex = sourceIndex;
+
+    // an empty direction has explored every point it can reach
+    while (!isOpenListEmpty(context->forward.open)
+        && !isOpenListEmpty(context->backward.open))
+    {
+        forwardMin = getMinOpenPriority(context->forward.open);
+        backwardMin = getMinOpenPriority(context->backward.open);
+        if (forwardMin >= context->bestCost
+            || backwardMin >= context->bestCost)
+        {
+            break;
+        }
+
+        if (forwardMin <= backwardMin)
+        {
+            expandFrontier(context, &context->forward, &context->backward);
+        }
+        else
+        {
+            expandFrontier(context, &context->backward, &context->forward);
+        }
+    }
+
+    if (context->bestCost == SCORE_MAX)
+    {
+        return NULL;
+    }
+    return reconstructPath(context, sourceIndex, targetIndex);
+}
+
+
+/*
+@context
+    * Gets the number of points expanded in the last search of `context`.
+    * Counts the expansions of both directions.
+
+@parameters
+    * context
+        * Search context to get number of expansions of.
+
+@return
+    * Number of points expanded.
+*/
+cell_t getBidirectionalExpansions(bidirectionalContext_t *context)
+{
+    return context->nExpanded;
+}
+
+
+/* ------------------------------- END PUBLIC ------------------------------- */
+/* ----------------------------- START  PRIVATE ----------------------------- */
+
+
+/*
+@context
+    * Initialises the search state and open list of one direction.
+
+@parameters
+    * frontier
+        * Direction to initialise.
+    * dungeon
+        * Dungeon the direction searches in.
+    * openType
+        * Priority queue used as the open list.
+    * isForward
+        * Indicates if the direction searches from the source.
+*/
+static void initFrontier(frontier_t     *frontier,
+                         dungeon_t      *dungeon,
+                         openListType_t  openType,
+                         bool            isForward)
+{
+    frontier->grid = initSearchGrid(getDungeonSize(dungeon));
+    // f-scores pushed are never more than 2 moves above the f-score popped
+    frontier->open = initOpenList(openType, 2 * COST_DIAGONAL);
+    frontier->goal = initPoint(0, 0);
+    frontier->isForward = isForward;
+}
+
+
+/*
+@context
+    * Resets one direction and adds its start point to its open list.
+
+@parameters
+    * context
+        * Search context holding the dungeon.
+    * frontier
+        * Direction to reset.
+    * start
+        * Location the direction searches from.
+    * goal
+        * Location the direction searches towards.
+*/
+static void startFrontier(bidirectionalContext_t *context,
+                          frontier_t             *frontier,
+                          point_t                 start,
+                          point_t                 goal)
+{
+    pointData_t *startData;
+
+    resetSearchGrid(frontier->grid);
+    clearOpenList(frontier->open);
+    frontier->goal = goal;
+
+    startData = getSearchGridCell(frontier->grid,
+                                  getDungeonIndex(context->dungeon, start));
+    startData->gScore = 0;
+    openSearchGridCell(startData,
+                       frontier->open,
+                       start,
+                       distancePoints(start,
+                                      goal,
+                                      COST_CARDINAL,
+                                      COST_DIAGONAL));
+}
+
+
+/*
+@context
+    * Expands the minimum f-score point of `frontier`.
+    * Neighbours with a new shortest g-score are added to its open list or
+      have their f-score lowered if already in it.
+        * If `other` has also reached a neighbour, the path through it becomes
+          the best meeting if it is the cheapest so far.
+
+@parameters
+    * context
+        * Search context holding the dungeon and the best meeting.
+    * frontier
+        * Direction to expand.
+        * Assumes its open list is not empty.
+    * other
+        * Opposite direction to `frontier`.
+*/
+static void expandFrontier(bidirectionalContext_t *context,
+                           frontier_t             *frontier,
+                           frontier_t             *other)
+{
+    uint8_t i, moves;
+    score_t gScore, hScore, otherScore;
+    cell_t currentIndex, neighbourIndex;
+    pointData_t *currentData, *neighbourData;
+    point_t current, neighbour;
+
+    current = getMinOpenData(frontier->open);
+    freeMinOpenNode(frontier->open);
+
+    // each point is only in the open list once so `current` is never closed yet
+    currentIndex = getDungeonIndex(context->dungeon, current);
+    currentData = getSearchGridCell(frontier->grid, currentIndex);
+    currentData->isClosed = true;
+    context->nExpanded += 1;
+
+    // forward follows moves out of `current` - backward follows moves into it
+    moves = frontier->isForward
+          ? getDungeonPointMoves(context->dungeon, current)
+          : getPredecessorMoves(context->dungeon, current);
+    for (i = 0; moves != 0; i += 1, moves >>= 1)
+    {
+        if (!(moves & 1))
+        {
+            continue;
+        }
+
+        neighbour = addPoints(current, MOVES[i]);
+        gScore = currentData->gScore + cost(MOVES[i]);
+
+        neighbourIndex = getMoveIndex(context->rowStride,
+                                      currentIndex,
+                                      MOVES[i]);
+        neighbourData = getSearchGridCell(frontier->grid, neighbourIndex);
+        if (gScore >= neighbourData->gScore)
+        {
+            continue;
+        }
+
+        neighbourData->prev = currentIndex;
+        neighbourData->gScore = gScore;
+
+        // add `neighbour` to `open` if not closed (expanded its neighbours)
+        if (!neighbourData->isClosed)
+        {
+            hScore = distancePoints(neighbour,
+                                    frontier->goal,
+                                    COST_CARDINAL,
+                                    COST_DIAGONAL);
+            openSearchGridCell(neighbourData,
+                               frontier->open,
+                               neighbour,
+                               gScore + hScore);
+        }
+
+        // both directions have reached `neighbour` - a path through it exists
+        otherScore = getSearchGridCell(other->grid, neighbourIndex)->gScore;
+        if (otherScore != SCORE_MAX
+            && gScore + otherScore < context->bestCost)
+        {
+            context->bestCost = gScore + otherScore;
+            context->meetIndex = neighbourIndex;
+        }
+    }
+}
+
+
+/*
+@context
+    * Determine the cost of a `move`.
+
+@parameters
+    * move
+        * Point indicating a unit move in an 8 directional movement system.
+        * Moves whose combined x and y have a magnitude of 1 are cardinal.
+
+@return
+    * Cost of the `move`.
+*/
+static uint16_t cost(point_t move)
+{
+    // only moving in x or y direction not both
+    if (abs(move.x + move.y) == 1)
+    {
+        return COST_CARDINAL;
+    }
+    return COST_DIAGONAL;
+}
+
+
+/*
+@context
+    * Finds the moves that lead into `point` from its neighbours.
+    * Bit `i` is set if moving from `point + MOVES[i]` to `point` is valid.
+        * The move from `point + MOVES[i]` is the opposite of `MOVES[i]`.
+
+@parameters
+    * dungeon
+        * Dungeon to check moves in.
+    * point
+        * Location to find moves into.
+
+@return
+    * Mask of the neighbours that can move into `point`.
+*/
+static uint8_t getPredecessorMoves(dungeon_t *dungeon,
+                                   point_t    point)
+{
+    uint8_t i, opposite, moves;
+    point_t neighbour;
+
+    moves = 0;
+    for (i = 0; i < N_MOVES; i += 1)
+    {
+        neighbour = addPoints(point, MOVES[i]);
+        opposite = (i + N_MOVES / 2) % N_MOVES;
+
+        if (isDungeonWalkable(dungeon, neighbour)
+            && getDungeonPointMoves(dungeon, neighbour) & (1 << opposite))
+        {
+            moves |= 1 << i;
+        }
+    }
+
+    return moves;
+}
+
+
+/*
+@context
+    * Creates an array of points to represent a found path.
+    * Joins the forward path from `source` to the meeting point with the
+      backward path from the meeting point to `target`.
+    * Assumes a meeting has been found.
+
+@parameters
+    * context
+        * Search context holding the search state of both directions.
+    * sourceIndex
+        * Cell index the forward direction started from.
+    * targetIndex
+        * Cell index the backward direction started from.
+
+@return
+    * Shortest path (sequence of points) from `source` to `target`.
+*/
+static point_t *reconstructPath(bidirectionalContext_t *context,
+                                cell_t                  sourceIndex,
+                                cell_t                  targetIndex)
+{
+    point_t *path;
+    cell_t current, forwardLength, length, i;
+
+    // find length of both halves of `path`
+    forwardLength = 0;
+    current = context->meetIndex;
+    while (current != sourceIndex)
+    {
+        forwardLength += 1;
+        current = getSearchGridCell(context->forward.grid, current)->prev;
+    }
+
+    length = forwardLength;
+    current = context->meetIndex;
+    while (current != targetIndex)
+    {
+        length += 1;
+        current = getSearchGridCell(context->backward.grid, current)->prev;
+    }
+
+    path = malloc(sizeof(point_t) * (size_t)length);
+    assert(path != NULL);
+
+    // forward half in reverse (from the meeting point to `source`)
+    current = context->meetIndex;
+    for (i = forwardLength; i > 0; i -= 1)
+    {
+        path[i - 1] = getDungeonIndexPoint(context->dungeon, current);
+        current = getSearchGridCell(context->forward.grid, current)->prev;
+    }
+
+    // backward half in order (from after the meeting point to `target`)
+    current = context->meetIndex;
+    for (i = forwardLength; i < length; i += 1)
+    {
+        current = getSearchGridCell(context->backward.grid, current)->prev;
+        path[i] = getDungeonIndexPoint(context->dungeon, current);
+    }
+
+    return path;
+}
+
+
+/* ------------------------------ END  PRIVATE ------------------------------ */
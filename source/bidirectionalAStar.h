@@ -0,0 +1,42 @@
+/*
+@context
+    * Provides a method of finding the shortest path between 2 points in a
+      dungeon using bidirectional A*.
+    * A forward search from the source and a backward search from the target
+      meet in the middle.
+        * Each search uses an Octile distance heuristic towards the other
+          search's start point.
+        * The search stops once either side can no longer find a path cheaper
+          than the cheapest meeting found so far, so the path is optimal.
+    * Follows the same movement rules as `isValidMove`.
+    * Finds a path of the same cost as `findPath` in the same format.
+    * The path found is dynamically allocated so it must be freed.
+    * A search context can be reused between searches on the same dungeon.
+*/
+
+
+#ifndef _BIDIRECTIONAL_A_STAR_H
+    #define _BIDIRECTIONAL_A_STAR_H
+
+    #include <stdint.h>
+
+    #include "dataStructs/dungeon.h"
+    #include "dataStructs/openList.h"
+    #include "dataTypes/point.h"
+
+
+    typedef struct bidirectionalContext_s bidirectionalContext_t;
+
+
+    bidirectionalContext_t *initBidirectionalContext(dungeon_t      *dungeon,
+                                                     openListType_t  openType);
+
+    void freeBidirectionalContext(bidirectionalContext_t *context);
+
+    point_t *findBidirectionalPath(bidirectionalContext_t *context,
+                                   point_t                 source,
+                                   point_t                 target);
+
+    cell_t getBidirectionalExpansions(bidirectionalContext_t *context);
+
+#endif
@@ -0,0 +1,528 @@
+#include "bucketPQ.h"
+
+#include <assert.h>
+#include <stdlib.h>
+
+
+// marks the end of a bucket or the recycled list
+static const cell_t NONE = CELL_MAX;
+
+// buckets of a queue are no more than `1 << MAX_BUCKET_SHIFT`
+static const uint8_t MAX_BUCKET_SHIFT = 31;
+
+// number of nodes allocated when the queue is first used
+static const cell_t INITIAL_CAPACITY = 64;
+
+
+typedef struct bucket_s bucket_t;
+
+
+struct bucket_s
+{
+    cell_t head;
+};
+
+struct bucketPQ_s
+{
+    // circular array of buckets - number of buckets is a power of 2
+    bucket_t *buckets;
+    uint32_t mask;
+    score_t spread;
+
+    // nodes are stored by index so the arrays can grow without invalidation
+    point_t *data;
+    score_t *priorities;
+    cell_t *next;
+    cell_t *prev;
+    cell_t capacity;
+    cell_t used;
+    cell_t recycled;
+
+    cell_t size;
+    score_t minPriority;
+};
+
+
+static cell_t reuseNode(bucketPQ_t *pq);
+
+static void growNodes(bucketPQ_t *pq);
+
+static bucket_t *getBucket(bucketPQ_t *pq,
+                           score_t     priority);
+
+static void connectNode(bucketPQ_t *pq,
+                        cell_t      node);
+static void disconnectNode(bucketPQ_t *pq,
+                           cell_t      node);
+
+static void advanceMin(bucketPQ_t *pq);
+
+
+/* ------------------------------ START PUBLIC ------------------------------ */
+
+
+/*
+@context
+    * Initialises an empty bucket priority queue.
+
+@parameters
+    * spread
+        * Largest difference between the last minimum priority found and any
+          priority inserted after it.
+        * Must be `<= BUCKET_SPREAD_MAX`.
+
+@return
+    * Empty bucket priority queue.
+*/
+bucketPQ_t *initBucketPQ(score_t spread)
+{
+    uint8_t shift;
+    uint32_t i, nBuckets;
+    bucketPQ_t *pq;
+
+    assert(spread <= BUCKET_SPREAD_MAX);
+
+    pq = malloc(sizeof(bucketPQ_t));
+    assert(pq != NULL);
+
+    // smallest power of 2 able to hold every priority within `spread`
+    shift = 0;
+    while (shift < MAX_BUCKET_SHIFT && ((score_t)1 << shift) <= spread)
+    {
+        shift += 1;
+    }
+    nBuckets = (uint32_t)1 << shift;
+
+    pq->buckets = malloc(sizeof(bucket_t) * nBuckets);
+    assert(pq->buckets != NULL);
+    for (i = 0; i < nBuckets; i += 1)
+    {
+        pq->buckets[i].head = NONE;
+    }
+
+    pq->mask = nBuckets - 1;
+    pq->spread = spread;
+
+    pq->data = NULL;
+    pq->priorities = NULL;
+    pq->next = NULL;
+    pq->prev = NULL;
+    pq->capacity = 0;
+    pq->used = 0;
+    pq->recycled = NONE;
+
+    pq->size = 0;
+    pq->minPriority = 0;
+
+    return pq;
+}
+
+
+/*
+@context
+    * Inserts `data` into `pq` by its `priority`.
+
+@parameters
+    * pq
+        * Bucket priority queue to insert `data` into.
+    * data
+        * Data to insert into `pq`.
+    * priority
+        * Sort value of `data`.
+        * Must be within the spread of `pq` from the minimum priority unless
+          `pq` is empty.
+
+@return
+    * Handle of the inserted node - valid until it is removed.
+*/
+cell_t initBucketNode(bucketPQ_t *pq,
+                      point_t     data,
+                      score_t     priority)
+{
+    cell_t node;
+
+    // an empty queue can restart from any priority outside its current range
+    if (pq->size == 0
+        && (priority < pq->minPriority
+            || priority - pq->minPriority > pq->spread))
+    {
+        pq->minPriority = priority;
+    }
+
+    assert(priority >= pq->minPriority);
+    assert(priority - pq->minPriority <= pq->spread);
+
+    node = reuseNode(pq);
+    pq->data[node] = data;
+    pq->priorities[node] = priority;
+    connectNode(pq, node);
+
+    pq->size += 1;
+
+    return node;
+}
+
+
+/*
+@context
+    * Lowers the priority of the node of `handle` in `pq`.
+    * The node is moved in front of nodes of equal priority as if newly
+      inserted.
+
+@parameters
+    * pq
+        * Bucket priority queue holding the node.
+    * handle
+        * Handle of the node returned when it was inserted.
+    * priority
+        * New sort value of the node.
+        * Must be lower than its current priority but not below the minimum
+          priority of `pq`.
+*/
+void decreaseBucketNode(bucketPQ_t *pq,
+                        cell_t      handle,
+                        score_t     priority)
+{
+    assert(priority < pq->priorities[handle]);
+    assert(priority >= pq->minPriority);
+
+    disconnectNode(pq, handle);
+    pq->priorities[handle] = priority;
+    connectNode(pq, handle);
+}
+
+
+/*
+@context
+    * Frees all allocated memory of `pq`.
+
+@parameters
+    * pq
+        * Bucket priority queue to free.
+*/
+void freeBucketPQ(bucketPQ_t *pq)
+{
+    free(pq->buckets);
+    free(pq->data);
+    free(pq->priorities);
+    free(pq->next);
+    free(pq->prev);
+    free(pq);
+}
+
+
+/*
+@context
+    * Removes the minimum priority node from `pq`.
+
+@parameters
+    * pq
+        * Bucket priority queue to remove minimum priority node from.
+        * Assumes `pq` is not empty.
+*/
+void freeMinBucketNode(bucketPQ_t *pq)
+{
+    cell_t node;
+
+    assert(pq->size > 0);
+
+    advanceMin(pq);
+    node = getBucket(pq, pq->minPriority)->head;
+    disconnectNode(pq, node);
+
+    pq->next[node] = pq->recycled;
+    pq->recycled = node;
+    pq->size -= 1;
+}
+
+
+/*
+@context
+    * Removes all nodes from `pq` without freeing them.
+    * Removed nodes are recycled by later insertions.
+
+@parameters
+    * pq
+        * Bucket priority queue to empty.
+*/
+void clearBucketPQ(bucketPQ_t *pq)
+{
+    uint32_t i;
+
+    for (i = 0; i <= pq->mask; i += 1)
+    {
+        pq->buckets[i].head = NONE;
+    }
+
+    // every node is free again - recycled list is rebuilt as nodes are used
+    pq->used = 0;
+    pq->recycled = NONE;
+    pq->size = 0;
+}
+
+
+/*
+@context
+    * Determines if `pq` is empty.
+
+@parameters
+    * pq
+        * Bucket priority queue to check if empty.
+
+@return
+    * Indicates if `pq` is empty.
+*/
+bool isBucketPQEmpty(bucketPQ_t *pq)
+{
+    return pq->size == 0;
+}
+
+
+/*
+@context
+    * Gets data of the minimum priority node from `pq`.
+
+@parameters
+    * pq
+        * Bucket priority queue to get minimum priority data from.
+        * Assumes `pq` is not empty.
+
+@return
+    * Data of the minimum priority node of `pq`.
+*/
+point_t getMinBucketData(bucketPQ_t *pq)
+{
+    assert(pq->size > 0);
+
+    advanceMin(pq);
+    return pq->data[getBucket(pq, pq->minPriority)->head];
+}
+
+
+/*
+@context
+    * Gets the minimum priority of `pq`.
+
+@parameters
+    * pq
+        * Bucket priority queue to get minimum priority of.
+        * Assumes `pq` is not empty.
+
+@return
+    * Minimum priority of `pq`.
+*/
+score_t getMinBucketPriority(bucketPQ_t *pq)
+{
+    assert(pq->size > 0);
+
+    advanceMin(pq);
+    return pq->minPriority;
+}
+
+
+/*
+@context
+    * Gets the number of nodes in `pq`.
+
+@parameters
+    * pq
+        * Bucket priority queue to get number of nodes of.
+
+@return
+    * Number of nodes in `pq`.
+*/
+cell_t getBucketPQSize(bucketPQ_t *pq)
+{
+    return pq->size;
+}
+
+
+/*
+@context
+    * Gets the number of bytes of memory held by `pq`.
+    * Includes nodes kept for reuse.
+
+@parameters
+    * pq
+        * Bucket priority queue to get memory of.
+
+@return
+    * Bytes of memory held by `pq`.
+*/
+uint64_t getBucketPQBytes(bucketPQ_t *pq)
+{
+    return sizeof(bucketPQ_t)
+         + sizeof(bucket_t) * ((uint64_t)pq->mask + 1)
+         + (sizeof(point_t) + sizeof(score_t) + sizeof(cell_t) * 2)
+           * (uint64_t)pq->capacity;
+}
+
+
+/* ------------------------------- END PUBLIC ------------------------------- */
+/* ----------------------------- START  PRIVATE ----------------------------- */
+
+
+/*
+@context
+    * Takes an unused node from `pq`.
+    * Recycled nodes are used first, then untouched nodes, then `pq` grows.
+
+@parameters
+    * pq
+        * Bucket priority queue to take node from.
+
+@return
+    * Index of an unused node.
+*/
+static cell_t reuseNode(bucketPQ_t *pq)
+{
+    cell_t node;
+
+    if (pq->recycled != NONE)
+    {
+        node = pq->recycled;
+        pq->recycled = pq->next[node];
+        return node;
+    }
+
+    if (pq->used == pq->capacity)
+    {
+        growNodes(pq);
+    }
+
+    node = pq->used;
+    pq->used += 1;
+
+    return node;
+}
+
+
+/*
+@context
+    * Doubles the number of nodes `pq` can hold.
+
+@parameters
+    * pq
+        * Bucket priority queue to grow.
+*/
+static void growNodes(bucketPQ_t *pq)
+{
+    pq->capacity = pq->capacity == 0 ? INITIAL_CAPACITY : pq->capacity * 2;
+
+    pq->data = realloc(pq->data, sizeof(point_t) * pq->capacity);
+    assert(pq->data != NULL);
+
+    pq->priorities = realloc(pq->priorities, sizeof(score_t) * pq->capacity);
+    assert(pq->priorities != NULL);
+
+    pq->next = realloc(pq->next, sizeof(cell_t) * pq->capacity);
+    assert(pq->next != NULL);
+
+    pq->prev = realloc(pq->prev, sizeof(cell_t) * pq->capacity);
+    assert(pq->prev != NULL);
+}
+
+
+/*
+@context
+    * Gets the bucket holding nodes of `priority`.
+
+@parameters
+    * pq
+        * Bucket priority queue to get bucket from.
+    * priority
+        * Priority of nodes held by bucket.
+
+@return
+    * Bucket holding nodes of `priority`.
+*/
+static bucket_t *getBucket(bucketPQ_t *pq,
+                           score_t     priority)
+{
+    return &pq->buckets[priority & pq->mask];
+}
+
+
+/*
+@context
+    * Connects `node` to the front of the bucket of its priority.
+    * Inserted in front of nodes of equal priority so ties pop newest first,
+      as in the skip list.
+
+@parameters
+    * pq
+        * Bucket priority queue to connect `node` to.
+    * node
+        * Index of node to connect - its priority is already set.
+*/
+static void connectNode(bucketPQ_t *pq,
+                        cell_t      node)
+{
+    bucket_t *bucket;
+
+    bucket = getBucket(pq, pq->priorities[node]);
+
+    pq->next[node] = bucket->head;
+    pq->prev[node] = NONE;
+    if (bucket->head != NONE)
+    {
+        pq->prev[bucket->head] = node;
+    }
+    bucket->head = node;
+}
+
+
+/*
+@context
+    * Disconnects `node` from the bucket of its priority.
+
+@parameters
+    * pq
+        * Bucket priority queue to disconnect `node` from.
+    * node
+        * Index of node to disconnect.
+*/
+static void disconnectNode(bucketPQ_t *pq,
+                           cell_t      node)
+{
+    bucket_t *bucket;
+
+    bucket = getBucket(pq, pq->priorities[node]);
+
+    if (pq->prev[node] == NONE)
+    {
+        bucket->head = pq->next[node];
+    }
+    else
+    {
+        pq->next[pq->prev[node]] = pq->next[node];
+    }
+
+    if (pq->next[node] != NONE)
+    {
+        pq->prev[pq->next[node]] = pq->prev[node];
+    }
+}
+
+
+/*
+@context
+    * Moves the minimum priority of `pq` forward to the next non-empty bucket.
+    * Only moves when the minimum is needed so nodes can still be inserted
+      relative to the last minimum priority found.
+
+@parameters
+    * pq
+        * Bucket priority queue to find minimum priority of.
+        * Assumes `pq` is not empty.
+*/
+static void advanceMin(bucketPQ_t *pq)
+{
+    while (getBucket(pq, pq->minPriority)->head == NONE)
+    {
+        pq->minPriority += 1;
+    }
+}
+
+
+/* ------------------------------ END  PRIVATE ------------------------------ */
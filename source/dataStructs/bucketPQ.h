@@ -0,0 +1,64 @@
+/*
+@context
+    * Provides a monotone priority queue data structure.
+    * The priority queue holds data by an integer priority.
+        * Sorted in ascending order where 0 is the minimum.
+        * Inserting data with priority equal to another node is inserted in
+          front of it, so equal priorities pop newest first.
+    * Can only get the minimum node and must be removed to get the next node.
+    * Underlying structure uses a circular array of buckets (one per priority).
+        * Inserting and removing are O(1) amortised.
+        * Priorities inserted must never be below the last minimum priority
+          found and never above it by more than the spread given on
+          initialisation.
+        * Holds for A* f-scores with a consistent heuristic where the spread is
+          twice the largest move cost.
+        * The spread must be no more than `BUCKET_SPREAD_MAX` as there is a
+          bucket for every priority within it.
+    * Removed nodes are recycled by later insertions instead of being freed.
+    * Inserting returns a handle so the node's priority can later be lowered
+      without inserting it again.
+        * Buckets are doubly linked so a node can be moved between them.
+*/
+
+
+#ifndef _BUCKET_PQ_H
+    #define _BUCKET_PQ_H
+
+    #include <stdbool.h>
+    #include <stdint.h>
+
+    #include "../dataTypes/point.h"
+
+
+    // largest spread of a bucket queue - bucket indices fit `uint32_t`
+    static const score_t BUCKET_SPREAD_MAX = ((score_t)1 << 31) - 1;
+
+
+    typedef struct bucketPQ_s bucketPQ_t;
+
+
+    bucketPQ_t *initBucketPQ(score_t spread);
+
+    cell_t initBucketNode(bucketPQ_t *pq,
+                          point_t     data,
+                          score_t     priority);
+
+    void decreaseBucketNode(bucketPQ_t *pq,
+                            cell_t      handle,
+                            score_t     priority);
+
+    void freeBucketPQ(bucketPQ_t *pq);
+    void freeMinBucketNode(bucketPQ_t *pq);
+
+    void clearBucketPQ(bucketPQ_t *pq);
+
+    bool isBucketPQEmpty(bucketPQ_t *pq);
+
+    point_t getMinBucketData(bucketPQ_t *pq);
+    score_t getMinBucketPriority(bucketPQ_t *pq);
+
+    cell_t getBucketPQSize(bucketPQ_t *pq);
+    uint64_t getBucketPQBytes(bucketPQ_t *pq);
+
+#endif
@@ -2,6 +2,7 @@
 
 #include <assert.h>
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
 
 
@@ -34,333 +35,1490 @@ static const int COST = 1;
 
 struct dungeon_s
 {
-    char **map;
+    // tile of point (x, y) is at cell index `getDungeonIndex`
+    char *map;
 
-    uint16_t width;
-    uint16_t height;
+#ifndef PACKED_MAPS
+    // bit `i` of a cell is set if moving by `MOVES[i]` from it is valid
+    uint8_t *moves;
+#endif
+
+    // 1 bit per tile set if walkable - rows of `stride` 64-bit words with a
+    // column of walls either side and a row of walls above and below so the
+    // 3x3 block around any point is read without bounds checks
+    uint64_t *passable;
+    uint32_t wordsPerRow;
+
+    uint32_t width;
+    uint32_t height;
+
+    // cell indices between a point and the point a row of tiles below and the
+    // number of cells once padded to whole tiles
+    int64_t rowStride;
+    cell_t size;
 
     uint8_t nPoints;
     point_t *points;
+
+    // bumped whenever a tile is set or the dungeon is regenerated
+    uint64_t version;
+
+    // connected component label of each cell under the moves of
+    // `isValidMove` - 0 for walls and cells outside the dungeon
+    cell_t *components;
+
+    // cells with each label (indexed by label) and labels with no cells to
+    // reuse - `labelCapacity` of each allocated
+    cell_t *componentSizes;
+    cell_t *freeLabels;
+    cell_t nLabels;
+    cell_t nFreeLabels;
+    cell_t labelCapacity;
+
+    // cells still to relabel by `floodComponent`
+    cell_t *floodStack;
+    cell_t floodCapacity;
 };
 
 
-static uint16_t randInt(uint16_t min,
-                        uint16_t max);
+static bool isWithinDungeon(dungeon_t *dungeon,
+                            point_t    point);
+
+static uint32_t randInt(uint32_t min,
+                        uint32_t max);
+
+static void fillMap(dungeon_t *dungeon);
+
+static void initLayout(dungeon_t *dungeon,
+                       uint32_t   width,
+                       uint32_t   height);
+static void initNavigation(dungeon_t *dungeon);
+static void updateNavigation(dungeon_t *dungeon,
+                             point_t    min,
+                             point_t    max);
+static uint8_t readMoves(dungeon_t *dungeon,
+                         point_t    point);
+static uint64_t *getPassableRow(dungeon_t *dungeon,
+                                int64_t    y);
+static void setPassable(dungeon_t *dungeon,
+                        point_t    point);
+static bool isPassable(dungeon_t *dungeon,
+                       int64_t    x,
+                       int64_t    y);
+static uint8_t getPassableBlockRow(dungeon_t *dungeon,
+                                   int64_t    x,
+                                   int64_t    y);
+
+static void labelComponents(dungeon_t *dungeon);
+static void updateComponents(dungeon_t *dungeon,
+                             point_t    point);
+static void splitComponent(dungeon_t *dungeon,
+                           point_t    point,
+                           cell_t     label);
+static void floodComponent(dungeon_t *dungeon,
+                           cell_t     index,
+                           cell_t     label);
+static void setComponent(dungeon_t *dungeon,
+                         cell_t     index,
+                         cell_t     label);
+static cell_t newComponentLabel(dungeon_t *dungeon);
+
+static void generatePoints(dungeon_t *dungeon);
+static point_t generatePoint(uint32_t width,
+                             uint32_t height);
+
+static void connectPoints(dungeon_t *dungeon);
+static void drawLine(dungeon_t *dungeon,
+                     point_t    start,
+                     point_t    end,
+                     uint8_t    radius);
+static void drawCircle(dungeon_t *dungeon,
+                       point_t    centre,
+                       uint8_t    radius);
+
+
+/* ------------------------------ START PUBLIC ------------------------------ */
+
+
+/*
+@context
+    * Initialises a dungeon with a random configuration.
+    * Dungeon maps are a single row-major buffer addressed by cell index.
+
+@parameters
+    * width
+        * Width of dungeon map.
+        * Must be `>= MIN_SIZE` if `height` is not.
+        * Must be `<= COORD_MAX + 1`.
+    * height
+        * Height of dungeon map.
+        * Must be `>= MIN_SIZE` if `width` is not.
+        * Must be `<= COORD_MAX + 1`.
+
+@return
+    * Dungeon with a random configuration.
+*/
+dungeon_t *initDungeon(uint32_t width,
+                       uint32_t height)
+{
+    dungeon_t *dungeon;
+
+    assert(width >= MIN_SIZE || height >= MIN_SIZE);
+    assert(width - 1 <= COORD_MAX && height - 1 <= COORD_MAX);
+
+    dungeon = malloc(sizeof(dungeon_t));
+    assert(dungeon != NULL);
+
+    // initialise `dungeon` map to the given size
+    initLayout(dungeon, width, height);
+    dungeon->map = malloc(sizeof(char) * (size_t)dungeon->size);
+    assert(dungeon->map != NULL);
+    initNavigation(dungeon);
+
+    dungeon->nPoints = 0;
+    dungeon->points = NULL;
+    dungeon->version = 0;
+
+    generateDungeon(dungeon);
+
+    return dungeon;
+}
+
+
+/*
+@context
+    * Initialises a dungeon with the given tiles instead of a random
+      configuration (e.g. a map loaded from a file).
+    * The dungeon has no source or target.
+        * Must not be regenerated unless `width` or `height` is
+          `>= MIN_SIZE`.
+
+@parameters
+    * width
+        * Width of dungeon map.
+        * Must be `> 0` and `<= COORD_MAX + 1`.
+    * height
+        * Height of dungeon map.
+        * Must be `> 0` and `<= COORD_MAX + 1`.
+    * tiles
+        * Row-major tile character representations - `width * height` of
+          them.
+
+@return
+    * Dungeon holding `tiles`.
+*/
+dungeon_t *initDungeonMap(uint32_t    width,
+                          uint32_t    height,
+                          const char *tiles)
+{
+    int64_t x, y;
+    dungeon_t *dungeon;
+
+    assert(width > 0 && height > 0);
+    assert(width - 1 <= COORD_MAX && height - 1 <= COORD_MAX);
+
+    dungeon = malloc(sizeof(dungeon_t));
+    assert(dungeon != NULL);
+
+    initLayout(dungeon, width, height);
+    dungeon->map = malloc(sizeof(char) * (size_t)dungeon->size);
+    assert(dungeon->map != NULL);
+    initNavigation(dungeon);
+
+    // `tiles` are row-major which may not be the layout of `dungeon`
+    fillMap(dungeon);
+    for (y = 0; y < height; y += 1)
+    {
+        for (x = 0; x < width; x += 1)
+        {
+            dungeon->map[getDungeonIndex(dungeon, initPoint(x, y))]
+                = tiles[(size_t)y * width + x];
+        }
+    }
+
+    dungeon->nPoints = 0;
+    dungeon->points = NULL;
+    dungeon->version = 0;
+
+    updateNavigation(dungeon,
+                     initPoint(0, 0),
+                     initPoint(width - 1, height - 1));
+    labelComponents(dungeon);
+
+    return dungeon;
+}
+
+
+/*
+@context
+    * Frees `dungeon`.
+
+@parameters
+    * dungeon
+        * Dungeon to free.
+*/
+void freeDungeon(dungeon_t *dungeon)
+{
+    free(dungeon->map);
+    free(dungeon->passable);
+#ifndef PACKED_MAPS
+    free(dungeon->moves);
+#endif
+    free(dungeon->components);
+    free(dungeon->componentSizes);
+    free(dungeon->freeLabels);
+    free(dungeon->floodStack);
+
+    free(dungeon->points);
+    free(dungeon);
+}
+
+
+/*
+@context
+    * Gets the width of `dungeon`.
+
+@parameters
+    * dungeon
+        * Dungeon to get width of.
+
+@return
+    * Width of `dungeon`.
+*/
+uint32_t getDungeonWidth(dungeon_t *dungeon)
+{
+    return dungeon->width;
+}
+
+
+/*
+@context
+    * Gets the height of `dungeon`.
+
+@parameters
+    * dungeon
+        * Dungeon to get height of.
+
+@return
+    * Height of `dungeon`.
+*/
+uint32_t getDungeonHeight(dungeon_t *dungeon)
+{
+    return dungeon->height;
+}
+
+
+/*
+@context
+    * Gets tile character representation at `point` of `dungeon`.
+
+@parameters
+    * dungeon
+        * Dungeon to get tile at `point`.
+    * point
+        * Location of tile to get.
+        * Assumes `point` is within `dungeon` bounds.
+
+@return
+    * Tile character representation.
+*/
+char getDungeonPoint(dungeon_t *dungeon,
+                     point_t    point)
+{
+    assert(isWithinDungeon(dungeon, point));
+    return dungeon->map[getDungeonIndex(dungeon, point)];
+}
+
+
+/*
+@context
+    * Gets tile character representation at cell `index` of `dungeon`.
+
+@parameters
+    * dungeon
+        * Dungeon to get tile at `index`.
+    * index
+        * Cell index of tile to get.
+        * Assumes `index` is within `dungeon` bounds.
+
+@return
+    * Tile character representation.
+*/
+char getDungeonCell(dungeon_t *dungeon,
+                    cell_t     index)
+{
+    assert(index < getDungeonSize(dungeon));
+    return dungeon->map[index];
+}
+
+
+/*
+@context
+    * Gets the mask of valid moves from cell `index` of `dungeon`.
+    * Bit `i` is set if moving by `MOVES[i]` is valid (same as `isValidMove`).
+    * Built with `PACKED_MAPS` the mask is read from the walkable bits which
+      first needs the point of `index` (prefer `getDungeonPointMoves`).
+
+@parameters
+    * dungeon
+        * Dungeon to get valid moves in.
+    * index
+        * Cell index to get valid moves from.
+        * Assumes `index` is within `dungeon` bounds.
+
+@return
+    * Mask of valid moves from cell `index`.
+*/
+uint8_t getDungeonMoves(dungeon_t *dungeon,
+                        cell_t     index)
+{
+    assert(index < getDungeonSize(dungeon));
+#ifdef PACKED_MAPS
+    return readMoves(dungeon, getDungeonIndexPoint(dungeon, index));
+#else
+    return dungeon->moves[index];
+#endif
+}
+
+
+/*
+@context
+    * Gets the mask of valid moves from `point` of `dungeon`.
+    * Bit `i` is set if moving by `MOVES[i]` is valid (same as `isValidMove`).
+    * Built with `PACKED_MAPS` the mask is read from the walkable bits around
+      `point` (no mask is cached for each cell).
+
+@parameters
+    * dungeon
+        * Dungeon to get valid moves in.
+    * point
+        * Location to get valid moves from.
+        * Assumes `point` is within `dungeon` bounds.
+
+@return
+    * Mask of valid moves from `point`.
+*/
+uint8_t getDungeonPointMoves(dungeon_t *dungeon,
+                             point_t    point)
+{
+    assert(isWithinDungeon(dungeon, point));
+#ifdef PACKED_MAPS
+    return readMoves(dungeon, point);
+#else
+    return dungeon->moves[getDungeonIndex(dungeon, point)];
+#endif
+}
+
+
+/*
+@context
+    * Gets the number of cells of `dungeon`.
+    * Cell indices of `dungeon` are within `[0, size)`.
+    * Built with `TILE_SHIFT` this includes the cells padding `dungeon` to
+      whole tiles - they are outside its bounds and hold walls.
+
+@parameters
+    * dungeon
+        * Dungeon to get number of cells of.
+
+@return
+    * Number of cells of `dungeon`.
+*/
+cell_t getDungeonSize(dungeon_t *dungeon)
+{
+    return dungeon->size;
+}
+
+
+/*
+@context
+    * Gets the number of cell indices between a point of `dungeon` and the
+      point a row of tiles below (`width` when cells are row-major).
+    * Passed to `getMoveIndex`.
+
+@parameters
+    * dungeon
+        * Dungeon to get row stride of.
+
+@return
+    * Row stride of `dungeon`.
+*/
+int64_t getDungeonRowStride(dungeon_t *dungeon)
+{
+    return dungeon->rowStride;
+}
+
+
+/*
+@context
+    * Gets the number of bytes `dungeon` uses to navigate (walkable bits and
+      cached valid moves) - the map of tiles is not included.
+
+@parameters
+    * dungeon
+        * Dungeon to get navigation bytes of.
+
+@return
+    * Number of bytes of navigation data.
+*/
+uint64_t getDungeonNavigationBytes(dungeon_t *dungeon)
+{
+    uint64_t bytes;
+
+    bytes = sizeof(uint64_t) * (uint64_t)dungeon->wordsPerRow
+          * (dungeon->height + 2);
+#ifndef PACKED_MAPS
+    bytes += sizeof(uint8_t) * getDungeonSize(dungeon);
+#endif
+
+    return bytes;
+}
+
+
+/*
+@context
+    * Gets the version of `dungeon`.
+    * Bumped whenever a tile is set or `dungeon` is regenerated so results
+      found in `dungeon` can be checked as still current.
+
+@parameters
+    * dungeon
+        * Dungeon to get version of.
+
+@return
+    * Version of `dungeon`.
+*/
+uint64_t getDungeonVersion(dungeon_t *dungeon)
+{
+    return dungeon->version;
+}
+
+
+/*
+@context
+    * Gets the connected component label of `point` of `dungeon`.
+    * Points have the same label if and only if a path joins them under the
+      moves of `isValidMove`.
+    * Labels are reused once a component is split or merged away so they are
+      only comparable within one version of `dungeon`.
+
+@parameters
+    * dungeon
+        * Dungeon to get component label in.
+    * point
+        * Location to get component label of.
+        * Assumes `point` is within `dungeon` bounds.
+
+@return
+    * Component label of `point` - `0` if `point` is a wall.
+*/
+cell_t getDungeonComponent(dungeon_t *dungeon,
+                           point_t    point)
+{
+    assert(isWithinDungeon(dungeon, point));
+    return dungeon->components[getDungeonIndex(dungeon, point)];
+}
+
+
+/*
+@context
+    * Gets the number of points in the connected component of `point` of
+      `dungeon`.
+
+@parameters
+    * dungeon
+        * Dungeon to get component size in.
+    * point
+        * Location to get component size of.
+        * Assumes `point` is within `dungeon` bounds.
+
+@return
+    * Number of points joined to `point` (including it) - `0` if `point` is
+      a wall.
+*/
+cell_t getDungeonComponentSize(dungeon_t *dungeon,
+                               point_t    point)
+{
+    cell_t label;
+
+    label = getDungeonComponent(dungeon, point);
+    return label != 0 ? dungeon->componentSizes[label] : 0;
+}
+
+
+/*
+@context
+    * Gets the bytes allocated for the connected component labels of
+      `dungeon` (a label for each cell and the size of each label).
+
+@parameters
+    * dungeon
+        * Dungeon to get component bytes of.
+
+@return
+    * Number of bytes of component labels.
+*/
+uint64_t getDungeonComponentBytes(dungeon_t *dungeon)
+{
+    return sizeof(cell_t) * ((uint64_t)getDungeonSize(dungeon)
+                             + 2 * (uint64_t)dungeon->labelCapacity
+                             + (uint64_t)dungeon->floodCapacity);
+}
+
+
+/*
+@context
+    * Converts `point` to its cell index in `dungeon`.
+    * Cells are row-major within a tile and tiles are row-major.
+        * A tile is a single cell unless built with `TILE_SHIFT`.
+
+@parameters
+    * dungeon
+        * Dungeon to get cell index in.
+    * point
+        * Location to convert.
+        * Assumes `point` is within `dungeon` bounds.
+
+@return
+    * Cell index of `point`.
+*/
+cell_t getDungeonIndex(dungeon_t *dungeon,
+                       point_t    point)
+{
+    return (cell_t)(point.y >> TILE_SHIFT) * dungeon->rowStride
+         + ((cell_t)(point.x >> TILE_SHIFT) << (2 * TILE_SHIFT))
+         + ((point.y & TILE_MASK) << TILE_SHIFT)
+         + (point.x & TILE_MASK);
+}
+
+
+/*
+@context
+    * Converts cell `index` of `dungeon` back to its point.
+
+@parameters
+    * dungeon
+        * Dungeon to get point in.
+    * index
+        * Cell index to convert.
+        * Assumes `index` is within `dungeon` bounds.
+
+@return
+    * Location of cell `index`.
+*/
+point_t getDungeonIndexPoint(dungeon_t *dungeon,
+                             cell_t     index)
+{
+    cell_t tile, nTilesX;
+
+    tile = index >> (2 * TILE_SHIFT);
+    nTilesX = dungeon->rowStride >> (2 * TILE_SHIFT);
+
+    return initPoint((tile % nTilesX) << TILE_SHIFT | (index & TILE_MASK),
+                     (tile / nTilesX) << TILE_SHIFT
+                     | (index >> TILE_SHIFT & TILE_MASK));
+}
+
+
+/*
+@context
+    * Gets source point of `dungeon`.
+    * Assumes `dungeon` has one (was generated).
+
+@parameters
+    * dungeon
+        * Dungeon to get source point of.
+
+@return
+    * Location point of `dungeon` source.
+*/
+point_t getDungeonSource(dungeon_t *dungeon)
+{
+    assert(dungeon->nPoints > 0);
+    return dungeon->points[0];
+}
+
+
+/*
+@context
+    * Gets target point of `dungeon`.
+    * Assumes `dungeon` has one (was generated).
+
+@parameters
+    * dungeon
+        * Dungeon to get target point of.
+
+@return
+    * Location point of `dungeon` target.
+*/
+point_t getDungeonTarget(dungeon_t *dungeon)
+{
+    assert(dungeon->nPoints > 0);
+    return dungeon->points[dungeon->nPoints - 1];
+}
+
+
+/*
+@context
+    * Sets tile character representation at `point` of `dungeon`.
+    * Updates the walkable bit of `point` and the valid moves of `point` and
+      its 8 neighbours.
+    * Updates the connected component labels if `point` changes between a
+      wall and walkable.
+        * A floor only merges the components around it and a wall only
+          relabels its component if the walkable points around it are no
+          longer joined without it.
+    * Bumps the version of `dungeon`.
+
+@parameters
+    * dungeon
+        * Dungeon to set tile of at `point`.
+    * point
+        * Location of tile to set.
+        * Assumes `point` is within `dungeon` bounds.
+    * tile
+        * Character representation to set tile to.
+*/
+void setDungeonPoint(dungeon_t *dungeon,
+                     point_t    point,
+                     char       tile)
+{
+    bool wasWalkable;
+
+    assert(isWithinDungeon(dungeon, point));
+    wasWalkable = isPassable(dungeon, point.x, point.y);
+    dungeon->map[getDungeonIndex(dungeon, point)] = tile;
+    updateNavigation(dungeon, point, point);
+    dungeon->version += 1;
+
+    // tiles changing between floors (e.g. drawing a path) keep every label
+    if (isPassable(dungeon, point.x, point.y) != wasWalkable)
+    {
+        updateComponents(dungeon, point);
+    }
+}
+
+
+/*
+@context
+    * Generates a new random configuration of `dungeon`.
+    * Labels the connected components of `dungeon` again.
+    * Bumps the version of `dungeon`.
+
+@parameters
+    * dungeon
+        * Dungeon to generate map for.
+*/
+void generateDungeon(dungeon_t *dungeon)
+{
+    point_t source, target;
+
+    fillMap(dungeon);
+
+    // draw `dungeon` map by drawing lines between points
+    generatePoints(dungeon);
+    connectPoints(dungeon);
+
+    source = getDungeonSource(dungeon);
+    target = getDungeonTarget(dungeon);
+
+    dungeon->map[getDungeonIndex(dungeon, source)] = TILE_SOURCE;
+    dungeon->map[getDungeonIndex(dungeon, target)] = TILE_TARGET;
+
+    updateNavigation(dungeon,
+                     initPoint(0, 0),
+                     initPoint(dungeon->width - 1, dungeon->height - 1));
+    labelComponents(dungeon);
+    dungeon->version += 1;
+}
+
+
+/*
+@context
+    * Checks if `point` is within `dungeon` and not a wall.
+
+@parameters
+    * dungeon
+        * Dungeon to check `point` in.
+    * point
+        * Location to check.
+        * May be out of `dungeon` bounds.
+
+@return
+    * Indication if `point` can be stood on.
+*/
+bool isDungeonWalkable(dungeon_t *dungeon,
+                       point_t    point)
+{
+    return isWithinDungeon(dungeon, point)
+        && isPassable(dungeon, point.x, point.y);
+}
+
+
+/*
+@context
+    * Checks if moving between 2 points in `dungeon` is valid.
+    * Points must be adjacent in 8 directional movement (`distance = 1`).
+
+@parameters
+    * dungeon
+        * Dungeon to check if valid move in.
+    * from
+        * Location moving from in `dungeon`.
+        * Assumes `from` is valid within `dungeon`.
+    * to
+        * Location moving to in `dungeon`.
+
+@return
+    * Indication if moving between `from` and `to` in `dungeon` is valid.
+*/
+bool isValidMove(dungeon_t *dungeon,
+                 point_t    from,
+                 point_t    to)
+{
+    assert(isWithinDungeon(dungeon, from));
+
+    return (distancePoints(from, to, COST, COST) == 1
+
+        // cannot move out of map bounds
+        && isWithinDungeon(dungeon, to)
+
+        // cannot move into a wall
+        && isPassable(dungeon, to.x, to.y)
+
+        // diagonal movement cannot clip wall (cannot move around corners)
+        && isPassable(dungeon, from.x, to.y)
+        && isPassable(dungeon, to.x, from.y));
+}
+
+
+/*
+@context
+    * Checks in O(1) if a path from `source` to `target` in `dungeon` is
+      possible by comparing their connected component labels.
+    * A path is possible from a `source` in a wall (searches may start inside
+      one) if any of its valid moves leads into the component of `target`.
+    * Lets searches reject unreachable queries without exploring every point
+      reachable from `source`.
+
+@parameters
+    * dungeon
+        * Dungeon to check path in.
+    * source
+        * Location to start from.
+        * Assumes `source` is within `dungeon` bounds.
+    * target
+        * Location to find from `source`.
+        * Assumes `target` is within `dungeon` bounds.
+
+@return
+    * Indication if a path from `source` to `target` is possible.
+*/
+bool isDungeonConnected(dungeon_t *dungeon,
+                        point_t    source,
+                        point_t    target)
+{
+    int i;
+    uint8_t moves;
+    cell_t sourceIndex, label;
+
+    sourceIndex = getDungeonIndex(dungeon, source);
+    label = getDungeonComponent(dungeon, target);
+
+    // a search finds `target` as soon as it starts from it
+    if (isEqualPoints(source, target))
+    {
+        return true;
+    }
+
+    if (dungeon->components[sourceIndex] != 0 || label == 0)
+    {
+        return dungeon->components[sourceIndex] == label && label != 0;
+    }
+
+    // a path from a wall leaves it by one of its valid moves
+    moves = getDungeonMoves(dungeon, sourceIndex);
+    for (i = 0; i < N_MOVES; i += 1)
+    {
+        if (moves >> i & 1
+            && dungeon->components[getMoveIndex(dungeon->rowStride,
+                                                sourceIndex,
+                                                MOVES[i])] == label)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+/* ------------------------------- END PUBLIC ------------------------------- */
+/* ----------------------------- START  PRIVATE ----------------------------- */
+
+
+/*
+@context
+    * Checks if `point` is within the bounds of `dungeon`.
 
-static void fillMap(dungeon_t *dungeon);
+@parameters
+    * dungeon
+        * Dungeon to check bounds of.
+    * point
+        * Location to check.
 
-static void generatePoints(dungeon_t *dungeon);
-static point_t generatePoint(uint16_t width,
-                             uint16_t height);
+@return
+    * Indication if `point` is within the bounds of `dungeon`.
+*/
+static bool isWithinDungeon(dungeon_t *dungeon,
+                            point_t    point)
+{
+    return (point.x >= 0 && (uint32_t)point.x < dungeon->width)
+        && (point.y >= 0 && (uint32_t)point.y < dungeon->height);
+}
 
-static void connectPoints(dungeon_t *dungeon);
-static void drawLine(char    **map,
-                     point_t   start,
-                     point_t   end,
-                     uint8_t   radius);
-static void drawCircle(char    **map,
-                       point_t   centre,
-                       uint8_t   radius);
 
+/*
+@context
+    * Generates a uniform number between `min` and `max` (inclusive).
+
+@parameters
+    * min
+        * Lower bounds (included).
+    * max
+        * Upper bounds (included).
 
-/* ------------------------------ START PUBLIC ------------------------------ */
+@return
+    * Random number between `min` and `max` (inclusive).
+*/
+static uint32_t randInt(uint32_t min,
+                        uint32_t max)
+{
+    assert(min <= max);
+    return rand() % (max + 1 - min) + min;
+}
 
 
 /*
 @context
-    * Initialises a dungeon with a random configuration.
-    * Dungeon maps are organised in columns (`map[x][y]`).
+    * Fills `dungeon` map with wall tiles.
+    * Wall tiles are later cut out by floor tiles.
+
+@parameters
+    * dungeon
+        * Dungeon to fill with wall tiles.
+*/
+static void fillMap(dungeon_t *dungeon)
+{
+    memset(dungeon->map, TILE_WALL, getDungeonSize(dungeon));
+}
+
+
+/*
+@context
+    * Sets the size of `dungeon` and the layout of its cells.
+    * Padded to whole tiles when built with `TILE_SHIFT`.
 
 @parameters
+    * dungeon
+        * Dungeon to set layout of.
     * width
         * Width of dungeon map.
-        * Must be `>= MIN_SIZE` if `height` is not.
     * height
         * Height of dungeon map.
-        * Must be `>= MIN_SIZE` if `width` is not.
-
-@return
-    * Dungeon with a random configuration.
 */
-dungeon_t *initDungeon(uint16_t width,
-                       uint16_t height)
+static void initLayout(dungeon_t *dungeon,
+                       uint32_t   width,
+                       uint32_t   height)
 {
-    uint16_t x;
-    dungeon_t *dungeon;
-
-    assert(width >= MIN_SIZE || height >= MIN_SIZE);
-
-    dungeon = malloc(sizeof(dungeon_t));
-    assert(dungeon != NULL);
-
-    // initialise `dungeon` map to the given size
-    dungeon->map = malloc(sizeof(char*) * width);
-    assert(dungeon->map != NULL);
-    for (x = 0; x < width; x += 1)
-    {
-        dungeon->map[x] = malloc(sizeof(char) * height);
-        assert(dungeon->map[x] != NULL);
-    }
+    cell_t nTilesX, nTilesY;
 
     dungeon->width = width;
     dungeon->height = height;
 
-    dungeon->nPoints = 0;
-    dungeon->points = NULL;
+    nTilesX = ((cell_t)width + TILE_MASK) >> TILE_SHIFT;
+    nTilesY = ((cell_t)height + TILE_MASK) >> TILE_SHIFT;
+    dungeon->rowStride = nTilesX * TILE_CELLS;
+    dungeon->size = nTilesX * nTilesY * TILE_CELLS;
+}
 
-    generateDungeon(dungeon);
 
-    return dungeon;
+/*
+@context
+    * Allocates the walkable bits of `dungeon` with every bit clear (walls),
+      the valid moves of each cell (unless built with `PACKED_MAPS`) and the
+      connected component label of each cell (every cell a wall).
+    * The width and height of `dungeon` must be set.
+
+@parameters
+    * dungeon
+        * Dungeon to allocate navigation data of.
+*/
+static void initNavigation(dungeon_t *dungeon)
+{
+    // a column of walls either side of each row
+    dungeon->wordsPerRow = (dungeon->width + 2 + 63) / 64;
+
+    // a row of walls above and below the dungeon
+    dungeon->passable = calloc((size_t)dungeon->wordsPerRow
+                               * (dungeon->height + 2),
+                               sizeof(uint64_t));
+    assert(dungeon->passable != NULL);
+
+#ifndef PACKED_MAPS
+    dungeon->moves = malloc(sizeof(uint8_t) * (size_t)getDungeonSize(dungeon));
+    assert(dungeon->moves != NULL);
+#endif
+
+    // labels and the flood stack grow as components are found
+    dungeon->components = calloc((size_t)getDungeonSize(dungeon),
+                                 sizeof(cell_t));
+    assert(dungeon->components != NULL);
+
+    dungeon->componentSizes = NULL;
+    dungeon->freeLabels = NULL;
+    dungeon->nLabels = 0;
+    dungeon->nFreeLabels = 0;
+    dungeon->labelCapacity = 0;
+
+    dungeon->floodStack = NULL;
+    dungeon->floodCapacity = 0;
 }
 
 
 /*
 @context
-    * Frees `dungeon`.
+    * Sets the walkable bit of every tile within a rectangle of `dungeon` from
+      its map.
+    * Then recomputes the valid moves of every cell within 1 tile of the
+      rectangle (unless built with `PACKED_MAPS`).
+        * A tile is a target or corner of every move into or out of the 3x3
+          block around it.
 
 @parameters
     * dungeon
-        * Dungeon to free.
+        * Dungeon to update navigation data of.
+    * min
+        * Top left corner of rectangle (included).
+        * Assumes `min` is within `dungeon` bounds.
+    * max
+        * Bottom right corner of rectangle (included).
+        * Assumes `max` is within `dungeon` bounds.
 */
-void freeDungeon(dungeon_t *dungeon)
+static void updateNavigation(dungeon_t *dungeon,
+                             point_t    min,
+                             point_t    max)
 {
-    uint16_t x;
+    int64_t x, y;
 
-    for (x = 0; x < dungeon->width; x += 1)
+    for (y = min.y; y <= max.y; y += 1)
     {
-        free(dungeon->map[x]);
+        for (x = min.x; x <= max.x; x += 1)
+        {
+            setPassable(dungeon, initPoint(x, y));
+        }
     }
-    free(dungeon->map);
 
-    free(dungeon->points);
-    free(dungeon);
+#ifndef PACKED_MAPS
+    // moves are clipped to `dungeon` bounds
+    for (y = min.y > 0 ? min.y - 1 : 0;
+         y <= max.y + 1 && y < dungeon->height;
+         y += 1)
+    {
+        for (x = min.x > 0 ? min.x - 1 : 0;
+             x <= max.x + 1 && x < dungeon->width;
+             x += 1)
+        {
+            dungeon->moves[getDungeonIndex(dungeon, initPoint(x, y))]
+                = readMoves(dungeon, initPoint(x, y));
+        }
+    }
+#endif
 }
 
 
 /*
 @context
-    * Gets the width of `dungeon`.
+    * Reads the mask of valid moves from `point` of `dungeon` from the
+      walkable bits of the 3x3 block around it.
 
 @parameters
     * dungeon
-        * Dungeon to get width of.
+        * Dungeon to read valid moves in.
+    * point
+        * Location to read valid moves from.
+        * Assumes `point` is within `dungeon` bounds.
 
 @return
-    * Width of `dungeon`.
+    * Mask of valid moves from `point`.
 */
-uint16_t getDungeonWidth(dungeon_t *dungeon)
+static uint8_t readMoves(dungeon_t *dungeon,
+                         point_t    point)
 {
-    return dungeon->width;
+    uint8_t above, middle, below, north, east, south, west;
+
+    // bit 0 of each row is west of `point` and bit 2 east of it
+    above = getPassableBlockRow(dungeon, point.x, point.y - 1);
+    middle = getPassableBlockRow(dungeon, point.x, point.y);
+    below = getPassableBlockRow(dungeon, point.x, point.y + 1);
+
+    north = above >> 1 & 1;
+    east = middle >> 2 & 1;
+    south = below >> 1 & 1;
+    west = middle & 1;
+
+    // in the order of `MOVES` - diagonal moves need both tiles they pass by
+    // and cardinal moves pass by `point` itself so cannot leave a wall
+    return (north | east << 2 | south << 4 | west << 6) * (middle >> 1 & 1)
+         | (above >> 2 & north & east) << 1
+         | (below >> 2 & south & east) << 3
+         | (below & south & west) << 5
+         | (above & north & west) << 7;
 }
 
 
 /*
 @context
-    * Gets the height of `dungeon`.
+    * Gets the walkable bits of row `y` of `dungeon`.
+    * Bit `x + 1` of the row is the bit of point `(x, y)`.
 
 @parameters
     * dungeon
-        * Dungeon to get height of.
+        * Dungeon to get row of.
+    * y
+        * Row to get - may be 1 row outside `dungeon` bounds.
 
 @return
-    * Height of `dungeon`.
+    * First word of the row.
 */
-uint16_t getDungeonHeight(dungeon_t *dungeon)
+static uint64_t *getPassableRow(dungeon_t *dungeon,
+                                int64_t    y)
 {
-    return dungeon->height;
+    return dungeon->passable + (y + 1) * dungeon->wordsPerRow;
 }
 
 
 /*
 @context
-    * Gets tile character representation at `point` of `dungeon`.
+    * Sets the walkable bit of `point` of `dungeon` from its tile.
 
 @parameters
     * dungeon
-        * Dungeon to get tile at `point`.
+        * Dungeon to set walkable bit of.
     * point
-        * Location of tile to get.
+        * Location to set walkable bit of.
         * Assumes `point` is within `dungeon` bounds.
-
-@return
-    * Tile character representation.
 */
-char getDungeonPoint(dungeon_t *dungeon,
-                     point_t    point)
+static void setPassable(dungeon_t *dungeon,
+                        point_t    point)
 {
-    assert(point.x >= 0 && point.x < dungeon->width);
-    assert(point.y >= 0 && point.y < dungeon->height);
-    return dungeon->map[point.x][point.y];
+    uint64_t *row;
+    uint64_t bit;
+
+    row = getPassableRow(dungeon, point.y);
+    bit = (uint64_t)1 << ((point.x + 1) & 63);
+
+    if (dungeon->map[getDungeonIndex(dungeon, point)] != TILE_WALL)
+    {
+        row[(point.x + 1) >> 6] |= bit;
+    }
+    else
+    {
+        row[(point.x + 1) >> 6] &= ~bit;
+    }
 }
 
 
 /*
 @context
-    * Gets source point of `dungeon`.
+    * Checks the walkable bit of `(x, y)` of `dungeon`.
 
 @parameters
     * dungeon
-        * Dungeon to get source point of.
+        * Dungeon to check.
+    * x
+        * Column to check - may be 1 column outside `dungeon` bounds.
+    * y
+        * Row to check - may be 1 row outside `dungeon` bounds.
 
 @return
-    * Location point of `dungeon` source.
+    * Indication `(x, y)` is walkable.
 */
-point_t getDungeonSource(dungeon_t *dungeon)
+static bool isPassable(dungeon_t *dungeon,
+                       int64_t    x,
+                       int64_t    y)
 {
-    return dungeon->points[0];
+    return getPassableRow(dungeon, y)[(x + 1) >> 6] >> ((x + 1) & 63) & 1;
 }
 
 
 /*
 @context
-    * Gets target point of `dungeon`.
+    * Gets the walkable bits of `(x - 1, y)`, `(x, y)` and `(x + 1, y)` of
+      `dungeon` as bits 0, 1 and 2.
 
 @parameters
     * dungeon
-        * Dungeon to get target point of.
+        * Dungeon to get walkable bits of.
+    * x
+        * Column of the middle bit.
+        * Assumes `x` is within `dungeon` bounds.
+    * y
+        * Row of the bits - may be 1 row outside `dungeon` bounds.
 
 @return
-    * Location point of `dungeon` target.
+    * 3 walkable bits.
 */
-point_t getDungeonTarget(dungeon_t *dungeon)
+static uint8_t getPassableBlockRow(dungeon_t *dungeon,
+                                   int64_t    x,
+                                   int64_t    y)
 {
-    return dungeon->points[dungeon->nPoints - 1];
+    uint64_t *row;
+    uint64_t bits;
+    uint8_t offset;
+
+    // bit of `x - 1` is bit `x` of the row
+    row = getPassableRow(dungeon, y) + (x >> 6);
+    offset = x & 63;
+
+    bits = row[0] >> offset;
+    if (offset > 61)
+    {
+        // the 3 bits cross into the next word
+        bits |= row[1] << (64 - offset);
+    }
+
+    return bits & 7;
 }
 
 
+
 /*
 @context
-    * Sets tile character representation at `point` of `dungeon`.
+    * Labels every connected component of `dungeon` from scratch.
+    * Each walkable point not yet labelled is flooded with a new label.
+    * Used when the whole of `dungeon` changes.
 
 @parameters
     * dungeon
-        * Dungeon to set tile of at `point`.
-    * point
-        * Location of tile to set.
-        * Assumes `point` is within `dungeon` bounds.
-    * tile
-        * Character representation to set tile to.
+        * Dungeon to label components of.
 */
-void setDungeonPoint(dungeon_t *dungeon,
-                     point_t    point,
-                     char       tile)
+static void labelComponents(dungeon_t *dungeon)
 {
-    assert(point.x >= 0 && point.x < dungeon->width);
-    assert(point.y >= 0 && point.y < dungeon->height);
-    dungeon->map[point.x][point.y] = tile;
+    int64_t x, y;
+    cell_t index;
+
+    memset(dungeon->components, 0, sizeof(cell_t) * (size_t)dungeon->size);
+
+    // label 0 marks walls so is taken before any component
+    dungeon->nLabels = 0;
+    dungeon->nFreeLabels = 0;
+    newComponentLabel(dungeon);
+
+    for (y = 0; y < dungeon->height; y += 1)
+    {
+        for (x = 0; x < dungeon->width; x += 1)
+        {
+            index = getDungeonIndex(dungeon, initPoint(x, y));
+            if (isPassable(dungeon, x, y) && dungeon->components[index] == 0)
+            {
+                floodComponent(dungeon, index, newComponentLabel(dungeon));
+            }
+        }
+    }
 }
 
 
 /*
 @context
-    * Generates a new random configuration of `dungeon`.
+    * Updates the connected component labels after `point` of `dungeon`
+      changed between a wall and walkable.
+    * A new floor joins the components of the points it has a valid move to.
+        * The largest keeps its label and the others are flooded with it.
+    * A new wall is labelled `0` and its component is split if needed (see
+      `splitComponent`).
 
 @parameters
     * dungeon
-        * Dungeon to generate map for.
+        * Dungeon to update component labels of.
+    * point
+        * Location that changed.
+        * Assumes the navigation data of `dungeon` is up to date.
 */
-void generateDungeon(dungeon_t *dungeon)
+static void updateComponents(dungeon_t *dungeon,
+                             point_t    point)
 {
-    point_t source, target;
+    int i;
+    uint8_t moves;
+    cell_t index, label, neighbourLabel;
 
-    fillMap(dungeon);
+    index = getDungeonIndex(dungeon, point);
+    label = dungeon->components[index];
 
-    // draw `dungeon` map by drawing lines between points
-    generatePoints(dungeon);
-    connectPoints(dungeon);
+    if (label != 0)
+    {
+        setComponent(dungeon, index, 0);
+        splitComponent(dungeon, point, label);
+        return;
+    }
 
-    source = getDungeonSource(dungeon);
-    target = getDungeonTarget(dungeon);
+    // join the largest neighbouring component - a floor with no valid moves
+    // is a component of its own
+    moves = getDungeonMoves(dungeon, index);
+    for (i = 0; i < N_MOVES; i += 1)
+    {
+        if (!(moves >> i & 1))
+        {
+            continue;
+        }
+
+        neighbourLabel = dungeon->components[getMoveIndex(dungeon->rowStride,
+                                                          index,
+                                                          MOVES[i])];
+        if (label == 0
+            || dungeon->componentSizes[neighbourLabel]
+               > dungeon->componentSizes[label])
+        {
+            label = neighbourLabel;
+        }
+    }
+    setComponent(dungeon, index, label != 0 ? label
+                                            : newComponentLabel(dungeon));
 
-    dungeon->map[source.x][source.y] = TILE_SOURCE;
-    dungeon->map[target.x][target.y] = TILE_TARGET;
+    for (i = 0; i < N_MOVES; i += 1)
+    {
+        if (moves >> i & 1)
+        {
+            floodComponent(dungeon,
+                           getMoveIndex(dungeon->rowStride, index, MOVES[i]),
+                           dungeon->components[index]);
+        }
+    }
 }
 
 
 /*
 @context
-    * Checks if moving between 2 points in `dungeon` is valid.
-    * Points must be adjacent in 8 directional movement (`distance = 1`).
+    * Splits the component `label` that lost the walkable `point` of
+      `dungeon` if its points are no longer joined.
+    * Every move a wall at `point` blocks is between 2 of its 8 neighbours
+      (into `point` or diagonally around it).
+        * Consecutive neighbours (in the order of `MOVES`) are always a valid
+          cardinal move apart while both are walkable.
+        * So the component stays whole if the walkable neighbours of `point`
+          that were joined to it form a single run around it.
+    * Otherwise each run is flooded with a new label (runs still joined end
+      up with the same label).
+        * Costs the size of the component rather than a small neighbourhood.
 
 @parameters
     * dungeon
-        * Dungeon to check if valid move in.
-    * from
-        * Location moving from in `dungeon`.
-        * Assumes `from` is valid within `dungeon`.
-    * to
-        * Location moving to in `dungeon`.
-
-@return
-    * Indication if moving between `from` and `to` in `dungeon` is valid.
+        * Dungeon to split component of.
+    * point
+        * Location that became a wall.
+    * label
+        * Component label `point` had.
 */
-bool isValidMove(dungeon_t *dungeon,
-                 point_t    from,
-                 point_t    to)
+static void splitComponent(dungeon_t *dungeon,
+                           point_t    point,
+                           cell_t     label)
 {
-    assert(from.x >= 0 && from.x < dungeon->width);
-    assert(from.y >= 0 && from.y < dungeon->height);
+    int i, j, nRuns;
+    bool walkable[8];
+    cell_t index, runs[4];
 
-    return (distancePoints(from, to, COST, COST) == 1
+    for (i = 0; i < N_MOVES; i += 1)
+    {
+        walkable[i] = isPassable(dungeon,
+                                 point.x + MOVES[i].x,
+                                 point.y + MOVES[i].y);
+    }
 
-        // cannot move out of map bounds
-        && (to.x >= 0 && to.x < dungeon->width)
-        && (to.y >= 0 && to.y < dungeon->height)
+    // each run joined to `point` holds a cardinal neighbour (even moves) - a
+    // diagonal neighbour alone was never joined to it
+    nRuns = 0;
+    for (i = 0; i < N_MOVES; i += 2)
+    {
+        if (walkable[i]
+            && !(walkable[(i + 7) % N_MOVES] && walkable[(i + 6) % N_MOVES]))
+        {
+            runs[nRuns] = i;
+            nRuns += 1;
+        }
+    }
 
-        // cannot move into a wall
-        && dungeon->map[to.x][to.y] != TILE_WALL
+    // a run covering every neighbour has no start
+    if (nRuns <= 1)
+    {
+        return;
+    }
 
-        // diagonal movement cannot clip wall (cannot move around corners)
-        && dungeon->map[from.x][to.y] != TILE_WALL
-        && dungeon->map[to.x][from.y] != TILE_WALL);
+    for (j = 0; j < nRuns; j += 1)
+    {
+        index = getMoveIndex(dungeon->rowStride,
+                             getDungeonIndex(dungeon, point),
+                             MOVES[runs[j]]);
+        if (dungeon->components[index] == label)
+        {
+            floodComponent(dungeon, index, newComponentLabel(dungeon));
+        }
+    }
 }
 
 
-/* ------------------------------- END PUBLIC ------------------------------- */
-/* ----------------------------- START  PRIVATE ----------------------------- */
-
-
 /*
 @context
-    * Generates a uniform number between `min` and `max` (inclusive).
+    * Labels every point reachable from cell `index` of `dungeon` with
+      `label`.
+    * Points already labelled `label` are not flooded through.
 
 @parameters
-    * min
-        * Lower bounds (included).
-    * max
-        * Upper bounds (included).
-
-@return
-    * Random number between `min` and `max` (inclusive).
+    * dungeon
+        * Dungeon to flood.
+    * index
+        * Cell index to flood from.
+        * Assumes `index` is walkable.
+    * label
+        * Component label to set.
 */
-static uint16_t randInt(uint16_t min,
-                        uint16_t max)
+static void floodComponent(dungeon_t *dungeon,
+                           cell_t     index,
+                           cell_t     label)
 {
-    assert(min <= max);
-    return rand() % (max + 1 - min) + min;
+    int i;
+    uint8_t moves;
+    cell_t nStack, neighbour;
+
+    if (dungeon->components[index] == label)
+    {
+        return;
+    }
+
+    // cells are labelled when pushed so each is pushed at most once
+    setComponent(dungeon, index, label);
+    nStack = 0;
+    while (true)
+    {
+        moves = getDungeonMoves(dungeon, index);
+        for (i = 0; i < N_MOVES; i += 1)
+        {
+            if (!(moves >> i & 1))
+            {
+                continue;
+            }
+
+            neighbour = getMoveIndex(dungeon->rowStride, index, MOVES[i]);
+            if (dungeon->components[neighbour] == label)
+            {
+                continue;
+            }
+
+            if (nStack == dungeon->floodCapacity)
+            {
+                dungeon->floodCapacity = nStack > 0 ? 2 * nStack : 64;
+                dungeon->floodStack
+                    = realloc(dungeon->floodStack,
+                              sizeof(cell_t)
+                              * (size_t)dungeon->floodCapacity);
+                assert(dungeon->floodStack != NULL);
+            }
+
+            setComponent(dungeon, neighbour, label);
+            dungeon->floodStack[nStack] = neighbour;
+            nStack += 1;
+        }
+
+        if (nStack == 0)
+        {
+            break;
+        }
+        nStack -= 1;
+        index = dungeon->floodStack[nStack];
+    }
 }
 
 
 /*
 @context
-    * Fills `dungeon` map with wall tiles.
-    * Wall tiles are later cut out by floor tiles.
+    * Sets the component label of cell `index` of `dungeon` and the sizes of
+      its old and new label.
+    * A label left with no cells is kept to reuse.
 
 @parameters
     * dungeon
-        * Dungeon to fill with wall tiles.
+        * Dungeon to set component label in.
+    * index
+        * Cell index to set component label of.
+    * label
+        * Component label to set - `0` for a wall.
 */
-static void fillMap(dungeon_t *dungeon)
+static void setComponent(dungeon_t *dungeon,
+                         cell_t     index,
+                         cell_t     label)
 {
-    uint16_t x, y;
+    cell_t old;
 
-    for (x = 0; x < dungeon->width; x += 1)
+    old = dungeon->components[index];
+    if (old != 0)
     {
-        for (y = 0; y < dungeon->height; y += 1)
+        dungeon->componentSizes[old] -= 1;
+        if (dungeon->componentSizes[old] == 0)
         {
-            dungeon->map[x][y] = TILE_WALL;
+            dungeon->freeLabels[dungeon->nFreeLabels] = old;
+            dungeon->nFreeLabels += 1;
         }
     }
+
+    if (label != 0)
+    {
+        dungeon->componentSizes[label] += 1;
+    }
+    dungeon->components[index] = label;
+}
+
+
+/*
+@context
+    * Gets a component label of `dungeon` with no cells.
+    * Reuses a label left with no cells before making a new one.
+
+@parameters
+    * dungeon
+        * Dungeon to get component label of.
+
+@return
+    * Component label with no cells.
+*/
+static cell_t newComponentLabel(dungeon_t *dungeon)
+{
+    cell_t label;
+
+    if (dungeon->nFreeLabels > 0)
+    {
+        dungeon->nFreeLabels -= 1;
+        return dungeon->freeLabels[dungeon->nFreeLabels];
+    }
+
+    if (dungeon->nLabels == dungeon->labelCapacity)
+    {
+        dungeon->labelCapacity = dungeon->nLabels > 0
+                               ? 2 * dungeon->nLabels
+                               : 64;
+        dungeon->componentSizes
+            = realloc(dungeon->componentSizes,
+                      sizeof(cell_t) * (size_t)dungeon->labelCapacity);
+        assert(dungeon->componentSizes != NULL);
+        dungeon->freeLabels
+            = realloc(dungeon->freeLabels,
+                      sizeof(cell_t) * (size_t)dungeon->labelCapacity);
+        assert(dungeon->freeLabels != NULL);
+    }
+
+    label = dungeon->nLabels;
+    dungeon->componentSizes[label] = 0;
+    dungeon->nLabels += 1;
+
+    return label;
 }
 
 
@@ -419,10 +1577,10 @@ static void generatePoints(dungeon_t *dungeon)
 @return
     * A single random point.
 */
-static point_t generatePoint(uint16_t width,
-                             uint16_t height)
+static point_t generatePoint(uint32_t width,
+                             uint32_t height)
 {
-    uint16_t x, y;
+    uint32_t x, y;
 
     x = randInt(RADIUS_MAX + BORDER - 1, width - BORDER - RADIUS_MAX);
     y = randInt(RADIUS_MAX + BORDER - 1, height - BORDER - RADIUS_MAX);
@@ -448,7 +1606,7 @@ static void connectPoints(dungeon_t *dungeon)
     for (i = 0; i < dungeon->nPoints - 1; i += 1)
     {
         radius = randInt(RADIUS_MIN, RADIUS_MAX);
-        drawLine(dungeon->map,
+        drawLine(dungeon,
                  dungeon->points[i],
                  dungeon->points[i + 1],
                  radius);
@@ -464,8 +1622,8 @@ static void connectPoints(dungeon_t *dungeon)
         * Ensured during point generation.
 
 @parameters
-    * map
-        * Dungeon map to draw line in.
+    * dungeon
+        * Dungeon to draw line in.
     * start
         * Location to start drawing line.
     * end
@@ -473,10 +1631,10 @@ static void connectPoints(dungeon_t *dungeon)
     * radius
         * Radius of circle to draw at each step of line.
 */
-static void drawLine(char    **map,
-                     point_t   start,
-                     point_t   end,
-                     uint8_t   radius)
+static void drawLine(dungeon_t *dungeon,
+                     point_t    start,
+                     point_t    end,
+                     uint8_t    radius)
 {
     int32_t dx, dy, error;
     int8_t sx, sy;
@@ -497,7 +1655,7 @@ static void drawLine(char    **map,
     current = start;
     while (!isEqualPoints(current, end))
     {
-        drawCircle(map, current, radius);
+        drawCircle(dungeon, current, radius);
 
         // moves in either the x or y direction (not both at the same time)
         if (2 * error >= dy && current.x != end.x)
@@ -513,7 +1671,7 @@ static void drawLine(char    **map,
     }
 
     // draw last circle at `end` point
-    drawCircle(map, current, radius);
+    drawCircle(dungeon, current, radius);
 }
 
 
@@ -524,17 +1682,17 @@ static void drawLine(char    **map,
         * Ensured during point generation.
 
 @parameters
-    * map
-        * Dungeon map to draw circle in.
+    * dungeon
+        * Dungeon to draw circle in.
     * centre
         * Centre location to draw circle.
         * The `radius` includes `centre`.
     * radius
         * Radius of circle.
 */
-static void drawCircle(char    **map,
-                       point_t   centre,
-                       uint8_t   radius)
+static void drawCircle(dungeon_t *dungeon,
+                       point_t    centre,
+                       uint8_t    radius)
 {
     int32_t x, y;
     int8_t halfHeight;
@@ -546,7 +1704,10 @@ static void drawCircle(char    **map,
         halfHeight = round(sqrt(radius * radius - x * x)) - 1;
         for (y = -halfHeight; y <= halfHeight; y += 1)
         {
-            map[centre.x + x][centre.y + y] = TILE_FLOOR;
+            dungeon->map[getDungeonIndex(dungeon,
+                                         initPoint(centre.x + x,
+                                                   centre.y + y))]
+                = TILE_FLOOR;
         }
     }
 }
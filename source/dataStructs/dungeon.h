@@ -6,6 +6,37 @@
         * Source and target separated by `SOURCE_TARGET_SEP`.
         * Either width or height must be `>= MIN_SIZE`.
     * As a dungeon is random, setting seed in `stdlib` may change the result.
+    * A dungeon can also be initialised with given tiles (no source or
+      target).
+    * Tiles are stored in a single buffer addressed by a linear cell index.
+        * By default cells are row-major - point `(x, y)` has cell index
+          `y * width + x`.
+        * Built with `TILE_SHIFT` (`make TILED=1`) cells are laid out in
+          square tiles `1 << TILE_SHIFT` points a side (row-major within a
+          tile and tiles row-major) so neighbours in every direction are
+          usually close in memory.
+            * The dungeon is padded to whole tiles with cells outside its
+              bounds so `getDungeonSize` can be more than `width * height`.
+        * `getMoveIndex` finds the cell index of a neighbour in either layout
+          without converting to a point.
+        * Width and height must be no more than `COORD_MAX + 1` so every
+          point and cell index fits `coord_t` and `cell_t`.
+    * Walkability is also packed 1 bit per tile into rows of 64-bit words.
+        * `isDungeonWalkable` and `isValidMove` read these bits.
+    * Each cell has a mask of the moves (`MOVES`) that are valid from it.
+        * Bit `i` is set if moving by `MOVES[i]` is valid.
+        * Read from the walkable bits of the 3x3 block around the cell.
+        * Cached for each cell unless built with `PACKED_MAPS` (`make
+          PACKED=1`), which keeps navigation data to 1 bit per tile at the
+          cost of reading the bits on every lookup.
+        * Kept up to date when the dungeon is generated or a tile is set.
+    * A version counter is bumped whenever a tile is set or the dungeon is
+      generated.
+    * Each cell has a connected component label - points share a label if
+      and only if a path (under `isValidMove`) joins them.
+        * `isDungeonConnected` rejects unreachable queries in O(1).
+        * Labelled from scratch when the dungeon is generated and updated
+          incrementally when a tile is set.
 */
 
 
@@ -18,29 +49,124 @@
     #include "../dataTypes/point.h"
 
 
+    // 8 directional movement system - also the bit order of move masks
+    static const point_t MOVES[] = {
+        { 0, -1},  // north
+        { 1, -1},  // north-east
+        { 1,  0},  // east
+        { 1,  1},  // south-east
+        { 0,  1},  // south
+        {-1,  1},  // south-west
+        {-1,  0},  // west
+        {-1, -1}   // north-west
+    };
+
+    static const int N_MOVES = sizeof(MOVES) / sizeof(point_t);
+
+    // cells are laid out in square tiles `1 << TILE_SHIFT` points a side - 0
+    // lays out plain rows
+    #ifndef TILE_SHIFT
+        #define TILE_SHIFT 0
+    #endif
+
+    static const int64_t TILE_SIDE = (int64_t)1 << TILE_SHIFT;
+    static const int64_t TILE_MASK = ((int64_t)1 << TILE_SHIFT) - 1;
+    static const int64_t TILE_CELLS = (int64_t)1 << (2 * TILE_SHIFT);
+
+
     typedef struct dungeon_s dungeon_t;
 
 
-    dungeon_t *initDungeon(uint16_t width,
-                           uint16_t height);
+    dungeon_t *initDungeon(uint32_t width,
+                           uint32_t height);
+    dungeon_t *initDungeonMap(uint32_t    width,
+                              uint32_t    height,
+                              const char *tiles);
 
     void freeDungeon(dungeon_t *dungeon);
 
-    uint16_t getDungeonWidth(dungeon_t *dungeon);
-    uint16_t getDungeonHeight(dungeon_t *dungeon);
+    uint32_t getDungeonWidth(dungeon_t *dungeon);
+    uint32_t getDungeonHeight(dungeon_t *dungeon);
     char getDungeonPoint(dungeon_t *dungeon,
                          point_t    point);
+    char getDungeonCell(dungeon_t *dungeon,
+                        cell_t     index);
+    uint8_t getDungeonMoves(dungeon_t *dungeon,
+                            cell_t     index);
+    uint8_t getDungeonPointMoves(dungeon_t *dungeon,
+                                 point_t    point);
     point_t getDungeonSource(dungeon_t *dungeon);
     point_t getDungeonTarget(dungeon_t *dungeon);
 
+    cell_t getDungeonSize(dungeon_t *dungeon);
+    int64_t getDungeonRowStride(dungeon_t *dungeon);
+    uint64_t getDungeonNavigationBytes(dungeon_t *dungeon);
+    uint64_t getDungeonVersion(dungeon_t *dungeon);
+    cell_t getDungeonComponent(dungeon_t *dungeon,
+                               point_t    point);
+    cell_t getDungeonComponentSize(dungeon_t *dungeon,
+                                   point_t    point);
+    uint64_t getDungeonComponentBytes(dungeon_t *dungeon);
+    cell_t getDungeonIndex(dungeon_t *dungeon,
+                           point_t    point);
+    point_t getDungeonIndexPoint(dungeon_t *dungeon,
+                                 cell_t     index);
+
     void setDungeonPoint(dungeon_t *dungeon,
                          point_t    point,
                          char       tile);
 
     void generateDungeon(dungeon_t *dungeon);
 
+    bool isDungeonWalkable(dungeon_t *dungeon,
+                           point_t    point);
+
     bool isValidMove(dungeon_t *dungeon,
                      point_t    from,
                      point_t    to);
 
+    bool isDungeonConnected(dungeon_t *dungeon,
+                            point_t    source,
+                            point_t    target);
+
+
+    /*
+    @context
+        * Gets the cell index reached by moving from cell `index` by `move`.
+        * Defined here so searches can inline it for every neighbour.
+
+    @parameters
+        * rowStride
+            * Cell indices between a point and the point a row of tiles below
+              (`getDungeonRowStride`).
+        * index
+            * Cell index to move from.
+        * move
+            * Move to make (one of `MOVES`).
+            * Assumes the point moved to is within the dungeon bounds.
+
+    @return
+        * Cell index moved to.
+    */
+    static inline cell_t getMoveIndex(int64_t rowStride,
+                                      cell_t  index,
+                                      point_t move)
+    {
+        int64_t x, y, offset;
+
+        // position of `index` within its tile
+        x = index & TILE_MASK;
+        y = index >> TILE_SHIFT & TILE_MASK;
+
+        // leaving the tile moves to the far side of the next tile
+        offset = x + move.x >= 0 && x + move.x <= TILE_MASK
+               ? move.x
+               : move.x * (TILE_CELLS - TILE_MASK);
+        offset += y + move.y >= 0 && y + move.y <= TILE_MASK
+                ? move.y * TILE_SIDE
+                : move.y * (rowStride - TILE_MASK * TILE_SIDE);
+
+        return index + offset;
+    }
+
 #endif
@@ -0,0 +1,507 @@
+#include "heapPQ.h"
+
+#include <assert.h>
+#include <stdlib.h>
+
+
+// marks the end of the recycled handle list
+static const cell_t NONE = CELL_MAX;
+
+// number of nodes allocated when the queue is first used
+static const cell_t INITIAL_CAPACITY = 64;
+
+
+typedef struct heapNode_s heapNode_t;
+
+
+struct heapNode_s
+{
+    // sorted by priority then by insertion order - newest first
+    score_t priority;
+    uint64_t order;
+
+    point_t data;
+
+    // index into `positions` - stays the same while the node moves
+    cell_t handle;
+};
+
+struct heapPQ_s
+{
+    heapNode_t *nodes;
+    cell_t capacity;
+    cell_t size;
+
+    // index of each handle's node in `nodes` (also links the recycled list)
+    cell_t *positions;
+    cell_t handleCapacity;
+    cell_t usedHandles;
+    cell_t recycled;
+
+    uint8_t arity;
+
+    // insertion counter used to break ties between equal priorities
+    uint64_t order;
+};
+
+
+static cell_t reuseHandle(heapPQ_t *pq);
+
+static bool isBefore(heapNode_t a,
+                     heapNode_t b);
+
+static void setNode(heapPQ_t   *pq,
+                    cell_t      i,
+                    heapNode_t  node);
+static void siftUp(heapPQ_t *pq,
+                   cell_t    i);
+static void siftDown(heapPQ_t *pq,
+                     cell_t    i);
+
+
+/* ------------------------------ START PUBLIC ------------------------------ */
+
+
+/*
+@context
+    * Initialises an empty heap priority queue.
+
+@parameters
+    * arity
+        * Number of children of each heap node.
+        * Must be `>= 2`.
+
+@return
+    * Empty heap priority queue.
+*/
+heapPQ_t *initHeapPQ(uint8_t arity)
+{
+    heapPQ_t *pq;
+
+    assert(arity >= 2);
+
+    pq = malloc(sizeof(heapPQ_t));
+    assert(pq != NULL);
+
+    pq->nodes = NULL;
+    pq->capacity = 0;
+    pq->size = 0;
+
+    pq->positions = NULL;
+    pq->handleCapacity = 0;
+    pq->usedHandles = 0;
+    pq->recycled = NONE;
+    pq->arity = arity;
+    pq->order = 0;
+
+    return pq;
+}
+
+
+/*
+@context
+    * Inserts `data` into `pq` by its `priority`.
+
+@parameters
+    * pq
+        * Heap priority queue to insert `data` into.
+    * data
+        * Data to insert into `pq`.
+    * priority
+        * Sort value of `data`.
+        * Sorted in ascending order - `0` is the lowest.
+
+@return
+    * Handle of the inserted node - valid until it is removed.
+*/
+cell_t initHeapNode(heapPQ_t *pq,
+                    point_t   data,
+                    score_t   priority)
+{
+    cell_t handle;
+
+    // double the array if full
+    if (pq->size == pq->capacity)
+    {
+        pq->capacity = pq->capacity == 0 ? INITIAL_CAPACITY : pq->capacity * 2;
+        pq->nodes = realloc(pq->nodes, sizeof(heapNode_t) * pq->capacity);
+        assert(pq->nodes != NULL);
+    }
+
+    handle = reuseHandle(pq);
+
+    pq->nodes[pq->size].priority = priority;
+    pq->nodes[pq->size].order = pq->order;
+    pq->nodes[pq->size].data = data;
+    pq->nodes[pq->size].handle = handle;
+    pq->order += 1;
+
+    pq->size += 1;
+    siftUp(pq, pq->size - 1);
+
+    return handle;
+}
+
+
+/*
+@context
+    * Lowers the priority of the node of `handle` in `pq`.
+    * The node is placed in front of nodes of equal priority as if newly
+      inserted.
+
+@parameters
+    * pq
+        * Heap priority queue holding the node.
+    * handle
+        * Handle of the node returned when it was inserted.
+    * priority
+        * New sort value of the node.
+        * Must be lower than its current priority.
+*/
+void decreaseHeapNode(heapPQ_t *pq,
+                      cell_t    handle,
+                      score_t   priority)
+{
+    cell_t i;
+
+    i = pq->positions[handle];
+    assert(i < pq->size && pq->nodes[i].handle == handle);
+    assert(priority < pq->nodes[i].priority);
+
+    pq->nodes[i].priority = priority;
+    pq->nodes[i].order = pq->order;
+    pq->order += 1;
+
+    siftUp(pq, i);
+}
+
+
+/*
+@context
+    * Frees all allocated memory of `pq`.
+
+@parameters
+    * pq
+        * Heap priority queue to free.
+*/
+void freeHeapPQ(heapPQ_t *pq)
+{
+    free(pq->nodes);
+    free(pq->positions);
+    free(pq);
+}
+
+
+/*
+@context
+    * Removes the minimum priority node from `pq`.
+    * The last node replaces the root and is sifted down.
+    * The handle of the removed node is recycled by later insertions.
+
+@parameters
+    * pq
+        * Heap priority queue to remove minimum priority node from.
+        * Assumes `pq` is not empty.
+*/
+void freeMinHeapNode(heapPQ_t *pq)
+{
+    assert(pq->size > 0);
+
+    pq->positions[pq->nodes[0].handle] = pq->recycled;
+    pq->recycled = pq->nodes[0].handle;
+
+    pq->size -= 1;
+    if (pq->size > 0)
+    {
+        pq->nodes[0] = pq->nodes[pq->size];
+        siftDown(pq, 0);
+    }
+}
+
+
+/*
+@context
+    * Removes all nodes from `pq` without freeing them.
+
+@parameters
+    * pq
+        * Heap priority queue to empty.
+*/
+void clearHeapPQ(heapPQ_t *pq)
+{
+    pq->size = 0;
+    pq->order = 0;
+
+    // every handle is free again - recycled list is rebuilt as nodes are used
+    pq->usedHandles = 0;
+    pq->recycled = NONE;
+}
+
+
+/*
+@context
+    * Determines if `pq` is empty.
+
+@parameters
+    * pq
+        * Heap priority queue to check if empty.
+
+@return
+    * Indicates if `pq` is empty.
+*/
+bool isHeapPQEmpty(heapPQ_t *pq)
+{
+    return pq->size == 0;
+}
+
+
+/*
+@context
+    * Gets data of the minimum priority node from `pq`.
+
+@parameters
+    * pq
+        * Heap priority queue to get minimum priority data from.
+        * Assumes `pq` is not empty.
+
+@return
+    * Data of the minimum priority node of `pq`.
+*/
+point_t getMinHeapData(heapPQ_t *pq)
+{
+    assert(pq->size > 0);
+    return pq->nodes[0].data;
+}
+
+
+/*
+@context
+    * Gets the minimum priority of `pq`.
+
+@parameters
+    * pq
+        * Heap priority queue to get minimum priority of.
+        * Assumes `pq` is not empty.
+
+@return
+    * Minimum priority of `pq`.
+*/
+score_t getMinHeapPriority(heapPQ_t *pq)
+{
+    assert(pq->size > 0);
+    return pq->nodes[0].priority;
+}
+
+
+/*
+@context
+    * Gets the number of nodes in `pq`.
+
+@parameters
+    * pq
+        * Heap priority queue to get number of nodes of.
+
+@return
+    * Number of nodes in `pq`.
+*/
+cell_t getHeapPQSize(heapPQ_t *pq)
+{
+    return pq->size;
+}
+
+
+/*
+@context
+    * Gets the number of bytes of memory held by `pq`.
+    * Includes nodes kept for reuse.
+
+@parameters
+    * pq
+        * Heap priority queue to get memory of.
+
+@return
+    * Bytes of memory held by `pq`.
+*/
+uint64_t getHeapPQBytes(heapPQ_t *pq)
+{
+    return sizeof(heapPQ_t)
+         + sizeof(heapNode_t) * (uint64_t)pq->capacity
+         + sizeof(cell_t) * (uint64_t)pq->handleCapacity;
+}
+
+
+/* ------------------------------- END PUBLIC ------------------------------- */
+/* ----------------------------- START  PRIVATE ----------------------------- */
+
+
+/*
+@context
+    * Takes an unused handle from `pq`.
+    * Recycled handles are used first, then untouched handles, then `pq`
+      grows.
+
+@parameters
+    * pq
+        * Heap priority queue to take handle from.
+
+@return
+    * Unused handle.
+*/
+static cell_t reuseHandle(heapPQ_t *pq)
+{
+    cell_t handle;
+
+    if (pq->recycled != NONE)
+    {
+        handle = pq->recycled;
+        pq->recycled = pq->positions[handle];
+        return handle;
+    }
+
+    // double the array if full
+    if (pq->usedHandles == pq->handleCapacity)
+    {
+        pq->handleCapacity = pq->handleCapacity == 0
+            ? INITIAL_CAPACITY
+            : pq->handleCapacity * 2;
+        pq->positions = realloc(pq->positions,
+                                sizeof(cell_t) * pq->handleCapacity);
+        assert(pq->positions != NULL);
+    }
+
+    handle = pq->usedHandles;
+    pq->usedHandles += 1;
+
+    return handle;
+}
+
+
+/*
+@context
+    * Determines if node `a` is sorted before node `b`.
+    * Lower priorities come first - equal priorities newest first.
+
+@parameters
+    * a
+        * Node to compare to `b`.
+    * b
+        * Node to compare to `a`.
+
+@return
+    * Indicates if `a` is sorted before `b`.
+*/
+static bool isBefore(heapNode_t a,
+                     heapNode_t b)
+{
+    return a.priority < b.priority
+        || (a.priority == b.priority && a.order > b.order);
+}
+
+
+/*
+@context
+    * Places `node` at index `i` of `pq` and records its new position.
+
+@parameters
+    * pq
+        * Heap priority queue to place `node` in.
+    * i
+        * Index to place `node` at.
+    * node
+        * Node to place.
+*/
+static void setNode(heapPQ_t   *pq,
+                    cell_t      i,
+                    heapNode_t  node)
+{
+    pq->nodes[i] = node;
+    pq->positions[node.handle] = i;
+}
+
+
+/*
+@context
+    * Moves node `i` up `pq` until its parent is sorted before it.
+
+@parameters
+    * pq
+        * Heap priority queue holding node `i`.
+    * i
+        * Index of node to move up.
+*/
+static void siftUp(heapPQ_t *pq,
+                   cell_t    i)
+{
+    cell_t parent;
+    heapNode_t node;
+
+    node = pq->nodes[i];
+    while (i > 0)
+    {
+        parent = (i - 1) / pq->arity;
+        if (!isBefore(node, pq->nodes[parent]))
+        {
+            break;
+        }
+
+        setNode(pq, i, pq->nodes[parent]);
+        i = parent;
+    }
+    setNode(pq, i, node);
+}
+
+
+/*
+@context
+    * Moves node `i` down `pq` until it is sorted before all its children.
+
+@parameters
+    * pq
+        * Heap priority queue holding node `i`.
+    * i
+        * Index of node to move down.
+*/
+static void siftDown(heapPQ_t *pq,
+                     cell_t    i)
+{
+    cell_t child, first, last, min;
+    heapNode_t node;
+
+    node = pq->nodes[i];
+    while (true)
+    {
+        first = i * pq->arity + 1;
+        if (first >= pq->size)
+        {
+            break;
+        }
+
+        // find the child sorted first
+        last = first + pq->arity;
+        if (last > pq->size)
+        {
+            last = pq->size;
+        }
+
+        min = first;
+        for (child = first + 1; child < last; child += 1)
+        {
+            if (isBefore(pq->nodes[child], pq->nodes[min]))
+            {
+                min = child;
+            }
+        }
+
+        if (!isBefore(pq->nodes[min], node))
+        {
+            break;
+        }
+
+        setNode(pq, i, pq->nodes[min]);
+        i = min;
+    }
+    setNode(pq, i, node);
+}
+
+
+/* ------------------------------ END  PRIVATE ------------------------------ */
@@ -0,0 +1,55 @@
+/*
+@context
+    * Provides a priority queue data structure.
+    * The priority queue holds data by a priority.
+        * Sorted in ascending order where 0 is the minimum.
+        * Inserting data with priority equal to another node is inserted in
+          front of it, so equal priorities pop newest first.
+    * Can only get the minimum node and must be removed to get the next node.
+    * Inserting returns a handle so the node's priority can later be lowered
+      without inserting it again.
+        * Each handle records where its node is in the heap.
+    * Underlying structure uses an array-backed d-ary heap.
+        * Arity of 2 gives a binary heap and 4 gives a 4-ary heap.
+        * Ties are broken by an insertion counter so it pops in the same order
+          as the other priority queues.
+    * The array only grows so removed space is reused by later insertions.
+*/
+
+
+#ifndef _HEAP_PQ_H
+    #define _HEAP_PQ_H
+
+    #include <stdbool.h>
+    #include <stdint.h>
+
+    #include "../dataTypes/point.h"
+
+
+    typedef struct heapPQ_s heapPQ_t;
+
+
+    heapPQ_t *initHeapPQ(uint8_t arity);
+
+    cell_t initHeapNode(heapPQ_t *pq,
+                        point_t   data,
+                        score_t   priority);
+
+    void decreaseHeapNode(heapPQ_t *pq,
+                          cell_t    handle,
+                          score_t   priority);
+
+    void freeHeapPQ(heapPQ_t *pq);
+    void freeMinHeapNode(heapPQ_t *pq);
+
+    void clearHeapPQ(heapPQ_t *pq);
+
+    bool isHeapPQEmpty(heapPQ_t *pq);
+
+    point_t getMinHeapData(heapPQ_t *pq);
+    score_t getMinHeapPriority(heapPQ_t *pq);
+
+    cell_t getHeapPQSize(heapPQ_t *pq);
+    uint64_t getHeapPQBytes(heapPQ_t *pq);
+
+#endif
@@ -0,0 +1,460 @@
+#include "openList.h"
+
+#include <assert.h>
+#include <stdlib.h>
+
+#include "bucketPQ.h"
+#include "heapPQ.h"
+#include "pairingPQ.h"
+#include "skipPQ.h"
+
+
+// number of children of each node in the heap types
+static const uint8_t ARITY_BINARY = 2;
+static const uint8_t ARITY_QUATERNARY = 4;
+
+// name of each open list type indexed by type
+static const char *TYPE_NAMES[] = {
+    "bucket",
+    "skip",
+    "binaryHeap",
+    "quaternaryHeap",
+    "pairingHeap"
+};
+
+
+struct openList_s
+{
+    openListType_t type;
+
+    // only the priority queue matching `type` is used
+    union
+    {
+        bucketPQ_t *bucket;
+        skipPQ_t *skip;
+        heapPQ_t *heap;
+        pairingPQ_t *pairing;
+    } pq;
+};
+
+
+/* ------------------------------ START PUBLIC ------------------------------ */
+
+
+/*
+@context
+    * Initialises an empty open list of `type`.
+
+@parameters
+    * type
+        * Priority queue to use underneath the open list.
+    * spread
+        * Largest difference between the last minimum priority found and any
+          priority inserted after it.
+        * Only used by `OPEN_LIST_BUCKET` - must then be
+          `<= BUCKET_SPREAD_MAX`.
+
+@return
+    * Empty open list.
+*/
+openList_t *initOpenList(openListType_t type,
+                         score_t        spread)
+{
+    openList_t *open;
+
+    open = malloc(sizeof(openList_t));
+    assert(open != NULL);
+
+    open->type = type;
+    switch (type)
+    {
+        case OPEN_LIST_BUCKET:
+            open->pq.bucket = initBucketPQ(spread);
+            break;
+        case OPEN_LIST_SKIP:
+            open->pq.skip = initSkipPQ();
+            break;
+        case OPEN_LIST_BINARY_HEAP:
+            open->pq.heap = initHeapPQ(ARITY_BINARY);
+            break;
+        case OPEN_LIST_QUATERNARY_HEAP:
+            open->pq.heap = initHeapPQ(ARITY_QUATERNARY);
+            break;
+        case OPEN_LIST_PAIRING_HEAP:
+            open->pq.pairing = initPairingPQ();
+            break;
+        default:
+            assert(false);
+    }
+
+    return open;
+}
+
+
+/*
+@context
+    * Inserts `data` into `open` by its `priority`.
+
+@parameters
+    * open
+        * Open list to insert `data` into.
+    * data
+        * Data to insert into `open`.
+    * priority
+        * Sort value of `data`.
+        * Sorted in ascending order - `0` is the lowest.
+
+@return
+    * Handle of the inserted node - valid until it is removed.
+    * Never `OPEN_NODE_NONE`.
+*/
+cell_t initOpenNode(openList_t *open,
+                    point_t     data,
+                    score_t     priority)
+{
+    switch (open->type)
+    {
+        case OPEN_LIST_BUCKET:
+            return initBucketNode(open->pq.bucket, data, priority);
+        case OPEN_LIST_SKIP:
+            return initSkipNode(open->pq.skip, data, priority);
+        case OPEN_LIST_BINARY_HEAP:
+        case OPEN_LIST_QUATERNARY_HEAP:
+            return initHeapNode(open->pq.heap, data, priority);
+        default:
+            return initPairingNode(open->pq.pairing, data, priority);
+    }
+}
+
+
+/*
+@context
+    * Lowers the priority of the node of `handle` in `open`.
+    * The node is placed in front of nodes of equal priority as if newly
+      inserted, so every type keeps popping in the same order.
+
+@parameters
+    * open
+        * Open list holding the node.
+    * handle
+        * Handle of the node returned when it was inserted.
+        * Must not have been removed since.
+    * priority
+        * New sort value of the node.
+        * Must be lower than its current priority.
+*/
+void decreaseOpenNode(openList_t *open,
+                      cell_t      handle,
+                      score_t     priority)
+{
+    switch (open->type)
+    {
+        case OPEN_LIST_BUCKET:
+            decreaseBucketNode(open->pq.bucket, handle, priority);
+            break;
+        case OPEN_LIST_SKIP:
+            decreaseSkipNode(open->pq.skip, handle, priority);
+            break;
+        case OPEN_LIST_BINARY_HEAP:
+        case OPEN_LIST_QUATERNARY_HEAP:
+            decreaseHeapNode(open->pq.heap, handle, priority);
+            break;
+        default:
+            decreasePairingNode(open->pq.pairing, handle, priority);
+            break;
+    }
+}
+
+
+/*
+@context
+    * Frees all allocated memory of `open`.
+
+@parameters
+    * open
+        * Open list to free.
+*/
+void freeOpenList(openList_t *open)
+{
+    switch (open->type)
+    {
+        case OPEN_LIST_BUCKET:
+            freeBucketPQ(open->pq.bucket);
+            break;
+        case OPEN_LIST_SKIP:
+            freeSkipPQ(open->pq.skip);
+            break;
+        case OPEN_LIST_BINARY_HEAP:
+        case OPEN_LIST_QUATERNARY_HEAP:
+            freeHeapPQ(open->pq.heap);
+            break;
+        default:
+            freePairingPQ(open->pq.pairing);
+            break;
+    }
+
+    free(open);
+}
+
+
+/*
+@context
+    * Removes the minimum priority node from `open`.
+
+@parameters
+    * open
+        * Open list to remove minimum priority node from.
+        * Assumes `open` is not empty.
+*/
+void freeMinOpenNode(openList_t *open)
+{
+    switch (open->type)
+    {
+        case OPEN_LIST_BUCKET:
+            freeMinBucketNode(open->pq.bucket);
+            break;
+        case OPEN_LIST_SKIP:
+            freeMinSkipNode(open->pq.skip);
+            break;
+        case OPEN_LIST_BINARY_HEAP:
+        case OPEN_LIST_QUATERNARY_HEAP:
+            freeMinHeapNode(open->pq.heap);
+            break;
+        default:
+            freeMinPairingNode(open->pq.pairing);
+            break;
+    }
+}
+
+
+/*
+@context
+    * Removes all nodes from `open` keeping their memory for reuse.
+
+@parameters
+    * open
+        * Open list to empty.
+*/
+void clearOpenList(openList_t *open)
+{
+    switch (open->type)
+    {
+        case OPEN_LIST_BUCKET:
+            clearBucketPQ(open->pq.bucket);
+            break;
+        case OPEN_LIST_SKIP:
+            clearSkipPQ(open->pq.skip);
+            break;
+        case OPEN_LIST_BINARY_HEAP:
+        case OPEN_LIST_QUATERNARY_HEAP:
+            clearHeapPQ(open->pq.heap);
+            break;
+        default:
+            clearPairingPQ(open->pq.pairing);
+            break;
+    }
+}
+
+
+/*
+@context
+    * Determines if `open` is empty.
+
+@parameters
+    * open
+        * Open list to check if empty.
+
+@return
+    * Indicates if `open` is empty.
+*/
+bool isOpenListEmpty(openList_t *open)
+{
+    switch (open->type)
+    {
+        case OPEN_LIST_BUCKET:
+            return isBucketPQEmpty(open->pq.bucket);
+        case OPEN_LIST_SKIP:
+            return isSkipPQEmpty(open->pq.skip);
+        case OPEN_LIST_BINARY_HEAP:
+        case OPEN_LIST_QUATERNARY_HEAP:
+            return isHeapPQEmpty(open->pq.heap);
+        default:
+            return isPairingPQEmpty(open->pq.pairing);
+    }
+}
+
+
+/*
+@context
+    * Gets data of the minimum priority node from `open`.
+
+@parameters
+    * open
+        * Open list to get minimum priority data from.
+        * Assumes `open` is not empty.
+
+@return
+    * Data of the minimum priority node of `open`.
+*/
+point_t getMinOpenData(openList_t *open)
+{
+    switch (open->type)
+    {
+        case OPEN_LIST_BUCKET:
+            return getMinBucketData(open->pq.bucket);
+        case OPEN_LIST_SKIP:
+            return getSkipNodeData(getMinSkipNode(open->pq.skip));
+        case OPEN_LIST_BINARY_HEAP:
+        case OPEN_LIST_QUATERNARY_HEAP:
+            return getMinHeapData(open->pq.heap);
+        default:
+            return getMinPairingData(open->pq.pairing);
+    }
+}
+
+
+/*
+@context
+    * Gets the minimum priority of `open`.
+
+@parameters
+    * open
+        * Open list to get minimum priority of.
+        * Assumes `open` is not empty.
+
+@return
+    * Minimum priority of `open`.
+*/
+score_t getMinOpenPriority(openList_t *open)
+{
+    switch (open->type)
+    {
+        case OPEN_LIST_BUCKET:
+            return getMinBucketPriority(open->pq.bucket);
+        case OPEN_LIST_SKIP:
+            return getSkipNodePriority(getMinSkipNode(open->pq.skip));
+        case OPEN_LIST_BINARY_HEAP:
+        case OPEN_LIST_QUATERNARY_HEAP:
+            return getMinHeapPriority(open->pq.heap);
+        default:
+            return getMinPairingPriority(open->pq.pairing);
+    }
+}
+
+
+/*
+@context
+    * Gets the priority queue type used underneath `open`.
+
+@parameters
+    * open
+        * Open list to get type of.
+
+@return
+    * Type of `open`.
+*/
+openListType_t getOpenListType(openList_t *open)
+{
+    return open->type;
+}
+
+
+/*
+@context
+    * Gets a short name of an open list `type` (e.g. for benchmark output).
+
+@parameters
+    * type
+        * Open list type to get name of.
+
+@return
+    * Name of `type`.
+*/
+const char *getOpenListTypeName(openListType_t type)
+{
+    assert(type < N_OPEN_LIST_TYPES);
+    return TYPE_NAMES[type];
+}
+
+
+/*
+@context
+    * Gets the number of nodes in `open`.
+    * Includes stale nodes of points already closed by a search.
+
+@parameters
+    * open
+        * Open list to get number of nodes of.
+
+@return
+    * Number of nodes in `open`.
+*/
+cell_t getOpenListSize(openList_t *open)
+{
+    switch (open->type)
+    {
+        case OPEN_LIST_BUCKET:
+            return getBucketPQSize(open->pq.bucket);
+        case OPEN_LIST_SKIP:
+            return getSkipPQSize(open->pq.skip);
+        case OPEN_LIST_BINARY_HEAP:
+        case OPEN_LIST_QUATERNARY_HEAP:
+            return getHeapPQSize(open->pq.heap);
+        default:
+            return getPairingPQSize(open->pq.pairing);
+    }
+}
+
+
+/*
+@context
+    * Gets the number of bytes of memory held by `open`.
+    * Includes nodes kept for reuse.
+
+@parameters
+    * open
+        * Open list to get memory of.
+
+@return
+    * Bytes of memory held by `open`.
+*/
+uint64_t getOpenListBytes(openList_t *open)
+{
+    switch (open->type)
+    {
+        case OPEN_LIST_BUCKET:
+            return sizeof(openList_t) + getBucketPQBytes(open->pq.bucket);
+        case OPEN_LIST_SKIP:
+            return sizeof(openList_t) + getSkipPQBytes(open->pq.skip);
+        case OPEN_LIST_BINARY_HEAP:
+        case OPEN_LIST_QUATERNARY_HEAP:
+            return sizeof(openList_t) + getHeapPQBytes(open->pq.heap);
+        default:
+            return sizeof(openList_t) + getPairingPQBytes(open->pq.pairing);
+    }
+}
+
+
+/*
+@context
+    * Gets the highest skip list level reached since `open` was last cleared.
+    * Only `OPEN_LIST_SKIP` has levels.
+
+@parameters
+    * open
+        * Open list to get peak level of.
+
+@return
+    * Peak skip list level of `open` - `0` if `open` is not a skip list.
+*/
+uint8_t getOpenListPeakLevel(openList_t *open)
+{
+    if (open->type != OPEN_LIST_SKIP)
+    {
+        return 0;
+    }
+    return getSkipPQPeakLevel(open->pq.skip);
+}
+
+
+/* ------------------------------- END PUBLIC ------------------------------- */
@@ -0,0 +1,79 @@
+/*
+@context
+    * Provides a single interface over the priority queues used as an open list.
+        * Bucket queue, skip list, binary heap, 4-ary heap and pairing heap.
+    * Every type sorts by ascending priority and inserts data with priority
+      equal to another node in front of it (newest first), so all types pop
+      in the same order.
+    * The bucket queue requires priorities to never decrease and stay within a
+      spread (see `bucketPQ.h`) - the other types accept any priority.
+    * Inserting returns a handle to the node so its priority can be lowered
+      with `decreaseOpenNode` instead of inserting the data again.
+        * Handles are reused once their node is removed or the list cleared.
+    * The default type can be chosen at build time by defining
+      `OPEN_LIST_DEFAULT` (e.g. `-DOPEN_LIST_DEFAULT=OPEN_LIST_BINARY_HEAP`).
+*/
+
+
+#ifndef _OPEN_LIST_H
+    #define _OPEN_LIST_H
+
+    #include <stdbool.h>
+    #include <stdint.h>
+
+    #include "../dataTypes/point.h"
+
+
+    typedef enum openListType_e openListType_t;
+    typedef struct openList_s openList_t;
+
+
+    enum openListType_e
+    {
+        OPEN_LIST_BUCKET,
+        OPEN_LIST_SKIP,
+        OPEN_LIST_BINARY_HEAP,
+        OPEN_LIST_QUATERNARY_HEAP,
+        OPEN_LIST_PAIRING_HEAP,
+        N_OPEN_LIST_TYPES
+    };
+
+
+    #ifndef OPEN_LIST_DEFAULT
+        #define OPEN_LIST_DEFAULT OPEN_LIST_BUCKET
+    #endif
+
+
+    // never returned as a handle - marks data not in an open list
+    static const cell_t OPEN_NODE_NONE = CELL_MAX;
+
+
+    openList_t *initOpenList(openListType_t type,
+                             score_t        spread);
+
+    cell_t initOpenNode(openList_t *open,
+                        point_t     data,
+                        score_t     priority);
+
+    void decreaseOpenNode(openList_t *open,
+                          cell_t      handle,
+                          score_t     priority);
+
+    void freeOpenList(openList_t *open);
+    void freeMinOpenNode(openList_t *open);
+
+    void clearOpenList(openList_t *open);
+
+    bool isOpenListEmpty(openList_t *open);
+
+    point_t getMinOpenData(openList_t *open);
+    score_t getMinOpenPriority(openList_t *open);
+
+    openListType_t getOpenListType(openList_t *open);
+    const char *getOpenListTypeName(openListType_t type);
+
+    cell_t getOpenListSize(openList_t *open);
+    uint64_t getOpenListBytes(openList_t *open);
+    uint8_t getOpenListPeakLevel(openList_t *open);
+
+#endif
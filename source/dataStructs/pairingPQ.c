@@ -0,0 +1,532 @@
+#include "pairingPQ.h"
+
+#include <assert.h>
+#include <stdlib.h>
+
+
+// marks a missing child, sibling or root
+static const cell_t NONE = CELL_MAX;
+
+// number of nodes allocated when the queue is first used
+static const cell_t INITIAL_CAPACITY = 64;
+
+
+typedef struct pairingNode_s pairingNode_t;
+
+
+struct pairingNode_s
+{
+    // sorted by priority then by insertion order - newest first
+    score_t priority;
+    uint64_t order;
+
+    // first child and next sibling (also links the recycled list)
+    cell_t child;
+    cell_t sibling;
+
+    // previous sibling or parent if the first child - unused by the root
+    cell_t prev;
+
+    point_t data;
+};
+
+struct pairingPQ_s
+{
+    // nodes are stored by index so the array can grow without invalidation
+    pairingNode_t *nodes;
+    cell_t capacity;
+    cell_t used;
+    cell_t recycled;
+
+    cell_t root;
+    cell_t size;
+
+    // insertion counter used to break ties between equal priorities
+    uint64_t order;
+
+    // children of the removed root waiting to be merged
+    cell_t *pending;
+    cell_t pendingCapacity;
+};
+
+
+static cell_t reuseNode(pairingPQ_t *pq);
+
+static bool isBefore(pairingNode_t *a,
+                     pairingNode_t *b);
+
+static cell_t meld(pairingPQ_t *pq,
+                   cell_t       a,
+                   cell_t       b);
+static void cutNode(pairingPQ_t *pq,
+                    cell_t       node);
+static cell_t mergePairs(pairingPQ_t *pq,
+                         cell_t       first);
+
+
+/* ------------------------------ START PUBLIC ------------------------------ */
+
+
+/*
+@context
+    * Initialises an empty pairing priority queue.
+
+@return
+    * Empty pairing priority queue.
+*/
+pairingPQ_t *initPairingPQ()
+{
+    pairingPQ_t *pq;
+
+    pq = malloc(sizeof(pairingPQ_t));
+    assert(pq != NULL);
+
+    pq->nodes = NULL;
+    pq->capacity = 0;
+    pq->used = 0;
+    pq->recycled = NONE;
+
+    pq->root = NONE;
+    pq->size = 0;
+    pq->order = 0;
+
+    pq->pending = NULL;
+    pq->pendingCapacity = 0;
+
+    return pq;
+}
+
+
+/*
+@context
+    * Inserts `data` into `pq` by its `priority`.
+    * The new node is melded with the root.
+
+@parameters
+    * pq
+        * Pairing priority queue to insert `data` into.
+    * data
+        * Data to insert into `pq`.
+    * priority
+        * Sort value of `data`.
+        * Sorted in ascending order - `0` is the lowest.
+
+@return
+    * Handle of the inserted node - valid until it is removed.
+*/
+cell_t initPairingNode(pairingPQ_t *pq,
+                       point_t      data,
+                       score_t      priority)
+{
+    cell_t node;
+
+    node = reuseNode(pq);
+    pq->nodes[node].priority = priority;
+    pq->nodes[node].order = pq->order;
+    pq->nodes[node].child = NONE;
+    pq->nodes[node].sibling = NONE;
+    pq->nodes[node].data = data;
+    pq->order += 1;
+
+    pq->root = pq->root == NONE ? node : meld(pq, pq->root, node);
+    pq->size += 1;
+
+    return node;
+}
+
+
+/*
+@context
+    * Lowers the priority of the node of `handle` in `pq`.
+    * The node is placed in front of nodes of equal priority as if newly
+      inserted.
+    * Unless it is the root, the node's subtree is cut from its parent and
+      melded with the root.
+
+@parameters
+    * pq
+        * Pairing priority queue holding the node.
+    * handle
+        * Handle of the node returned when it was inserted.
+    * priority
+        * New sort value of the node.
+        * Must be lower than its current priority.
+*/
+void decreasePairingNode(pairingPQ_t *pq,
+                         cell_t       handle,
+                         score_t      priority)
+{
+    assert(priority < pq->nodes[handle].priority);
+
+    pq->nodes[handle].priority = priority;
+    pq->nodes[handle].order = pq->order;
+    pq->order += 1;
+
+    if (handle != pq->root)
+    {
+        cutNode(pq, handle);
+        pq->root = meld(pq, pq->root, handle);
+    }
+}
+
+
+/*
+@context
+    * Frees all allocated memory of `pq`.
+
+@parameters
+    * pq
+        * Pairing priority queue to free.
+*/
+void freePairingPQ(pairingPQ_t *pq)
+{
+    free(pq->nodes);
+    free(pq->pending);
+    free(pq);
+}
+
+
+/*
+@context
+    * Removes the minimum priority node (root) from `pq`.
+    * The root's children are merged with the two-pass pairing strategy.
+
+@parameters
+    * pq
+        * Pairing priority queue to remove minimum priority node from.
+        * Assumes `pq` is not empty.
+*/
+void freeMinPairingNode(pairingPQ_t *pq)
+{
+    cell_t root;
+
+    assert(pq->size > 0);
+
+    root = pq->root;
+    pq->root = mergePairs(pq, pq->nodes[root].child);
+
+    pq->nodes[root].sibling = pq->recycled;
+    pq->recycled = root;
+    pq->size -= 1;
+}
+
+
+/*
+@context
+    * Removes all nodes from `pq` without freeing them.
+    * Removed nodes are recycled by later insertions.
+
+@parameters
+    * pq
+        * Pairing priority queue to empty.
+*/
+void clearPairingPQ(pairingPQ_t *pq)
+{
+    pq->used = 0;
+    pq->recycled = NONE;
+
+    pq->root = NONE;
+    pq->size = 0;
+    pq->order = 0;
+}
+
+
+/*
+@context
+    * Determines if `pq` is empty.
+
+@parameters
+    * pq
+        * Pairing priority queue to check if empty.
+
+@return
+    * Indicates if `pq` is empty.
+*/
+bool isPairingPQEmpty(pairingPQ_t *pq)
+{
+    return pq->size == 0;
+}
+
+
+/*
+@context
+    * Gets data of the minimum priority node from `pq`.
+
+@parameters
+    * pq
+        * Pairing priority queue to get minimum priority data from.
+        * Assumes `pq` is not empty.
+
+@return
+    * Data of the minimum priority node of `pq`.
+*/
+point_t getMinPairingData(pairingPQ_t *pq)
+{
+    assert(pq->size > 0);
+    return pq->nodes[pq->root].data;
+}
+
+
+/*
+@context
+    * Gets the minimum priority of `pq`.
+
+@parameters
+    * pq
+        * Pairing priority queue to get minimum priority of.
+        * Assumes `pq` is not empty.
+
+@return
+    * Minimum priority of `pq`.
+*/
+score_t getMinPairingPriority(pairingPQ_t *pq)
+{
+    assert(pq->size > 0);
+    return pq->nodes[pq->root].priority;
+}
+
+
+/*
+@context
+    * Gets the number of nodes in `pq`.
+
+@parameters
+    * pq
+        * Pairing priority queue to get number of nodes of.
+
+@return
+    * Number of nodes in `pq`.
+*/
+cell_t getPairingPQSize(pairingPQ_t *pq)
+{
+    return pq->size;
+}
+
+
+/*
+@context
+    * Gets the number of bytes of memory held by `pq`.
+    * Includes nodes kept for reuse.
+
+@parameters
+    * pq
+        * Pairing priority queue to get memory of.
+
+@return
+    * Bytes of memory held by `pq`.
+*/
+uint64_t getPairingPQBytes(pairingPQ_t *pq)
+{
+    return sizeof(pairingPQ_t)
+         + sizeof(pairingNode_t) * (uint64_t)pq->capacity
+         + sizeof(cell_t) * (uint64_t)pq->pendingCapacity;
+}
+
+
+/* ------------------------------- END PUBLIC ------------------------------- */
+/* ----------------------------- START  PRIVATE ----------------------------- */
+
+
+/*
+@context
+    * Takes an unused node from `pq`.
+    * Recycled nodes are used first, then untouched nodes, then `pq` grows.
+
+@parameters
+    * pq
+        * Pairing priority queue to take node from.
+
+@return
+    * Index of an unused node.
+*/
+static cell_t reuseNode(pairingPQ_t *pq)
+{
+    cell_t node;
+
+    if (pq->recycled != NONE)
+    {
+        node = pq->recycled;
+        pq->recycled = pq->nodes[node].sibling;
+        return node;
+    }
+
+    // double the array if full
+    if (pq->used == pq->capacity)
+    {
+        pq->capacity = pq->capacity == 0 ? INITIAL_CAPACITY : pq->capacity * 2;
+        pq->nodes = realloc(pq->nodes, sizeof(pairingNode_t) * pq->capacity);
+        assert(pq->nodes != NULL);
+    }
+
+    node = pq->used;
+    pq->used += 1;
+
+    return node;
+}
+
+
+/*
+@context
+    * Determines if node `a` is sorted before node `b`.
+    * Lower priorities come first - equal priorities newest first.
+
+@parameters
+    * a
+        * Node to compare to `b`.
+    * b
+        * Node to compare to `a`.
+
+@return
+    * Indicates if `a` is sorted before `b`.
+*/
+static bool isBefore(pairingNode_t *a,
+                     pairingNode_t *b)
+{
+    return a->priority < b->priority
+        || (a->priority == b->priority && a->order > b->order);
+}
+
+
+/*
+@context
+    * Melds 2 heaps by making the root sorted last the first child of the
+      other.
+
+@parameters
+    * pq
+        * Pairing priority queue holding both heaps.
+    * a
+        * Root of heap to meld with `b`.
+    * b
+        * Root of heap to meld with `a`.
+
+@return
+    * Root of the melded heap.
+*/
+static cell_t meld(pairingPQ_t *pq,
+                   cell_t       a,
+                   cell_t       b)
+{
+    cell_t swap;
+
+    if (isBefore(&pq->nodes[b], &pq->nodes[a]))
+    {
+        swap = a;
+        a = b;
+        b = swap;
+    }
+
+    pq->nodes[b].sibling = pq->nodes[a].child;
+    pq->nodes[b].prev = a;
+    if (pq->nodes[a].child != NONE)
+    {
+        pq->nodes[pq->nodes[a].child].prev = b;
+    }
+    pq->nodes[a].child = b;
+
+    return a;
+}
+
+
+/*
+@context
+    * Disconnects the subtree of `node` from its parent and siblings.
+
+@parameters
+    * pq
+        * Pairing priority queue holding `node`.
+    * node
+        * Root of subtree to disconnect.
+        * Must not be the root of `pq`.
+*/
+static void cutNode(pairingPQ_t *pq,
+                    cell_t       node)
+{
+    cell_t prev, sibling;
+
+    prev = pq->nodes[node].prev;
+    sibling = pq->nodes[node].sibling;
+
+    if (pq->nodes[prev].child == node)
+    {
+        pq->nodes[prev].child = sibling;
+    }
+    else
+    {
+        pq->nodes[prev].sibling = sibling;
+    }
+
+    if (sibling != NONE)
+    {
+        pq->nodes[sibling].prev = prev;
+    }
+    pq->nodes[node].sibling = NONE;
+}
+
+
+/*
+@context
+    * Merges a list of sibling heaps into a single heap.
+    * First pass melds adjacent pairs left to right, second pass melds the
+      pairs right to left.
+
+@parameters
+    * pq
+        * Pairing priority queue holding the sibling heaps.
+    * first
+        * Root of the first sibling heap.
+
+@return
+    * Root of the merged heap or `NONE` if there are no siblings.
+*/
+static cell_t mergePairs(pairingPQ_t *pq,
+                         cell_t       first)
+{
+    cell_t a, b, root, nPending;
+
+    // first pass - meld adjacent pairs and remember each result
+    nPending = 0;
+    while (first != NONE)
+    {
+        a = first;
+        b = pq->nodes[a].sibling;
+        first = b == NONE ? NONE : pq->nodes[b].sibling;
+
+        pq->nodes[a].sibling = NONE;
+        if (b != NONE)
+        {
+            pq->nodes[b].sibling = NONE;
+            a = meld(pq, a, b);
+        }
+
+        if (nPending == pq->pendingCapacity)
+        {
+            pq->pendingCapacity = pq->pendingCapacity == 0
+                ? INITIAL_CAPACITY
+                : pq->pendingCapacity * 2;
+            pq->pending = realloc(pq->pending,
+                                  sizeof(cell_t) * pq->pendingCapacity);
+            assert(pq->pending != NULL);
+        }
+        pq->pending[nPending] = a;
+        nPending += 1;
+    }
+
+    if (nPending == 0)
+    {
+        return NONE;
+    }
+
+    // second pass - meld the pairs from right to left
+    root = pq->pending[nPending - 1];
+    while (nPending > 1)
+    {
+        nPending -= 1;
+        root = meld(pq, pq->pending[nPending - 1], root);
+    }
+
+    return root;
+}
+
+
+/* ------------------------------ END  PRIVATE ------------------------------ */
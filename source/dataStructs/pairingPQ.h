@@ -0,0 +1,54 @@
+/*
+@context
+    * Provides a priority queue data structure.
+    * The priority queue holds data by a priority.
+        * Sorted in ascending order where 0 is the minimum.
+        * Inserting data with priority equal to another node is inserted in
+          front of it, so equal priorities pop newest first.
+    * Can only get the minimum node and must be removed to get the next node.
+    * Underlying structure uses a pairing heap.
+        * Inserting is O(1) and removing the minimum is O(log n) amortised.
+        * Ties are broken by an insertion counter so it pops in the same order
+          as the other priority queues.
+    * Removed nodes are recycled by later insertions instead of being freed.
+    * Inserting returns a handle so the node's priority can later be lowered
+      without inserting it again.
+*/
+
+
+#ifndef _PAIRING_PQ_H
+    #define _PAIRING_PQ_H
+
+    #include <stdbool.h>
+    #include <stdint.h>
+
+    #include "../dataTypes/point.h"
+
+
+    typedef struct pairingPQ_s pairingPQ_t;
+
+
+    pairingPQ_t *initPairingPQ();
+
+    cell_t initPairingNode(pairingPQ_t *pq,
+                           point_t      data,
+                           score_t      priority);
+
+    void decreasePairingNode(pairingPQ_t *pq,
+                             cell_t       handle,
+                             score_t      priority);
+
+    void freePairingPQ(pairingPQ_t *pq);
+    void freeMinPairingNode(pairingPQ_t *pq);
+
+    void clearPairingPQ(pairingPQ_t *pq);
+
+    bool isPairingPQEmpty(pairingPQ_t *pq);
+
+    point_t getMinPairingData(pairingPQ_t *pq);
+    score_t getMinPairingPriority(pairingPQ_t *pq);
+
+    cell_t getPairingPQSize(pairingPQ_t *pq);
+    uint64_t getPairingPQBytes(pairingPQ_t *pq);
+
+#endif
@@ -0,0 +1,189 @@
+#include "searchGrid.h"
+
+#include <assert.h>
+#include <stdlib.h>
+
+
+struct searchGrid_s
+{
+    pointData_t *points;
+    cell_t nCells;
+
+    uint32_t generation;
+};
+
+
+static void clearPoints(searchGrid_t *grid);
+
+
+/* ------------------------------ START PUBLIC ------------------------------ */
+
+
+/*
+@context
+    * Initialises a search grid covering a dungeon of `nCells` cells.
+    * All points are stored in a single allocation indexed by cell index.
+
+@parameters
+    * nCells
+        * Number of cells of dungeon.
+
+@return
+    * Search grid with every point in its initial state.
+*/
+searchGrid_t *initSearchGrid(cell_t nCells)
+{
+    searchGrid_t *grid;
+
+    grid = malloc(sizeof(searchGrid_t));
+    assert(grid != NULL);
+
+    grid->points = malloc(sizeof(pointData_t) * (size_t)nCells);
+    assert(grid->points != NULL);
+
+    grid->nCells = nCells;
+
+    // generation 0 is never used so every point starts out of date
+    grid->generation = 1;
+    clearPoints(grid);
+
+    return grid;
+}
+
+
+/*
+@context
+    * Frees `grid`.
+
+@parameters
+    * grid
+        * Search grid to free.
+*/
+void freeSearchGrid(searchGrid_t *grid)
+{
+    free(grid->points);
+    free(grid);
+}
+
+
+/*
+@context
+    * Resets every point of `grid` to its initial state in O(1).
+    * Points are only rewritten when next accessed.
+
+@parameters
+    * grid
+        * Search grid to reset.
+*/
+void resetSearchGrid(searchGrid_t *grid)
+{
+    grid->generation += 1;
+
+    // generation wrapped around - old stamps could be mistaken as current
+    if (grid->generation == 0)
+    {
+        grid->generation = 1;
+        clearPoints(grid);
+    }
+}
+
+
+/*
+@context
+    * Gets the search state of cell `index` in `grid`.
+    * If the cell was last written before the latest reset it is reset first.
+        * G-score starts at the max distance possible.
+        * It starts outside the open list.
+
+@parameters
+    * grid
+        * Search grid to get cell from.
+    * index
+        * Cell index of search state to get.
+        * Assumes `index` is within `grid` bounds.
+
+@return
+    * Search state of cell `index` - can be modified in place.
+*/
+pointData_t *getSearchGridCell(searchGrid_t *grid,
+                               cell_t        index)
+{
+    pointData_t *pointData;
+
+    assert(index < grid->nCells);
+
+    pointData = &grid->points[index];
+    if (pointData->generation != grid->generation)
+    {
+        pointData->gScore = SCORE_MAX;
+        pointData->openNode = OPEN_NODE_NONE;
+        pointData->isClosed = false;
+        pointData->generation = grid->generation;
+    }
+
+    return pointData;
+}
+
+
+/*
+@context
+    * Inserts a point into `open` or lowers its priority if already there.
+    * Keeps each point in `open` at most once.
+
+@parameters
+    * pointData
+        * Search state of the point - must not be closed.
+    * open
+        * Open list to insert the point into.
+        * Must be the open list all points of the grid are inserted into.
+    * data
+        * Location of the point.
+    * priority
+        * Sort value of the point.
+        * Must be lower than its current priority if already in `open`.
+
+@return
+    * Indicates the point was newly inserted rather than lowered.
+*/
+bool openSearchGridCell(pointData_t *pointData,
+                        openList_t  *open,
+                        point_t      data,
+                        score_t      priority)
+{
+    assert(!pointData->isClosed);
+
+    if (pointData->openNode == OPEN_NODE_NONE)
+    {
+        pointData->openNode = initOpenNode(open, data, priority);
+        return true;
+    }
+
+    decreaseOpenNode(open, pointData->openNode, priority);
+    return false;
+}
+
+
+/* ------------------------------- END PUBLIC ------------------------------- */
+/* ----------------------------- START  PRIVATE ----------------------------- */
+
+
+/*
+@context
+    * Marks every point of `grid` as out of date.
+
+@parameters
+    * grid
+        * Search grid to clear.
+*/
+static void clearPoints(searchGrid_t *grid)
+{
+    cell_t i;
+
+    for (i = 0; i < grid->nCells; i += 1)
+    {
+        grid->points[i].generation = 0;
+    }
+}
+
+
+/* ------------------------------ END  PRIVATE ------------------------------ */
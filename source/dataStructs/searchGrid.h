@@ -0,0 +1,57 @@
+/*
+@context
+    * Provides a grid holding the search state of each point within a dungeon.
+    * Points are addressed by the cell index of the dungeon they belong to.
+    * The grid is allocated once and reused between searches.
+        * Resetting the grid is O(1) - each point is stamped with the
+          generation it was last written in.
+        * Points from an older generation are lazily reset when next accessed.
+    * Each point remembers its open list node so it is only ever in the open
+      list once - a shorter path lowers the node's priority instead.
+*/
+
+
+#ifndef _SEARCH_GRID_H
+    #define _SEARCH_GRID_H
+
+    #include <stdbool.h>
+    #include <stdint.h>
+
+    #include "openList.h"
+    #include "../dataTypes/point.h"
+
+
+    typedef struct pointData_s pointData_t;
+    typedef struct searchGrid_s searchGrid_t;
+
+
+    struct pointData_s
+    {
+        // cell index of the point before this one on the path
+        cell_t prev;
+        score_t gScore;
+
+        // handle of the point's open list node - `OPEN_NODE_NONE` if never
+        // inserted (only valid while the point is not closed)
+        cell_t openNode;
+
+        uint32_t generation;
+        bool isClosed;
+    };
+
+
+    searchGrid_t *initSearchGrid(cell_t nCells);
+
+    void freeSearchGrid(searchGrid_t *grid);
+
+    void resetSearchGrid(searchGrid_t *grid);
+
+    pointData_t *getSearchGridCell(searchGrid_t *grid,
+                                   cell_t        index);
+
+    bool openSearchGridCell(pointData_t *pointData,
+                            openList_t  *open,
+                            point_t      data,
+                            score_t      priority);
+
+#endif
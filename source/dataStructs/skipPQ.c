@@ -1,36 +1,99 @@
 #include "skipPQ.h"
 
 #include <assert.h>
+#include <stddef.h>
 #include <stdlib.h>
 
 
 static const double PROB = 0.5;
 static const int NEXT = 0;
 
+// starting state of each queue's random number generator (must not be 0)
+static const uint32_t RANDOM_SEED = 7907;
+
+// highest level a node can have - also the number of recycled node lists
+#define MAX_LEVEL 32
+
+// words (node pointers) in the first slab - each later slab doubles in size
+static const uint32_t SLAB_WORDS = 4096;
+
+// number of handles allocated when the queue is first used
+static const cell_t INITIAL_HANDLES = 64;
+
 
 struct skipNode_s
 {
-    skipNode_t **forward;
     uint8_t level;
 
-    uint32_t priority;
+    score_t priority;
 
     point_t data;
+
+    // index into the handle table of its queue - kept while recycled
+    cell_t handle;
+
+    // stored inline - sized for `level` skips
+    skipNode_t *forward[];
 };
 
+// block of memory nodes are carved from - freed only with its queue
+typedef struct slab_s
+{
+    struct slab_s *next;
+
+    // words carved into nodes and total words of `memory`
+    uint32_t used;
+    uint32_t capacity;
+
+    skipNode_t *memory[];
+} slab_t;
+
 struct skipPQ_s
 {
     skipNode_t *head;
+
+    // slabs in order of allocation - nodes are carved from `slab` onwards
+    slab_t *slabs;
+    slab_t *slab;
+
+    // freed nodes kept for reuse - `recycled[i]` holds nodes of level `i + 1`
+    skipNode_t *recycled[MAX_LEVEL];
+
+    // node of each handle - one per node carved since the slabs were reset
+    skipNode_t **handles;
+    cell_t handleCapacity;
+    cell_t nHandles;
+
+    // xorshift state - kept per queue so queues can be used on many threads
+    uint32_t random;
+
+    cell_t size;
+
+    // highest level of a node inserted since `pq` was last emptied by a clear
+    uint8_t peakLevel;
+
+    // memory held by `pq` including all slabs
+    uint64_t bytes;
 };
 
 
-static uint8_t randLevel();
+static uint8_t randLevel(skipPQ_t *pq);
 
-static skipNode_t *initNode(point_t  data,
-                            uint32_t priority,
-                            uint8_t  level);
+static slab_t *initSlab(uint32_t capacity);
+static skipNode_t *initNode(skipPQ_t *pq,
+                            point_t   data,
+                            score_t   priority,
+                            uint8_t   level);
+static skipNode_t *reuseNode(skipPQ_t *pq,
+                             point_t   data,
+                             score_t   priority,
+                             uint8_t   level);
+static void recycleNode(skipPQ_t   *pq,
+                        skipNode_t *node);
 static void connectNode(skipPQ_t   *pq,
                         skipNode_t *node);
+static void disconnectNode(skipPQ_t   *pq,
+                           skipNode_t *node);
 
 static void updatePQLevel(skipPQ_t *pq,
                           uint8_t   newLevel);
@@ -46,21 +109,51 @@ static void updatePQLevel(skipPQ_t *pq,
         * Its level is constantly updated to be equal to the highest level.
         * It has the lowest priority so it is always at the top of the queue.
         * It is skipped over when getting the min node.
+        * Its forward array is sized for `MAX_LEVEL` so it is never resized.
+        * It is allocated on its own so it outlives resets of the slabs.
+    * Other nodes are carved from slabs owned by the queue.
 
 @return
     * Empty skip priority queue.
 */
 skipPQ_t *initSkipPQ()
 {
+    uint8_t i;
     skipPQ_t *pq;
 
     pq = malloc(sizeof(skipPQ_t));
     assert(pq != NULL);
 
     // head node has no data and has minimum priority (0)
-    pq->head = initNode(initPoint(0, 0), 0, 1);
+    pq->head = malloc(sizeof(skipNode_t) + sizeof(skipNode_t*) * MAX_LEVEL);
+    assert(pq->head != NULL);
+    pq->head->level = 1;
+    pq->head->priority = 0;
+    pq->head->data = initPoint(0, 0);
     pq->head->forward[NEXT] = NULL;
 
+    pq->slabs = initSlab(SLAB_WORDS);
+    pq->slab = pq->slabs;
+
+    pq->handles = NULL;
+    pq->handleCapacity = 0;
+    pq->nHandles = 0;
+
+    for (i = 0; i < MAX_LEVEL; i += 1)
+    {
+        pq->recycled[i] = NULL;
+    }
+
+    pq->random = RANDOM_SEED;
+
+    pq->size = 0;
+    pq->peakLevel = 1;
+    pq->bytes = sizeof(skipPQ_t)
+              + sizeof(skipNode_t)
+              + sizeof(skipNode_t*) * MAX_LEVEL
+              + sizeof(slab_t)
+              + sizeof(skipNode_t*) * SLAB_WORDS;
+
     return pq;
 }
 
@@ -77,16 +170,19 @@ skipPQ_t *initSkipPQ()
     * priority
         * Sort value of `data`.
         * Sorted in ascending order - `0` is the lowest.
+
+@return
+    * Handle of the inserted node - valid until it is removed.
 */
-void initSkipNode(skipPQ_t *pq,
-                  point_t   data,
-                  uint32_t  priority)
+cell_t initSkipNode(skipPQ_t *pq,
+                    point_t   data,
+                    score_t   priority)
 {
     uint8_t level;
     skipNode_t *node;
 
-    level = randLevel();
-    node = initNode(data, priority, level);
+    level = randLevel(pq);
+    node = reuseNode(pq, data, priority, level);
 
     // increase `pq` head node level to match `level` if higher than it
     if (level > pq->head->level)
@@ -95,12 +191,59 @@ void initSkipNode(skipPQ_t *pq,
     }
 
     connectNode(pq, node);
+
+    pq->size += 1;
+    if (level > pq->peakLevel)
+    {
+        pq->peakLevel = level;
+    }
+
+    return node->handle;
+}
+
+
+/*
+@context
+    * Lowers the priority of the node of `handle` in `pq`.
+    * The node is disconnected and connected again by its new priority, in
+      front of nodes of equal priority as if newly inserted.
+
+@parameters
+    * pq
+        * Skip priority queue holding the node.
+    * handle
+        * Handle of the node returned when it was inserted.
+    * priority
+        * New sort value of the node.
+        * Must be lower than its current priority.
+*/
+void decreaseSkipNode(skipPQ_t *pq,
+                      cell_t    handle,
+                      score_t   priority)
+{
+    skipNode_t *node;
+
+    assert(handle < pq->nHandles);
+    node = pq->handles[handle];
+    assert(priority < node->priority);
+
+    disconnectNode(pq, node);
+    node->priority = priority;
+
+    // head node level may have dropped below `node` level when disconnected
+    if (node->level > pq->head->level)
+    {
+        updatePQLevel(pq, node->level);
+    }
+
+    connectNode(pq, node);
 }
 
 
 /*
 @context
     * Frees all allocated memory of `pq`.
+    * Nodes are freed with the slabs they were carved from.
 
 @parameters
     * pq
@@ -108,24 +251,58 @@ void initSkipNode(skipPQ_t *pq,
 */
 void freeSkipPQ(skipPQ_t *pq)
 {
-    skipNode_t *prev;
-    skipNode_t *current;
+    slab_t *prev;
+    slab_t *current;
 
-    // linearly traverse `pq` and free all nodes
-    current = pq->head;
+    current = pq->slabs;
     while (current != NULL)
     {
         prev = current;
-        current = current->forward[NEXT];
-
-        free(prev->forward);
+        current = current->next;
         free(prev);
     }
 
+    free(pq->handles);
+    free(pq->head);
     free(pq);
 }
 
 
+/*
+@context
+    * Removes all nodes from `pq` without freeing them.
+    * Resets the slabs in one step instead of visiting each node.
+        * Slabs are kept and carved again by later insertions.
+
+@parameters
+    * pq
+        * Skip priority queue to empty.
+*/
+void clearSkipPQ(skipPQ_t *pq)
+{
+    uint8_t i;
+    slab_t *current;
+
+    for (current = pq->slabs; current != NULL; current = current->next)
+    {
+        current->used = 0;
+    }
+    pq->slab = pq->slabs;
+    pq->nHandles = 0;
+
+    for (i = 0; i < MAX_LEVEL; i += 1)
+    {
+        pq->recycled[i] = NULL;
+    }
+
+    pq->head->forward[NEXT] = NULL;
+    pq->head->level = 1;
+
+    pq->size = 0;
+    pq->peakLevel = 1;
+}
+
+
 /*
 @context
     * Frees the minimum priority node from `pq`.
@@ -164,8 +341,8 @@ void freeMinSkipNode(skipPQ_t *pq)
         updatePQLevel(pq, newLevel);
     }
 
-    free(node->forward);
-    free(node);
+    recycleNode(pq, node);
+    pq->size -= 1;
 }
 
 
@@ -234,12 +411,67 @@ point_t getSkipNodeData(skipNode_t *node)
 @return
     * Priority of `node`.
 */
-uint32_t getSkipNodePriority(skipNode_t *node)
+score_t getSkipNodePriority(skipNode_t *node)
 {
     return node->priority;
 }
 
 
+/*
+@context
+    * Gets the number of nodes in `pq`.
+    * Does not include the head node.
+
+@parameters
+    * pq
+        * Skip priority queue to get number of nodes of.
+
+@return
+    * Number of nodes in `pq`.
+*/
+cell_t getSkipPQSize(skipPQ_t *pq)
+{
+    return pq->size;
+}
+
+
+/*
+@context
+    * Gets the number of bytes of memory held by `pq`.
+    * Includes the head node, the handle table and every slab whether carved
+      or not.
+
+@parameters
+    * pq
+        * Skip priority queue to get memory of.
+
+@return
+    * Bytes of memory held by `pq`.
+*/
+uint64_t getSkipPQBytes(skipPQ_t *pq)
+{
+    return pq->bytes + sizeof(skipNode_t*) * (uint64_t)pq->handleCapacity;
+}
+
+
+/*
+@context
+    * Gets the highest level of a node inserted into `pq` since it was
+      created or last cleared.
+
+@parameters
+    * pq
+        * Skip priority queue to get peak level of.
+
+@return
+    * Peak level of `pq` - `1` if no node has been inserted.
+*/
+uint8_t getSkipPQPeakLevel(skipPQ_t *pq)
+{
+    return pq->peakLevel;
+}
+
+
 /* ------------------------------- END PUBLIC ------------------------------- */
 /* ----------------------------- START  PRIVATE ----------------------------- */
 
@@ -249,17 +481,32 @@ uint32_t getSkipNodePriority(skipNode_t *node)
     * Chooses a random level for a node.
     * P(level = l) = 1 / (PROB^l).
     * Provides tree like structure of the skip priority queue.
+    * Capped at `MAX_LEVEL`.
+    * Uses the xorshift generator of `pq` rather than `rand` so no state is
+      shared between queues.
+
+@parameters
+    * pq
+        * Skip priority queue holding the generator state.
 
 @return
     * Random positive level.
 */
-static uint8_t randLevel()
+static uint8_t randLevel(skipPQ_t *pq)
 {
     uint8_t level;
 
     level = 1;
-    while (rand() < RAND_MAX * PROB)
+    while (level < MAX_LEVEL)
     {
+        pq->random ^= pq->random << 13;
+        pq->random ^= pq->random >> 17;
+        pq->random ^= pq->random << 5;
+
+        if (pq->random >= UINT32_MAX * PROB)
+        {
+            break;
+        }
         level += 1;
     }
 
@@ -269,9 +516,40 @@ static uint8_t randLevel()
 
 /*
 @context
-    * Initialises a node.
+    * Initialises an empty slab.
 
 @parameters
+    * capacity
+        * Number of words (node pointers) nodes can be carved from.
+
+@return
+    * Slab with nothing carved from it.
+*/
+static slab_t *initSlab(uint32_t capacity)
+{
+    slab_t *slab;
+
+    slab = malloc(sizeof(slab_t) + sizeof(skipNode_t*) * capacity);
+    assert(slab != NULL);
+
+    slab->next = NULL;
+    slab->used = 0;
+    slab->capacity = capacity;
+
+    return slab;
+}
+
+
+/*
+@context
+    * Initialises a node carved from the slabs of `pq`.
+    * Moves on to the next slab when the current one is full - a slab double
+      the size of the last is allocated if there is no next slab.
+    * The node is given the next handle of `pq`.
+
+@parameters
+    * pq
+        * Skip priority queue owning the slabs.
     * data
         * Data held by node.
     * priority
@@ -284,18 +562,46 @@ static uint8_t randLevel()
     * Node with given properties.
     * Not yet connected to a skip priority queue.
 */
-static skipNode_t *initNode(point_t  data,
-                            uint32_t priority,
-                            uint8_t  level)
+static skipNode_t *initNode(skipPQ_t *pq,
+                            point_t   data,
+                            score_t   priority,
+                            uint8_t   level)
 {
+    uint32_t words;
     skipNode_t *node;
 
-    node = malloc(sizeof(skipNode_t));
-    assert(node != NULL);
+    // `skipNode_t` ends with node pointers so its size is a whole word count
+    words = sizeof(skipNode_t) / sizeof(skipNode_t*) + level;
+
+    while (pq->slab->used + words > pq->slab->capacity)
+    {
+        if (pq->slab->next == NULL)
+        {
+            pq->slab->next = initSlab(pq->slab->capacity * 2);
+            pq->bytes += sizeof(slab_t)
+                       + sizeof(skipNode_t*) * pq->slab->next->capacity;
+        }
+        pq->slab = pq->slab->next;
+    }
 
     // forward values are set later when `node` connected
-    node->forward = malloc(sizeof(skipNode_t*) * level);
-    assert(node->forward != NULL);
+    node = (skipNode_t*)(pq->slab->memory + pq->slab->used);
+    pq->slab->used += words;
+
+    // double the handle table if full
+    if (pq->nHandles == pq->handleCapacity)
+    {
+        pq->handleCapacity = pq->handleCapacity == 0
+            ? INITIAL_HANDLES
+            : pq->handleCapacity * 2;
+        pq->handles = realloc(pq->handles,
+                              sizeof(skipNode_t*) * pq->handleCapacity);
+        assert(pq->handles != NULL);
+    }
+
+    node->handle = pq->nHandles;
+    pq->handles[pq->nHandles] = node;
+    pq->nHandles += 1;
 
     node->level = level;
     node->priority = priority;
@@ -305,10 +611,69 @@ static skipNode_t *initNode(point_t  data,
 }
 
 
+/*
+@context
+    * Initialises a node reusing a recycled node of `level` if there is one.
+
+@parameters
+    * pq
+        * Skip priority queue holding recycled nodes.
+    * data
+        * Data held by node.
+    * priority
+        * Sort value of node.
+        * Sorted in ascending order - `0` is the lowest.
+    * level
+        * Level of node (forward size).
+
+@return
+    * Node with given properties.
+    * Not yet connected to a skip priority queue.
+*/
+static skipNode_t *reuseNode(skipPQ_t *pq,
+                             point_t   data,
+                             score_t   priority,
+                             uint8_t   level)
+{
+    skipNode_t *node;
+
+    node = pq->recycled[level - 1];
+    if (node == NULL)
+    {
+        return initNode(pq, data, priority, level);
+    }
+
+    pq->recycled[level - 1] = node->forward[NEXT];
+
+    node->priority = priority;
+    node->data = data;
+
+    return node;
+}
+
+
+/*
+@context
+    * Keeps a node removed from `pq` for reuse by a later insertion.
+
+@parameters
+    * pq
+        * Skip priority queue to hold recycled `node`.
+    * node
+        * Node already disconnected from `pq`.
+*/
+static void recycleNode(skipPQ_t   *pq,
+                        skipNode_t *node)
+{
+    node->forward[NEXT] = pq->recycled[node->level - 1];
+    pq->recycled[node->level - 1] = node;
+}
+
+
 /*
 @context
     * Connects `node` to `pq` by its priority.
-    * If priority equal to another node is inserted behind it.
+    * Inserted in front of nodes of equal priority so ties pop newest first.
 
 @parameters
     * pq
@@ -319,7 +684,7 @@ static skipNode_t *initNode(point_t  data,
 static void connectNode(skipPQ_t   *pq,
                         skipNode_t *node)
 {
-    int16_t i;
+    int i;
     skipNode_t *current;
 
     // traverse across `pq` stating at the top level and moving down to level 1
@@ -343,9 +708,63 @@ static void connectNode(skipPQ_t   *pq,
 }
 
 
+/*
+@context
+    * Disconnects `node` from `pq`.
+    * Nodes before `node` are found the same way it was connected, then nodes
+      of equal priority are skipped over until `node` is reached.
+    * Lowers the `pq` head node level if its top levels no longer point to a
+      node.
+
+@parameters
+    * pq
+        * Skip priority queue to disconnect `node` from.
+    * node
+        * Node connected to `pq`.
+*/
+static void disconnectNode(skipPQ_t   *pq,
+                           skipNode_t *node)
+{
+    int i;
+    uint8_t newLevel;
+    skipNode_t *current;
+
+    current = pq->head;
+    for (i = pq->head->level - 1; i >= 0; i -= 1)
+    {
+        while (current->forward[i] != NULL
+            && current->forward[i]->priority < node->priority)
+        {
+            current = current->forward[i];
+        }
+
+        // `node` is only on levels below its own - skip equal priorities to it
+        if (i < node->level)
+        {
+            while (current->forward[i] != node)
+            {
+                current = current->forward[i];
+            }
+            current->forward[i] = node->forward[i];
+        }
+    }
+
+    newLevel = pq->head->level;
+    while (newLevel > 1 && pq->head->forward[newLevel - 1] == NULL)
+    {
+        newLevel -= 1;
+    }
+    if (newLevel < pq->head->level)
+    {
+        updatePQLevel(pq, newLevel);
+    }
+}
+
+
 /*
 @context
     * Changes the `pq` head node level to `newLevel`.
+    * The head node forward array already holds `MAX_LEVEL` skips.
 
 @parameters
     * pq
@@ -357,28 +776,13 @@ static void updatePQLevel(skipPQ_t *pq,
                           uint8_t   newLevel)
 {
     uint8_t i;
-    skipNode_t **newForward;
 
-    newForward = malloc(sizeof(skipNode_t*) * newLevel);
-    assert(newForward != NULL);
-
-    // copy old forward skips to `newForward`
-    for (i = 0; i < newLevel; i += 1)
+    // if the head node has extra levels they start at NULL
+    for (i = pq->head->level; i < newLevel; i += 1)
     {
-        // if `newForward` has less levels then the top levels are pruned
-        if (i < pq->head->level)
-        {
-            newForward[i] = pq->head->forward[i];
-        }
-        // if `newForward` has extra levels they start at NULL
-        else
-        {
-            newForward[i] = NULL;
-        }
+        pq->head->forward[i] = NULL;
     }
 
-    free(pq->head->forward);
-    pq->head->forward = newForward;
     pq->head->level = newLevel;
 }
 
@@ -3,12 +3,20 @@
     * Provides a priority queue data structure.
     * The priority queue holds data by a priority.
         * Sorted in ascending order where 0 is the minimum.
-        * Inserting data with priority equal to another node is inserted behind
-          it.
+        * Inserting data with priority equal to another node is inserted in
+          front of it, so equal priorities pop newest first.
     * Can only get the minimum node and must be removed to get the next node.
+    * Nodes are carved from slabs of memory owned by the queue.
+        * Removed nodes are recycled by later insertions instead of being
+          freed.
+        * Clearing the queue resets its slabs in one step and freeing the
+          queue frees only its slabs.
+    * Inserting returns a handle so the node's priority can later be lowered
+      without inserting it again.
+        * Each handle maps to its node through a table held by the queue.
     * Underlying structure uses a skip list.
-        * As a skip list is probabilistic, setting seed in `stdlib` may change
-          the result.
+        * Node levels are random but each queue has its own generator, so
+          queues do not share state and can be used on separate threads.
 */
 
 
@@ -27,17 +35,27 @@
 
     skipPQ_t *initSkipPQ();
 
-    void initSkipNode(skipPQ_t *pq,
-                      point_t   data,
-                      uint32_t  priority);
+    cell_t initSkipNode(skipPQ_t *pq,
+                        point_t   data,
+                        score_t   priority);
+
+    void decreaseSkipNode(skipPQ_t *pq,
+                          cell_t    handle,
+                          score_t   priority);
 
     void freeSkipPQ(skipPQ_t *pq);
     void freeMinSkipNode(skipPQ_t *pq);
 
+    void clearSkipPQ(skipPQ_t *pq);
+
     bool isSkipPQEmpty(skipPQ_t *pq);
 
     skipNode_t *getMinSkipNode(skipPQ_t *pq);
     point_t getSkipNodeData(skipNode_t *node);
-    uint32_t getSkipNodePriority(skipNode_t *node);
+    score_t getSkipNodePriority(skipNode_t *node);
+
+    cell_t getSkipPQSize(skipPQ_t *pq);
+    uint64_t getSkipPQBytes(skipPQ_t *pq);
+    uint8_t getSkipPQPeakLevel(skipPQ_t *pq);
 
 #endif
@@ -19,8 +19,8 @@
 @return
     * Point with value.
 */
-point_t initPoint(int16_t x,
-                  int16_t y)
+point_t initPoint(coord_t x,
+                  coord_t y)
 {
     point_t point;
 
@@ -96,15 +96,16 @@ point_t addPoints(point_t a,
 @return
     * Distance between `a` and `b`.
 */
-uint16_t distancePoints(point_t  a,
-                        point_t  b,
-                        uint16_t costCardinal,
-                        uint16_t costDiagonal)
+score_t distancePoints(point_t  a,
+                       point_t  b,
+                       uint16_t costCardinal,
+                       uint16_t costDiagonal)
 {
-    uint16_t dx, dy, costDifference;
+    score_t dx, dy, costDifference;
 
-    dx = abs(a.x - b.x);
-    dy = abs(a.y - b.y);
+    // widened before subtracting so opposite corners do not overflow
+    dx = a.x > b.x ? (score_t)a.x - b.x : (score_t)b.x - a.x;
+    dy = a.y > b.y ? (score_t)a.y - b.y : (score_t)b.y - a.y;
     costDifference = abs(costCardinal - costDiagonal);
 
     if (dx > dy)
@@ -1,6 +1,13 @@
 /*
 @context
     * Provides a 2D point data type.
+    * Also provides the integer types sized for the largest dungeon supported.
+        * `coord_t` holds a coordinate, `cell_t` a cell index or count and
+          `score_t` a path cost or search score.
+        * By default they fit dungeons of at least 65536x65536.
+        * Defining `COMPACT_MAPS` (e.g. `make COMPACT=1`) narrows them for
+          dungeons no more than 4096x4096 - halving the size of points and most
+          search state.
 */
 
 
@@ -11,17 +18,38 @@
     #include <stdint.h>
 
 
+    #ifdef COMPACT_MAPS
+        typedef int16_t coord_t;
+        typedef uint32_t cell_t;
+        typedef uint32_t score_t;
+
+        // a path through a 4096x4096 dungeon has fewer than 2^24 moves, each
+        // costing less than 2^8, so any path cost fits `score_t`
+        #define COORD_MAX 4095
+        #define CELL_MAX UINT32_MAX
+        #define SCORE_MAX UINT32_MAX
+    #else
+        typedef int32_t coord_t;
+        typedef uint64_t cell_t;
+        typedef uint64_t score_t;
+
+        #define COORD_MAX INT32_MAX
+        #define CELL_MAX UINT64_MAX
+        #define SCORE_MAX UINT64_MAX
+    #endif
+
+
     typedef struct point_s point_t;
 
 
     struct point_s
     {
-        int16_t x, y;
+        coord_t x, y;
     };
 
 
-    point_t initPoint(int16_t x,
-                      int16_t y);
+    point_t initPoint(coord_t x,
+                      coord_t y);
 
     bool isEqualPoints(point_t a,
                        point_t b);
@@ -29,9 +57,9 @@
     point_t addPoints(point_t a,
                       point_t b);
 
-    uint16_t distancePoints(point_t  a,
-                            point_t  b,
-                            uint16_t costCardinal,
-                            uint16_t costDiagonal);
+    score_t distancePoints(point_t  a,
+                           point_t  b,
+                           uint16_t costCardinal,
+                           uint16_t costDiagonal);
 
 #endif
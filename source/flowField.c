@@ -0,0 +1,630 @@
+#include "flowField.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "aStar.h"
+#include "dataStructs/openList.h"
+
+
+// initial capacity of the points made stale by a change - grown by doubling
+static const cell_t STALE_CAPACITY = 64;
+
+
+struct flowField_s
+{
+    dungeon_t *dungeon;
+
+    // signed to compare with coordinates
+    int64_t width;
+    int64_t height;
+
+    // cell indices between rows of tiles (see `getMoveIndex`)
+    int64_t rowStride;
+
+    point_t target;
+    cell_t targetIndex;
+
+    // distance to the target and first move towards it of every cell
+    score_t *distances;
+    uint8_t *moves;
+
+    // open list of the reverse search and the handle of each point in it
+    openList_t *open;
+    cell_t *handles;
+
+    // points whose distance is found again after a change
+    point_t *stale;
+    cell_t staleCapacity;
+};
+
+
+static void searchField(flowField_t *field);
+static void relaxPoint(flowField_t *field,
+                       point_t      point,
+                       cell_t       index,
+                       uint8_t      move,
+                       score_t      distance);
+static void lookahead(flowField_t *field,
+                      point_t      point);
+static bool keepDistance(flowField_t *field,
+                         point_t      point,
+                         cell_t       index);
+static cell_t markStale(flowField_t *field,
+                        point_t      point,
+                        cell_t       index,
+                        cell_t       nStale);
+static score_t moveCost(uint8_t move);
+
+
+/* ------------------------------ START PUBLIC ------------------------------ */
+
+
+/*
+@context
+    * Initialises and builds the flow field of `dungeon` towards `target`.
+    * `dungeon` must only change through `setFlowPoint` (or be followed by
+      `rebuildFlowField`) and must not be resized or freed while the field is
+      in use.
+
+@parameters
+    * dungeon
+        * Dungeon to lead points through.
+    * target
+        * Location every point is led to.
+
+@return
+    * Flow field of every point of `dungeon` to `target`.
+*/
+flowField_t *initFlowField(dungeon_t *dungeon,
+                           point_t    target)
+{
+    cell_t i;
+    flowField_t *field;
+
+    field = malloc(sizeof(flowField_t));
+    assert(field != NULL);
+
+    field->dungeon = dungeon;
+    field->width = getDungeonWidth(dungeon);
+    field->height = getDungeonHeight(dungeon);
+    field->rowStride = getDungeonRowStride(dungeon);
+    field->target = target;
+    field->targetIndex = getDungeonIndex(dungeon, target);
+
+    field->distances = malloc(sizeof(score_t)
+                              * (size_t)getDungeonSize(dungeon));
+    assert(field->distances != NULL);
+    field->moves = malloc(sizeof(uint8_t) * (size_t)getDungeonSize(dungeon));
+    assert(field->moves != NULL);
+
+    // changes seed points anywhere in the field so a heap is used
+    field->open = initOpenList(OPEN_LIST_BINARY_HEAP, 0);
+    field->handles = malloc(sizeof(cell_t)
+                            * (size_t)getDungeonSize(dungeon));
+    assert(field->handles != NULL);
+    for (i = 0; i < getDungeonSize(dungeon); i += 1)
+    {
+        field->handles[i] = OPEN_NODE_NONE;
+    }
+
+    field->staleCapacity = STALE_CAPACITY;
+    field->stale = malloc(sizeof(point_t) * (size_t)field->staleCapacity);
+    assert(field->stale != NULL);
+
+    rebuildFlowField(field);
+
+    return field;
+}
+
+
+/*
+@context
+    * Frees `field`.
+    * The dungeon of `field` is not freed.
+
+@parameters
+    * field
+        * Flow field to free.
+*/
+void freeFlowField(flowField_t *field)
+{
+    free(field->distances);
+    free(field->moves);
+    freeOpenList(field->open);
+    free(field->handles);
+    free(field->stale);
+    free(field);
+}
+
+
+/*
+@context
+    * Builds the distance and move of every point of `field` from scratch.
+    * Used after the whole dungeon has changed (e.g. `generateDungeon`).
+
+@parameters
+    * field
+        * Flow field to rebuild.
+*/
+void rebuildFlowField(flowField_t *field)
+{
+    cell_t i;
+
+    for (i = 0; i < getDungeonSize(field->dungeon); i += 1)
+    {
+        field->distances[i] = SCORE_MAX;
+        field->moves[i] = FLOW_MOVE_NONE;
+    }
+
+    relaxPoint(field, field->target, field->targetIndex, FLOW_MOVE_NONE, 0);
+    searchField(field);
+}
+
+
+/*
+@context
+    * Sets tile character representation at `point` of the dungeon of `field`.
+    * Only the distances the change made wrong are found again.
+        * Every move the tile changes enters the 3x3 block around `point`.
+        * Points whose first move was made invalid, and points whose first
+          move leads into a point that lost its distance, are checked closest
+          to the target first.
+        * A point keeps its distance if a neighbour still gives it the same
+          distance (common as many paths tie) - otherwise it loses it.
+        * Points that lost their distance and the block are then given the
+          best distance through their neighbours and the search continues
+          from them.
+
+@parameters
+    * field
+        * Flow field of the dungeon to set tile of.
+    * point
+        * Location of tile to set.
+        * Assumes `point` is within the dungeon bounds.
+    * tile
+        * Character representation to set tile to.
+*/
+void setFlowPoint(flowField_t *field,
+                  point_t      point,
+                  char         tile)
+{
+    int64_t x, y;
+    uint8_t i, move;
+    cell_t index, neighbourIndex, nStale, j;
+    point_t current, neighbour;
+
+    setDungeonPoint(field->dungeon, point, tile);
+
+    // points of the block whose first move is no longer valid
+    for (y = point.y - 1; y <= point.y + 1; y += 1)
+    {
+        for (x = point.x - 1; x <= point.x + 1; x += 1)
+        {
+            if (x < 0 || x >= field->width || y < 0 || y >= field->height)
+            {
+                continue;
+            }
+
+            index = getDungeonIndex(field->dungeon, initPoint(x, y));
+            move = field->moves[index];
+            if (move != FLOW_MOVE_NONE
+                && (!isDungeonWalkable(field->dungeon, initPoint(x, y))
+                    || !(getDungeonPointMoves(field->dungeon, initPoint(x, y))
+                         & (1 << move))))
+            {
+                field->handles[index] = initOpenNode(field->open,
+                                                     initPoint(x, y),
+                                                     field->distances[index]);
+            }
+        }
+    }
+
+    // closer points are checked first so every neighbour closer than a point
+    // checked already holds a distance known to be right
+    nStale = 0;
+    while (!isOpenListEmpty(field->open))
+    {
+        current = getMinOpenData(field->open);
+        freeMinOpenNode(field->open);
+
+        index = getDungeonIndex(field->dungeon, current);
+        field->handles[index] = OPEN_NODE_NONE;
+        if (keepDistance(field, current, index))
+        {
+            continue;
+        }
+        nStale = markStale(field, current, index, nStale);
+
+        // points whose first move leads into `current` need checking too
+        for (i = 0; i < N_MOVES; i += 1)
+        {
+            neighbour = addPoints(current, MOVES[i]);
+            if (neighbour.x < 0 || neighbour.x >= field->width
+                || neighbour.y < 0 || neighbour.y >= field->height)
+            {
+                continue;
+            }
+
+            neighbourIndex = getMoveIndex(field->rowStride, index, MOVES[i]);
+            if (field->moves[neighbourIndex] == (i + N_MOVES / 2) % N_MOVES
+                && field->handles[neighbourIndex] == OPEN_NODE_NONE)
+            {
+                field->handles[neighbourIndex] = initOpenNode(
+                    field->open,
+                    neighbour,
+                    field->distances[neighbourIndex]
+                );
+            }
+        }
+    }
+
+    // seed the search with the stale points and the block changed
+    for (j = 0; j < nStale; j += 1)
+    {
+        lookahead(field, field->stale[j]);
+    }
+    for (y = point.y - 1; y <= point.y + 1; y += 1)
+    {
+        for (x = point.x - 1; x <= point.x + 1; x += 1)
+        {
+            if (x >= 0 && x < field->width && y >= 0 && y < field->height)
+            {
+                lookahead(field, initPoint(x, y));
+            }
+        }
+    }
+
+    searchField(field);
+}
+
+
+/*
+@context
+    * Gets the distance from `point` to the target of `field`.
+
+@parameters
+    * field
+        * Flow field to get distance of.
+    * point
+        * Location to get distance of.
+        * Assumes `point` is within the dungeon bounds.
+
+@return
+    * Cost of the shortest path from `point` to the target.
+    * `SCORE_MAX` if `point` cannot reach the target.
+*/
+score_t getFlowDistance(flowField_t *field,
+                        point_t      point)
+{
+    return field->distances[getDungeonIndex(field->dungeon, point)];
+}
+
+
+/*
+@context
+    * Gets the first move of the shortest path from `point` to the target of
+      `field`.
+
+@parameters
+    * field
+        * Flow field to get move of.
+    * point
+        * Location to get move of.
+        * Assumes `point` is within the dungeon bounds.
+
+@return
+    * Index into `MOVES` of the move to take from `point`.
+    * `FLOW_MOVE_NONE` if `point` is the target or cannot reach it.
+*/
+uint8_t getFlowMove(flowField_t *field,
+                    point_t      point)
+{
+    return field->moves[getDungeonIndex(field->dungeon, point)];
+}
+
+
+/*
+@context
+    * Finds shortest path from `source` to the target of `field` by following
+      the moves of the field.
+    * No search is done - takes O(path length).
+
+@parameters
+    * field
+        * Flow field to follow.
+    * source
+        * Location to start from.
+
+@return
+    * Shortest path (sequence of points) from `source` to the target.
+        * `source` is not included.
+        * The target is included as the last point.
+    * `NULL` if no path is possible.
+*/
+point_t *findFlowPath(flowField_t *field,
+                      point_t      source)
+{
+    point_t *path;
+    point_t current;
+    cell_t length, i;
+
+    if (getFlowDistance(field, source) == SCORE_MAX)
+    {
+        return NULL;
+    }
+
+    // find length of `path`
+    length = 0;
+    for (current = source;
+         !isEqualPoints(current, field->target);
+         current = addPoints(current, MOVES[getFlowMove(field, current)]))
+    {
+        length += 1;
+    }
+
+    path = malloc(sizeof(point_t) * (size_t)length);
+    assert(path != NULL);
+
+    current = source;
+    for (i = 0; i < length; i += 1)
+    {
+        current = addPoints(current, MOVES[getFlowMove(field, current)]);
+        path[i] = current;
+    }
+
+    return path;
+}
+
+
+/* ------------------------------- END PUBLIC ------------------------------- */
+/* ----------------------------- START  PRIVATE ----------------------------- */
+
+
+/*
+@context
+    * Runs the reverse Dijkstra search until the open list of `field` is
+      empty.
+    * Moves between walkable tiles are valid in both directions so each point
+      a move from the point popped reaches can move back into it.
+
+@parameters
+    * field
+        * Flow field whose open list holds the points to expand.
+*/
+static void searchField(flowField_t *field)
+{
+    uint8_t i, moves;
+    cell_t currentIndex, neighbourIndex;
+    point_t current;
+
+    while (!isOpenListEmpty(field->open))
+    {
+        current = getMinOpenData(field->open);
+        freeMinOpenNode(field->open);
+
+        currentIndex = getDungeonIndex(field->dungeon, current);
+        field->handles[currentIndex] = OPEN_NODE_NONE;
+
+        // nothing can move into a wall (only the target can be one here)
+        if (!isDungeonWalkable(field->dungeon, current))
+        {
+            continue;
+        }
+
+        moves = getDungeonPointMoves(field->dungeon, current);
+        for (i = 0; moves != 0; i += 1, moves >>= 1)
+        {
+            if (!(moves & 1))
+            {
+                continue;
+            }
+
+            neighbourIndex = getMoveIndex(field->rowStride,
+                                          currentIndex,
+                                          MOVES[i]);
+            relaxPoint(field,
+                       addPoints(current, MOVES[i]),
+                       neighbourIndex,
+                       (i + N_MOVES / 2) % N_MOVES,
+                       field->distances[currentIndex] + moveCost(i));
+        }
+    }
+}
+
+
+/*
+@context
+    * Gives `point` a new distance and first move if `distance` is shorter.
+    * `point` is added to the open list or has its priority lowered.
+
+@parameters
+    * field
+        * Flow field holding `point`.
+    * point
+        * Location to relax.
+    * index
+        * Cell index of `point`.
+    * move
+        * First move of the path of `distance`.
+    * distance
+        * Distance to the target through `move`.
+*/
+static void relaxPoint(flowField_t *field,
+                       point_t      point,
+                       cell_t       index,
+                       uint8_t      move,
+                       score_t      distance)
+{
+    if (distance >= field->distances[index])
+    {
+        return;
+    }
+
+    field->distances[index] = distance;
+    field->moves[index] = move;
+
+    if (field->handles[index] == OPEN_NODE_NONE)
+    {
+        field->handles[index] = initOpenNode(field->open, point, distance);
+    }
+    else
+    {
+        decreaseOpenNode(field->open, field->handles[index], distance);
+    }
+}
+
+
+/*
+@context
+    * Relaxes `point` through each neighbour it can move to that has a
+      distance.
+    * Walls and the target are left alone.
+
+@parameters
+    * field
+        * Flow field holding `point`.
+    * point
+        * Location to relax.
+*/
+static void lookahead(flowField_t *field,
+                      point_t      point)
+{
+    uint8_t i, moves;
+    cell_t index, neighbourIndex;
+
+    index = getDungeonIndex(field->dungeon, point);
+    if (index == field->targetIndex
+        || !isDungeonWalkable(field->dungeon, point))
+    {
+        return;
+    }
+
+    moves = getDungeonPointMoves(field->dungeon, point);
+    for (i = 0; moves != 0; i += 1, moves >>= 1)
+    {
+        neighbourIndex = getMoveIndex(field->rowStride, index, MOVES[i]);
+        if ((moves & 1) && field->distances[neighbourIndex] != SCORE_MAX)
+        {
+            relaxPoint(field,
+                       point,
+                       index,
+                       i,
+                       field->distances[neighbourIndex] + moveCost(i));
+        }
+    }
+}
+
+
+/*
+@context
+    * Moves `point` to a neighbour giving it the same distance it holds.
+    * Every neighbour closer to the target than `point` must hold a distance
+      known to be right (or none).
+
+@parameters
+    * field
+        * Flow field holding `point`.
+    * point
+        * Location to keep distance of.
+    * index
+        * Cell index of `point`.
+
+@return
+    * Indication `point` kept its distance.
+*/
+static bool keepDistance(flowField_t *field,
+                         point_t      point,
+                         cell_t       index)
+{
+    uint8_t i, moves;
+    cell_t neighbourIndex;
+
+    if (!isDungeonWalkable(field->dungeon, point))
+    {
+        return false;
+    }
+
+    moves = getDungeonPointMoves(field->dungeon, point);
+    for (i = 0; moves != 0; i += 1, moves >>= 1)
+    {
+        neighbourIndex = getMoveIndex(field->rowStride, index, MOVES[i]);
+        if ((moves & 1)
+            && field->distances[neighbourIndex] != SCORE_MAX
+            && field->distances[neighbourIndex] + moveCost(i)
+               == field->distances[index])
+        {
+            field->moves[index] = i;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+/*
+@context
+    * Clears the distance and move of `point` and adds it to the stale points
+      of `field`.
+    * The stale points are grown when full.
+
+@parameters
+    * field
+        * Flow field holding the cell.
+    * point
+        * Location to mark.
+    * index
+        * Cell index of `point`.
+    * nStale
+        * Number of stale points before `point`.
+
+@return
+    * Number of stale points including `point`.
+*/
+static cell_t markStale(flowField_t *field,
+                        point_t      point,
+                        cell_t       index,
+                        cell_t       nStale)
+{
+    if (nStale == field->staleCapacity)
+    {
+        field->staleCapacity *= 2;
+        field->stale = realloc(field->stale,
+                               sizeof(point_t) * (size_t)field->staleCapacity);
+        assert(field->stale != NULL);
+    }
+
+    field->distances[index] = SCORE_MAX;
+    field->moves[index] = FLOW_MOVE_NONE;
+    field->stale[nStale] = point;
+
+    return nStale + 1;
+}
+
+
+/*
+@context
+    * Determine the cost of moving by `MOVES[move]`.
+
+@parameters
+    * move
+        * Index of the move in `MOVES`.
+
+@return
+    * Cost of the move.
+*/
+static score_t moveCost(uint8_t move)
+{
+    // only moving in x or y direction not both
+    if (MOVES[move].x == 0 || MOVES[move].y == 0)
+    {
+        return COST_CARDINAL;
+    }
+    return COST_DIAGONAL;
+}
+
+
+/* ------------------------------ END  PRIVATE ------------------------------ */
@@ -0,0 +1,54 @@
+/*
+@context
+    * Provides a flow field leading every point of a dungeon to one target.
+    * Built with a single reverse Dijkstra search from the target.
+        * Holds the distance of every point to the target and the move
+          (index into `MOVES`) starting its shortest path.
+        * Any number of agents can then follow the field to the target in
+          O(path length) without searching.
+    * Follows the same movement rules and costs as `findPath` so paths
+      followed have the same cost.
+        * Walls hold no distance or move.
+    * Tiles must be changed through `setFlowPoint` so only the distances the
+      change made wrong are found again.
+        * `rebuildFlowField` must be called after regenerating the dungeon.
+*/
+
+
+#ifndef _FLOW_FIELD_H
+    #define _FLOW_FIELD_H
+
+    #include <stdint.h>
+
+    #include "dataStructs/dungeon.h"
+    #include "dataTypes/point.h"
+
+
+    // move of the target and of points that cannot reach it
+    static const uint8_t FLOW_MOVE_NONE = UINT8_MAX;
+
+
+    typedef struct flowField_s flowField_t;
+
+
+    flowField_t *initFlowField(dungeon_t *dungeon,
+                               point_t    target);
+
+    void freeFlowField(flowField_t *field);
+
+    void rebuildFlowField(flowField_t *field);
+
+    void setFlowPoint(flowField_t *field,
+                      point_t      point,
+                      char         tile);
+
+    score_t getFlowDistance(flowField_t *field,
+                            point_t      point);
+
+    uint8_t getFlowMove(flowField_t *field,
+                        point_t      point);
+
+    point_t *findFlowPath(flowField_t *field,
+                          point_t      source);
+
+#endif
@@ -0,0 +1,1220 @@
+#include "hierarchicalAStar.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "aStar.h"
+#include "dataStructs/openList.h"
+#include "dataStructs/searchGrid.h"
+
+
+// marks the lack of a cell or node
+static const cell_t NO_CELL = CELL_MAX;
+static const uint16_t NO_NODE = UINT16_MAX;
+
+// entrances at least this wide get a node at both ends instead of the middle
+static const uint16_t ENTRANCE_WIDTH_MAX = 6;
+
+// initial capacity of a refined path - grown by doubling
+static const uint32_t PATH_CAPACITY = 64;
+
+
+typedef struct cluster_s cluster_t;
+
+
+struct cluster_s
+{
+    // corners of the tiles within the cluster (both included)
+    point_t min;
+    point_t max;
+
+    // cell index of each node (entrance tile) of the cluster
+    cell_t *cells;
+    uint16_t nNodes;
+
+    // distance between each pair of nodes within the cluster - row-major
+    score_t *distances;
+};
+
+struct hpaGraph_s
+{
+    dungeon_t *dungeon;
+
+    // signed to compare with coordinates
+    int64_t width;
+    int64_t height;
+
+    // cell indices between rows of tiles (see `getMoveIndex`)
+    int64_t rowStride;
+
+    uint16_t clusterSize;
+    uint32_t nClustersX;
+    uint32_t nClustersY;
+    cluster_t *clusters;
+
+    // node index within its cluster of each cell (`NO_NODE` if not a node)
+    uint16_t *nodes;
+
+    // search within a single cluster - building distances and refining paths
+    searchGrid_t *clusterGrid;
+    openList_t *clusterOpen;
+
+    // search over the nodes - addressed by the cell index of each node
+    searchGrid_t *graphGrid;
+    openList_t *graphOpen;
+
+    // distance of the query's source and target to each node of their cluster
+    score_t *sourceDistances;
+    score_t *targetDistances;
+};
+
+
+static cluster_t *getCluster(hpaGraph_t *graph,
+                             cell_t      index);
+
+static void rebuildCluster(hpaGraph_t *graph,
+                           cluster_t  *cluster);
+static void addBorderNodes(hpaGraph_t *graph,
+                           cluster_t  *cluster,
+                           point_t     start,
+                           point_t     step,
+                           point_t     across,
+                           uint16_t    length);
+static void addNode(hpaGraph_t *graph,
+                    cluster_t  *cluster,
+                    cell_t      index);
+
+static void searchCluster(hpaGraph_t *graph,
+                          cluster_t  *cluster,
+                          cell_t      startIndex,
+                          cell_t      goalIndex);
+static void copyDistances(hpaGraph_t *graph,
+                          cluster_t  *cluster,
+                          score_t    *distances);
+
+static void expandGraphNode(hpaGraph_t *graph,
+                            cell_t      currentIndex,
+                            cell_t      sourceIndex,
+                            cell_t      targetIndex,
+                            score_t     directDistance);
+static void relaxGraphEdge(hpaGraph_t *graph,
+                           cell_t      fromIndex,
+                           cell_t      toIndex,
+                           score_t     cost,
+                           point_t     target);
+
+static point_t *refinePath(hpaGraph_t *graph,
+                           cell_t      sourceIndex,
+                           cell_t      targetIndex);
+static cell_t smoothPath(hpaGraph_t *graph,
+                         point_t     source,
+                         point_t    *path,
+                         cell_t      length);
+static bool isOctileWalk(hpaGraph_t *graph,
+                         point_t     from,
+                         point_t     to,
+                         bool        isDiagonalFirst);
+static cell_t addOctileWalk(point_t  from,
+                            point_t  to,
+                            bool     isDiagonalFirst,
+                            point_t *path,
+                            cell_t   length);
+static uint8_t getOctileMove(point_t from,
+                             point_t to,
+                             bool    isDiagonalFirst);
+
+
+/* ------------------------------ START PUBLIC ------------------------------ */
+
+
+/*
+@context
+    * Initialises the graph of clusters and entrances of `dungeon`.
+    * Builds every cluster - entrances and distances between them.
+    * `dungeon` must not be resized or freed while the graph is in use.
+
+@parameters
+    * dungeon
+        * Dungeon to find paths in.
+    * clusterSize
+        * Width and height of each cluster in tiles.
+        * Clusters on the right and bottom edges may be smaller.
+        * Must be `>= 2`.
+
+@return
+    * Graph ready to find paths in `dungeon`.
+*/
+hpaGraph_t *initHpaGraph(dungeon_t *dungeon,
+                         uint16_t   clusterSize)
+{
+    cell_t i;
+    uint32_t x, y;
+    hpaGraph_t *graph;
+    cluster_t *cluster;
+
+    assert(clusterSize >= 2);
+
+    graph = malloc(sizeof(hpaGraph_t));
+    assert(graph != NULL);
+
+    graph->dungeon = dungeon;
+    graph->width = getDungeonWidth(dungeon);
+    graph->height = getDungeonHeight(dungeon);
+    graph->rowStride = getDungeonRowStride(dungeon);
+
+    graph->clusterSize = clusterSize;
+    graph->nClustersX = (graph->width + clusterSize - 1) / clusterSize;
+    graph->nClustersY = (graph->height + clusterSize - 1) / clusterSize;
+    graph->clusters = malloc(sizeof(cluster_t)
+                             * (size_t)graph->nClustersX * graph->nClustersY);
+    assert(graph->clusters != NULL);
+
+    // each border holds at most 1 node per tile
+    for (y = 0; y < graph->nClustersY; y += 1)
+    {
+        for (x = 0; x < graph->nClustersX; x += 1)
+        {
+            cluster = &graph->clusters[(size_t)y * graph->nClustersX + x];
+            cluster->min = initPoint(x * clusterSize, y * clusterSize);
+            cluster->max = initPoint(
+                (x + 1) * clusterSize > graph->width
+                    ? graph->width - 1 : (x + 1) * clusterSize - 1,
+                (y + 1) * clusterSize > graph->height
+                    ? graph->height - 1 : (y + 1) * clusterSize - 1);
+
+            cluster->cells = malloc(sizeof(cell_t) * 4 * clusterSize);
+            assert(cluster->cells != NULL);
+            cluster->nNodes = 0;
+            cluster->distances = NULL;
+        }
+    }
+
+    graph->nodes = malloc(sizeof(uint16_t) * (size_t)getDungeonSize(dungeon));
+    assert(graph->nodes != NULL);
+    for (i = 0; i < getDungeonSize(dungeon); i += 1)
+    {
+        graph->nodes[i] = NO_NODE;
+    }
+
+    // cluster searches only move between adjacent tiles
+    graph->clusterGrid = initSearchGrid(getDungeonSize(dungeon));
+    graph->clusterOpen = initOpenList(OPEN_LIST_BUCKET, 2 * COST_DIAGONAL);
+
+    // edges between nodes can span a whole cluster so a heap is used
+    graph->graphGrid = initSearchGrid(getDungeonSize(dungeon));
+    graph->graphOpen = initOpenList(OPEN_LIST_BINARY_HEAP, 0);
+
+    graph->sourceDistances = malloc(sizeof(score_t) * 4 * clusterSize);
+    assert(graph->sourceDistances != NULL);
+    graph->targetDistances = malloc(sizeof(score_t) * 4 * clusterSize);
+    assert(graph->targetDistances != NULL);
+
+    rebuildHpaGraph(graph);
+
+    return graph;
+}
+
+
+/*
+@context
+    * Frees `graph`.
+    * The dungeon of `graph` is not freed.
+
+@parameters
+    * graph
+        * Graph to free.
+*/
+void freeHpaGraph(hpaGraph_t *graph)
+{
+    cell_t i;
+
+    for (i = 0; i < (cell_t)graph->nClustersX * graph->nClustersY; i += 1)
+    {
+        free(graph->clusters[i].cells);
+        free(graph->clusters[i].distances);
+    }
+    free(graph->clusters);
+    free(graph->nodes);
+
+    freeSearchGrid(graph->clusterGrid);
+    freeOpenList(graph->clusterOpen);
+    freeSearchGrid(graph->graphGrid);
+    freeOpenList(graph->graphOpen);
+
+    free(graph->sourceDistances);
+    free(graph->targetDistances);
+    free(graph);
+}
+
+
+/*
+@context
+    * Rebuilds every cluster of `graph`.
+    * Used after the whole dungeon has changed (e.g. `generateDungeon`).
+
+@parameters
+    * graph
+        * Graph to rebuild.
+*/
+void rebuildHpaGraph(hpaGraph_t *graph)
+{
+    cell_t i;
+
+    for (i = 0; i < (cell_t)graph->nClustersX * graph->nClustersY; i += 1)
+    {
+        rebuildCluster(graph, &graph->clusters[i]);
+    }
+}
+
+
+/*
+@context
+    * Sets tile character representation at `point` of the dungeon of `graph`.
+    * Only rebuilds the clusters touching the 3x3 block around `point`.
+        * The tile changes the valid moves of its 8 neighbours and can open or
+          close an entrance of the cluster across a border.
+
+@parameters
+    * graph
+        * Graph of the dungeon to set tile of.
+    * point
+        * Location of tile to set.
+        * Assumes `point` is within the dungeon bounds.
+    * tile
+        * Character representation to set tile to.
+*/
+void setHpaPoint(hpaGraph_t *graph,
+                 point_t     point,
+                 char        tile)
+{
+    uint32_t x, y, minX, minY, maxX, maxY;
+
+    setDungeonPoint(graph->dungeon, point, tile);
+
+    // clusters holding any tile of the 3x3 block (clipped to the dungeon)
+    minX = (point.x > 0 ? point.x - 1 : 0) / graph->clusterSize;
+    minY = (point.y > 0 ? point.y - 1 : 0) / graph->clusterSize;
+    maxX = (point.x < graph->width - 1 ? point.x + 1 : point.x)
+         / graph->clusterSize;
+    maxY = (point.y < graph->height - 1 ? point.y + 1 : point.y)
+         / graph->clusterSize;
+
+    for (y = minY; y <= maxY; y += 1)
+    {
+        for (x = minX; x <= maxX; x += 1)
+        {
+            rebuildCluster(graph,
+                           &graph->clusters[(size_t)y * graph->nClustersX + x]);
+        }
+    }
+}
+
+
+/*
+@context
+    * Finds a path from `source` to `target` in the dungeon of `graph` if
+      possible - not always a shortest path (see `hierarchicalAStar.h`).
+    * `source` and `target` are joined to the nodes of their clusters by
+      searching within those clusters.
+    * A* (Octile distance heuristic) then searches the graph of nodes and the
+      nodes found are refined into single steps.
+
+@parameters
+    * graph
+        * Graph of the dungeon to find path in.
+    * source
+        * Location to start from.
+    * target
+        * Location to find from `source`.
+
+@return
+    * Path (sequence of points) from `source` to `target`.
+        * `source` is not included.
+        * `target` is included as the last point.
+    * `NULL` if no path is possible.
+*/
+point_t *findHpaPath(hpaGraph_t *graph,
+                     point_t     source,
+                     point_t     target)
+{
+    cell_t sourceIndex, targetIndex, currentIndex;
+    score_t directDistance;
+    cluster_t *sourceCluster, *targetCluster;
+    pointData_t *currentData;
+
+    sourceIndex = getDungeonIndex(graph->dungeon, source);
+    targetIndex = getDungeonIndex(graph->dungeon, target);
+    sourceCluster = getCluster(graph, sourceIndex);
+    targetCluster = getCluster(graph, targetIndex);
+
+    // join `source` and `target` to the nodes of their clusters
+    searchCluster(graph, sourceCluster, sourceIndex, NO_CELL);
+    copyDistances(graph, sourceCluster, graph->sourceDistances);
+    directDistance = getSearchGridCell(graph->clusterGrid, targetIndex)->gScore;
+
+    searchCluster(graph, targetCluster, targetIndex, NO_CELL);
+    copyDistances(graph, targetCluster, graph->targetDistances);
+
+    resetSearchGrid(graph->graphGrid);
+    clearOpenList(graph->graphOpen);
+
+    currentData = getSearchGridCell(graph->graphGrid, sourceIndex);
+    currentData->gScore = 0;
+    openSearchGridCell(currentData,
+                       graph->graphOpen,
+                       source,
+                       distancePoints(source,
+                                      target,
+                                      COST_CARDINAL,
+                                      COST_DIAGONAL));
+
+    // search the nodes for `target` or until no more nodes to explore
+    while (!isOpenListEmpty(graph->graphOpen))
+    {
+        currentIndex = getDungeonIndex(graph->dungeon,
+                                       getMinOpenData(graph->graphOpen));
+        freeMinOpenNode(graph->graphOpen);
+
+        // each node is only in the open list once so it is never closed yet
+        currentData = getSearchGridCell(graph->graphGrid, currentIndex);
+        currentData->isClosed = true;
+
+        if (currentIndex == targetIndex)
+        {
+            return refinePath(graph, sourceIndex, targetIndex);
+        }
+
+        expandGraphNode(graph,
+                        currentIndex,
+                        sourceIndex,
+                        targetIndex,
+                        directDistance);
+    }
+
+    return NULL;
+}
+
+
+/* ------------------------------- END PUBLIC ------------------------------- */
+/* ----------------------------- START  PRIVATE ----------------------------- */
+
+
+/*
+@context
+    * Gets the cluster holding cell `index`.
+
+@parameters
+    * graph
+        * Graph to get cluster of.
+    * index
+        * Cell index to get cluster of.
+
+@return
+    * Cluster holding cell `index`.
+*/
+static cluster_t *getCluster(hpaGraph_t *graph,
+                             cell_t      index)
+{
+    point_t point;
+
+    point = getDungeonIndexPoint(graph->dungeon, index);
+    return &graph->clusters[(size_t)(point.y / graph->clusterSize)
+                            * graph->nClustersX
+                            + point.x / graph->clusterSize];
+}
+
+
+/*
+@context
+    * Rebuilds the nodes of `cluster` and the distances between them.
+    * Entrances are found on every border shared with another cluster.
+        * Both clusters of a border find the same entrances.
+
+@parameters
+    * graph
+        * Graph holding `cluster`.
+    * cluster
+        * Cluster to rebuild.
+*/
+static void rebuildCluster(hpaGraph_t *graph,
+                           cluster_t  *cluster)
+{
+    uint16_t i, j, width, height;
+
+    // forget the nodes of the previous build
+    for (i = 0; i < cluster->nNodes; i += 1)
+    {
+        graph->nodes[cluster->cells[i]] = NO_NODE;
+    }
+    cluster->nNodes = 0;
+
+    width = cluster->max.x - cluster->min.x + 1;
+    height = cluster->max.y - cluster->min.y + 1;
+
+    // west, east, north and south borders
+    if (cluster->min.x > 0)
+    {
+        addBorderNodes(graph, cluster, cluster->min,
+                       initPoint(0, 1), initPoint(-1, 0), height);
+    }
+    if (cluster->max.x < graph->width - 1)
+    {
+        addBorderNodes(graph, cluster,
+                       initPoint(cluster->max.x, cluster->min.y),
+                       initPoint(0, 1), initPoint(1, 0), height);
+    }
+    if (cluster->min.y > 0)
+    {
+        addBorderNodes(graph, cluster, cluster->min,
+                       initPoint(1, 0), initPoint(0, -1), width);
+    }
+    if (cluster->max.y < graph->height - 1)
+    {
+        addBorderNodes(graph, cluster,
+                       initPoint(cluster->min.x, cluster->max.y),
+                       initPoint(1, 0), initPoint(0, 1), width);
+    }
+
+    free(cluster->distances);
+    cluster->distances = malloc(sizeof(score_t)
+                                * cluster->nNodes * cluster->nNodes);
+    assert(cluster->nNodes == 0 || cluster->distances != NULL);
+
+    // distances from each node to every other node of `cluster`
+    for (i = 0; i < cluster->nNodes; i += 1)
+    {
+        searchCluster(graph, cluster, cluster->cells[i], NO_CELL);
+        for (j = 0; j < cluster->nNodes; j += 1)
+        {
+            cluster->distances[i * cluster->nNodes + j]
+                = getSearchGridCell(graph->clusterGrid,
+                                    cluster->cells[j])->gScore;
+        }
+    }
+}
+
+
+/*
+@context
+    * Adds a node for each entrance along one border of `cluster`.
+    * An entrance is a run of tiles open on both sides of the border.
+        * Narrow entrances get a node in the middle.
+        * Entrances of at least `ENTRANCE_WIDTH_MAX` get a node at both ends.
+
+@parameters
+    * graph
+        * Graph holding `cluster`.
+    * cluster
+        * Cluster to add nodes to.
+    * start
+        * First tile of the border within `cluster`.
+    * step
+        * Direction along the border.
+    * across
+        * Direction to the tile on the other side of the border.
+    * length
+        * Number of tiles along the border.
+*/
+static void addBorderNodes(hpaGraph_t *graph,
+                           cluster_t  *cluster,
+                           point_t     start,
+                           point_t     step,
+                           point_t     across,
+                           uint16_t    length)
+{
+    uint16_t i, runStart, runLength;
+    point_t current, first, last;
+
+    runStart = 0;
+    runLength = 0;
+    current = start;
+
+    // one past the end closes the last run
+    for (i = 0; i <= length; i += 1)
+    {
+        if (i < length
+            && isDungeonWalkable(graph->dungeon, current)
+            && isDungeonWalkable(graph->dungeon, addPoints(current, across)))
+        {
+            if (runLength == 0)
+            {
+                runStart = i;
+            }
+            runLength += 1;
+        }
+        else if (runLength > 0)
+        {
+            first = initPoint(start.x + step.x * runStart,
+                              start.y + step.y * runStart);
+            last = initPoint(start.x + step.x * (i - 1),
+                             start.y + step.y * (i - 1));
+
+            if (runLength < ENTRANCE_WIDTH_MAX)
+            {
+                addNode(graph, cluster,
+                        getDungeonIndex(graph->dungeon,
+                                        initPoint((first.x + last.x) / 2,
+                                                  (first.y + last.y) / 2)));
+            }
+            else
+            {
+                addNode(graph, cluster,
+                        getDungeonIndex(graph->dungeon, first));
+                addNode(graph, cluster,
+                        getDungeonIndex(graph->dungeon, last));
+            }
+            runLength = 0;
+        }
+
+        current = addPoints(current, step);
+    }
+}
+
+
+/*
+@context
+    * Adds cell `index` as a node of `cluster` unless it already is one.
+    * Corner tiles can be an entrance on 2 borders.
+
+@parameters
+    * graph
+        * Graph holding `cluster`.
+    * cluster
+        * Cluster to add node to.
+    * index
+        * Cell index of the node within `cluster`.
+*/
+static void addNode(hpaGraph_t *graph,
+                    cluster_t  *cluster,
+                    cell_t      index)
+{
+    if (graph->nodes[index] != NO_NODE)
+    {
+        return;
+    }
+
+    graph->nodes[index] = cluster->nNodes;
+    cluster->cells[cluster->nNodes] = index;
+    cluster->nNodes += 1;
+}
+
+
+/*
+@context
+    * Searches from `startIndex` without leaving the tiles of `cluster`.
+    * Without a goal every reachable tile of `cluster` is expanded (Dijkstra).
+    * With a goal A* stops once the goal is expanded.
+    * The g-score and previous cell of each tile reached is left in the
+      cluster search grid of `graph`.
+
+@parameters
+    * graph
+        * Graph holding `cluster`.
+    * cluster
+        * Cluster to search within.
+    * startIndex
+        * Cell index to start from.
+    * goalIndex
+        * Cell index to find or `NO_CELL` to reach every tile.
+*/
+static void searchCluster(hpaGraph_t *graph,
+                          cluster_t  *cluster,
+                          cell_t      startIndex,
+                          cell_t      goalIndex)
+{
+    uint8_t i, moves;
+    score_t gScore, hScore;
+    cell_t currentIndex, neighbourIndex;
+    pointData_t *currentData, *neighbourData;
+    point_t current, neighbour, goal;
+
+    resetSearchGrid(graph->clusterGrid);
+    clearOpenList(graph->clusterOpen);
+
+    goal = goalIndex == NO_CELL
+         ? initPoint(0, 0)
+         : getDungeonIndexPoint(graph->dungeon, goalIndex);
+
+    current = getDungeonIndexPoint(graph->dungeon, startIndex);
+    currentData = getSearchGridCell(graph->clusterGrid, startIndex);
+    currentData->gScore = 0;
+    openSearchGridCell(currentData,
+                       graph->clusterOpen,
+                       current,
+                       goalIndex == NO_CELL
+                           ? 0
+                           : distancePoints(current,
+                                            goal,
+                                            COST_CARDINAL,
+                                            COST_DIAGONAL));
+
+    while (!isOpenListEmpty(graph->clusterOpen))
+    {
+        current = getMinOpenData(graph->clusterOpen);
+        freeMinOpenNode(graph->clusterOpen);
+
+        currentIndex = getDungeonIndex(graph->dungeon, current);
+        // each point is only in the open list once so it is never closed yet
+        currentData = getSearchGridCell(graph->clusterGrid, currentIndex);
+        currentData->isClosed = true;
+        if (currentIndex == goalIndex)
+        {
+            return;
+        }
+
+        moves = getDungeonPointMoves(graph->dungeon, current);
+        for (i = 0; moves != 0; i += 1, moves >>= 1)
+        {
+            neighbour = addPoints(current, MOVES[i]);
+
+            // skip invalid moves and moves leaving `cluster`
+            if (!(moves & 1)
+                || neighbour.x < cluster->min.x || neighbour.x > cluster->max.x
+                || neighbour.y < cluster->min.y || neighbour.y > cluster->max.y)
+            {
+                continue;
+            }
+
+            gScore = currentData->gScore
+                   + distancePoints(current,
+                                    neighbour,
+                                    COST_CARDINAL,
+                                    COST_DIAGONAL);
+
+            neighbourIndex = getDungeonIndex(graph->dungeon, neighbour);
+            neighbourData = getSearchGridCell(graph->clusterGrid,
+                                              neighbourIndex);
+            if (gScore < neighbourData->gScore)
+            {
+                neighbourData->prev = currentIndex;
+                neighbourData->gScore = gScore;
+
+                if (!neighbourData->isClosed)
+                {
+                    hScore = goalIndex == NO_CELL
+                           ? 0
+                           : distancePoints(neighbour,
+                                            goal,
+                                            COST_CARDINAL,
+                                            COST_DIAGONAL);
+                    openSearchGridCell(neighbourData,
+                                       graph->clusterOpen,
+                                       neighbour,
+                                       gScore + hScore);
+                }
+            }
+        }
+    }
+}
+
+
+/*
+@context
+    * Copies the g-score of each node of `cluster` from the last cluster
+      search.
+    * Nodes not reached have a distance of `SCORE_MAX`.
+
+@parameters
+    * graph
+        * Graph holding `cluster`.
+    * cluster
+        * Cluster last searched.
+    * distances
+        * Array (of at least the number of nodes of `cluster`) to copy to.
+*/
+static void copyDistances(hpaGraph_t *graph,
+                          cluster_t  *cluster,
+                          score_t    *distances)
+{
+    uint16_t i;
+
+    for (i = 0; i < cluster->nNodes; i += 1)
+    {
+        distances[i] = getSearchGridCell(graph->clusterGrid,
+                                         cluster->cells[i])->gScore;
+    }
+}
+
+
+/*
+@context
+    * Explores the edges of the graph point at `currentIndex`.
+        * The source is joined to every node of its cluster (and the target if
+          they share a cluster).
+        * A node is joined to every node of its cluster, nodes across a border
+          one cardinal move away and the target if they share a cluster.
+    * The source can also be a node so both are checked.
+
+@parameters
+    * graph
+        * Graph to search.
+    * currentIndex
+        * Cell index of the graph point to expand.
+    * sourceIndex
+        * Cell index of the source of the query.
+    * targetIndex
+        * Cell index of the target of the query.
+    * directDistance
+        * Distance from source to target within the source's cluster.
+*/
+static void expandGraphNode(hpaGraph_t *graph,
+                            cell_t      currentIndex,
+                            cell_t      sourceIndex,
+                            cell_t      targetIndex,
+                            score_t     directDistance)
+{
+    uint16_t i, node;
+    uint8_t moves;
+    cell_t neighbourIndex;
+    cluster_t *cluster, *targetCluster;
+    point_t target;
+
+    cluster = getCluster(graph, currentIndex);
+    targetCluster = getCluster(graph, targetIndex);
+    target = getDungeonIndexPoint(graph->dungeon, targetIndex);
+
+    if (currentIndex == sourceIndex)
+    {
+        for (i = 0; i < cluster->nNodes; i += 1)
+        {
+            relaxGraphEdge(graph, currentIndex, cluster->cells[i],
+                           graph->sourceDistances[i], target);
+        }
+        relaxGraphEdge(graph, currentIndex, targetIndex,
+                       directDistance, target);
+    }
+
+    node = graph->nodes[currentIndex];
+    if (node == NO_NODE)
+    {
+        return;
+    }
+
+    // nodes within the same cluster
+    for (i = 0; i < cluster->nNodes; i += 1)
+    {
+        relaxGraphEdge(graph, currentIndex, cluster->cells[i],
+                       cluster->distances[node * cluster->nNodes + i], target);
+    }
+
+    // nodes across a border - entrances are crossed with cardinal moves
+    moves = getDungeonMoves(graph->dungeon, currentIndex);
+    for (i = 0; i < N_MOVES; i += 2)
+    {
+        if (!(moves & (1 << i)))
+        {
+            continue;
+        }
+
+        neighbourIndex = getMoveIndex(graph->rowStride, currentIndex, MOVES[i]);
+        if (graph->nodes[neighbourIndex] != NO_NODE
+            && getCluster(graph, neighbourIndex) != cluster)
+        {
+            relaxGraphEdge(graph, currentIndex, neighbourIndex,
+                           COST_CARDINAL, target);
+        }
+    }
+
+    if (cluster == targetCluster)
+    {
+        relaxGraphEdge(graph, currentIndex, targetIndex,
+                       graph->targetDistances[node], target);
+    }
+}
+
+
+/*
+@context
+    * Adds a graph point to the open list of `graph` if the edge to it is a
+      new shortest path from the source.
+
+@parameters
+    * graph
+        * Graph being searched.
+    * fromIndex
+        * Cell index of the graph point the edge leaves.
+    * toIndex
+        * Cell index of the graph point the edge enters.
+    * cost
+        * Cost of the edge - `SCORE_MAX` if there is no edge.
+    * target
+        * Location of the target of the query.
+*/
+static void relaxGraphEdge(hpaGraph_t *graph,
+                           cell_t      fromIndex,
+                           cell_t      toIndex,
+                           score_t     cost,
+                           point_t     target)
+{
+    score_t gScore;
+    pointData_t *toData;
+    point_t to;
+
+    if (cost == SCORE_MAX || fromIndex == toIndex)
+    {
+        return;
+    }
+
+    gScore = getSearchGridCell(graph->graphGrid, fromIndex)->gScore + cost;
+    toData = getSearchGridCell(graph->graphGrid, toIndex);
+    if (gScore < toData->gScore)
+    {
+        toData->prev = fromIndex;
+        toData->gScore = gScore;
+
+        if (!toData->isClosed)
+        {
+            to = getDungeonIndexPoint(graph->dungeon, toIndex);
+            openSearchGridCell(toData,
+                               graph->graphOpen,
+                               to,
+                               gScore + distancePoints(to,
+                                                       target,
+                                                       COST_CARDINAL,
+                                                       COST_DIAGONAL));
+        }
+    }
+}
+
+
+/*
+@context
+    * Refines the graph path found into single steps.
+    * Consecutive graph points in the same cluster are joined by searching
+      within that cluster - others are a single move across a border.
+    * The refined path is then smoothed (see `smoothPath`).
+    * Assumes a graph path to `targetIndex` from `sourceIndex` has been found.
+
+@parameters
+    * graph
+        * Graph holding the graph path found.
+    * sourceIndex
+        * Cell index of the source of the query.
+    * targetIndex
+        * Cell index of the target of the query.
+
+@return
+    * Path (sequence of points) from `source` to `target`.
+*/
+static point_t *refinePath(hpaGraph_t *graph,
+                           cell_t      sourceIndex,
+                           cell_t      targetIndex)
+{
+    cell_t *graphPath;
+    cell_t i, j, current, nGraphPoints, length, capacity, stepLength;
+    point_t *path;
+    cluster_t *cluster;
+
+    // graph points from `targetIndex` back to `sourceIndex` (both included)
+    nGraphPoints = 1;
+    for (current = targetIndex;
+         current != sourceIndex;
+         current = getSearchGridCell(graph->graphGrid, current)->prev)
+    {
+        nGraphPoints += 1;
+    }
+
+    graphPath = malloc(sizeof(cell_t) * (size_t)nGraphPoints);
+    assert(graphPath != NULL);
+
+    current = targetIndex;
+    for (i = nGraphPoints; i > 0; i -= 1)
+    {
+        graphPath[i - 1] = current;
+        current = getSearchGridCell(graph->graphGrid, current)->prev;
+    }
+
+    capacity = PATH_CAPACITY;
+    path = malloc(sizeof(point_t) * (size_t)capacity);
+    assert(path != NULL);
+    length = 0;
+
+    for (i = 1; i < nGraphPoints; i += 1)
+    {
+        cluster = getCluster(graph, graphPath[i - 1]);
+
+        // single move across a border
+        if (cluster != getCluster(graph, graphPath[i]))
+        {
+            stepLength = 1;
+        }
+        else
+        {
+            searchCluster(graph, cluster, graphPath[i - 1], graphPath[i]);
+
+            stepLength = 0;
+            for (current = graphPath[i];
+                 current != graphPath[i - 1];
+                 current = getSearchGridCell(graph->clusterGrid, current)->prev)
+            {
+                stepLength += 1;
+            }
+        }
+
+        if (length + stepLength > capacity)
+        {
+            while (length + stepLength > capacity)
+            {
+                capacity *= 2;
+            }
+            path = realloc(path, sizeof(point_t) * (size_t)capacity);
+            assert(path != NULL);
+        }
+
+        // steps are written in reverse from `graphPath[i]`
+        current = graphPath[i];
+        for (j = length + stepLength; j > length; j -= 1)
+        {
+            path[j - 1] = getDungeonIndexPoint(graph->dungeon, current);
+            current = getSearchGridCell(graph->clusterGrid, current)->prev;
+        }
+        length += stepLength;
+    }
+
+    free(graphPath);
+
+    smoothPath(graph, getDungeonIndexPoint(graph->dungeon, sourceIndex), path,
+               length);
+
+    return path;
+}
+
+
+/*
+@context
+    * Shortens a refined path in place by replacing detours with straight
+      walks.
+    * From each point of the path the points up to a cluster size ahead are
+      tried farthest first - the first reached by a valid Octile walk
+      (diagonal moves first or cardinal moves first) cheaper than the path
+      between them replaces that part of the path.
+        * Detours made by only crossing clusters at entrances are mostly
+          shorter than a cluster so most of them are removed.
+        * Looking further ahead removes a little more of them but costs more
+          time than the rest of the query on large dungeons.
+    * A walk has no more points than the part of the path it replaces so the
+      path never grows, and it stays valid and ends at the same target.
+
+@parameters
+    * graph
+        * Graph of the dungeon of the path.
+    * source
+        * Location the path starts from - not part of `path`.
+    * path
+        * Path to smooth - overwritten by the smoothed path.
+    * length
+        * Number of points in `path`.
+        * Must be `> 0`.
+
+@return
+    * Number of points in the smoothed path.
+*/
+static cell_t smoothPath(hpaGraph_t *graph,
+                         point_t     source,
+                         point_t    *path,
+                         cell_t      length)
+{
+    bool isDiagonalFirst;
+    cell_t i, j, last, smoothLength;
+    score_t anchorCost;
+    score_t *costs;
+    point_t anchor, end;
+
+    // cost of the path from `source` to each point
+    costs = malloc(sizeof(score_t) * (size_t)length);
+    assert(costs != NULL);
+
+    anchor = source;
+    for (i = 0; i < length; i += 1)
+    {
+        costs[i] = (i > 0 ? costs[i - 1] : 0)
+                 + (anchor.x != path[i].x && anchor.y != path[i].y
+                    ? COST_DIAGONAL
+                    : COST_CARDINAL);
+        anchor = path[i];
+    }
+
+    // `anchor` is the last point kept and `i` the next point not yet kept
+    smoothLength = 0;
+    anchor = source;
+    anchorCost = 0;
+    isDiagonalFirst = true;
+    i = 0;
+    while (i < length)
+    {
+        // farthest point ahead reached by a cheaper walk than the path - the
+        // path only gets further above the Octile distance the further it
+        // goes so no closer point can be cheaper once one is not
+        last = length - i > graph->clusterSize
+             ? i + graph->clusterSize
+             : length - 1;
+        for (j = last; j > i; j -= 1)
+        {
+            if (distancePoints(anchor, path[j], COST_CARDINAL, COST_DIAGONAL)
+                == costs[j] - anchorCost)
+            {
+                j = i;
+                break;
+            }
+
+            isDiagonalFirst = isOctileWalk(graph, anchor, path[j], true);
+            if (isDiagonalFirst
+                || isOctileWalk(graph, anchor, path[j], false))
+            {
+                break;
+            }
+        }
+
+        end = path[j];
+        if (j == i)
+        {
+            path[smoothLength] = end;
+            smoothLength += 1;
+        }
+        else
+        {
+            smoothLength = addOctileWalk(anchor, end, isDiagonalFirst, path,
+                                         smoothLength);
+        }
+
+        anchor = end;
+        anchorCost = costs[j];
+        i = j + 1;
+    }
+
+    free(costs);
+
+    return smoothLength;
+}
+
+
+/*
+@context
+    * Checks if every move of the Octile walk from `from` to `to` is valid.
+
+@parameters
+    * graph
+        * Graph of the dungeon to walk in.
+    * from
+        * Location to walk from.
+    * to
+        * Location to walk to.
+    * isDiagonalFirst
+        * Indicates diagonal moves are taken before cardinal moves instead
+          of after.
+
+@return
+    * Indication the walk is valid.
+*/
+static bool isOctileWalk(hpaGraph_t *graph,
+                         point_t     from,
+                         point_t     to,
+                         bool        isDiagonalFirst)
+{
+    uint8_t move;
+
+    while (from.x != to.x || from.y != to.y)
+    {
+        move = getOctileMove(from, to, isDiagonalFirst);
+        if (!(getDungeonPointMoves(graph->dungeon, from) >> move & 1))
+        {
+            return false;
+        }
+        from.x += MOVES[move].x;
+        from.y += MOVES[move].y;
+    }
+
+    return true;
+}
+
+
+/*
+@context
+    * Writes the points of the Octile walk from `from` to `to` to `path`.
+
+@parameters
+    * from
+        * Location to walk from - not written.
+    * to
+        * Location to walk to - written last.
+    * isDiagonalFirst
+        * Indicates diagonal moves are taken before cardinal moves instead
+          of after.
+    * path
+        * Path to write the walk to.
+    * length
+        * Number of points in `path` - the walk is written after them.
+
+@return
+    * Number of points in `path` after the walk.
+*/
+static cell_t addOctileWalk(point_t  from,
+                            point_t  to,
+                            bool     isDiagonalFirst,
+                            point_t *path,
+                            cell_t   length)
+{
+    while (!isEqualPoints(from, to))
+    {
+        from = addPoints(from, MOVES[getOctileMove(from, to, isDiagonalFirst)]);
+        path[length] = from;
+        length += 1;
+    }
+
+    return length;
+}
+
+
+/*
+@context
+    * Gets the next move of the Octile walk from `from` to `to`.
+    * The walk takes as many diagonal moves as the shorter axis needs and
+      cardinal moves along the longer axis for the rest, so it costs the
+      Octile distance.
+
+@parameters
+    * from
+        * Location of the walk so far.
+        * Must not be `to`.
+    * to
+        * Location the walk ends at.
+    * isDiagonalFirst
+        * Indicates diagonal moves are taken before cardinal moves instead
+          of after.
+
+@return
+    * Index of the next move of the walk in `MOVES`.
+*/
+static uint8_t getOctileMove(point_t from,
+                             point_t to,
+                             bool    isDiagonalFirst)
+{
+    // index in `MOVES` of each step by `(x + 1, y + 1)` in row-major order
+    static const uint8_t MOVE_INDICES[] = {7, 0, 1, 6, 0, 2, 5, 4, 3};
+    int64_t dx, dy, stepX, stepY;
+
+    dx = (int64_t)to.x - from.x;
+    dy = (int64_t)to.y - from.y;
+    stepX = (dx > 0) - (dx < 0);
+    stepY = (dy > 0) - (dy < 0);
+
+    // cardinal along the longer axis unless it is time for a diagonal move
+    if (!(isDiagonalFirst ? dx != 0 && dy != 0 : llabs(dx) == llabs(dy)))
+    {
+        if (llabs(dx) > llabs(dy))
+        {
+            stepY = 0;
+        }
+        else
+        {
+            stepX = 0;
+        }
+    }
+
+    return MOVE_INDICES[(stepY + 1) * 3 + stepX + 1];
+}
+
+
+/* ------------------------------ END  PRIVATE ------------------------------ */
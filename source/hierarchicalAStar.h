@@ -0,0 +1,53 @@
+/*
+@context
+    * Provides hierarchical path-finding (HPA*) for large dungeons.
+    * The dungeon is split into square clusters.
+        * Entrances are found where 2 neighbouring clusters share open tiles
+          along their border - each becomes a node on both sides.
+        * The distance between every pair of nodes within a cluster is
+          precomputed by searching only the tiles of that cluster.
+    * Queries are answered on the graph of nodes then refined into single
+      steps by searching within each cluster the path passes through.
+        * Paths only cross clusters at entrances so they can detour - each
+          cluster border crossed by a shortest path adds at most
+          `clusterSize` cardinal moves to the cost.
+        * The refined path is smoothed by replacing parts of it with straight
+          walks where cheaper, which removes most of the detours.
+        * A path is found whenever one is possible.
+    * Follows the same movement rules as `isValidMove` and returns paths in the
+      same format as `findPath`.
+        * The path found is dynamically allocated so it must be freed.
+    * Tiles must be changed through `setHpaPoint` so only the clusters around
+      the tile are rebuilt.
+        * `rebuildHpaGraph` must be called after regenerating the dungeon.
+*/
+
+
+#ifndef _HIERARCHICAL_A_STAR_H
+    #define _HIERARCHICAL_A_STAR_H
+
+    #include <stdint.h>
+
+    #include "dataStructs/dungeon.h"
+    #include "dataTypes/point.h"
+
+
+    typedef struct hpaGraph_s hpaGraph_t;
+
+
+    hpaGraph_t *initHpaGraph(dungeon_t *dungeon,
+                             uint16_t   clusterSize);
+
+    void freeHpaGraph(hpaGraph_t *graph);
+
+    void rebuildHpaGraph(hpaGraph_t *graph);
+
+    void setHpaPoint(hpaGraph_t *graph,
+                     point_t     point,
+                     char        tile);
+
+    point_t *findHpaPath(hpaGraph_t *graph,
+                         point_t     source,
+                         point_t     target);
+
+#endif
@@ -0,0 +1,522 @@
+#include "jumpPointSearch.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "aStar.h"
+#include "dataStructs/searchGrid.h"
+
+
+struct jumpContext_s
+{
+    dungeon_t *dungeon;
+
+    searchGrid_t *grid;
+    openList_t *open;
+};
+
+
+static void identifySuccessors(jumpContext_t *context,
+                               point_t        current,
+                               cell_t         currentIndex,
+                               point_t        target);
+
+static uint8_t pruneDirections(jumpContext_t *context,
+                               point_t        current,
+                               point_t        direction,
+                               point_t       *directions);
+
+static bool jump(jumpContext_t *context,
+                 point_t        from,
+                 point_t        direction,
+                 point_t        target,
+                 point_t       *jumpPoint);
+
+static bool isForced(jumpContext_t *context,
+                     point_t        point,
+                     point_t        direction,
+                     point_t        side);
+
+static point_t stepDirection(point_t from,
+                             point_t to);
+
+static point_t *reconstructPath(jumpContext_t *context,
+                                cell_t         sourceIndex,
+                                cell_t         targetIndex);
+
+
+/* ------------------------------ START PUBLIC ------------------------------ */
+
+
+/*
+@context
+    * Initialises a search context to find jump point paths in `dungeon`.
+    * `dungeon` can be regenerated but must not be resized or freed while the
+      context is in use.
+
+@parameters
+    * dungeon
+        * Dungeon to find paths in.
+    * openType
+        * Priority queue used as the open list.
+        * Must not be `OPEN_LIST_BUCKET` - jumps can span the whole dungeon
+          so it would need (and clear before every search) a bucket per
+          f-score across the dungeon.
+
+@return
+    * Search context ready to find paths in `dungeon`.
+*/
+jumpContext_t *initJumpContext(dungeon_t      *dungeon,
+                               openListType_t  openType)
+{
+    jumpContext_t *context;
+
+    assert(openType != OPEN_LIST_BUCKET);
+
+    context = malloc(sizeof(jumpContext_t));
+    assert(context != NULL);
+
+    context->dungeon = dungeon;
+    context->grid = initSearchGrid(getDungeonSize(dungeon));
+    context->open = initOpenList(openType, 0);
+
+    return context;
+}
+
+
+/*
+@context
+    * Frees `context`.
+    * The dungeon of `context` is not freed.
+
+@parameters
+    * context
+        * Search context to free.
+*/
+void freeJumpContext(jumpContext_t *context)
+{
+    freeSearchGrid(context->grid);
+    freeOpenList(context->open);
+    free(context);
+}
+
+
+/*
+@context
+    * Finds shortest path from `source` and `target` in the dungeon of
+      `context` if possible.
+    * Uses Jump Point Search with an Octile distance heuristic.
+        * Only jump points are added to the open list.
+        * The cost between 2 jump points is exact as they share a straight or
+          diagonal line.
+
+@parameters
+    * context
+        * Search context holding the dungeon to find path in.
+    * source
+        * Location to start from.
+    * target
+        * Location to find from `source`.
+
+@return
+    * Shortest path (sequence of points) from `source` to `target`.
+        * `source` is not included.
+        * `target` is included as the last point.
+    * `NULL` if no path is possible.
+*/
+point_t *findJumpPath(jumpContext_t *context,
+                      point_t        source,
+                      point_t        target)
+{
+    cell_t currentIndex, sourceIndex, targetIndex;
+    pointData_t *currentData;
+    point_t *path;
+    point_t current;
+
+    resetSearchGrid(context->grid);
+    clearOpenList(context->open);
+    path = NULL;
+
+    sourceIndex = getDungeonIndex(context->dungeon, source);
+    targetIndex = getDungeonIndex(context->dungeon, target);
+
+    // `source` is its own previous point - marks it as having no direction
+    currentData = getSearchGridCell(context->grid, sourceIndex);
+    currentData->gScore = 0;
+    currentData->prev = sourceIndex;
+    openSearchGridCell(currentData,
+                       context->open,
+                       source,
+                       distancePoints(source,
+                                      target,
+                                      COST_CARDINAL,
+                                      COST_DIAGONAL));
+
+    // search for `target` or until no more jump points to explore
+    while (!isOpenListEmpty(context->open))
+    {
+        // grab next jump point based on the lowest f-score
+        current = getMinOpenData(context->open);
+        freeMinOpenNode(context->open);
+
+        // each jump point is only in `open` once so `current` is never closed
+        currentIndex = getDungeonIndex(context->dungeon, current);
+        currentData = getSearchGridCell(context->grid, currentIndex);
+        currentData->isClosed = true;
+
+        // path found - reconstruct path
+        if (currentIndex == targetIndex)
+        {
+            path = reconstructPath(context, sourceIndex, targetIndex);
+            break;
+        }
+
+        // jump from `current` in each direction that may hold a shorter path
+        identifySuccessors(context, current, currentIndex, target);
+    }
+
+    return path;
+}
+
+
+/* ------------------------------- END PUBLIC ------------------------------- */
+/* ----------------------------- START  PRIVATE ----------------------------- */
+
+
+/*
+@context
+    * Jumps from `current` in each pruned direction and adds the jump points
+      found to the open list.
+
+@parameters
+    * context
+        * Search context holding the dungeon, search state and open list.
+    * current
+        * Jump point to expand.
+    * currentIndex
+        * Cell index of `current`.
+    * target
+        * Location to find from `current`.
+*/
+static void identifySuccessors(jumpContext_t *context,
+                               point_t        current,
+                               cell_t         currentIndex,
+                               point_t        target)
+{
+    uint8_t i, nDirections;
+    score_t gScore, fScore;
+    cell_t jumpIndex;
+    pointData_t *currentData, *jumpData;
+    point_t direction, jumpPoint;
+    point_t directions[8];
+
+    currentData = getSearchGridCell(context->grid, currentIndex);
+
+    // direction `current` was reached from - none for the source
+    direction = stepDirection(
+        getDungeonIndexPoint(context->dungeon, currentData->prev),
+        current);
+
+    nDirections = pruneDirections(context, current, direction, directions);
+    for (i = 0; i < nDirections; i += 1)
+    {
+        if (!jump(context, current, directions[i], target, &jumpPoint))
+        {
+            continue;
+        }
+
+        gScore = currentData->gScore + distancePoints(current,
+                                                      jumpPoint,
+                                                      COST_CARDINAL,
+                                                      COST_DIAGONAL);
+        fScore = gScore + distancePoints(jumpPoint,
+                                         target,
+                                         COST_CARDINAL,
+                                         COST_DIAGONAL);
+
+        // check if this is the new shortest path to `jumpPoint` from the source
+        jumpIndex = getDungeonIndex(context->dungeon, jumpPoint);
+        jumpData = getSearchGridCell(context->grid, jumpIndex);
+        if (gScore < jumpData->gScore)
+        {
+            jumpData->prev = currentIndex;
+            jumpData->gScore = gScore;
+
+            if (!jumpData->isClosed)
+            {
+                openSearchGridCell(jumpData, context->open, jumpPoint, fScore);
+            }
+        }
+    }
+}
+
+
+/*
+@context
+    * Finds the directions worth jumping in from `current`.
+    * Natural directions continue along `direction`.
+        * Diagonal - the diagonal and both of its cardinal components.
+        * Cardinal - straight ahead only.
+    * Forced directions turn around a wall beside a cardinal move.
+    * The source (no `direction`) jumps in all 8 directions.
+
+@parameters
+    * context
+        * Search context holding the dungeon.
+    * current
+        * Jump point to find directions from.
+    * direction
+        * Unit direction `current` was reached in - `(0, 0)` for the source.
+    * directions
+        * Array (of at least 8) to hold the directions found.
+
+@return
+    * Number of directions held in `directions`.
+*/
+static uint8_t pruneDirections(jumpContext_t *context,
+                               point_t        current,
+                               point_t        direction,
+                               point_t       *directions)
+{
+    uint8_t i, n;
+    int8_t side;
+    point_t perpendicular;
+
+    n = 0;
+
+    // source - every direction is natural
+    if (direction.x == 0 && direction.y == 0)
+    {
+        for (i = 0; i < N_MOVES; i += 1)
+        {
+            directions[n] = MOVES[i];
+            n += 1;
+        }
+        return n;
+    }
+
+    directions[n] = direction;
+    n += 1;
+
+    // diagonal - both cardinal components are also natural
+    if (direction.x != 0 && direction.y != 0)
+    {
+        directions[n] = initPoint(direction.x, 0);
+        directions[n + 1] = initPoint(0, direction.y);
+        return n + 2;
+    }
+
+    // cardinal - turn towards each side whose cell behind is a wall
+    for (side = -1; side <= 1; side += 2)
+    {
+        perpendicular = initPoint(direction.y * side, direction.x * side);
+        if (isForced(context, current, direction, perpendicular))
+        {
+            directions[n] = perpendicular;
+            directions[n + 1] = addPoints(direction, perpendicular);
+            n += 2;
+        }
+    }
+
+    return n;
+}
+
+
+/*
+@context
+    * Moves from `from` in `direction` until a jump point is found.
+    * A jump point is `target`, a point with a forced direction or (when moving
+      diagonally) a point whose cardinal components reach a jump point.
+    * Every step must be a valid move so walls and corners stop the jump.
+
+@parameters
+    * context
+        * Search context holding the dungeon.
+    * from
+        * Location to jump from (not itself a candidate).
+    * direction
+        * Unit direction to jump in.
+    * target
+        * Location being searched for.
+    * jumpPoint
+        * Set to the jump point found.
+
+@return
+    * Indication if a jump point was found.
+*/
+static bool jump(jumpContext_t *context,
+                 point_t        from,
+                 point_t        direction,
+                 point_t        target,
+                 point_t       *jumpPoint)
+{
+    int8_t side;
+    point_t current, next, unused, horizontal, vertical;
+
+    current = from;
+    while (true)
+    {
+        next = addPoints(current, direction);
+        if (!isValidMove(context->dungeon, current, next))
+        {
+            return false;
+        }
+        current = next;
+
+        if (isEqualPoints(current, target))
+        {
+            *jumpPoint = current;
+            return true;
+        }
+
+        // diagonal - stop if either cardinal component leads to a jump point
+        if (direction.x != 0 && direction.y != 0)
+        {
+            horizontal = initPoint(direction.x, 0);
+            vertical = initPoint(0, direction.y);
+            if (jump(context, current, horizontal, target, &unused)
+             || jump(context, current, vertical, target, &unused))
+            {
+                *jumpPoint = current;
+                return true;
+            }
+            continue;
+        }
+
+        // cardinal - stop if a wall behind either side opens up
+        for (side = -1; side <= 1; side += 2)
+        {
+            if (isForced(context,
+                         current,
+                         direction,
+                         initPoint(direction.y * side, direction.x * side)))
+            {
+                *jumpPoint = current;
+                return true;
+            }
+        }
+    }
+}
+
+
+/*
+@context
+    * Checks if moving cardinally through `point` forces a turn to `side`.
+    * Forced when the cell to `side` is open but the cell to `side` one step
+      back is a wall - the turn cannot be made earlier without cutting the
+      corner so it must be considered here.
+
+@parameters
+    * context
+        * Search context holding the dungeon.
+    * point
+        * Location being moved through.
+    * direction
+        * Unit cardinal direction of the move.
+    * side
+        * Unit direction perpendicular to `direction`.
+
+@return
+    * Indication if turning to `side` is forced at `point`.
+*/
+static bool isForced(jumpContext_t *context,
+                     point_t        point,
+                     point_t        direction,
+                     point_t        side)
+{
+    point_t behind;
+
+    behind = initPoint(point.x - direction.x + side.x,
+                       point.y - direction.y + side.y);
+
+    return isDungeonWalkable(context->dungeon, addPoints(point, side))
+        && !isDungeonWalkable(context->dungeon, behind);
+}
+
+
+/*
+@context
+    * Finds the unit direction of travel from `from` to `to`.
+
+@parameters
+    * from
+        * Location travelled from.
+    * to
+        * Location travelled to.
+
+@return
+    * Unit direction (each component `-1`, `0` or `1`).
+*/
+static point_t stepDirection(point_t from,
+                             point_t to)
+{
+    return initPoint((to.x > from.x) - (to.x < from.x),
+                     (to.y > from.y) - (to.y < from.y));
+}
+
+
+/*
+@context
+    * Creates an array of points to represent a found path.
+    * Jump points are expanded into the single steps between them.
+    * Assumes path to `target` from `source` has been found.
+
+@parameters
+    * context
+        * Search context holding the search state of each jump point.
+    * sourceIndex
+        * Cell index to stop reconstructing path when moving backwards.
+    * targetIndex
+        * Cell index to start reconstructing path when moving backwards.
+
+@return
+    * Shortest path (sequence of points) from `source` to `target`.
+*/
+static point_t *reconstructPath(jumpContext_t *context,
+                                cell_t         sourceIndex,
+                                cell_t         targetIndex)
+{
+    point_t *path;
+    point_t current, prev, step;
+    cell_t index, length, i;
+
+    // find length of `path` - each jump is as many steps as its longest axis
+    length = 0;
+    index = targetIndex;
+    while (index != sourceIndex)
+    {
+        current = getDungeonIndexPoint(context->dungeon, index);
+        index = getSearchGridCell(context->grid, index)->prev;
+        length += distancePoints(current,
+                                 getDungeonIndexPoint(context->dungeon, index),
+                                 1,
+                                 1);
+    }
+
+    path = malloc(sizeof(point_t) * (size_t)length);
+    assert(path != NULL);
+
+    // reconstruct `path` in reverse, stepping back along each jump
+    i = length;
+    index = targetIndex;
+    while (index != sourceIndex)
+    {
+        current = getDungeonIndexPoint(context->dungeon, index);
+        index = getSearchGridCell(context->grid, index)->prev;
+        prev = getDungeonIndexPoint(context->dungeon, index);
+
+        step = stepDirection(current, prev);
+        while (!isEqualPoints(current, prev))
+        {
+            i -= 1;
+            path[i] = current;
+            current = addPoints(current, step);
+        }
+    }
+
+    return path;
+}
+
+
+/* ------------------------------ END  PRIVATE ------------------------------ */
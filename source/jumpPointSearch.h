@@ -0,0 +1,37 @@
+/*
+@context
+    * Provides a method of finding the shortest path between 2 points in a
+      dungeon using Jump Point Search (JPS).
+    * JPS is A* that skips over points along straight and diagonal lines that
+      only symmetric paths pass through, so far fewer points enter the open
+      list.
+    * Follows the same movement rules as `isValidMove`.
+        * Diagonal moves cannot cut around wall corners.
+    * Finds a path of the same cost as `findPath` in the same format.
+        * Jump points are expanded back into single steps.
+    * The path found is dynamically allocated so it must be freed.
+    * A search context can be reused between searches on the same dungeon.
+*/
+
+
+#ifndef _JUMP_POINT_SEARCH_H
+    #define _JUMP_POINT_SEARCH_H
+
+    #include "dataStructs/dungeon.h"
+    #include "dataStructs/openList.h"
+    #include "dataTypes/point.h"
+
+
+    typedef struct jumpContext_s jumpContext_t;
+
+
+    jumpContext_t *initJumpContext(dungeon_t      *dungeon,
+                                   openListType_t  openType);
+
+    void freeJumpContext(jumpContext_t *context);
+
+    point_t *findJumpPath(jumpContext_t *context,
+                          point_t        source,
+                          point_t        target);
+
+#endif
@@ -0,0 +1,406 @@
+#include "landmarks.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "flowField.h"
+
+
+struct landmarks_s
+{
+    dungeon_t *dungeon;
+
+    uint32_t nLandmarks;
+    point_t *points;
+
+    // distance of cell `i` from landmark `j` is at `i * nLandmarks + j` -
+    // `SCORE_MAX` if it cannot reach the landmark
+    score_t *distances;
+
+    // version of `dungeon` the tables were built from
+    uint64_t version;
+};
+
+
+static point_t findLargestComponent(dungeon_t *dungeon);
+static point_t findFarthestPoint(landmarks_t *landmarks,
+                                 score_t     *distances);
+static void addLandmark(landmarks_t *landmarks,
+                        uint32_t     landmark,
+                        score_t     *nearest);
+
+
+/* ------------------------------ START PUBLIC ------------------------------ */
+
+
+/*
+@context
+    * Initialises and builds the landmark distance tables of `dungeon`.
+    * `dungeon` must not be resized or freed while the tables are in use.
+
+@parameters
+    * dungeon
+        * Dungeon to choose landmarks in.
+    * nLandmarks
+        * Number of landmarks to choose.
+        * Must be `> 0`.
+        * Landmarks may repeat if the largest component has fewer points.
+
+@return
+    * Landmark distance tables of `dungeon`.
+*/
+landmarks_t *initLandmarks(dungeon_t *dungeon,
+                           uint32_t   nLandmarks)
+{
+    landmarks_t *landmarks;
+
+    assert(nLandmarks > 0);
+
+    landmarks = malloc(sizeof(landmarks_t));
+    assert(landmarks != NULL);
+
+    landmarks->dungeon = dungeon;
+    landmarks->nLandmarks = nLandmarks;
+
+    landmarks->points = malloc(sizeof(point_t) * nLandmarks);
+    assert(landmarks->points != NULL);
+    landmarks->distances = malloc(sizeof(score_t) * nLandmarks
+                                  * (size_t)getDungeonSize(dungeon));
+    assert(landmarks->distances != NULL);
+
+    rebuildLandmarks(landmarks);
+
+    return landmarks;
+}
+
+
+/*
+@context
+    * Frees `landmarks`.
+    * The dungeon of `landmarks` is not freed.
+
+@parameters
+    * landmarks
+        * Landmark distance tables to free.
+*/
+void freeLandmarks(landmarks_t *landmarks)
+{
+    free(landmarks->points);
+    free(landmarks->distances);
+    free(landmarks);
+}
+
+
+/*
+@context
+    * Chooses the landmarks of the dungeon of `landmarks` again and builds
+      their distance tables.
+    * The first landmark is the point farthest from a point of the largest
+      connected component and each next landmark is the point farthest from
+      its nearest landmark so far.
+        * Landmarks spread to the ends of the dungeon where their bounds are
+          tightest.
+    * Costs a reverse Dijkstra search of the dungeon per landmark (and 1 to
+      find the first).
+
+@parameters
+    * landmarks
+        * Landmark distance tables to rebuild.
+*/
+void rebuildLandmarks(landmarks_t *landmarks)
+{
+    uint32_t i;
+    cell_t j, size;
+    score_t *nearest;
+
+    size = getDungeonSize(landmarks->dungeon);
+
+    // distance from the nearest landmark so far of every cell
+    nearest = malloc(sizeof(score_t) * (size_t)size);
+    assert(nearest != NULL);
+
+    // cells padding the dungeon to whole tiles are never searched
+    for (j = 0; j < size * landmarks->nLandmarks; j += 1)
+    {
+        landmarks->distances[j] = SCORE_MAX;
+    }
+
+    // a point of the largest component stands in as the first landmark so
+    // the first landmark chosen is the point farthest from it
+    for (j = 0; j < size; j += 1)
+    {
+        nearest[j] = SCORE_MAX;
+    }
+    landmarks->points[0] = findLargestComponent(landmarks->dungeon);
+    addLandmark(landmarks, 0, nearest);
+    landmarks->points[0] = findFarthestPoint(landmarks, nearest);
+
+    for (j = 0; j < size; j += 1)
+    {
+        nearest[j] = SCORE_MAX;
+    }
+    for (i = 0; i < landmarks->nLandmarks; i += 1)
+    {
+        if (i > 0)
+        {
+            landmarks->points[i] = findFarthestPoint(landmarks, nearest);
+        }
+        addLandmark(landmarks, i, nearest);
+    }
+
+    landmarks->version = getDungeonVersion(landmarks->dungeon);
+
+    free(nearest);
+}
+
+
+/*
+@context
+    * Gets the lower bound on the cost of the shortest path from cell `index`
+      to cell `targetIndex` given by the landmarks.
+    * The largest `|d(L, target) - d(L, index)|` over landmarks `L` both can
+      reach.
+    * Only valid while `isLandmarksCurrent`.
+
+@parameters
+    * landmarks
+        * Landmark distance tables of the dungeon.
+    * index
+        * Cell index to bound the cost from.
+    * targetIndex
+        * Cell index to bound the cost to.
+
+@return
+    * Lower bound on the cost of the shortest path.
+    * `0` if no landmark can reach both cells.
+*/
+score_t getLandmarkBound(landmarks_t *landmarks,
+                         cell_t       index,
+                         cell_t       targetIndex)
+{
+    uint32_t i;
+    score_t bound, difference;
+    score_t *from, *to;
+
+    from = landmarks->distances + index * landmarks->nLandmarks;
+    to = landmarks->distances + targetIndex * landmarks->nLandmarks;
+
+    bound = 0;
+    for (i = 0; i < landmarks->nLandmarks; i += 1)
+    {
+        if (from[i] == SCORE_MAX || to[i] == SCORE_MAX)
+        {
+            continue;
+        }
+
+        difference = from[i] > to[i] ? from[i] - to[i] : to[i] - from[i];
+        if (difference > bound)
+        {
+            bound = difference;
+        }
+    }
+
+    return bound;
+}
+
+
+/*
+@context
+    * Gets the number of landmarks of `landmarks`.
+
+@parameters
+    * landmarks
+        * Landmark distance tables to get number of landmarks of.
+
+@return
+    * Number of landmarks.
+*/
+uint32_t getLandmarkCount(landmarks_t *landmarks)
+{
+    return landmarks->nLandmarks;
+}
+
+
+/*
+@context
+    * Gets a landmark of `landmarks`.
+
+@parameters
+    * landmarks
+        * Landmark distance tables to get landmark of.
+    * landmark
+        * Index of the landmark - in the order they were chosen.
+        * Must be `< getLandmarkCount`.
+
+@return
+    * Location of the landmark.
+*/
+point_t getLandmark(landmarks_t *landmarks,
+                    uint32_t     landmark)
+{
+    assert(landmark < landmarks->nLandmarks);
+    return landmarks->points[landmark];
+}
+
+
+/*
+@context
+    * Gets the bytes of the distance tables of `landmarks`.
+    * A `score_t` for every cell of the dungeon per landmark.
+
+@parameters
+    * landmarks
+        * Landmark distance tables to get bytes of.
+
+@return
+    * Number of bytes of distance tables.
+*/
+uint64_t getLandmarkBytes(landmarks_t *landmarks)
+{
+    return sizeof(score_t) * (uint64_t)landmarks->nLandmarks
+         * getDungeonSize(landmarks->dungeon);
+}
+
+
+/*
+@context
+    * Checks if the distance tables of `landmarks` were built from the current
+      version of its dungeon.
+
+@parameters
+    * landmarks
+        * Landmark distance tables to check.
+
+@return
+    * Indication the tables can be used for bounds.
+*/
+bool isLandmarksCurrent(landmarks_t *landmarks)
+{
+    return landmarks->version == getDungeonVersion(landmarks->dungeon);
+}
+
+
+/* ------------------------------- END PUBLIC ------------------------------- */
+/* ----------------------------- START  PRIVATE ----------------------------- */
+
+
+/*
+@context
+    * Finds a walkable point of the largest connected component of `dungeon`.
+
+@parameters
+    * dungeon
+        * Dungeon to find point in.
+
+@return
+    * First point of the largest component in row-major order.
+    * `(0, 0)` if `dungeon` has no walkable points.
+*/
+static point_t findLargestComponent(dungeon_t *dungeon)
+{
+    uint32_t x, y;
+    cell_t size, largest;
+    point_t point, start;
+
+    largest = 0;
+    start = initPoint(0, 0);
+    for (y = 0; y < getDungeonHeight(dungeon); y += 1)
+    {
+        for (x = 0; x < getDungeonWidth(dungeon); x += 1)
+        {
+            point = initPoint(x, y);
+            size = getDungeonComponentSize(dungeon, point);
+            if (size > largest)
+            {
+                largest = size;
+                start = point;
+            }
+        }
+    }
+
+    return start;
+}
+
+
+/*
+@context
+    * Finds the point farthest from its nearest landmark.
+    * Points that cannot reach any landmark are skipped.
+
+@parameters
+    * landmarks
+        * Landmark distance tables of the dungeon.
+    * distances
+        * Distance of every cell from its nearest landmark.
+
+@return
+    * Farthest point - the first in cell order if several tie.
+*/
+static point_t findFarthestPoint(landmarks_t *landmarks,
+                                 score_t     *distances)
+{
+    cell_t i, farthest;
+
+    farthest = 0;
+    for (i = 0; i < getDungeonSize(landmarks->dungeon); i += 1)
+    {
+        if (distances[i] != SCORE_MAX
+            && (distances[farthest] == SCORE_MAX
+                || distances[i] > distances[farthest]))
+        {
+            farthest = i;
+        }
+    }
+
+    return getDungeonIndexPoint(landmarks->dungeon, farthest);
+}
+
+
+/*
+@context
+    * Builds the distance table of a landmark and lowers the distance from
+      the nearest landmark of every cell it is nearer to.
+
+@parameters
+    * landmarks
+        * Landmark distance tables of the dungeon.
+    * landmark
+        * Index of the landmark to build - its point must be set.
+    * nearest
+        * Distance of every cell from its nearest landmark.
+*/
+static void addLandmark(landmarks_t *landmarks,
+                        uint32_t     landmark,
+                        score_t     *nearest)
+{
+    uint32_t x, y;
+    cell_t index;
+    score_t distance;
+    flowField_t *field;
+    point_t point;
+
+    // moves are valid both ways so the distance to a landmark is the
+    // distance from it
+    field = initFlowField(landmarks->dungeon, landmarks->points[landmark]);
+
+    for (y = 0; y < getDungeonHeight(landmarks->dungeon); y += 1)
+    {
+        for (x = 0; x < getDungeonWidth(landmarks->dungeon); x += 1)
+        {
+            point = initPoint(x, y);
+            index = getDungeonIndex(landmarks->dungeon, point);
+            distance = getFlowDistance(field, point);
+
+            landmarks->distances[index * landmarks->nLandmarks + landmark]
+                = distance;
+            if (distance < nearest[index])
+            {
+                nearest[index] = distance;
+            }
+        }
+    }
+
+    freeFlowField(field);
+}
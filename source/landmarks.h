@@ -0,0 +1,58 @@
+/*
+@context
+    * Provides ALT (A*, landmarks, triangle inequality) distance tables of a
+      dungeon for a tighter A* heuristic than Octile distance.
+    * A few walkable points are chosen as landmarks and the exact distance of
+      every point from each is precomputed with a reverse Dijkstra search
+      (see `flowField.h`).
+        * Landmarks are chosen farthest first within the largest connected
+          component - each is the point farthest from the landmarks before
+          it.
+        * Distances of a point from every landmark are stored together so a
+          heuristic lookup reads 1 cache line.
+    * By the triangle inequality the shortest path from `a` to `b` costs at
+      least `|d(L, b) - d(L, a)|` for every landmark `L`.
+        * Walls are accounted for so the bound is often much tighter than
+          Octile distance in winding dungeons.
+        * The largest bound over the landmarks is consistent so A* can use it
+          with any open list type.
+    * Each landmark takes a `score_t` for every cell of the dungeon.
+    * Tables are only current for the version of the dungeon they were built
+      from (see `getDungeonVersion`).
+        * `rebuildLandmarks` must be called after changing the dungeon - A*
+          falls back to Octile distance while they are out of date.
+*/
+
+
+#ifndef _LANDMARKS_H
+    #define _LANDMARKS_H
+
+    #include <stdbool.h>
+    #include <stdint.h>
+
+    #include "dataStructs/dungeon.h"
+    #include "dataTypes/point.h"
+
+
+    typedef struct landmarks_s landmarks_t;
+
+
+    landmarks_t *initLandmarks(dungeon_t *dungeon,
+                               uint32_t   nLandmarks);
+
+    void freeLandmarks(landmarks_t *landmarks);
+
+    void rebuildLandmarks(landmarks_t *landmarks);
+
+    score_t getLandmarkBound(landmarks_t *landmarks,
+                             cell_t       index,
+                             cell_t       targetIndex);
+
+    uint32_t getLandmarkCount(landmarks_t *landmarks);
+    point_t getLandmark(landmarks_t *landmarks,
+                        uint32_t     landmark);
+    uint64_t getLandmarkBytes(landmarks_t *landmarks);
+
+    bool isLandmarksCurrent(landmarks_t *landmarks);
+
+#endif
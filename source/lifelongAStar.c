@@ -0,0 +1,835 @@
+#include "lifelongAStar.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "aStar.h"
+
+
+// marks a point not in the queue of inconsistent points
+static const cell_t NO_POSITION = CELL_MAX;
+
+// initial capacity of the queue and the list of cells to repair - grown by
+// doubling
+static const cell_t QUEUE_CAPACITY = 64;
+
+
+typedef struct lpaCell_s lpaCell_t;
+typedef struct lpaKey_s lpaKey_t;
+typedef struct lpaNode_s lpaNode_t;
+
+
+struct lpaCell_s
+{
+    // distance from the source when last expanded and the distance through
+    // its best predecessor - the point is consistent when they are equal
+    score_t gScore;
+    score_t rhsScore;
+
+    // index of the point in the queue (`NO_POSITION` if consistent)
+    cell_t position;
+};
+
+// queue priority - compared by `primary` then `secondary`
+struct lpaKey_s
+{
+    score_t primary;
+    score_t secondary;
+};
+
+struct lpaNode_s
+{
+    lpaKey_t key;
+    cell_t index;
+};
+
+struct lpaPlanner_s
+{
+    dungeon_t *dungeon;
+
+    // signed to compare with coordinates
+    int64_t width;
+    int64_t height;
+
+    // cell indices between rows of tiles (see `getMoveIndex`)
+    int64_t rowStride;
+
+    point_t target;
+    cell_t sourceIndex;
+    cell_t targetIndex;
+
+    // search state of every cell - kept between searches
+    lpaCell_t *cells;
+
+    // binary min heap of inconsistent points
+    lpaNode_t *queue;
+    cell_t queueSize;
+    cell_t queueCapacity;
+
+    // cells around tiles changed since the last search - each listed once and
+    // repaired by the next search
+    cell_t *repairs;
+    cell_t nRepairs;
+    cell_t repairCapacity;
+    bool *isRepairing;
+
+    // points expanded in the last search
+    cell_t nExpanded;
+};
+
+
+static void addRepair(lpaPlanner_t *planner,
+                      cell_t        index);
+static void repairCells(lpaPlanner_t *planner);
+static void computeShortestPath(lpaPlanner_t *planner);
+static void updateCell(lpaPlanner_t *planner,
+                       cell_t        index);
+static score_t getLookahead(lpaPlanner_t *planner,
+                            cell_t        index,
+                            cell_t       *bestIndex);
+static score_t moveCost(uint8_t move);
+
+static lpaKey_t getKey(lpaPlanner_t *planner,
+                       cell_t        index);
+static bool isKeyBefore(lpaKey_t a,
+                        lpaKey_t b);
+
+static void updateQueue(lpaPlanner_t *planner,
+                        cell_t        index);
+static void removeQueueNode(lpaPlanner_t *planner,
+                            cell_t        position);
+static void setQueueNode(lpaPlanner_t *planner,
+                         cell_t        position,
+                         lpaNode_t     node);
+static void siftUp(lpaPlanner_t *planner,
+                   cell_t        position);
+static void siftDown(lpaPlanner_t *planner,
+                     cell_t        position);
+
+static point_t *reconstructPath(lpaPlanner_t *planner);
+
+
+/* ------------------------------ START PUBLIC ------------------------------ */
+
+
+/*
+@context
+    * Initialises a planner of the path from `source` to `target` in
+      `dungeon`.
+    * Nothing is searched until the first `findLpaPath`.
+    * `source` must stay walkable - distances are only passed on between
+      walkable tiles.
+    * `dungeon` must only change through `setLpaPoint` and must not be resized
+      or freed while the planner is in use.
+
+@parameters
+    * dungeon
+        * Dungeon to find paths in.
+    * source
+        * Location to start from.
+    * target
+        * Location to find from `source`.
+
+@return
+    * Planner ready to find paths in `dungeon`.
+*/
+lpaPlanner_t *initLpaPlanner(dungeon_t *dungeon,
+                             point_t    source,
+                             point_t    target)
+{
+    cell_t i;
+    lpaPlanner_t *planner;
+
+    planner = malloc(sizeof(lpaPlanner_t));
+    assert(planner != NULL);
+
+    planner->dungeon = dungeon;
+    planner->width = getDungeonWidth(dungeon);
+    planner->height = getDungeonHeight(dungeon);
+    planner->rowStride = getDungeonRowStride(dungeon);
+    planner->target = target;
+    planner->sourceIndex = getDungeonIndex(dungeon, source);
+    planner->targetIndex = getDungeonIndex(dungeon, target);
+    planner->nExpanded = 0;
+
+    planner->cells = malloc(sizeof(lpaCell_t)
+                            * (size_t)getDungeonSize(dungeon));
+    assert(planner->cells != NULL);
+    for (i = 0; i < getDungeonSize(dungeon); i += 1)
+    {
+        planner->cells[i].gScore = SCORE_MAX;
+        planner->cells[i].rhsScore = SCORE_MAX;
+        planner->cells[i].position = NO_POSITION;
+    }
+
+    planner->queueCapacity = QUEUE_CAPACITY;
+    planner->queue = malloc(sizeof(lpaNode_t)
+                            * (size_t)planner->queueCapacity);
+    assert(planner->queue != NULL);
+    planner->queueSize = 0;
+
+    planner->repairCapacity = QUEUE_CAPACITY;
+    planner->repairs = malloc(sizeof(cell_t)
+                              * (size_t)planner->repairCapacity);
+    assert(planner->repairs != NULL);
+    planner->nRepairs = 0;
+    planner->isRepairing = calloc((size_t)getDungeonSize(dungeon),
+                                  sizeof(bool));
+    assert(planner->isRepairing != NULL);
+
+    // the source is the only point whose distance is known
+    planner->cells[planner->sourceIndex].rhsScore = 0;
+    updateQueue(planner, planner->sourceIndex);
+
+    return planner;
+}
+
+
+/*
+@context
+    * Frees `planner`.
+    * The dungeon of `planner` is not freed.
+
+@parameters
+    * planner
+        * Planner to free.
+*/
+void freeLpaPlanner(lpaPlanner_t *planner)
+{
+    free(planner->cells);
+    free(planner->queue);
+    free(planner->repairs);
+    free(planner->isRepairing);
+    free(planner);
+}
+
+
+/*
+@context
+    * Sets tile character representation at `point` of the dungeon of
+      `planner`.
+    * Marks the 3x3 block around `point` for repair by the next search.
+        * The tile is the target or a corner of every move it changes so each
+          move changed enters a point of the block.
+        * Each cell is repaired once however many changed tiles it is next to
+          (e.g. 25 cells for a 3x3 region instead of 81).
+
+@parameters
+    * planner
+        * Planner of the dungeon to set tile of.
+    * point
+        * Location of tile to set.
+        * Assumes `point` is within the dungeon bounds.
+    * tile
+        * Character representation to set tile to.
+*/
+void setLpaPoint(lpaPlanner_t *planner,
+                 point_t       point,
+                 char          tile)
+{
+    int64_t x, y;
+
+    setDungeonPoint(planner->dungeon, point, tile);
+
+    for (y = point.y - 1; y <= point.y + 1; y += 1)
+    {
+        for (x = point.x - 1; x <= point.x + 1; x += 1)
+        {
+            if (x >= 0 && x < planner->width && y >= 0 && y < planner->height)
+            {
+                addRepair(planner,
+                          getDungeonIndex(planner->dungeon, initPoint(x, y)));
+            }
+        }
+    }
+}
+
+
+/*
+@context
+    * Finds shortest path from the source to the target of `planner` if
+      possible.
+    * Only points made inconsistent by changes since the last search (or
+      every point needed on the first search) are expanded.
+
+@parameters
+    * planner
+        * Planner to find path of.
+
+@return
+    * Shortest path (sequence of points) from the source to the target.
+        * The source is not included.
+        * The target is included as the last point.
+    * `NULL` if no path is possible.
+*/
+point_t *findLpaPath(lpaPlanner_t *planner)
+{
+    repairCells(planner);
+    computeShortestPath(planner);
+
+    if (planner->cells[planner->targetIndex].gScore == SCORE_MAX)
+    {
+        return NULL;
+    }
+    return reconstructPath(planner);
+}
+
+
+/*
+@context
+    * Gets the number of points expanded in the last search of `planner`.
+    * A point is expanded each time it is taken from the queue - a point can be
+      expanded twice when its distance grew.
+
+@parameters
+    * planner
+        * Planner to get number of expansions of.
+
+@return
+    * Number of points expanded.
+*/
+cell_t getLpaExpansions(lpaPlanner_t *planner)
+{
+    return planner->nExpanded;
+}
+
+
+/* ------------------------------- END PUBLIC ------------------------------- */
+/* ----------------------------- START  PRIVATE ----------------------------- */
+
+
+/*
+@context
+    * Lists cell `index` for repair by the next search unless already listed.
+
+@parameters
+    * planner
+        * Planner holding the cell.
+    * index
+        * Cell index to repair.
+*/
+static void addRepair(lpaPlanner_t *planner,
+                      cell_t        index)
+{
+    if (planner->isRepairing[index])
+    {
+        return;
+    }
+
+    if (planner->nRepairs == planner->repairCapacity)
+    {
+        planner->repairCapacity *= 2;
+        planner->repairs = realloc(planner->repairs,
+                                   sizeof(cell_t)
+                                   * (size_t)planner->repairCapacity);
+        assert(planner->repairs != NULL);
+    }
+
+    planner->isRepairing[index] = true;
+    planner->repairs[planner->nRepairs] = index;
+    planner->nRepairs += 1;
+}
+
+
+/*
+@context
+    * Recomputes the distance through the best predecessor of every cell listed
+      for repair and queues those made inconsistent.
+    * Distances only change while searching so repairing once before the
+      search is the same as repairing after each change.
+
+@parameters
+    * planner
+        * Planner to repair.
+*/
+static void repairCells(lpaPlanner_t *planner)
+{
+    cell_t i;
+
+    for (i = 0; i < planner->nRepairs; i += 1)
+    {
+        planner->isRepairing[planner->repairs[i]] = false;
+        updateCell(planner, planner->repairs[i]);
+    }
+    planner->nRepairs = 0;
+}
+
+
+/*
+@context
+    * Expands inconsistent points in key order until the distance of the
+      target is known.
+    * Over-consistent points (distance lowered) take their new distance and
+      may lower their successors.
+    * Under-consistent points (distance grew) forget their distance so it is
+      found again and their successors recheck their best predecessor.
+
+@parameters
+    * planner
+        * Planner to search.
+*/
+static void computeShortestPath(lpaPlanner_t *planner)
+{
+    uint8_t i, moves;
+    score_t oldScore, score;
+    cell_t currentIndex, neighbourIndex;
+    lpaCell_t *current, *neighbour, *target;
+
+    planner->nExpanded = 0;
+    target = &planner->cells[planner->targetIndex];
+
+    while (planner->queueSize > 0
+           && (isKeyBefore(planner->queue[0].key,
+                           getKey(planner, planner->targetIndex))
+               || target->rhsScore != target->gScore))
+    {
+        currentIndex = planner->queue[0].index;
+        current = &planner->cells[currentIndex];
+        planner->nExpanded += 1;
+
+        // a point whose distance grew stays queued (moved to its new key)
+        // unless it has no predecessor left
+        oldScore = current->gScore;
+        if (current->gScore > current->rhsScore)
+        {
+            current->gScore = current->rhsScore;
+            removeQueueNode(planner, 0);
+        }
+        else
+        {
+            current->gScore = SCORE_MAX;
+            updateQueue(planner, currentIndex);
+        }
+
+        moves = getDungeonMoves(planner->dungeon, currentIndex);
+        for (i = 0; moves != 0; i += 1, moves >>= 1)
+        {
+            if (!(moves & 1))
+            {
+                continue;
+            }
+
+            // the source keeps a distance of `0`
+            neighbourIndex = getMoveIndex(planner->rowStride,
+                                          currentIndex,
+                                          MOVES[i]);
+            if (neighbourIndex == planner->sourceIndex)
+            {
+                continue;
+            }
+            neighbour = &planner->cells[neighbourIndex];
+
+            // lowered - `current` may now be the best predecessor
+            if (current->gScore != SCORE_MAX)
+            {
+                score = current->gScore + moveCost(i);
+                if (score < neighbour->rhsScore)
+                {
+                    neighbour->rhsScore = score;
+                    updateQueue(planner, neighbourIndex);
+                }
+            }
+            // grew - find another predecessor if `current` was the best
+            else if (oldScore != SCORE_MAX
+                     && neighbour->rhsScore == oldScore + moveCost(i))
+            {
+                updateCell(planner, neighbourIndex);
+            }
+        }
+    }
+}
+
+
+/*
+@context
+    * Recomputes the distance of cell `index` through its best predecessor and
+      queues it if inconsistent.
+    * The source always has a distance of `0`.
+
+@parameters
+    * planner
+        * Planner holding the cell.
+    * index
+        * Cell index to update.
+*/
+static void updateCell(lpaPlanner_t *planner,
+                       cell_t        index)
+{
+    cell_t bestIndex;
+
+    if (index != planner->sourceIndex)
+    {
+        planner->cells[index].rhsScore = getLookahead(planner,
+                                                      index,
+                                                      &bestIndex);
+    }
+    updateQueue(planner, index);
+}
+
+
+/*
+@context
+    * Finds the cheapest distance to cell `index` through one of its
+      predecessors (points with a valid move into it).
+    * Moves between walkable tiles are valid in both directions so the
+      predecessors of a walkable tile are the points it can move to.
+        * Nothing can move into a wall.
+
+@parameters
+    * planner
+        * Planner holding the cell.
+    * index
+        * Cell index to find distance of.
+    * bestIndex
+        * Set to the cell index of the best predecessor.
+        * Left unchanged if no predecessor has a distance.
+
+@return
+    * Cheapest distance through a predecessor - `SCORE_MAX` if none.
+*/
+static score_t getLookahead(lpaPlanner_t *planner,
+                            cell_t        index,
+                            cell_t       *bestIndex)
+{
+    uint8_t i, moves;
+    score_t best, score;
+    cell_t neighbourIndex;
+
+    best = SCORE_MAX;
+    if (!isDungeonWalkable(planner->dungeon,
+                           getDungeonIndexPoint(planner->dungeon, index)))
+    {
+        return best;
+    }
+
+    moves = getDungeonMoves(planner->dungeon, index);
+    for (i = 0; moves != 0; i += 1, moves >>= 1)
+    {
+        if (!(moves & 1))
+        {
+            continue;
+        }
+
+        neighbourIndex = getMoveIndex(planner->rowStride, index, MOVES[i]);
+        if (planner->cells[neighbourIndex].gScore == SCORE_MAX)
+        {
+            continue;
+        }
+
+        score = planner->cells[neighbourIndex].gScore + moveCost(i);
+        if (score < best)
+        {
+            best = score;
+            *bestIndex = neighbourIndex;
+        }
+    }
+
+    return best;
+}
+
+
+/*
+@context
+    * Determine the cost of moving by `MOVES[move]`.
+
+@parameters
+    * move
+        * Index of the move in `MOVES`.
+
+@return
+    * Cost of the move.
+*/
+static score_t moveCost(uint8_t move)
+{
+    // only moving in x or y direction not both
+    if (MOVES[move].x == 0 || MOVES[move].y == 0)
+    {
+        return COST_CARDINAL;
+    }
+    return COST_DIAGONAL;
+}
+
+
+/*
+@context
+    * Finds the queue priority of cell `index` from its distances.
+        * Primary is the f-score of its smaller distance.
+        * Secondary is its smaller distance so ties favour points nearer the
+          source.
+
+@parameters
+    * planner
+        * Planner holding the cell.
+    * index
+        * Cell index to find key of.
+
+@return
+    * Key of cell `index`.
+*/
+static lpaKey_t getKey(lpaPlanner_t *planner,
+                       cell_t        index)
+{
+    lpaKey_t key;
+    lpaCell_t *cell;
+
+    cell = &planner->cells[index];
+    key.secondary = cell->gScore < cell->rhsScore
+                  ? cell->gScore
+                  : cell->rhsScore;
+    key.primary = key.secondary == SCORE_MAX
+                ? SCORE_MAX
+                : key.secondary
+                  + distancePoints(getDungeonIndexPoint(planner->dungeon,
+                                                        index),
+                                   planner->target,
+                                   COST_CARDINAL,
+                                   COST_DIAGONAL);
+
+    return key;
+}
+
+
+/*
+@context
+    * Compares 2 keys by primary then secondary priority.
+
+@parameters
+    * a
+        * Key to check is first.
+    * b
+        * Key to compare against.
+
+@return
+    * Indication if `a` is strictly before `b`.
+*/
+static bool isKeyBefore(lpaKey_t a,
+                        lpaKey_t b)
+{
+    return a.primary < b.primary
+        || (a.primary == b.primary && a.secondary < b.secondary);
+}
+
+
+/*
+@context
+    * Keeps cell `index` in the queue only while it is inconsistent.
+        * Inserted, moved to its new key or removed as needed.
+
+@parameters
+    * planner
+        * Planner holding the queue.
+    * index
+        * Cell index whose distances changed.
+*/
+static void updateQueue(lpaPlanner_t *planner,
+                        cell_t        index)
+{
+    lpaCell_t *cell;
+    lpaNode_t node;
+
+    cell = &planner->cells[index];
+    if (cell->gScore == cell->rhsScore)
+    {
+        if (cell->position != NO_POSITION)
+        {
+            removeQueueNode(planner, cell->position);
+        }
+        return;
+    }
+
+    node.key = getKey(planner, index);
+    node.index = index;
+
+    if (cell->position != NO_POSITION)
+    {
+        setQueueNode(planner, cell->position, node);
+        siftUp(planner, cell->position);
+        siftDown(planner, cell->position);
+        return;
+    }
+
+    if (planner->queueSize == planner->queueCapacity)
+    {
+        planner->queueCapacity *= 2;
+        planner->queue = realloc(planner->queue,
+                                 sizeof(lpaNode_t)
+                                 * (size_t)planner->queueCapacity);
+        assert(planner->queue != NULL);
+    }
+
+    planner->queueSize += 1;
+    setQueueNode(planner, planner->queueSize - 1, node);
+    siftUp(planner, planner->queueSize - 1);
+}
+
+
+/*
+@context
+    * Removes the node at `position` from the queue.
+    * The last node fills its place then moves to keep the heap ordered.
+
+@parameters
+    * planner
+        * Planner holding the queue.
+    * position
+        * Index of the node in the queue.
+*/
+static void removeQueueNode(lpaPlanner_t *planner,
+                            cell_t        position)
+{
+    planner->cells[planner->queue[position].index].position = NO_POSITION;
+    planner->queueSize -= 1;
+
+    if (position < planner->queueSize)
+    {
+        setQueueNode(planner, position, planner->queue[planner->queueSize]);
+        siftUp(planner, position);
+        siftDown(planner, position);
+    }
+}
+
+
+/*
+@context
+    * Places `node` at `position` of the queue and records its position.
+
+@parameters
+    * planner
+        * Planner holding the queue.
+    * position
+        * Index in the queue to place `node` at.
+    * node
+        * Node to place.
+*/
+static void setQueueNode(lpaPlanner_t *planner,
+                         cell_t        position,
+                         lpaNode_t     node)
+{
+    planner->queue[position] = node;
+    planner->cells[node.index].position = position;
+}
+
+
+/*
+@context
+    * Moves the node at `position` towards the root until its parent is not
+      after it.
+
+@parameters
+    * planner
+        * Planner holding the queue.
+    * position
+        * Index of the node in the queue.
+*/
+static void siftUp(lpaPlanner_t *planner,
+                   cell_t        position)
+{
+    cell_t parent;
+    lpaNode_t node;
+
+    node = planner->queue[position];
+    while (position > 0)
+    {
+        parent = (position - 1) / 2;
+        if (!isKeyBefore(node.key, planner->queue[parent].key))
+        {
+            break;
+        }
+
+        setQueueNode(planner, position, planner->queue[parent]);
+        position = parent;
+    }
+    setQueueNode(planner, position, node);
+}
+
+
+/*
+@context
+    * Moves the node at `position` away from the root until no child is before
+      it.
+
+@parameters
+    * planner
+        * Planner holding the queue.
+    * position
+        * Index of the node in the queue.
+*/
+static void siftDown(lpaPlanner_t *planner,
+                     cell_t        position)
+{
+    cell_t child;
+    lpaNode_t node;
+
+    node = planner->queue[position];
+    while (2 * position + 1 < planner->queueSize)
+    {
+        child = 2 * position + 1;
+        if (child + 1 < planner->queueSize
+            && isKeyBefore(planner->queue[child + 1].key,
+                           planner->queue[child].key))
+        {
+            child += 1;
+        }
+        if (!isKeyBefore(planner->queue[child].key, node.key))
+        {
+            break;
+        }
+
+        setQueueNode(planner, position, planner->queue[child]);
+        position = child;
+    }
+    setQueueNode(planner, position, node);
+}
+
+
+/*
+@context
+    * Creates an array of points to represent the path found.
+    * Steps back from the target through the best predecessor of each point
+      then reverses the points.
+        * Every move costs at least `COST_CARDINAL` so the distance of the
+          target bounds the length of the path - it is allocated once.
+    * Assumes the distance of the target is known.
+
+@parameters
+    * planner
+        * Planner holding the distance of each point.
+
+@return
+    * Shortest path (sequence of points) from the source to the target.
+*/
+static point_t *reconstructPath(lpaPlanner_t *planner)
+{
+    point_t *path;
+    point_t swap;
+    cell_t current, length, i;
+
+    path = malloc(sizeof(point_t)
+                  * (size_t)(planner->cells[planner->targetIndex].gScore
+                             / COST_CARDINAL));
+    assert(path != NULL);
+
+    // reconstruct `path` in reverse (from the target to the source)
+    length = 0;
+    for (current = planner->targetIndex;
+         current != planner->sourceIndex;
+         getLookahead(planner, current, &current))
+    {
+        path[length] = getDungeonIndexPoint(planner->dungeon, current);
+        length += 1;
+    }
+
+    for (i = 0; i < length / 2; i += 1)
+    {
+        swap = path[i];
+        path[i] = path[length - 1 - i];
+        path[length - 1 - i] = swap;
+    }
+
+    return path;
+}
+
+
+/* ------------------------------ END  PRIVATE ------------------------------ */
@@ -0,0 +1,47 @@
+/*
+@context
+    * Provides incremental replanning of the shortest path between 2 points in
+      a dungeon using Lifelong Planning A* (LPA*).
+    * A planner is bound to a dungeon and a source and target.
+        * Keeps the distance from the source of every point it searched.
+        * Tiles must be changed through `setLpaPoint` so only the points whose
+          moves changed are marked for repair.
+        * The next search only repairs distances the changes made wrong
+          instead of searching from scratch.
+        * Each expansion does more work than one of `findPath` so replanning
+          is only faster when the changes affect a small part of the search
+          (e.g. large dungeons) - a fresh `findPath` can win on small ones.
+    * Uses an Octile distance heuristic so every path found is optimal.
+    * Follows the same movement rules as `isValidMove`.
+    * Finds a path of the same cost as `findPath` in the same format.
+    * The path found is dynamically allocated so it must be freed.
+*/
+
+
+#ifndef _LIFELONG_A_STAR_H
+    #define _LIFELONG_A_STAR_H
+
+    #include <stdint.h>
+
+    #include "dataStructs/dungeon.h"
+    #include "dataTypes/point.h"
+
+
+    typedef struct lpaPlanner_s lpaPlanner_t;
+
+
+    lpaPlanner_t *initLpaPlanner(dungeon_t *dungeon,
+                                 point_t    source,
+                                 point_t    target);
+
+    void freeLpaPlanner(lpaPlanner_t *planner);
+
+    void setLpaPoint(lpaPlanner_t *planner,
+                     point_t       point,
+                     char          tile);
+
+    point_t *findLpaPath(lpaPlanner_t *planner);
+
+    cell_t getLpaExpansions(lpaPlanner_t *planner);
+
+#endif
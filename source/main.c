@@ -6,6 +6,7 @@
 */
 
 
+#include <assert.h>
 #include <stdlib.h>
 
 #include "aStar.h"
@@ -20,7 +21,9 @@ static const char TILE_PATH = '.';
 
 
 static void play(dungeon_t *dungeon);
-static void displayDungeon(dungeon_t *dungeon);
+static void displayDungeon(aStarContext_t *context,
+                           dungeon_t      *dungeon,
+                           point_t        *path);
 
 
 /*
@@ -60,6 +63,8 @@ int main()
 static void play(dungeon_t *dungeon)
 {
     char input;
+    aStarContext_t *context;
+    point_t *path;
 
     // initialise interface (terminal must be large enough)
     if (!initInterface())
@@ -67,6 +72,12 @@ static void play(dungeon_t *dungeon)
         return;
     }
 
+    // search state and path buffer are reused so each frame allocates nothing
+    // - a path never visits a cell twice so it fits a buffer of every cell
+    context = initAStarContext(dungeon, OPEN_LIST_DEFAULT);
+    path = malloc(sizeof(point_t) * (size_t)getDungeonSize(dungeon));
+    assert(path != NULL);
+
     // keep displaying different `dungeon` configurations until exited
     input = ' ';
     while (input != KEY_QUIT)
@@ -74,17 +85,18 @@ static void play(dungeon_t *dungeon)
         // exit the interface if terminal becomes to small
         if (!isTerminalValidSize())
         {
-            freeInterface();
-            return;
+            break;
         }
 
         // find the path and display the current `dungeon` configuration
-        displayDungeon(dungeon);
+        displayDungeon(context, dungeon, path);
 
         input = getInput();
         generateDungeon(dungeon);
     }
 
+    freeAStarContext(context);
+    free(path);
     freeInterface();
 }
 
@@ -95,26 +107,33 @@ static void play(dungeon_t *dungeon)
       interface.
 
 @parameters
+    * context
+        * Search context of `dungeon`.
     * dungeon
         * Dungeon to find solution of and display.
+    * path
+        * Buffer holding a point for every cell of `dungeon`.
 */
-static void displayDungeon(dungeon_t *dungeon)
+static void displayDungeon(aStarContext_t *context,
+                           dungeon_t      *dungeon,
+                           point_t        *path)
 {
-    uint16_t i, x, y;
-    point_t *path;
+    cell_t i;
+    uint32_t x, y;
+    pathResult_t result;
     point_t point;
 
     // find shortest path between the source and target in `dungeon`
-    path = findPath(dungeon,
-                    getDungeonSource(dungeon),
-                    getDungeonTarget(dungeon));
-
-    // draw the found path on `dungeon`
-    i = 0;
-    while (!isEqualPoints(path[i], getDungeonTarget(dungeon)))
+    result = findContextPathBuffer(context,
+                                   getDungeonSource(dungeon),
+                                   getDungeonTarget(dungeon),
+                                   path,
+                                   getDungeonSize(dungeon));
+
+    // draw the found path on `dungeon` - the target keeps its own tile
+    for (i = 0; i + 1 < result.length; i += 1)
     {
         setDungeonPoint(dungeon, path[i], TILE_PATH);
-        i += 1;
     }
 
     // display `dungeon` with its `path`
@@ -126,6 +145,4 @@ static void displayDungeon(dungeon_t *dungeon)
             updateCanvas(point, getDungeonPoint(dungeon, point));
         }
     }
-
-    free(path);
 }
@@ -0,0 +1,458 @@
+#include "movingAI.h"
+
+#include <assert.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "aStar.h"
+
+
+// character representations of dungeon tiles
+static const char TILE_WALL = '#';
+static const char TILE_FLOOR = ' ';
+
+// longest map name of a scenario (including terminator)
+#define MAP_NAME_SIZE 256
+
+// longest header keyword of a map (including terminator)
+#define KEYWORD_SIZE 16
+
+// initial capacity of the queries of a scenario - grown by doubling
+static const uint32_t QUERY_CAPACITY = 64;
+
+// optimal lengths are printed rounded so costs may be slightly off
+static const double LENGTH_EPSILON = 1e-4;
+
+
+struct scenario_s
+{
+    char mapName[MAP_NAME_SIZE];
+    uint32_t mapWidth;
+    uint32_t mapHeight;
+
+    uint32_t nQueries;
+    uint32_t capacity;
+    scenarioQuery_t *queries;
+};
+
+
+static bool readMapHeader(FILE     *file,
+                          uint32_t *width,
+                          uint32_t *height);
+static int readMapTile(FILE *file);
+static bool isWithinMap(long     x,
+                        long     y,
+                        uint32_t width,
+                        uint32_t height);
+
+
+/* ------------------------------ START PUBLIC ------------------------------ */
+
+
+/*
+@context
+    * Loads a MovingAI `.map` file into a dungeon.
+    * The dungeon has no source or target.
+
+@parameters
+    * path
+        * Location of the `.map` file.
+
+@return
+    * Dungeon holding the tiles of the map.
+    * `NULL` if the file cannot be read, is malformed or the map is wider or
+      taller than `COORD_MAX + 1`.
+*/
+dungeon_t *loadMovingAiMap(const char *path)
+{
+    uint32_t width, height;
+    cell_t i;
+    int tile;
+    char *tiles;
+    FILE *file;
+    dungeon_t *dungeon;
+
+    file = fopen(path, "r");
+    if (file == NULL)
+    {
+        return NULL;
+    }
+
+    if (!readMapHeader(file, &width, &height))
+    {
+        fclose(file);
+        return NULL;
+    }
+
+    tiles = malloc(sizeof(char) * (size_t)width * height);
+    assert(tiles != NULL);
+
+    for (i = 0; i < (cell_t)width * height; i += 1)
+    {
+        tile = readMapTile(file);
+        if (tile == EOF)
+        {
+            free(tiles);
+            fclose(file);
+            return NULL;
+        }
+
+        // swamp (`S`) can be walked from any floor so is treated as floor
+        tiles[i] = tile == '.' || tile == 'G' || tile == 'S'
+                 ? TILE_FLOOR
+                 : TILE_WALL;
+    }
+    fclose(file);
+
+    dungeon = initDungeonMap(width, height, tiles);
+    free(tiles);
+
+    return dungeon;
+}
+
+
+/*
+@context
+    * Loads a MovingAI `.scen` file.
+    * Every query must be on the same map.
+
+@parameters
+    * path
+        * Location of the `.scen` file.
+
+@return
+    * Scenario holding every query of the file.
+    * `NULL` if the file cannot be read or is malformed.
+*/
+scenario_t *loadMovingAiScenario(const char *path)
+{
+    long sourceX, sourceY, targetX, targetY;
+    uint32_t bucket, width, height;
+    double length, version;
+    char mapName[MAP_NAME_SIZE];
+    FILE *file;
+    scenario_t *scenario;
+
+    file = fopen(path, "r");
+    if (file == NULL)
+    {
+        return NULL;
+    }
+
+    if (fscanf(file, " version %lf", &version) != 1)
+    {
+        fclose(file);
+        return NULL;
+    }
+
+    scenario = malloc(sizeof(scenario_t));
+    assert(scenario != NULL);
+
+    scenario->mapName[0] = '\0';
+    scenario->mapWidth = 0;
+    scenario->mapHeight = 0;
+    scenario->nQueries = 0;
+    scenario->capacity = QUERY_CAPACITY;
+    scenario->queries = malloc(sizeof(scenarioQuery_t) * scenario->capacity);
+    assert(scenario->queries != NULL);
+
+    while (fscanf(file, "%u %255s %u %u %ld %ld %ld %ld %lf",
+                  &bucket, mapName, &width, &height,
+                  &sourceX, &sourceY, &targetX, &targetY, &length) == 9)
+    {
+        if (scenario->nQueries == 0)
+        {
+            strcpy(scenario->mapName, mapName);
+            scenario->mapWidth = width;
+            scenario->mapHeight = height;
+        }
+
+        if (strcmp(mapName, scenario->mapName) != 0
+            || width != scenario->mapWidth
+            || height != scenario->mapHeight
+            || !isWithinMap(sourceX, sourceY, width, height)
+            || !isWithinMap(targetX, targetY, width, height))
+        {
+            fclose(file);
+            freeScenario(scenario);
+            return NULL;
+        }
+
+        if (scenario->nQueries == scenario->capacity)
+        {
+            scenario->capacity *= 2;
+            scenario->queries = realloc(scenario->queries,
+                                        sizeof(scenarioQuery_t)
+                                        * scenario->capacity);
+            assert(scenario->queries != NULL);
+        }
+
+        scenario->queries[scenario->nQueries] = (scenarioQuery_t){
+            .bucket = bucket,
+            .source = initPoint(sourceX, sourceY),
+            .target = initPoint(targetX, targetY),
+            .optimalLength = length
+        };
+        scenario->nQueries += 1;
+    }
+
+    // anything left unread is a malformed query
+    if (!feof(file))
+    {
+        fclose(file);
+        freeScenario(scenario);
+        return NULL;
+    }
+    fclose(file);
+
+    return scenario;
+}
+
+
+/*
+@context
+    * Frees `scenario`.
+
+@parameters
+    * scenario
+        * Scenario to free.
+*/
+void freeScenario(scenario_t *scenario)
+{
+    free(scenario->queries);
+    free(scenario);
+}
+
+
+/*
+@context
+    * Gets the name of the map the queries of `scenario` are on.
+    * As written in the file (usually relative to a directory of maps).
+
+@parameters
+    * scenario
+        * Scenario to get map name of.
+
+@return
+    * Name of the map (empty if `scenario` has no queries).
+*/
+const char *getScenarioMapName(scenario_t *scenario)
+{
+    return scenario->mapName;
+}
+
+
+/*
+@context
+    * Gets the width of the map the queries of `scenario` are on.
+
+@parameters
+    * scenario
+        * Scenario to get map width of.
+
+@return
+    * Width of the map.
+*/
+uint32_t getScenarioMapWidth(scenario_t *scenario)
+{
+    return scenario->mapWidth;
+}
+
+
+/*
+@context
+    * Gets the height of the map the queries of `scenario` are on.
+
+@parameters
+    * scenario
+        * Scenario to get map height of.
+
+@return
+    * Height of the map.
+*/
+uint32_t getScenarioMapHeight(scenario_t *scenario)
+{
+    return scenario->mapHeight;
+}
+
+
+/*
+@context
+    * Gets the number of queries of `scenario`.
+
+@parameters
+    * scenario
+        * Scenario to get number of queries of.
+
+@return
+    * Number of queries.
+*/
+uint32_t getScenarioSize(scenario_t *scenario)
+{
+    return scenario->nQueries;
+}
+
+
+/*
+@context
+    * Gets query `index` of `scenario` (in file order).
+
+@parameters
+    * scenario
+        * Scenario to get query of.
+    * index
+        * Index of the query.
+        * Must be `< getScenarioSize(scenario)`.
+
+@return
+    * Query `index`.
+*/
+scenarioQuery_t getScenarioQuery(scenario_t *scenario,
+                                 uint32_t    index)
+{
+    assert(index < scenario->nQueries);
+    return scenario->queries[index];
+}
+
+
+/*
+@context
+    * Checks if a path `cost` (in `COST_CARDINAL` and `COST_DIAGONAL`) is the
+      cost of a shortest path of `optimalLength`.
+    * Each path costs no less than its length but a diagonal move costs
+      `COST_DIAGONAL / (COST_CARDINAL * sqrt(2))` times more.
+        * The shortest path by cost may not be the shortest by length but its
+          length can be no longer than this factor allows.
+
+@parameters
+    * cost
+        * Cost of the path found.
+    * optimalLength
+        * Length of a shortest path (cardinal moves cost 1).
+
+@return
+    * Indication `cost` is within the bounds of a shortest path.
+*/
+bool isScenarioOptimal(score_t cost,
+                       double  optimalLength)
+{
+    double length;
+
+    length = (double)cost / COST_CARDINAL;
+
+    return length >= optimalLength - LENGTH_EPSILON
+        && length <= optimalLength * COST_DIAGONAL
+                                   / (COST_CARDINAL * sqrt(2))
+                   + LENGTH_EPSILON;
+}
+
+
+/* ------------------------------- END PUBLIC ------------------------------- */
+/* ----------------------------- START  PRIVATE ----------------------------- */
+
+
+/*
+@context
+    * Reads the header of a `.map` file up to and including the `map` line.
+    * Keywords may be in any order and the `type` is not checked (every map
+      type is treated as octile).
+
+@parameters
+    * file
+        * Map file at its start.
+    * width
+        * Output of the map width.
+    * height
+        * Output of the map height.
+
+@return
+    * Indication the header is valid.
+*/
+static bool readMapHeader(FILE     *file,
+                          uint32_t *width,
+                          uint32_t *height)
+{
+    char keyword[KEYWORD_SIZE];
+
+    *width = 0;
+    *height = 0;
+    while (fscanf(file, "%15s", keyword) == 1)
+    {
+        if (strcmp(keyword, "map") == 0)
+        {
+            return *width > 0 && *height > 0
+                && *width - 1 <= COORD_MAX && *height - 1 <= COORD_MAX;
+        }
+
+        if ((strcmp(keyword, "type") == 0
+             && fscanf(file, "%*s") != 0)
+            || (strcmp(keyword, "width") == 0
+                && fscanf(file, "%u", width) != 1)
+            || (strcmp(keyword, "height") == 0
+                && fscanf(file, "%u", height) != 1))
+        {
+            return false;
+        }
+    }
+
+    return false;
+}
+
+
+/*
+@context
+    * Reads the next tile of a `.map` file skipping line endings.
+
+@parameters
+    * file
+        * Map file after its header.
+
+@return
+    * Tile character read.
+    * `EOF` if the file ended.
+*/
+static int readMapTile(FILE *file)
+{
+    int tile;
+
+    do
+    {
+        tile = fgetc(file);
+    } while (tile == '\n' || tile == '\r');
+
+    return tile;
+}
+
+
+/*
+@context
+    * Checks if `(x, y)` is within a map of `width` and `height`.
+
+@parameters
+    * x
+        * X coordinate to check.
+    * y
+        * Y coordinate to check.
+    * width
+        * Width of the map.
+    * height
+        * Height of the map.
+
+@return
+    * Indication `(x, y)` is within the map.
+*/
+static bool isWithinMap(long     x,
+                        long     y,
+                        uint32_t width,
+                        uint32_t height)
+{
+    return x >= 0 && (unsigned long)x < width
+        && y >= 0 && (unsigned long)y < height;
+}
+
+
+/* ------------------------------ END  PRIVATE ------------------------------ */
@@ -0,0 +1,58 @@
+/*
+@context
+    * Provides loading of MovingAI grid benchmark files.
+        * `.map` files are loaded into a dungeon (no source or target).
+            * `.`, `G` and `S` tiles are floor, every other tile is a wall.
+        * `.scen` files are loaded into a list of queries on one map.
+    * MovingAI optimal lengths cost 1 for a cardinal move and sqrt(2) for a
+      diagonal move with no corner cutting (the same moves as `isValidMove`).
+        * `COST_DIAGONAL / COST_CARDINAL` is slightly above sqrt(2) so
+          `isScenarioOptimal` allows for the difference.
+    * Loading fails (returns `NULL`) on a missing or malformed file.
+*/
+
+
+#ifndef _MOVING_AI_H
+    #define _MOVING_AI_H
+
+    #include <stdbool.h>
+    #include <stdint.h>
+
+    #include "dataStructs/dungeon.h"
+    #include "dataTypes/point.h"
+
+
+    typedef struct scenario_s scenario_t;
+    typedef struct scenarioQuery_s scenarioQuery_t;
+
+
+    // single query (row) of a scenario
+    struct scenarioQuery_s
+    {
+        // queries are bucketed by optimal length (`bucket = length / 4`)
+        uint32_t bucket;
+
+        point_t source;
+        point_t target;
+
+        // length of a shortest path (cardinal moves cost 1)
+        double optimalLength;
+    };
+
+
+    dungeon_t *loadMovingAiMap(const char *path);
+
+    scenario_t *loadMovingAiScenario(const char *path);
+    void freeScenario(scenario_t *scenario);
+
+    const char *getScenarioMapName(scenario_t *scenario);
+    uint32_t getScenarioMapWidth(scenario_t *scenario);
+    uint32_t getScenarioMapHeight(scenario_t *scenario);
+    uint32_t getScenarioSize(scenario_t *scenario);
+    scenarioQuery_t getScenarioQuery(scenario_t *scenario,
+                                     uint32_t    index);
+
+    bool isScenarioOptimal(score_t cost,
+                           double  optimalLength);
+
+#endif
@@ -0,0 +1,892 @@
+#include "pathCache.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <threads.h>
+
+
+// initial number of hash buckets - doubled once entries outnumber them
+static const uint32_t BUCKET_CAPACITY = 64;
+
+
+typedef struct pathEntry_s pathEntry_t;
+
+
+// path of one query - allocated with its points
+struct pathEntry_s
+{
+    point_t source;
+    point_t target;
+
+    // `PATH_FOUND` or `PATH_NOT_FOUND` (`length` and `cost` are then `0`)
+    pathStatus_t status;
+    cell_t length;
+    score_t cost;
+
+    // corners of the box around `source` and every point of `path`
+    point_t min;
+    point_t max;
+
+    // bytes of the entry including `path`
+    uint64_t bytes;
+
+    // next entry of the same hash bucket
+    pathEntry_t *next;
+
+    // neighbours in the order of use - `newer` is `NULL` for the newest
+    pathEntry_t *newer;
+    pathEntry_t *older;
+
+    point_t path[];
+};
+
+struct pathCache_s
+{
+    dungeon_t *dungeon;
+
+    // guards every field below
+    mtx_t lock;
+
+    // version of `dungeon` the entries are current for
+    uint64_t version;
+
+    // entries chained by hash of their source and target - the number of
+    // buckets is a power of 2
+    pathEntry_t **buckets;
+    uint32_t nBuckets;
+    uint32_t nEntries;
+
+    // ends of the entries in order of use
+    pathEntry_t *newest;
+    pathEntry_t *oldest;
+
+    uint64_t bytes;
+    uint64_t maxBytes;
+
+    uint64_t nHits;
+    uint64_t nMisses;
+};
+
+
+static void syncVersion(pathCache_t *cache);
+static pathEntry_t *findEntry(pathCache_t *cache,
+                              point_t      source,
+                              point_t      target);
+static pathEntry_t *initEntry(aStarContext_t *context,
+                              point_t         source,
+                              point_t         target);
+static void insertEntry(pathCache_t *cache,
+                        pathEntry_t *entry);
+static void removeEntry(pathCache_t *cache,
+                        pathEntry_t *entry);
+static void touchEntry(pathCache_t *cache,
+                       pathEntry_t *entry);
+static void unlinkEntry(pathCache_t *cache,
+                        pathEntry_t *entry);
+static pathResult_t copyEntry(pathEntry_t *entry,
+                              point_t     *path,
+                              cell_t       capacity);
+static void growBuckets(pathCache_t *cache);
+
+static bool isEntryBordering(pathEntry_t *entry,
+                             point_t      point);
+static bool isEntryShortened(pathEntry_t *entry,
+                             point_t      point);
+
+static uint32_t hashQuery(point_t  source,
+                          point_t  target,
+                          uint32_t nBuckets);
+
+
+/* ------------------------------ START PUBLIC ------------------------------ */
+
+
+/*
+@context
+    * Initialises an empty path cache of `dungeon`.
+
+@parameters
+    * dungeon
+        * Dungeon the paths cached are found in.
+    * maxBytes
+        * Most bytes the cached paths (and their bookkeeping) can take.
+        * Paths larger than this are never cached.
+
+@return
+    * Empty path cache.
+*/
+pathCache_t *initPathCache(dungeon_t *dungeon,
+                           uint64_t   maxBytes)
+{
+    uint32_t i;
+    pathCache_t *cache;
+
+    cache = malloc(sizeof(pathCache_t));
+    assert(cache != NULL);
+
+    cache->dungeon = dungeon;
+    mtx_init(&cache->lock, mtx_plain);
+    cache->version = getDungeonVersion(dungeon);
+
+    cache->nBuckets = BUCKET_CAPACITY;
+    cache->buckets = malloc(sizeof(pathEntry_t*) * cache->nBuckets);
+    assert(cache->buckets != NULL);
+    for (i = 0; i < cache->nBuckets; i += 1)
+    {
+        cache->buckets[i] = NULL;
+    }
+    cache->nEntries = 0;
+
+    cache->newest = NULL;
+    cache->oldest = NULL;
+    cache->bytes = 0;
+    cache->maxBytes = maxBytes;
+    cache->nHits = 0;
+    cache->nMisses = 0;
+
+    return cache;
+}
+
+
+/*
+@context
+    * Frees `cache` and every path it holds.
+    * The dungeon of `cache` is not freed.
+
+@parameters
+    * cache
+        * Path cache to free.
+*/
+void freePathCache(pathCache_t *cache)
+{
+    clearPathCache(cache);
+    mtx_destroy(&cache->lock);
+    free(cache->buckets);
+    free(cache);
+}
+
+
+/*
+@context
+    * Evicts every path of `cache`.
+    * Hit and miss counts are kept.
+
+@parameters
+    * cache
+        * Path cache to clear.
+*/
+void clearPathCache(pathCache_t *cache)
+{
+    mtx_lock(&cache->lock);
+    while (cache->oldest != NULL)
+    {
+        removeEntry(cache, cache->oldest);
+    }
+    mtx_unlock(&cache->lock);
+}
+
+
+/*
+@context
+    * Finds the shortest path from `source` to `target` in the dungeon of
+      `cache` and writes it to `path`.
+    * A cached path is copied without searching (a hit).
+    * Otherwise (a miss) the path is found with `context` and cached - the
+      least recently used paths are evicted to stay within the byte cap.
+        * The lock of `cache` is not held while searching so threads only
+          wait on each other to copy paths.
+    * Every path is evicted first if the dungeon changed other than through
+      `setCachedPoint`.
+
+@parameters
+    * cache
+        * Path cache of the dungeon to find path in.
+    * context
+        * Search context of the dungeon of `cache` used on a miss.
+        * Each thread must use its own.
+    * source
+        * Location to start from.
+    * target
+        * Location to find from `source`.
+    * path
+        * Buffer to write the path (sequence of points) to.
+            * `source` is not included.
+            * `target` is included as the last point.
+        * Can be `NULL` when `capacity` is `0` to only find length and cost.
+    * capacity
+        * Number of points `path` can hold.
+
+@return
+    * Status, length and cost of the path found.
+        * `PATH_BUFFER_TOO_SMALL` if `path` cannot hold it - the path is still
+          cached so it can be found again with a larger buffer.
+*/
+pathResult_t findCachedPath(pathCache_t    *cache,
+                            aStarContext_t *context,
+                            point_t         source,
+                            point_t         target,
+                            point_t        *path,
+                            cell_t          capacity)
+{
+    uint64_t version;
+    pathEntry_t *entry;
+    pathResult_t result;
+
+    mtx_lock(&cache->lock);
+    syncVersion(cache);
+
+    entry = findEntry(cache, source, target);
+    if (entry != NULL)
+    {
+        cache->nHits += 1;
+        touchEntry(cache, entry);
+        result = copyEntry(entry, path, capacity);
+        mtx_unlock(&cache->lock);
+
+        return result;
+    }
+
+    cache->nMisses += 1;
+    version = cache->version;
+    mtx_unlock(&cache->lock);
+
+    entry = initEntry(context, source, target);
+    result = copyEntry(entry, path, capacity);
+
+    // another thread may have cached the same query while searching
+    mtx_lock(&cache->lock);
+    if (version == cache->version
+        && entry->bytes <= cache->maxBytes
+        && findEntry(cache, source, target) == NULL)
+    {
+        insertEntry(cache, entry);
+    }
+    else
+    {
+        free(entry);
+    }
+    mtx_unlock(&cache->lock);
+
+    return result;
+}
+
+
+/*
+@context
+    * Sets tile character representation at `point` of the dungeon of
+      `cache` and evicts only the paths the change can affect.
+        * Floor to wall evicts the paths through or next to `point` - the
+          moves of no other path change and a path still valid in a dungeon
+          with more walls is still shortest.
+        * Wall to floor evicts the paths that a path near `point` could beat
+          - any new path passes within 1 point of it so costs no less than
+          the Octile distance through `point` less 2 diagonal moves.
+    * Must not be called while a lookup is in progress.
+
+@parameters
+    * cache
+        * Path cache of the dungeon to set tile of.
+    * point
+        * Location of tile to set.
+        * Assumes `point` is within the dungeon bounds.
+    * tile
+        * Character representation to set tile to.
+*/
+void setCachedPoint(pathCache_t *cache,
+                    point_t      point,
+                    char         tile)
+{
+    bool wasWalkable, isWalkable;
+    pathEntry_t *entry, *newer;
+
+    mtx_lock(&cache->lock);
+    syncVersion(cache);
+
+    wasWalkable = isDungeonWalkable(cache->dungeon, point);
+    setDungeonPoint(cache->dungeon, point, tile);
+    isWalkable = isDungeonWalkable(cache->dungeon, point);
+    cache->version = getDungeonVersion(cache->dungeon);
+
+    // changing between walkable tiles (e.g. floor to target) moves nothing
+    if (wasWalkable == isWalkable)
+    {
+        mtx_unlock(&cache->lock);
+        return;
+    }
+
+    for (entry = cache->oldest; entry != NULL; entry = newer)
+    {
+        newer = entry->newer;
+        if (wasWalkable ? isEntryBordering(entry, point)
+                        : isEntryShortened(entry, point))
+        {
+            removeEntry(cache, entry);
+        }
+    }
+    mtx_unlock(&cache->lock);
+}
+
+
+/*
+@context
+    * Gets the number of lookups of `cache` answered from a cached path.
+
+@parameters
+    * cache
+        * Path cache to get hits of.
+
+@return
+    * Number of hits.
+*/
+uint64_t getPathCacheHits(pathCache_t *cache)
+{
+    uint64_t nHits;
+
+    mtx_lock(&cache->lock);
+    nHits = cache->nHits;
+    mtx_unlock(&cache->lock);
+
+    return nHits;
+}
+
+
+/*
+@context
+    * Gets the number of lookups of `cache` that searched for the path.
+
+@parameters
+    * cache
+        * Path cache to get misses of.
+
+@return
+    * Number of misses.
+*/
+uint64_t getPathCacheMisses(pathCache_t *cache)
+{
+    uint64_t nMisses;
+
+    mtx_lock(&cache->lock);
+    nMisses = cache->nMisses;
+    mtx_unlock(&cache->lock);
+
+    return nMisses;
+}
+
+
+/*
+@context
+    * Gets the number of bytes taken by the paths cached in `cache`.
+    * Never more than the byte cap of `cache`.
+
+@parameters
+    * cache
+        * Path cache to get bytes of.
+
+@return
+    * Bytes of the cached paths and their bookkeeping.
+*/
+uint64_t getPathCacheBytes(pathCache_t *cache)
+{
+    uint64_t bytes;
+
+    mtx_lock(&cache->lock);
+    bytes = cache->bytes;
+    mtx_unlock(&cache->lock);
+
+    return bytes;
+}
+
+
+/*
+@context
+    * Gets the number of paths cached in `cache`.
+
+@parameters
+    * cache
+        * Path cache to get size of.
+
+@return
+    * Number of cached paths.
+*/
+uint32_t getPathCacheSize(pathCache_t *cache)
+{
+    uint32_t nEntries;
+
+    mtx_lock(&cache->lock);
+    nEntries = cache->nEntries;
+    mtx_unlock(&cache->lock);
+
+    return nEntries;
+}
+
+
+/* ------------------------------- END PUBLIC ------------------------------- */
+/* ----------------------------- START  PRIVATE ----------------------------- */
+
+
+/*
+@context
+    * Evicts every path of `cache` if its dungeon changed other than through
+      `setCachedPoint`.
+    * Must be called with the lock of `cache` held.
+
+@parameters
+    * cache
+        * Path cache to check.
+*/
+static void syncVersion(pathCache_t *cache)
+{
+    if (cache->version == getDungeonVersion(cache->dungeon))
+    {
+        return;
+    }
+
+    while (cache->oldest != NULL)
+    {
+        removeEntry(cache, cache->oldest);
+    }
+    cache->version = getDungeonVersion(cache->dungeon);
+}
+
+
+/*
+@context
+    * Finds the entry of `cache` for the query from `source` to `target`.
+    * Must be called with the lock of `cache` held.
+
+@parameters
+    * cache
+        * Path cache to search.
+    * source
+        * Location the query starts from.
+    * target
+        * Location the query finds.
+
+@return
+    * Entry of the query.
+    * `NULL` if the query is not cached.
+*/
+static pathEntry_t *findEntry(pathCache_t *cache,
+                              point_t      source,
+                              point_t      target)
+{
+    pathEntry_t *entry;
+
+    entry = cache->buckets[hashQuery(source, target, cache->nBuckets)];
+    while (entry != NULL
+           && !(isEqualPoints(entry->source, source)
+                && isEqualPoints(entry->target, target)))
+    {
+        entry = entry->next;
+    }
+
+    return entry;
+}
+
+
+/*
+@context
+    * Finds the path from `source` to `target` with `context` and copies it
+      into a new entry.
+    * Called without the lock of a cache held.
+
+@parameters
+    * context
+        * Search context of the dungeon to find path in.
+    * source
+        * Location to start from.
+    * target
+        * Location to find from `source`.
+
+@return
+    * Entry holding the path found (not in any cache).
+*/
+static pathEntry_t *initEntry(aStarContext_t *context,
+                              point_t         source,
+                              point_t         target)
+{
+    cell_t i;
+    pathEntry_t *entry;
+    pathResult_t result;
+
+    // only length and cost are found first - the path is read once sized
+    result = findContextPathBuffer(context, source, target, NULL, 0);
+
+    entry = malloc(sizeof(pathEntry_t)
+                   + sizeof(point_t) * (size_t)result.length);
+    assert(entry != NULL);
+
+    entry->source = source;
+    entry->target = target;
+    entry->status = result.status == PATH_NOT_FOUND
+                  ? PATH_NOT_FOUND
+                  : PATH_FOUND;
+    entry->length = result.length;
+    entry->cost = result.cost;
+    entry->bytes = sizeof(pathEntry_t)
+                 + sizeof(point_t) * (uint64_t)result.length;
+    getAStarPath(context, entry->path, entry->length);
+
+    entry->min = source;
+    entry->max = source;
+    for (i = 0; i < entry->length; i += 1)
+    {
+        entry->min = initPoint(entry->path[i].x < entry->min.x
+                               ? entry->path[i].x
+                               : entry->min.x,
+                               entry->path[i].y < entry->min.y
+                               ? entry->path[i].y
+                               : entry->min.y);
+        entry->max = initPoint(entry->path[i].x > entry->max.x
+                               ? entry->path[i].x
+                               : entry->max.x,
+                               entry->path[i].y > entry->max.y
+                               ? entry->path[i].y
+                               : entry->max.y);
+    }
+
+    return entry;
+}
+
+
+/*
+@context
+    * Inserts `entry` into `cache` as its newest entry.
+    * The oldest entries are evicted until `cache` is within its byte cap.
+    * Must be called with the lock of `cache` held.
+
+@parameters
+    * cache
+        * Path cache to insert into.
+    * entry
+        * Entry to insert - must fit the byte cap of `cache` on its own.
+*/
+static void insertEntry(pathCache_t *cache,
+                        pathEntry_t *entry)
+{
+    uint32_t bucket;
+
+    while (cache->bytes + entry->bytes > cache->maxBytes)
+    {
+        removeEntry(cache, cache->oldest);
+    }
+
+    if (cache->nEntries == cache->nBuckets)
+    {
+        growBuckets(cache);
+    }
+
+    bucket = hashQuery(entry->source, entry->target, cache->nBuckets);
+    entry->next = cache->buckets[bucket];
+    cache->buckets[bucket] = entry;
+
+    entry->older = cache->newest;
+    entry->newer = NULL;
+    if (cache->newest != NULL)
+    {
+        cache->newest->newer = entry;
+    }
+    else
+    {
+        cache->oldest = entry;
+    }
+    cache->newest = entry;
+
+    cache->nEntries += 1;
+    cache->bytes += entry->bytes;
+}
+
+
+/*
+@context
+    * Removes `entry` from `cache` and frees it.
+    * Must be called with the lock of `cache` held.
+
+@parameters
+    * cache
+        * Path cache holding `entry`.
+    * entry
+        * Entry to remove.
+*/
+static void removeEntry(pathCache_t *cache,
+                        pathEntry_t *entry)
+{
+    pathEntry_t **link;
+
+    link = &cache->buckets[hashQuery(entry->source,
+                                     entry->target,
+                                     cache->nBuckets)];
+    while (*link != entry)
+    {
+        link = &(*link)->next;
+    }
+    *link = entry->next;
+
+    unlinkEntry(cache, entry);
+
+    cache->nEntries -= 1;
+    cache->bytes -= entry->bytes;
+    free(entry);
+}
+
+
+/*
+@context
+    * Makes `entry` the newest entry of `cache`.
+    * Must be called with the lock of `cache` held.
+
+@parameters
+    * cache
+        * Path cache holding `entry`.
+    * entry
+        * Entry just used.
+*/
+static void touchEntry(pathCache_t *cache,
+                       pathEntry_t *entry)
+{
+    if (entry == cache->newest)
+    {
+        return;
+    }
+
+    unlinkEntry(cache, entry);
+
+    entry->older = cache->newest;
+    entry->newer = NULL;
+    cache->newest->newer = entry;
+    cache->newest = entry;
+}
+
+
+/*
+@context
+    * Removes `entry` from the order of use of `cache`.
+    * Must be called with the lock of `cache` held.
+
+@parameters
+    * cache
+        * Path cache holding `entry`.
+    * entry
+        * Entry to unlink.
+*/
+static void unlinkEntry(pathCache_t *cache,
+                        pathEntry_t *entry)
+{
+    if (entry->newer != NULL)
+    {
+        entry->newer->older = entry->older;
+    }
+    else
+    {
+        cache->newest = entry->older;
+    }
+
+    if (entry->older != NULL)
+    {
+        entry->older->newer = entry->newer;
+    }
+    else
+    {
+        cache->oldest = entry->newer;
+    }
+}
+
+
+/*
+@context
+    * Writes the path of `entry` to `path`.
+
+@parameters
+    * entry
+        * Entry to copy.
+    * path
+        * Buffer to write the path to.
+    * capacity
+        * Number of points `path` can hold.
+
+@return
+    * Status, length and cost of the path of `entry`.
+*/
+static pathResult_t copyEntry(pathEntry_t *entry,
+                              point_t     *path,
+                              cell_t       capacity)
+{
+    pathResult_t result;
+
+    result.status = entry->status;
+    result.length = entry->length;
+    result.cost = entry->cost;
+
+    if (entry->status == PATH_FOUND && entry->length > capacity)
+    {
+        result.status = PATH_BUFFER_TOO_SMALL;
+    }
+    else if (entry->length > 0)
+    {
+        memcpy(path, entry->path, sizeof(point_t) * (size_t)entry->length);
+    }
+
+    return result;
+}
+
+
+/*
+@context
+    * Doubles the hash buckets of `cache` and rehashes every entry.
+    * Must be called with the lock of `cache` held.
+
+@parameters
+    * cache
+        * Path cache to grow.
+*/
+static void growBuckets(pathCache_t *cache)
+{
+    uint32_t i, bucket;
+    pathEntry_t **buckets;
+    pathEntry_t *entry;
+
+    buckets = malloc(sizeof(pathEntry_t*) * 2 * cache->nBuckets);
+    assert(buckets != NULL);
+    for (i = 0; i < 2 * cache->nBuckets; i += 1)
+    {
+        buckets[i] = NULL;
+    }
+
+    for (entry = cache->oldest; entry != NULL; entry = entry->newer)
+    {
+        bucket = hashQuery(entry->source, entry->target, 2 * cache->nBuckets);
+        entry->next = buckets[bucket];
+        buckets[bucket] = entry;
+    }
+
+    free(cache->buckets);
+    cache->buckets = buckets;
+    cache->nBuckets *= 2;
+}
+
+
+/*
+@context
+    * Checks if the path of `entry` passes through or next to `point`.
+    * Only such paths have a move made invalid by a wall at `point` (diagonal
+      moves cannot cut its corners).
+
+@parameters
+    * entry
+        * Entry to check.
+    * point
+        * Location of the new wall.
+
+@return
+    * Indication the path has a point within 1 move of `point`.
+*/
+static bool isEntryBordering(pathEntry_t *entry,
+                             point_t      point)
+{
+    cell_t i;
+
+    // a query with no path has none to break
+    if (entry->status == PATH_NOT_FOUND
+        || point.x < entry->min.x - 1 || point.x > entry->max.x + 1
+        || point.y < entry->min.y - 1 || point.y > entry->max.y + 1)
+    {
+        return false;
+    }
+
+    if (abs(entry->source.x - point.x) <= 1
+        && abs(entry->source.y - point.y) <= 1)
+    {
+        return true;
+    }
+
+    for (i = 0; i < entry->length; i += 1)
+    {
+        if (abs(entry->path[i].x - point.x) <= 1
+            && abs(entry->path[i].y - point.y) <= 1)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+/*
+@context
+    * Checks if a path of `entry` could become shorter once `point` is floor.
+    * Every move made valid is within 1 move of `point` so a new path costs
+      at least the Octile distance through `point` less 2 diagonal moves.
+
+@parameters
+    * entry
+        * Entry to check.
+    * point
+        * Location of the new floor.
+
+@return
+    * Indication a path through `point` could cost less than the cached path
+      (always for a query with no path).
+*/
+static bool isEntryShortened(pathEntry_t *entry,
+                             point_t      point)
+{
+    score_t bound;
+
+    if (entry->status == PATH_NOT_FOUND)
+    {
+        return true;
+    }
+
+    bound = distancePoints(entry->source,
+                           point,
+                           COST_CARDINAL,
+                           COST_DIAGONAL)
+          + distancePoints(point,
+                           entry->target,
+                           COST_CARDINAL,
+                           COST_DIAGONAL);
+
+    return bound < entry->cost + 2 * COST_DIAGONAL;
+}
+
+
+/*
+@context
+    * Hashes the query from `source` to `target` to a bucket.
+    * Mixes the coordinates so nearby queries spread over the buckets.
+
+@parameters
+    * source
+        * Location the query starts from.
+    * target
+        * Location the query finds.
+    * nBuckets
+        * Number of buckets - must be a power of 2.
+
+@return
+    * Bucket of the query.
+*/
+static uint32_t hashQuery(point_t  source,
+                          point_t  target,
+                          uint32_t nBuckets)
+{
+    uint64_t hash;
+
+    hash = (uint64_t)(uint32_t)source.x << 32 | (uint32_t)source.y;
+    hash ^= ((uint64_t)(uint32_t)target.x << 32 | (uint32_t)target.y)
+          * 0x9E3779B97F4A7C15;
+
+    // finaliser of SplitMix64
+    hash = (hash ^ hash >> 30) * 0xBF58476D1CE4E5B9;
+    hash = (hash ^ hash >> 27) * 0x94D049BB133111EB;
+    hash ^= hash >> 31;
+
+    return (uint32_t)hash & (nBuckets - 1);
+}
+
+
+/* ------------------------------ END  PRIVATE ------------------------------ */
@@ -0,0 +1,59 @@
+/*
+@context
+    * Provides a cache of paths found in a dungeon keyed by source and target.
+        * Repeated queries are answered by copying the cached path instead of
+          searching.
+        * Queries with no path are cached too.
+    * The least recently used paths are evicted once the cache holds more
+      bytes than its cap.
+    * Entries are only current for the version of the dungeon they were found
+      in (see `getDungeonVersion`).
+        * Tiles set through `setCachedPoint` only evict the paths the change
+          can affect - a wall evicts paths crossing or bordering it and a
+          floor evicts paths it could make shorter.
+        * Any other change (e.g. regenerating the dungeon) evicts every path
+          on the next lookup.
+    * Lookups are safe from multiple threads, each searching misses with its
+      own A* context.
+        * The dungeon is only read by lookups so it must not be changed while
+          any are in progress.
+*/
+
+
+#ifndef _PATH_CACHE_H
+    #define _PATH_CACHE_H
+
+    #include <stdint.h>
+
+    #include "aStar.h"
+    #include "dataStructs/dungeon.h"
+    #include "dataTypes/point.h"
+
+
+    typedef struct pathCache_s pathCache_t;
+
+
+    pathCache_t *initPathCache(dungeon_t *dungeon,
+                               uint64_t   maxBytes);
+
+    void freePathCache(pathCache_t *cache);
+
+    void clearPathCache(pathCache_t *cache);
+
+    pathResult_t findCachedPath(pathCache_t    *cache,
+                                aStarContext_t *context,
+                                point_t         source,
+                                point_t         target,
+                                point_t        *path,
+                                cell_t          capacity);
+
+    void setCachedPoint(pathCache_t *cache,
+                        point_t      point,
+                        char         tile);
+
+    uint64_t getPathCacheHits(pathCache_t *cache);
+    uint64_t getPathCacheMisses(pathCache_t *cache);
+    uint64_t getPathCacheBytes(pathCache_t *cache);
+    uint32_t getPathCacheSize(pathCache_t *cache);
+
+#endif
@@ -0,0 +1,254 @@
+#include "pathPool.h"
+
+#include <assert.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <threads.h>
+
+#include "aStar.h"
+
+
+typedef struct worker_s worker_t;
+
+
+struct worker_s
+{
+    thrd_t thread;
+    aStarContext_t *context;
+    pathPool_t *pool;
+};
+
+struct pathPool_s
+{
+    worker_t *workers;
+    uint8_t nThreads;
+
+    // guards every field below other than `next`
+    mtx_t lock;
+    cnd_t started;
+    cnd_t finished;
+
+    // current batch - a new batch is signalled by changing `batch`
+    uint32_t batch;
+    pathQuery_t *queries;
+    point_t **paths;
+    uint32_t nQueries;
+
+    // index of the next query to be taken by a worker
+    atomic_uint_fast32_t next;
+
+    // workers still finding paths in the current batch
+    uint8_t nBusy;
+
+    bool isStopping;
+};
+
+
+static int work(void *arg);
+
+
+/* ------------------------------ START PUBLIC ------------------------------ */
+
+
+/*
+@context
+    * Initialises a pool of `nThreads` threads to find paths in `dungeon`.
+    * Threads wait until a batch of queries is given.
+
+@parameters
+    * dungeon
+        * Dungeon to find paths in.
+        * Shared read only between all threads.
+    * nThreads
+        * Number of threads (and search contexts) in the pool.
+        * Must be `>= 1`.
+    * openType
+        * Priority queue used as the open list of each search context.
+
+@return
+    * Pool of threads ready to find paths in `dungeon`.
+*/
+pathPool_t *initPathPool(dungeon_t      *dungeon,
+                         uint8_t         nThreads,
+                         openListType_t  openType)
+{
+    uint8_t i;
+    int status;
+    pathPool_t *pool;
+
+    assert(nThreads >= 1);
+
+    pool = malloc(sizeof(pathPool_t));
+    assert(pool != NULL);
+
+    pool->workers = malloc(sizeof(worker_t) * nThreads);
+    assert(pool->workers != NULL);
+    pool->nThreads = nThreads;
+
+    mtx_init(&pool->lock, mtx_plain);
+    cnd_init(&pool->started);
+    cnd_init(&pool->finished);
+
+    pool->batch = 0;
+    pool->queries = NULL;
+    pool->paths = NULL;
+    pool->nQueries = 0;
+    atomic_init(&pool->next, 0);
+    pool->nBusy = 0;
+    pool->isStopping = false;
+
+    for (i = 0; i < nThreads; i += 1)
+    {
+        pool->workers[i].context = initAStarContext(dungeon, openType);
+        pool->workers[i].pool = pool;
+        status = thrd_create(&pool->workers[i].thread,
+                             work,
+                             &pool->workers[i]);
+        assert(status == thrd_success);
+    }
+
+    return pool;
+}
+
+
+/*
+@context
+    * Stops all threads of `pool` and frees it.
+    * The dungeon of `pool` is not freed.
+
+@parameters
+    * pool
+        * Pool of threads to free.
+        * Must not be finding paths.
+*/
+void freePathPool(pathPool_t *pool)
+{
+    uint8_t i;
+
+    mtx_lock(&pool->lock);
+    pool->isStopping = true;
+    cnd_broadcast(&pool->started);
+    mtx_unlock(&pool->lock);
+
+    for (i = 0; i < pool->nThreads; i += 1)
+    {
+        thrd_join(pool->workers[i].thread, NULL);
+        freeAStarContext(pool->workers[i].context);
+    }
+
+    cnd_destroy(&pool->started);
+    cnd_destroy(&pool->finished);
+    mtx_destroy(&pool->lock);
+
+    free(pool->workers);
+    free(pool);
+}
+
+
+/*
+@context
+    * Finds the shortest path of every query using all threads of `pool`.
+    * Returns once every path has been found.
+
+@parameters
+    * pool
+        * Pool of threads to find paths with.
+    * queries
+        * Source and target of each path to find.
+    * nQueries
+        * Number of `queries`.
+    * paths
+        * Array (of at least `nQueries`) to hold each path found.
+        * `paths[i]` is the path of `queries[i]` in the format of `findPath`
+          (`NULL` if no path is possible).
+*/
+void findPoolPaths(pathPool_t   *pool,
+                   pathQuery_t  *queries,
+                   uint32_t      nQueries,
+                   point_t     **paths)
+{
+    mtx_lock(&pool->lock);
+
+    pool->queries = queries;
+    pool->paths = paths;
+    pool->nQueries = nQueries;
+    atomic_store(&pool->next, 0);
+    pool->nBusy = pool->nThreads;
+
+    // wake every worker for the new batch and wait for all to finish it
+    pool->batch += 1;
+    cnd_broadcast(&pool->started);
+    while (pool->nBusy > 0)
+    {
+        cnd_wait(&pool->finished, &pool->lock);
+    }
+
+    mtx_unlock(&pool->lock);
+}
+
+
+/* ------------------------------- END PUBLIC ------------------------------- */
+/* ----------------------------- START  PRIVATE ----------------------------- */
+
+
+/*
+@context
+    * Main loop of a worker thread.
+    * Waits for a batch then takes queries one at a time until none are left.
+
+@parameters
+    * arg
+        * Worker running the loop.
+
+@return
+    * Indicates the thread successfully terminates.
+*/
+static int work(void *arg)
+{
+    uint32_t i, batch;
+    worker_t *worker;
+    pathPool_t *pool;
+
+    worker = arg;
+    pool = worker->pool;
+    batch = 0;
+
+    while (true)
+    {
+        // wait for a batch this worker has not yet worked on
+        mtx_lock(&pool->lock);
+        while (!pool->isStopping && pool->batch == batch)
+        {
+            cnd_wait(&pool->started, &pool->lock);
+        }
+        if (pool->isStopping)
+        {
+            mtx_unlock(&pool->lock);
+            return thrd_success;
+        }
+        batch = pool->batch;
+        mtx_unlock(&pool->lock);
+
+        // queries are taken in order so each path goes to its query's slot
+        i = atomic_fetch_add(&pool->next, 1);
+        while (i < pool->nQueries)
+        {
+            pool->paths[i] = findContextPath(worker->context,
+                                             pool->queries[i].source,
+                                             pool->queries[i].target);
+            i = atomic_fetch_add(&pool->next, 1);
+        }
+
+        mtx_lock(&pool->lock);
+        pool->nBusy -= 1;
+        if (pool->nBusy == 0)
+        {
+            cnd_signal(&pool->finished);
+        }
+        mtx_unlock(&pool->lock);
+    }
+}
+
+
+/* ------------------------------ END  PRIVATE ------------------------------ */
@@ -0,0 +1,45 @@
+/*
+@context
+    * Provides a pool of threads finding many paths in a shared dungeon.
+    * Each thread owns its own A* search context.
+        * The dungeon is only read while paths are being found so it must not
+          be changed until a batch of queries returns.
+    * A batch of (source, target) queries is split between the threads.
+        * Paths are returned in the same order as their queries.
+        * Each path is dynamically allocated so it must be freed.
+*/
+
+
+#ifndef _PATH_POOL_H
+    #define _PATH_POOL_H
+
+    #include <stdint.h>
+
+    #include "dataStructs/dungeon.h"
+    #include "dataStructs/openList.h"
+    #include "dataTypes/point.h"
+
+
+    typedef struct pathQuery_s pathQuery_t;
+    typedef struct pathPool_s pathPool_t;
+
+
+    struct pathQuery_s
+    {
+        point_t source;
+        point_t target;
+    };
+
+
+    pathPool_t *initPathPool(dungeon_t      *dungeon,
+                             uint8_t         nThreads,
+                             openListType_t  openType);
+
+    void freePathPool(pathPool_t *pool);
+
+    void findPoolPaths(pathPool_t   *pool,
+                       pathQuery_t  *queries,
+                       uint32_t      nQueries,
+                       point_t     **paths);
+
+#endif
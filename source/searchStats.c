@@ -0,0 +1,42 @@
+#include "searchStats.h"
+
+#include <time.h>
+
+
+static const uint64_t NS_PER_S = 1000000000;
+
+
+/* ------------------------------ START PUBLIC ------------------------------ */
+
+
+/*
+@context
+    * Sets every statistic of `stats` to `0`.
+
+@parameters
+    * stats
+        * Statistics to reset.
+*/
+void resetSearchStats(searchStats_t *stats)
+{
+    *stats = (searchStats_t){0};
+}
+
+
+/*
+@context
+    * Gets the current calendar time for timing parts of a search.
+
+@return
+    * Current time in nanoseconds.
+*/
+uint64_t getStatsTimeNs()
+{
+    struct timespec now;
+
+    timespec_get(&now, TIME_UTC);
+    return (uint64_t)now.tv_sec * NS_PER_S + now.tv_nsec;
+}
+
+
+/* ------------------------------- END PUBLIC ------------------------------- */
@@ -0,0 +1,59 @@
+/*
+@context
+    * Provides statistics of a single search.
+    * Statistics are only gathered when built with `-DSEARCH_STATS` (e.g.
+      `make STATS=1`).
+        * Otherwise `STATS` removes every statement gathering them so they cost
+          nothing and all statistics read as `0`.
+*/
+
+
+#ifndef _SEARCH_STATS_H
+    #define _SEARCH_STATS_H
+
+    #include <stdint.h>
+
+    #include "dataTypes/point.h"
+
+
+    #ifdef SEARCH_STATS
+        #define STATS(statement) statement
+    #else
+        #define STATS(statement)
+    #endif
+
+
+    typedef struct searchStats_s searchStats_t;
+
+
+    struct searchStats_s
+    {
+        // points closed (including the target)
+        cell_t nExpanded;
+
+        // nodes inserted into the open list (including the source)
+        cell_t nPushed;
+
+        // open list nodes lowered to a shorter path instead of inserted
+        cell_t nDecreased;
+
+        // most nodes held by the open list at once
+        cell_t peakOpenSize;
+
+        // highest skip list level reached - `0` if not a skip list
+        uint8_t peakSkipLevel;
+
+        // memory allocated by the search - open list growth and the path
+        uint64_t bytesAllocated;
+
+        // time spent searching and reconstructing the path
+        uint64_t searchNs;
+        uint64_t reconstructNs;
+    };
+
+
+    void resetSearchStats(searchStats_t *stats);
+
+    uint64_t getStatsTimeNs();
+
+#endif
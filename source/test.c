@@ -0,0 +1,2862 @@
+/*
+@context
+    * Checks the shortest paths found by the search stack against a plain
+      Dijkstra search written independently of it.
+    * Dungeons are larger than 65536 cells so counts, handles and path
+      lengths that only fit 32 (or 16) bits would fail.
+        * A generated dungeon of 512x512.
+        * A very wide generated dungeon - 70000 points wide (4096 built with
+          `COMPACT_MAPS`) so coordinates pass 65535.
+        * A serpentine corridor whose path runs through every row, so a
+          single path is more than 65536 points long.
+    * Each query from a few sources to random targets is checked with
+      `findPath` and `findContextPathBuffer` of every open list type.
+        * Paths must only take valid moves, end at the target and cost the
+          same as the Dijkstra distance.
+        * Queries without a path must be reported as such.
+        * The same search is run again in slices of `STEP_EXPANSIONS`
+          expansions after one cancelled partway - it must find the same
+          length and cost with the same expansions.
+    * The same queries are checked with `findBidirectionalPath` of every open
+      list type, so a wrong meeting or stopping rule shows up as a longer path.
+    * The same queries are checked with `findWeightedPath` and
+      `findAnytimePath` of every open list type but the bucket queue.
+        * Weight `1` must find a shortest path.
+        * Every path reported for a weight (each ARA* iteration too) must
+          cost at most its reported bound times the Dijkstra distance.
+    * The same queries are checked with `findHpaPath` over clusters of
+      `HPA_CLUSTER_SIZE`.
+        * Paths must only take moves passing `isValidMove` and end at the
+          target.
+        * Each must cost at most the Dijkstra distance plus the detour
+          allowed for every cluster border the `findPath` path crosses (see
+          `hierarchicalAStar.h`).
+        * Queries without a path must be reported as such.
+    * The same queries are checked with `findJumpPath` of every open list type
+      but the bucket queue, and every step of its paths with `isValidMove`.
+    * `N_POOL_QUERIES` random queries of the large dungeon are found by a
+      pool of `N_POOL_THREADS` threads - each path must be the same as the
+      path of `findPath`.
+    * ALT landmark distance tables of the large dungeon are checked for
+      `N_SOURCES` random targets.
+        * The bound of every walkable point to the target must not exceed its
+          Dijkstra distance (the heuristic must not overestimate).
+        * Searches of every open list type given the tables must still find
+          shortest paths from random sources.
+    * `findLpaPath` is checked the same way after each round of walls placed
+      on its path and floors opened through `setLpaPoint` in the large
+      dungeon.
+        * Walls raise the distances of the points past them and floors lower
+          distances, so both ways of repairing are checked.
+    * `getFlowDistance` of a flow field to the target of the large dungeon is
+      checked for every walkable point against a Dijkstra search from the
+      target, when built and after each round of edits through
+      `setFlowPoint`.
+        * Half of the edits wall a tile of the flow path from the source.
+    * `findCachedPath` is checked in a new large dungeon as tiles are set.
+        * A path stays cached after a wall is set away from it with
+          `setCachedPoint`, and is searched again after a wall is set on it
+          or next to it.
+        * Every path is searched again after a tile is set with
+          `setDungeonPoint` (the dungeon version changes).
+        * Every lookup must match the Dijkstra distance.
+    * The connected component labels of
+      the same dungeon
+      are checked against a flood fill after each round of squares of walls
+      (around walkable points) and floors set with `setDungeonPoint`.
+        * Points must share a label exactly when the flood fill joins them,
+          and component sizes must match.
+        * `isDungeonConnected` must agree with the flood fill for random
+          queries (sources in walls too).
+    * The cached move mask of every cell of the large dungeon (walls too) is
+      checked against `isValidMove`.
+    * The query from one end of the serpentine corridor to the other must
+      expand and push every point of the corridor once - counted by
+      `getAStarExpansions` and, built with `SEARCH_STATS`, by
+      `getAStarStats`.
+    * The queries of the MovingAI scenario `SCENARIO_PATH` (on `MAP_PATH`)
+      are checked with `findPath` against the optimal lengths it lists.
+    * Prints one `test=<name>` line of `key=value` fields per dungeon and exits
+      with a failure if any query does not match.
+    * Usage: `./tests [seed]` (built and run with `make test`).
+*/
+
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "anytimeAStar.h"
+#include "aStar.h"
+#include "bidirectionalAStar.h"
+#include "flowField.h"
+#include "hierarchicalAStar.h"
+#include "jumpPointSearch.h"
+#include "landmarks.h"
+#include "lifelongAStar.h"
+#include "movingAI.h"
+#include "pathCache.h"
+#include "pathPool.h"
+#include "searchStats.h"
+#include "dataStructs/dungeon.h"
+#include "dataStructs/openList.h"
+#include "dataTypes/point.h"
+
+
+static const int SEED = 7907;
+
+static const uint32_t LARGE_SIDE = 512;
+
+#ifdef COMPACT_MAPS
+    static const uint32_t WIDE_WIDTH = COORD_MAX + 1;
+#else
+    static const uint32_t WIDE_WIDTH = 70000;
+#endif
+static const uint32_t WIDE_HEIGHT = 8;
+
+// rows of the serpentine corridor alternate with walls open at one end
+static const uint32_t SERPENT_WIDTH = 1024;
+static const uint32_t SERPENT_HEIGHT = 255;
+
+static const int N_SOURCES = 3;
+static const int N_TARGETS = 8;
+
+// most expansions of each slice of a search split by `stepContextPath`
+static const cell_t STEP_EXPANSIONS = 64;
+
+// width and height of each cluster of the graph searched by `findHpaPath`
+static const uint16_t HPA_CLUSTER_SIZE = 16;
+
+// queries of the batch found by `findPoolPaths` and the threads finding them
+static const uint32_t N_POOL_QUERIES = 256;
+static const uint8_t N_POOL_THREADS = 4;
+
+// MovingAI map and scenario of its queries (relative to `source`)
+static const char *const MAP_PATH = "scenarios/rooms.map";
+static const char *const SCENARIO_PATH = "scenarios/rooms.map.scen";
+
+// landmarks of the distance tables checked by `checkLandmarks`
+static const uint32_t N_LANDMARKS = 8;
+
+// inflation of the heuristic checked by `findWeightedPath` and the first
+// weight of `findAnytimePath` (given no deadline so it lowers to `1`)
+static const double BOUNDED_WEIGHT = 3;
+
+// bounds are floating point - slack allowed when comparing costs to them
+static const double BOUND_TOLERANCE = 1e-9;
+
+// rounds of edits replanned by `findLpaPath` - each walls tiles of the last
+// path and opens squares of up to `EDIT_RADIUS_MAX` around random points
+static const int N_REPLANS = 32;
+static const int N_EDITS = 4;
+static const int EDIT_RADIUS_MAX = 2;
+
+// rounds of `N_EDITS` edits made through `setFlowPoint`
+static const int N_FLOW_UPDATES = 16;
+
+// rounds of `N_EDITS` edits made through `setDungeonPoint` and the random
+// queries checked with `isDungeonConnected` after each
+static const int N_COMPONENT_UPDATES = 16;
+static const int N_COMPONENT_QUERIES = 256;
+
+// large enough that the paths checked in the cache are never evicted
+static const uint64_t CACHE_MAX_BYTES = 64 << 20;
+
+static const char TILE_WALL = '#';
+static const char TILE_FLOOR = ' ';
+
+
+typedef struct heapEntry_s heapEntry_t;
+typedef struct cacheQuery_s cacheQuery_t;
+
+// query looked up in a path cache and the path last found for it
+struct cacheQuery_s
+{
+    point_t source;
+    point_t target;
+
+    // buffer able to hold a path through every cell of the dungeon
+    point_t *path;
+    pathResult_t result;
+};
+
+// sets a tile of a dungeon through a structure kept up to date with it
+typedef void (*setTile_t)(void   *editor,
+                          point_t point,
+                          char    tile);
+
+
+// entry of the Dijkstra search queue - stale once `distance` is improved
+struct heapEntry_s
+{
+    score_t distance;
+    cell_t cell;
+};
+
+
+static bool checkDungeon(const char *name,
+                         dungeon_t  *dungeon,
+                         point_t     firstSource);
+static bool checkQuery(dungeon_t       *dungeon,
+                       aStarContext_t **contexts,
+                       point_t         *buffer,
+                       point_t          source,
+                       point_t          target,
+                       score_t          distance);
+static bool checkSlicedQuery(dungeon_t      *dungeon,
+                             aStarContext_t *context,
+                             point_t        *buffer,
+                             point_t         source,
+                             point_t         target,
+                             pathResult_t    expected);
+static bool checkBidirectionalQuery(dungeon_t               *dungeon,
+                                    bidirectionalContext_t **contexts,
+                                    point_t                  source,
+                                    point_t                  target,
+                                    score_t                  distance);
+static bool checkBoundedQuery(dungeon_t     *dungeon,
+                              araContext_t **contexts,
+                              point_t       *buffer,
+                              point_t        source,
+                              point_t        target,
+                              score_t        distance);
+static bool checkBoundedResult(dungeon_t    *dungeon,
+                               araContext_t *context,
+                               pathResult_t  result,
+                               point_t      *buffer,
+                               point_t       source,
+                               point_t       target,
+                               score_t       distance);
+static bool isWithinBound(score_t cost,
+                          double  bound,
+                          score_t distance);
+static bool checkHpaQuery(dungeon_t  *dungeon,
+                          hpaGraph_t *graph,
+                          point_t     source,
+                          point_t     target,
+                          score_t     distance);
+static cell_t countClusterCrossings(point_t  source,
+                                    point_t *path,
+                                    cell_t   length);
+static bool checkJumpQuery(dungeon_t      *dungeon,
+                           jumpContext_t **contexts,
+                           point_t         source,
+                           point_t         target,
+                           score_t         distance);
+static void reportMismatch(const char *name,
+                           const char *search,
+                           point_t     source,
+                           point_t     target);
+static bool checkStats(const char *name,
+                       dungeon_t  *dungeon);
+static bool checkPathPool(const char *name,
+                          dungeon_t  *dungeon);
+static bool checkScenario(const char *name,
+                          const char *mapPath,
+                          const char *scenarioPath);
+static bool checkLandmarks(const char *name,
+                           dungeon_t  *dungeon);
+static bool checkReplans(const char *name,
+                         dungeon_t  *dungeon);
+static bool checkMoves(const char *name,
+                       dungeon_t  *dungeon);
+static bool checkFlowField(const char *name,
+                           dungeon_t  *dungeon);
+static bool checkFlowDistances(flowField_t *field,
+                               dungeon_t   *dungeon,
+                               score_t     *distances);
+static bool checkPathCache(const char *name,
+                           dungeon_t  *dungeon);
+static bool checkCachedQuery(dungeon_t      *dungeon,
+                             pathCache_t    *cache,
+                             aStarContext_t *context,
+                             cacheQuery_t   *query,
+                             score_t        *distances,
+                             bool            isHit);
+static bool isNearPath(point_t       point,
+                       cacheQuery_t *query);
+static bool findNearPath(dungeon_t    *dungeon,
+                         cacheQuery_t *query,
+                         cacheQuery_t *other,
+                         point_t      *near);
+static bool checkComponents(const char *name,
+                            dungeon_t  *dungeon);
+static bool checkLabels(dungeon_t *dungeon,
+                        cell_t    *labels,
+                        cell_t    *sizes);
+static bool isFloodConnected(dungeon_t *dungeon,
+                             cell_t    *labels,
+                             point_t    source,
+                             point_t    target);
+static void findComponents(dungeon_t *dungeon,
+                           cell_t    *labels,
+                           cell_t    *sizes);
+
+static void editSquare(setTile_t  setTile,
+                       void      *editor,
+                       dungeon_t *dungeon,
+                       point_t    centre,
+                       int        radius,
+                       char       tile);
+static void setLpaTile(void   *planner,
+                       point_t point,
+                       char    tile);
+static void setFlowTile(void   *field,
+                        point_t point,
+                        char    tile);
+static void setDungeonTile(void   *dungeon,
+                           point_t point,
+                           char    tile);
+
+static cell_t getPathLength(dungeon_t *dungeon,
+                            point_t    target,
+                            point_t   *path);
+static bool checkPath(dungeon_t *dungeon,
+                      point_t    source,
+                      point_t    target,
+                      point_t   *path,
+                      cell_t     length,
+                      score_t    distance);
+static bool isValidPath(dungeon_t *dungeon,
+                        point_t    source,
+                        point_t   *path,
+                        cell_t     length);
+static score_t getPathCost(point_t  source,
+                           point_t *path,
+                           cell_t   length);
+
+static void findDistances(dungeon_t *dungeon,
+                          point_t    source,
+                          score_t   *distances);
+static void pushEntry(heapEntry_t *heap,
+                      cell_t      *size,
+                      heapEntry_t  entry);
+static heapEntry_t popEntry(heapEntry_t *heap,
+                            cell_t      *size);
+
+static dungeon_t *initSerpentDungeon(void);
+static point_t findRandomWalkable(dungeon_t *dungeon);
+static bool isWalkable(dungeon_t *dungeon,
+                       int64_t    x,
+                       int64_t    y);
+
+
+int main(int argc, char **argv)
+{
+    bool isPassed;
+    dungeon_t *dungeon;
+
+    srand(argc > 1 ? atoi(argv[1]) : SEED);
+
+    isPassed = true;
+
+    dungeon = initDungeon(LARGE_SIDE, LARGE_SIDE);
+    isPassed &= checkMoves("moves", dungeon);
+    isPassed &= checkDungeon("large", dungeon, getDungeonSource(dungeon));
+    isPassed &= checkPathPool("pool", dungeon);
+    isPassed &= checkLandmarks("landmarks", dungeon);
+    isPassed &= checkReplans("replan", dungeon);
+    isPassed &= checkFlowField("flow", dungeon);
+    freeDungeon(dungeon);
+
+    dungeon = initDungeon(LARGE_SIDE, LARGE_SIDE);
+    isPassed &= checkPathCache("cache", dungeon);
+    isPassed &= checkComponents("components", dungeon);
+    freeDungeon(dungeon);
+
+    dungeon = initDungeon(WIDE_WIDTH, WIDE_HEIGHT);
+    isPassed &= checkDungeon("wide", dungeon, getDungeonSource(dungeon));
+    freeDungeon(dungeon);
+
+    // from the start of the corridor so the path to its end is the longest
+    dungeon = initSerpentDungeon();
+    isPassed &= checkDungeon("serpent", dungeon, initPoint(0, 0));
+    isPassed &= checkStats("stats", dungeon);
+    freeDungeon(dungeon);
+
+    isPassed &= checkScenario("scenario", MAP_PATH, SCENARIO_PATH);
+
+    printf("tests %s\n", isPassed ? "passed" : "failed");
+
+    return isPassed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+/*
+@context
+    * Checks queries from `N_SOURCES` sources to `N_TARGETS` random walkable
+      targets each in `dungeon` and prints the results.
+    * The first query of `firstSource` is to the walkable point farthest from
+      it, so the longest paths of `dungeon` are checked.
+
+@parameters
+    * name
+        * Name of the dungeon printed with the results.
+    * dungeon
+        * Dungeon to check queries in.
+    * firstSource
+        * Source of the first queries - later sources are random.
+
+@return
+    * Indication every query matched the Dijkstra distances.
+*/
+static bool checkDungeon(const char *name,
+                         dungeon_t  *dungeon,
+                         point_t     firstSource)
+{
+    int i, j, nQueries, nFailed;
+    bool isMatched;
+    cell_t cell, farthest, length, longest;
+    score_t distance;
+    score_t *distances;
+    point_t *buffer;
+    point_t source, target;
+    aStarContext_t *contexts[N_OPEN_LIST_TYPES];
+    bidirectionalContext_t *bidirectionalContexts[N_OPEN_LIST_TYPES];
+    araContext_t *araContexts[N_OPEN_LIST_TYPES];
+    jumpContext_t *jumpContexts[N_OPEN_LIST_TYPES];
+    hpaGraph_t *graph;
+    openListType_t openType;
+
+    distances = malloc(sizeof(score_t) * (size_t)getDungeonSize(dungeon));
+    assert(distances != NULL);
+    buffer = malloc(sizeof(point_t) * (size_t)getDungeonSize(dungeon));
+    assert(buffer != NULL);
+    for (openType = 0; openType < N_OPEN_LIST_TYPES; openType += 1)
+    {
+        contexts[openType] = initAStarContext(dungeon, openType);
+        bidirectionalContexts[openType] = initBidirectionalContext(dungeon,
+                                                                   openType);
+
+        // weighted f-scores can decrease and jumps can span the dungeon so
+        // the bucket queue cannot be used
+        araContexts[openType] = openType == OPEN_LIST_BUCKET
+                              ? NULL
+                              : initAraContext(dungeon, openType);
+        jumpContexts[openType] = openType == OPEN_LIST_BUCKET
+                               ? NULL
+                               : initJumpContext(dungeon, openType);
+    }
+    graph = initHpaGraph(dungeon, HPA_CLUSTER_SIZE);
+
+    nQueries = 0;
+    nFailed = 0;
+    longest = 0;
+    for (i = 0; i < N_SOURCES; i += 1)
+    {
+        source = i == 0 ? firstSource : findRandomWalkable(dungeon);
+        findDistances(dungeon, source, distances);
+
+        for (j = 0; j < N_TARGETS; j += 1)
+        {
+            // a query from a point to itself has no path to check
+            do
+            {
+                target = findRandomWalkable(dungeon);
+            }
+            while (isEqualPoints(target, source));
+
+            if (i == 0 && j == 0)
+            {
+                farthest = getDungeonIndex(dungeon, source);
+                for (cell = 0; cell < getDungeonSize(dungeon); cell += 1)
+                {
+                    if (distances[cell] != SCORE_MAX
+                        && distances[cell] > distances[farthest])
+                    {
+                        farthest = cell;
+                    }
+                }
+                target = getDungeonIndexPoint(dungeon, farthest);
+            }
+
+            nQueries += 1;
+            distance = distances[getDungeonIndex(dungeon, target)];
+            isMatched = true;
+
+            if (!checkQuery(dungeon, contexts, buffer, source, target,
+                            distance))
+            {
+                isMatched = false;
+                reportMismatch(name, "findPath", source, target);
+            }
+            if (!checkBidirectionalQuery(dungeon, bidirectionalContexts,
+                                         source, target, distance))
+            {
+                isMatched = false;
+                reportMismatch(name, "findBidirectionalPath", source, target);
+            }
+            if (!checkBoundedQuery(dungeon, araContexts, buffer, source,
+                                   target, distance))
+            {
+                isMatched = false;
+                reportMismatch(name, "findAnytimePath", source, target);
+            }
+            if (!checkHpaQuery(dungeon, graph, source, target, distance))
+            {
+                isMatched = false;
+                reportMismatch(name, "findHpaPath", source, target);
+            }
+            if (!checkJumpQuery(dungeon, jumpContexts, source, target,
+                                distance))
+            {
+                isMatched = false;
+                reportMismatch(name, "findJumpPath", source, target);
+            }
+
+            nFailed += !isMatched;
+
+            // the last search of every context was this query
+            length = getAStarPath(contexts[0], buffer,
+                                  getDungeonSize(dungeon)).length;
+            if (length > longest)
+            {
+                longest = length;
+            }
+        }
+    }
+
+    printf("test=%s width=%u height=%u cells=%llu queries=%d failed=%d"
+           " longest_path=%llu\n",
+           name, getDungeonWidth(dungeon), getDungeonHeight(dungeon),
+           (unsigned long long)getDungeonSize(dungeon), nQueries, nFailed,
+           (unsigned long long)longest);
+
+    for (openType = 0; openType < N_OPEN_LIST_TYPES; openType += 1)
+    {
+        freeAStarContext(contexts[openType]);
+        freeBidirectionalContext(bidirectionalContexts[openType]);
+        if (araContexts[openType] != NULL)
+        {
+            freeAraContext(araContexts[openType]);
+        }
+        if (jumpContexts[openType] != NULL)
+        {
+            freeJumpContext(jumpContexts[openType]);
+        }
+    }
+    freeHpaGraph(graph);
+    free(buffer);
+    free(distances);
+
+    return nFailed == 0;
+}
+
+
+/*
+@context
+    * Checks a query with `findPath` and `findContextPathBuffer` of every
+      open list type.
+    * Each context then searches the query again in slices.
+
+@parameters
+    * dungeon
+        * Dungeon of the query.
+    * contexts
+        * Search context of each open list type.
+    * buffer
+        * Buffer able to hold a path through every cell of `dungeon`.
+    * source
+        * Source of the query.
+    * target
+        * Target of the query.
+    * distance
+        * Dijkstra distance from `source` to `target` - `SCORE_MAX` if no
+          path is possible.
+
+@return
+    * Indication every search matched `distance`.
+*/
+static bool checkQuery(dungeon_t       *dungeon,
+                       aStarContext_t **contexts,
+                       point_t         *buffer,
+                       point_t          source,
+                       point_t          target,
+                       score_t          distance)
+{
+    bool isMatched;
+    cell_t length;
+    point_t *path;
+    pathResult_t result;
+    openListType_t openType;
+
+    isMatched = true;
+
+    path = findPath(dungeon, source, target);
+    if (path == NULL)
+    {
+        isMatched &= distance == SCORE_MAX;
+    }
+    else
+    {
+        length = getPathLength(dungeon, target, path);
+        isMatched &= checkPath(dungeon, source, target, path, length,
+                               distance);
+        free(path);
+    }
+
+    for (openType = 0; openType < N_OPEN_LIST_TYPES; openType += 1)
+    {
+        result = findContextPathBuffer(contexts[openType], source, target,
+                                       buffer, getDungeonSize(dungeon));
+        if (result.status == PATH_NOT_FOUND)
+        {
+            isMatched &= distance == SCORE_MAX;
+        }
+        else
+        {
+            isMatched &= result.status == PATH_FOUND
+                      && result.cost == distance
+                      && checkPath(dungeon, source, target, buffer,
+                                   result.length, distance);
+        }
+
+        isMatched &= checkSlicedQuery(dungeon, contexts[openType], buffer,
+                                      source, target, result);
+    }
+
+    return isMatched;
+}
+
+
+/*
+@context
+    * Checks a query searched in slices of `STEP_EXPANSIONS` expansions
+      (`startContextPath`, `stepContextPath` then `finishContextPath`)
+      matches the same search run in one go.
+    * A first search is cancelled after its first slice - it must not give a
+      path and the next search of `context` must not be affected by it.
+
+@parameters
+    * dungeon
+        * Dungeon of the query.
+    * context
+        * Search context whose last search was the query in one go.
+    * buffer
+        * Buffer able to hold a path through every cell of `dungeon`.
+    * source
+        * Source of the query.
+    * target
+        * Target of the query.
+    * expected
+        * Result of the search in one go.
+
+@return
+    * Indication the sliced search found the same length and cost with the
+      same number of expansions.
+*/
+static bool checkSlicedQuery(dungeon_t      *dungeon,
+                             aStarContext_t *context,
+                             point_t        *buffer,
+                             point_t         source,
+                             point_t         target,
+                             pathResult_t    expected)
+{
+    cell_t nExpanded, nSlices;
+    pathStatus_t status;
+    pathResult_t result;
+
+    nExpanded = getAStarExpansions(context);
+
+    startContextPath(context, source, target);
+    stepContextPath(context, STEP_EXPANSIONS);
+    cancelContextPath(context);
+    if (finishContextPath(context, buffer,
+                          getDungeonSize(dungeon)).status != PATH_NOT_FOUND)
+    {
+        return false;
+    }
+
+    startContextPath(context, source, target);
+    nSlices = 0;
+    do
+    {
+        status = stepContextPath(context, STEP_EXPANSIONS);
+        nSlices += 1;
+    }
+    while (status == PATH_SEARCHING);
+    result = finishContextPath(context, buffer, getDungeonSize(dungeon));
+
+    return status == expected.status
+        && result.status == expected.status
+        && result.length == expected.length
+        && result.cost == expected.cost
+        && getAStarExpansions(context) == nExpanded
+        && nExpanded <= nSlices * STEP_EXPANSIONS
+        && (result.status != PATH_FOUND
+            || checkPath(dungeon, source, target, buffer, result.length,
+                         result.cost));
+}
+
+
+/*
+@context
+    * Checks a query with `findBidirectionalPath` of every open list type.
+
+@parameters
+    * dungeon
+        * Dungeon of the query.
+    * contexts
+        * Bidirectional A* context of each open list type.
+    * source
+        * Source of the query.
+    * target
+        * Target of the query.
+    * distance
+        * Dijkstra distance from `source` to `target` - `SCORE_MAX` if no
+          path is possible.
+
+@return
+    * Indication every search matched `distance`.
+*/
+static bool checkBidirectionalQuery(dungeon_t               *dungeon,
+                                    bidirectionalContext_t **contexts,
+                                    point_t                  source,
+                                    point_t                  target,
+                                    score_t                  distance)
+{
+    bool isMatched;
+    point_t *path;
+    openListType_t openType;
+
+    isMatched = true;
+
+    for (openType = 0; openType < N_OPEN_LIST_TYPES; openType += 1)
+    {
+        path = findBidirectionalPath(contexts[openType], source, target);
+        if (path == NULL)
+        {
+            isMatched &= distance == SCORE_MAX;
+        }
+        else
+        {
+            isMatched &= checkPath(dungeon, source, target, path,
+                                   getPathLength(dungeon, target, path),
+                                   distance);
+            free(path);
+        }
+    }
+
+    return isMatched;
+}
+
+
+/*
+@context
+    * Checks a query with `findWeightedPath` and `findAnytimePath` of every
+      open list type but the bucket queue.
+        * `findWeightedPath` with weight `1` must find a shortest path.
+        * `findWeightedPath` and `findAnytimePath` with `BOUNDED_WEIGHT` must
+          find paths within the bounds they report.
+        * `findAnytimePath` has no deadline so must end with a shortest path.
+
+@parameters
+    * dungeon
+        * Dungeon of the query.
+    * contexts
+        * ARA* context of each open list type - `NULL` for the bucket queue.
+    * buffer
+        * Buffer able to hold a path through every cell of `dungeon`.
+    * source
+        * Source of the query.
+    * target
+        * Target of the query.
+    * distance
+        * Dijkstra distance from `source` to `target` - `SCORE_MAX` if no
+          path is possible.
+
+@return
+    * Indication every search was within its bound of `distance`.
+*/
+static bool checkBoundedQuery(dungeon_t     *dungeon,
+                              araContext_t **contexts,
+                              point_t       *buffer,
+                              point_t        source,
+                              point_t        target,
+                              score_t        distance)
+{
+    bool isMatched;
+    cell_t capacity;
+    pathResult_t result;
+    openListType_t openType;
+
+    isMatched = true;
+    capacity = getDungeonSize(dungeon);
+
+    for (openType = 0; openType < N_OPEN_LIST_TYPES; openType += 1)
+    {
+        if (contexts[openType] == NULL)
+        {
+            continue;
+        }
+
+        result = findWeightedPath(contexts[openType], source, target, 1,
+                                  buffer, capacity);
+        isMatched &= checkBoundedResult(dungeon, contexts[openType], result,
+                                        buffer, source, target, distance)
+                  && (result.status != PATH_FOUND
+                      || result.cost == distance);
+
+        result = findWeightedPath(contexts[openType], source, target,
+                                  BOUNDED_WEIGHT, buffer, capacity);
+        isMatched &= checkBoundedResult(dungeon, contexts[openType], result,
+                                        buffer, source, target, distance);
+
+        result = findAnytimePath(contexts[openType], source, target,
+                                 BOUNDED_WEIGHT, UINT64_MAX, buffer,
+                                 capacity);
+        isMatched &= checkBoundedResult(dungeon, contexts[openType], result,
+                                        buffer, source, target, distance)
+                  && (result.status != PATH_FOUND
+                      || result.cost == distance);
+    }
+
+    return isMatched;
+}
+
+
+/*
+@context
+    * Checks the result of the last search of an ARA* context.
+        * Queries without a path must be reported as such.
+        * The path must only take valid moves, end at `target` and cost what
+          `result` reports.
+        * The path and the target g-score of every weight searched must be
+          within the bound reported for it.
+
+@parameters
+    * dungeon
+        * Dungeon of the query.
+    * context
+        * ARA* context that searched the query last.
+    * result
+        * Result of the search.
+    * buffer
+        * Path written by the search.
+    * source
+        * Source of the query.
+    * target
+        * Target of the query.
+    * distance
+        * Dijkstra distance from `source` to `target` - `SCORE_MAX` if no
+          path is possible.
+
+@return
+    * Indication the search was within its bounds of `distance`.
+*/
+static bool checkBoundedResult(dungeon_t    *dungeon,
+                               araContext_t *context,
+                               pathResult_t  result,
+                               point_t      *buffer,
+                               point_t       source,
+                               point_t       target,
+                               score_t       distance)
+{
+    uint32_t i;
+    araIteration_t iteration;
+
+    if (result.status == PATH_NOT_FOUND)
+    {
+        return distance == SCORE_MAX;
+    }
+
+    if (result.status != PATH_FOUND
+        || !checkPath(dungeon, source, target, buffer, result.length,
+                      result.cost)
+        || !isWithinBound(result.cost, getAraBound(context), distance))
+    {
+        return false;
+    }
+
+    for (i = 0; i < getAraIterations(context); i += 1)
+    {
+        iteration = getAraIteration(context, i);
+        if (iteration.bound > iteration.weight + BOUND_TOLERANCE
+            || !isWithinBound(iteration.cost, iteration.bound, distance))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+/*
+@context
+    * Checks `cost` is at most `bound` times `distance`.
+
+@parameters
+    * cost
+        * Cost of a path found.
+    * bound
+        * Suboptimality bound reported for the path.
+    * distance
+        * Cost of a shortest path.
+
+@return
+    * Indication `cost` is within `bound`.
+*/
+static bool isWithinBound(score_t cost,
+                          double  bound,
+                          score_t distance)
+{
+    return (double)cost
+        <= bound * (double)distance * (1 + BOUND_TOLERANCE);
+}
+
+
+/*
+@context
+    * Checks a query with `findHpaPath`.
+        * Its path only crosses clusters at entrances so need not be a
+          shortest path - it may cost up to `HPA_CLUSTER_SIZE` cardinal moves
+          more than `distance` for each cluster border a shortest path
+          crosses (see `hierarchicalAStar.h`).
+        * Every step must pass `isValidMove`.
+    * The borders crossed are counted on the path of `findPath`.
+
+@parameters
+    * dungeon
+        * Dungeon of the query.
+    * graph
+        * Cluster graph of `dungeon`.
+    * source
+        * Source of the query.
+    * target
+        * Target of the query.
+    * distance
+        * Dijkstra distance from `source` to `target` - `SCORE_MAX` if no
+          path is possible.
+
+@return
+    * Indication the path was found and within the bound of `distance`.
+*/
+static bool checkHpaQuery(dungeon_t  *dungeon,
+                          hpaGraph_t *graph,
+                          point_t     source,
+                          point_t     target,
+                          score_t     distance)
+{
+    bool isMatched;
+    cell_t length, nCrossings;
+    score_t bound;
+    point_t *path, *shortest;
+
+    path = findHpaPath(graph, source, target);
+    shortest = findPath(dungeon, source, target);
+    if (path == NULL || shortest == NULL)
+    {
+        free(path);
+        free(shortest);
+        return path == NULL && distance == SCORE_MAX;
+    }
+
+    nCrossings = countClusterCrossings(source, shortest,
+                                       getPathLength(dungeon, target,
+                                                     shortest));
+    bound = distance + nCrossings * HPA_CLUSTER_SIZE * COST_CARDINAL;
+
+    length = getPathLength(dungeon, target, path);
+    isMatched = distance != SCORE_MAX
+             && isEqualPoints(path[length - 1], target)
+             && isValidPath(dungeon, source, path, length)
+             && getPathCost(source, path, length) <= bound;
+    free(shortest);
+    free(path);
+
+    return isMatched;
+}
+
+
+/*
+@context
+    * Counts the cluster borders of `findHpaPath` crossed by the moves of
+      `path` from `source`.
+    * A diagonal move through the corner of a cluster crosses 2 borders.
+
+@parameters
+    * source
+        * Source of the path - not part of `path`.
+    * path
+        * Points of the path - each adjacent to the last.
+    * length
+        * Number of points in `path`.
+
+@return
+    * Number of borders crossed.
+*/
+static cell_t countClusterCrossings(point_t  source,
+                                    point_t *path,
+                                    cell_t   length)
+{
+    cell_t i, nCrossings;
+    point_t from;
+
+    nCrossings = 0;
+    for (i = 0; i < length; i += 1)
+    {
+        from = i == 0 ? source : path[i - 1];
+        nCrossings += from.x / HPA_CLUSTER_SIZE != path[i].x / HPA_CLUSTER_SIZE;
+        nCrossings += from.y / HPA_CLUSTER_SIZE != path[i].y / HPA_CLUSTER_SIZE;
+    }
+
+    return nCrossings;
+}
+
+
+/*
+@context
+    * Checks a query with `findJumpPath` of every open list type but the
+      bucket queue.
+    * Every step of the paths must also pass `isValidMove`.
+
+@parameters
+    * dungeon
+        * Dungeon of the query.
+    * contexts
+        * Jump Point Search context of each open list type - `NULL` for the
+          bucket queue.
+    * source
+        * Source of the query.
+    * target
+        * Target of the query.
+    * distance
+        * Dijkstra distance from `source` to `target` - `SCORE_MAX` if no
+          path is possible.
+
+@return
+    * Indication every search matched `distance`.
+*/
+static bool checkJumpQuery(dungeon_t      *dungeon,
+                           jumpContext_t **contexts,
+                           point_t         source,
+                           point_t         target,
+                           score_t         distance)
+{
+    bool isMatched;
+    cell_t length;
+    point_t *path;
+    openListType_t openType;
+
+    isMatched = true;
+
+    for (openType = 0; openType < N_OPEN_LIST_TYPES; openType += 1)
+    {
+        if (contexts[openType] == NULL)
+        {
+            continue;
+        }
+
+        path = findJumpPath(contexts[openType], source, target);
+        if (path == NULL)
+        {
+            isMatched &= distance == SCORE_MAX;
+        }
+        else
+        {
+            length = getPathLength(dungeon, target, path);
+            isMatched &= checkPath(dungeon, source, target, path, length,
+                                   distance)
+                      && isValidPath(dungeon, source, path, length);
+            free(path);
+        }
+    }
+
+    return isMatched;
+}
+
+
+/*
+@context
+    * Prints a query that did not match the Dijkstra distances.
+
+@parameters
+    * name
+        * Name of the dungeon of the query.
+    * search
+        * Name of the search that did not match.
+    * source
+        * Source of the query.
+    * target
+        * Target of the query.
+*/
+static void reportMismatch(const char *name,
+                           const char *search,
+                           point_t     source,
+                           point_t     target)
+{
+    fprintf(stderr, "mismatch test=%s search=%s source=(%lld,%lld)"
+            " target=(%lld,%lld)\n", name, search,
+            (long long)source.x, (long long)source.y,
+            (long long)target.x, (long long)target.y);
+}
+
+
+/*
+@context
+    * Checks the expansions counted by a search along the serpentine corridor
+      of `dungeon` from one end to the other, and prints the results.
+    * Every point of the corridor is on the path so each must be pushed and
+      expanded exactly once.
+        * `getAStarExpansions` must count every point.
+        * Built with `SEARCH_STATS`, the expansions and pushes of
+          `getAStarStats` must match it.
+
+@parameters
+    * name
+        * Name of the check printed with the results.
+    * dungeon
+        * Serpentine corridor dungeon (`initSerpentDungeon`).
+
+@return
+    * Indication the counts matched.
+*/
+static bool checkStats(const char *name,
+                       dungeon_t  *dungeon)
+{
+    bool isMatched;
+    int64_t x, y;
+    cell_t nWalkable, nExpanded;
+    point_t *path;
+    point_t source, target;
+    aStarContext_t *context;
+    searchStats_t stats;
+
+    nWalkable = 0;
+    for (y = 0; y < getDungeonHeight(dungeon); y += 1)
+    {
+        for (x = 0; x < getDungeonWidth(dungeon); x += 1)
+        {
+            nWalkable += isWalkable(dungeon, x, y);
+        }
+    }
+
+    // the last row is entered from the right as the walls above it open
+    // there - the corridor ends at its left
+    source = initPoint(0, 0);
+    target = initPoint(0, getDungeonHeight(dungeon) - 1);
+
+    context = initAStarContext(dungeon, OPEN_LIST_DEFAULT);
+    path = findContextPath(context, source, target);
+    nExpanded = getAStarExpansions(context);
+    stats = getAStarStats(context);
+
+    isMatched = path != NULL
+             && getPathLength(dungeon, target, path) + 1 == nWalkable
+             && nExpanded == nWalkable;
+#ifdef SEARCH_STATS
+    isMatched = isMatched
+             && stats.nExpanded == nExpanded
+             && stats.nPushed == nExpanded;
+#endif
+
+    if (!isMatched)
+    {
+        reportMismatch(name, "getAStarStats", source, target);
+    }
+
+    printf("test=%s width=%u height=%u expanded=%llu pushed=%llu"
+           " failed=%d\n",
+           name, getDungeonWidth(dungeon), getDungeonHeight(dungeon),
+           (unsigned long long)nExpanded, (unsigned long long)stats.nPushed,
+           !isMatched);
+
+    free(path);
+    freeAStarContext(context);
+
+    return isMatched;
+}
+
+
+/*
+@context
+    * Checks a batch of `N_POOL_QUERIES` random queries found by a pool of
+      `N_POOL_THREADS` threads, and prints the results.
+    * Each path must be the same as the path of `findPath` - the threads
+      search with the same open list type.
+
+@parameters
+    * name
+        * Name of the check printed with the results.
+    * dungeon
+        * Dungeon to find paths in.
+
+@return
+    * Indication every path matched.
+*/
+static bool checkPathPool(const char *name,
+                          dungeon_t  *dungeon)
+{
+    uint32_t i;
+    int nFailed;
+    bool isMatched;
+    cell_t j, length;
+    point_t *expected;
+    point_t **paths;
+    pathQuery_t *queries;
+    pathPool_t *pool;
+
+    queries = malloc(sizeof(pathQuery_t) * N_POOL_QUERIES);
+    assert(queries != NULL);
+    paths = malloc(sizeof(point_t *) * N_POOL_QUERIES);
+    assert(paths != NULL);
+
+    for (i = 0; i < N_POOL_QUERIES; i += 1)
+    {
+        queries[i].source = findRandomWalkable(dungeon);
+        do
+        {
+            queries[i].target = findRandomWalkable(dungeon);
+        }
+        while (isEqualPoints(queries[i].target, queries[i].source));
+    }
+
+    pool = initPathPool(dungeon, N_POOL_THREADS, OPEN_LIST_DEFAULT);
+    findPoolPaths(pool, queries, N_POOL_QUERIES, paths);
+
+    nFailed = 0;
+    for (i = 0; i < N_POOL_QUERIES; i += 1)
+    {
+        expected = findPath(dungeon, queries[i].source, queries[i].target);
+
+        isMatched = (paths[i] == NULL) == (expected == NULL);
+        if (isMatched && expected != NULL)
+        {
+            length = getPathLength(dungeon, queries[i].target, expected);
+            isMatched = getPathLength(dungeon, queries[i].target, paths[i])
+                     == length;
+            for (j = 0; j < length && isMatched; j += 1)
+            {
+                isMatched = isEqualPoints(paths[i][j], expected[j]);
+            }
+        }
+
+        if (!isMatched)
+        {
+            nFailed += 1;
+            reportMismatch(name, "findPoolPaths", queries[i].source,
+                           queries[i].target);
+        }
+
+        free(expected);
+        free(paths[i]);
+    }
+
+    printf("test=%s width=%u height=%u threads=%u queries=%u failed=%d\n",
+           name, getDungeonWidth(dungeon), getDungeonHeight(dungeon),
+           N_POOL_THREADS, N_POOL_QUERIES, nFailed);
+
+    freePathPool(pool);
+    free(paths);
+    free(queries);
+
+    return nFailed == 0;
+}
+
+
+/*
+@context
+    * Checks the queries of a MovingAI scenario with `findPath`, and prints
+      the results.
+    * Each path must be a shortest path by the Dijkstra distance and that
+      distance must match the optimal length of the scenario (allowing for
+      `COST_DIAGONAL / COST_CARDINAL` not being exactly sqrt(2)).
+
+@parameters
+    * name
+        * Name of the check printed with the results.
+    * mapPath
+        * Location of the `.map` file.
+    * scenarioPath
+        * Location of the `.scen` file of queries on the map.
+
+@return
+    * Indication the files loaded and every query matched.
+*/
+static bool checkScenario(const char *name,
+                          const char *mapPath,
+                          const char *scenarioPath)
+{
+    uint32_t i;
+    int nFailed;
+    score_t distance;
+    score_t *distances;
+    point_t *path;
+    dungeon_t *dungeon;
+    scenario_t *scenario;
+    scenarioQuery_t query;
+
+    dungeon = loadMovingAiMap(mapPath);
+    scenario = loadMovingAiScenario(scenarioPath);
+    if (dungeon == NULL || scenario == NULL
+        || getScenarioSize(scenario) == 0
+        || getScenarioMapWidth(scenario) != getDungeonWidth(dungeon)
+        || getScenarioMapHeight(scenario) != getDungeonHeight(dungeon))
+    {
+        fprintf(stderr, "mismatch test=%s map=%s scenario=%s\n", name,
+                mapPath, scenarioPath);
+        if (dungeon != NULL)
+        {
+            freeDungeon(dungeon);
+        }
+        if (scenario != NULL)
+        {
+            freeScenario(scenario);
+        }
+        return false;
+    }
+
+    distances = malloc(sizeof(score_t) * (size_t)getDungeonSize(dungeon));
+    assert(distances != NULL);
+
+    nFailed = 0;
+    for (i = 0; i < getScenarioSize(scenario); i += 1)
+    {
+        query = getScenarioQuery(scenario, i);
+        findDistances(dungeon, query.source, distances);
+        distance = distances[getDungeonIndex(dungeon, query.target)];
+
+        path = findPath(dungeon, query.source, query.target);
+        if (path == NULL
+            || !checkPath(dungeon, query.source, query.target, path,
+                          getPathLength(dungeon, query.target, path),
+                          distance)
+            || !isScenarioOptimal(distance, query.optimalLength))
+        {
+            nFailed += 1;
+            reportMismatch(name, "findPath", query.source, query.target);
+        }
+        free(path);
+    }
+
+    printf("test=%s map=%s width=%u height=%u queries=%u failed=%d\n",
+           name, getScenarioMapName(scenario), getDungeonWidth(dungeon),
+           getDungeonHeight(dungeon), getScenarioSize(scenario), nFailed);
+
+    free(distances);
+    freeScenario(scenario);
+    freeDungeon(dungeon);
+
+    return nFailed == 0;
+}
+
+
+/*
+@context
+    * Checks ALT landmark distance tables of `dungeon` against Dijkstra
+      distances, and prints the results.
+    * For each of `N_SOURCES` random targets:
+        * The bound from every walkable point to the target must be at most
+          its distance.
+        * `N_TARGETS` random sources are searched with `findContextPathBuffer`
+          of every open list type using the tables - each path must be a
+          shortest path.
+
+@parameters
+    * name
+        * Name of the check printed with the results.
+    * dungeon
+        * Dungeon to build landmark distance tables of.
+
+@return
+    * Indication every bound and search matched the Dijkstra distances.
+*/
+static bool checkLandmarks(const char *name,
+                           dungeon_t  *dungeon)
+{
+    int i, j, nQueries, nFailed;
+    int64_t x, y;
+    bool isMatched;
+    cell_t cell, targetIndex;
+    score_t distance;
+    score_t *distances;
+    point_t *buffer;
+    point_t source, target;
+    pathResult_t result;
+    landmarks_t *landmarks;
+    aStarContext_t *contexts[N_OPEN_LIST_TYPES];
+    openListType_t openType;
+
+    distances = malloc(sizeof(score_t) * (size_t)getDungeonSize(dungeon));
+    assert(distances != NULL);
+    buffer = malloc(sizeof(point_t) * (size_t)getDungeonSize(dungeon));
+    assert(buffer != NULL);
+
+    landmarks = initLandmarks(dungeon, N_LANDMARKS);
+    for (openType = 0; openType < N_OPEN_LIST_TYPES; openType += 1)
+    {
+        contexts[openType] = initAStarContext(dungeon, openType);
+        setAStarLandmarks(contexts[openType], landmarks);
+    }
+
+    nQueries = 0;
+    nFailed = 0;
+    for (i = 0; i < N_SOURCES; i += 1)
+    {
+        // moves are symmetric between walkable points so distances from the
+        // target are distances to it
+        target = findRandomWalkable(dungeon);
+        targetIndex = getDungeonIndex(dungeon, target);
+        findDistances(dungeon, target, distances);
+
+        isMatched = true;
+        for (y = 0; y < getDungeonHeight(dungeon); y += 1)
+        {
+            for (x = 0; x < getDungeonWidth(dungeon); x += 1)
+            {
+                cell = getDungeonIndex(dungeon, initPoint(x, y));
+                isMatched &= !isWalkable(dungeon, x, y)
+                          || getLandmarkBound(landmarks, cell, targetIndex)
+                             <= distances[cell];
+            }
+        }
+        if (!isMatched)
+        {
+            nFailed += 1;
+            fprintf(stderr, "mismatch test=%s target=(%lld,%lld)\n", name,
+                    (long long)target.x, (long long)target.y);
+        }
+
+        for (j = 0; j < N_TARGETS; j += 1)
+        {
+            do
+            {
+                source = findRandomWalkable(dungeon);
+            }
+            while (isEqualPoints(source, target));
+            distance = distances[getDungeonIndex(dungeon, source)];
+
+            isMatched = true;
+            for (openType = 0; openType < N_OPEN_LIST_TYPES; openType += 1)
+            {
+                result = findContextPathBuffer(contexts[openType], source,
+                                               target, buffer,
+                                               getDungeonSize(dungeon));
+                isMatched &= result.status == PATH_NOT_FOUND
+                           ? distance == SCORE_MAX
+                           : result.status == PATH_FOUND
+                             && result.cost == distance
+                             && checkPath(dungeon, source, target, buffer,
+                                          result.length, distance);
+            }
+
+            nQueries += 1;
+            if (!isMatched)
+            {
+                nFailed += 1;
+                reportMismatch(name, "findContextPathBuffer", source, target);
+            }
+        }
+    }
+
+    printf("test=%s width=%u height=%u landmarks=%u queries=%d failed=%d\n",
+           name, getDungeonWidth(dungeon), getDungeonHeight(dungeon),
+           getLandmarkCount(landmarks), nQueries, nFailed);
+
+    for (openType = 0; openType < N_OPEN_LIST_TYPES; openType += 1)
+    {
+        freeAStarContext(contexts[openType]);
+    }
+    freeLandmarks(landmarks);
+    free(buffer);
+    free(distances);
+
+    return nFailed == 0;
+}
+
+
+/*
+@context
+    * Checks the path of a `findLpaPath` planner from the source to the target
+      of `dungeon` as `dungeon` is edited, and prints the results.
+    * Each round makes `N_EDITS` edits then replans - the first path is
+      checked too.
+        * Half of the edits wall a tile of the last path so it has to be
+          repaired (single tiles rarely cut the corridors off).
+        * The others open a square of floors around a random point.
+    * `dungeon` is left edited.
+
+@parameters
+    * name
+        * Name of the check printed with the results.
+    * dungeon
+        * Generated dungeon to edit - its source and target are planned.
+
+@return
+    * Indication every path matched the Dijkstra distances.
+*/
+static bool checkReplans(const char *name,
+                         dungeon_t  *dungeon)
+{
+    int i, j, nFailed;
+    long long nExpanded;
+    cell_t length;
+    score_t distance;
+    score_t *distances;
+    lpaPlanner_t *planner;
+    point_t *path;
+    point_t source, target, centre;
+
+    distances = malloc(sizeof(score_t) * (size_t)getDungeonSize(dungeon));
+    assert(distances != NULL);
+
+    source = getDungeonSource(dungeon);
+    target = getDungeonTarget(dungeon);
+    planner = initLpaPlanner(dungeon, source, target);
+    path = findLpaPath(planner);
+
+    nFailed = 0;
+    nExpanded = 0;
+    for (i = 0; i <= N_REPLANS; i += 1)
+    {
+        findDistances(dungeon, source, distances);
+        distance = distances[getDungeonIndex(dungeon, target)];
+
+        length = path == NULL ? 0 : getPathLength(dungeon, target, path);
+        if (path == NULL
+            ? distance != SCORE_MAX
+            : !checkPath(dungeon, source, target, path, length, distance))
+        {
+            nFailed += 1;
+            fprintf(stderr, "mismatch test=%s replan=%d\n", name, i);
+        }
+
+        if (i == N_REPLANS)
+        {
+            break;
+        }
+
+        for (j = 0; j < N_EDITS; j += 1)
+        {
+            if (length > 0 && rand() % 2 == 0)
+            {
+                editSquare(setLpaTile, planner, dungeon,
+                           path[rand() % length], 0, TILE_WALL);
+            }
+            else
+            {
+                centre = initPoint(rand() % getDungeonWidth(dungeon),
+                                   rand() % getDungeonHeight(dungeon));
+                editSquare(setLpaTile, planner, dungeon, centre,
+                           rand() % (EDIT_RADIUS_MAX + 1), TILE_FLOOR);
+            }
+        }
+
+        free(path);
+        path = findLpaPath(planner);
+        nExpanded += getLpaExpansions(planner);
+    }
+
+    printf("test=%s width=%u height=%u replans=%d failed=%d"
+           " expanded_per_replan=%.1f\n",
+           name, getDungeonWidth(dungeon), getDungeonHeight(dungeon),
+           N_REPLANS, nFailed, (double)nExpanded / N_REPLANS);
+
+    free(path);
+    freeLpaPlanner(planner);
+    free(distances);
+
+    return nFailed == 0;
+}
+
+
+/*
+@context
+    * Checks the move mask of every cell of `dungeon` matches the moves
+      `isValidMove` allows from it, and prints the results.
+    * Walls are checked too as searches may start inside one.
+
+@parameters
+    * name
+        * Name of the check printed with the results.
+    * dungeon
+        * Dungeon to check move masks of.
+
+@return
+    * Indication every move mask matched.
+*/
+static bool checkMoves(const char *name,
+                       dungeon_t  *dungeon)
+{
+    int i, nFailed;
+    int64_t x, y;
+    uint8_t moves;
+    point_t point;
+
+    nFailed = 0;
+    for (y = 0; y < getDungeonHeight(dungeon); y += 1)
+    {
+        for (x = 0; x < getDungeonWidth(dungeon); x += 1)
+        {
+            point = initPoint(x, y);
+
+            moves = 0;
+            for (i = 0; i < N_MOVES; i += 1)
+            {
+                if (isValidMove(dungeon, point, addPoints(point, MOVES[i])))
+                {
+                    moves |= 1 << i;
+                }
+            }
+
+            if (getDungeonMoves(dungeon, getDungeonIndex(dungeon, point))
+                    != moves
+                || getDungeonPointMoves(dungeon, point) != moves)
+            {
+                nFailed += 1;
+                fprintf(stderr, "mismatch test=%s point=(%lld,%lld)\n",
+                        name, (long long)x, (long long)y);
+            }
+        }
+    }
+
+    printf("test=%s width=%u height=%u cells=%llu failed=%d\n",
+           name, getDungeonWidth(dungeon), getDungeonHeight(dungeon),
+           (unsigned long long)getDungeonSize(dungeon), nFailed);
+
+    return nFailed == 0;
+}
+
+
+/*
+@context
+    * Checks the distances of a flow field to the target of `dungeon` as
+      `dungeon` is edited, and prints the results.
+    * Each round makes `N_EDITS` edits through `setFlowPoint` - the distances
+      of the field when built are checked too.
+        * Half of the edits wall a tile of the flow path from the source so
+          distances past it are raised.
+        * The others open a square of floors around a random point.
+    * `dungeon` is left edited.
+
+@parameters
+    * name
+        * Name of the check printed with the results.
+    * dungeon
+        * Generated dungeon to edit - the field leads to its target.
+
+@return
+    * Indication every distance matched the Dijkstra distances.
+*/
+static bool checkFlowField(const char *name,
+                           dungeon_t  *dungeon)
+{
+    int i, j, nFailed;
+    cell_t length;
+    score_t *distances;
+    flowField_t *field;
+    point_t *path;
+    point_t centre;
+
+    distances = malloc(sizeof(score_t) * (size_t)getDungeonSize(dungeon));
+    assert(distances != NULL);
+
+    field = initFlowField(dungeon, getDungeonTarget(dungeon));
+
+    nFailed = 0;
+    for (i = 0; i <= N_FLOW_UPDATES; i += 1)
+    {
+        if (!checkFlowDistances(field, dungeon, distances))
+        {
+            nFailed += 1;
+            fprintf(stderr, "mismatch test=%s update=%d\n", name, i);
+        }
+
+        if (i == N_FLOW_UPDATES)
+        {
+            break;
+        }
+
+        path = findFlowPath(field, getDungeonSource(dungeon));
+        length = path == NULL
+               ? 0
+               : getPathLength(dungeon, getDungeonTarget(dungeon), path);
+        for (j = 0; j < N_EDITS; j += 1)
+        {
+            if (length > 0 && rand() % 2 == 0)
+            {
+                editSquare(setFlowTile, field, dungeon,
+                           path[rand() % length], 0, TILE_WALL);
+            }
+            else
+            {
+                centre = initPoint(rand() % getDungeonWidth(dungeon),
+                                   rand() % getDungeonHeight(dungeon));
+                editSquare(setFlowTile, field, dungeon, centre,
+                           rand() % (EDIT_RADIUS_MAX + 1), TILE_FLOOR);
+            }
+        }
+        free(path);
+    }
+
+    printf("test=%s width=%u height=%u updates=%d failed=%d\n",
+           name, getDungeonWidth(dungeon), getDungeonHeight(dungeon),
+           N_FLOW_UPDATES, nFailed);
+
+    freeFlowField(field);
+    free(distances);
+
+    return nFailed == 0;
+}
+
+
+/*
+@context
+    * Checks `getFlowDistance` of every walkable point of `dungeon` matches
+      the Dijkstra distance to the target of `field`.
+    * The path followed from the source of `dungeon` must also be a shortest
+      path.
+
+@parameters
+    * field
+        * Flow field to check - leads to the target of `dungeon`.
+    * dungeon
+        * Dungeon of `field`.
+    * distances
+        * Distance of each cell - overwritten.
+
+@return
+    * Indication every distance matched.
+*/
+static bool checkFlowDistances(flowField_t *field,
+                               dungeon_t   *dungeon,
+                               score_t     *distances)
+{
+    bool isMatched;
+    int64_t x, y;
+    score_t distance;
+    point_t *path;
+    point_t source, target;
+
+    source = getDungeonSource(dungeon);
+    target = getDungeonTarget(dungeon);
+
+    // moves are symmetric between walkable points so distances from the
+    // target are distances to it
+    findDistances(dungeon, target, distances);
+
+    isMatched = true;
+    for (y = 0; y < getDungeonHeight(dungeon); y += 1)
+    {
+        for (x = 0; x < getDungeonWidth(dungeon); x += 1)
+        {
+            if (isWalkable(dungeon, x, y))
+            {
+                isMatched &= getFlowDistance(field, initPoint(x, y))
+                          == distances[getDungeonIndex(dungeon,
+                                                       initPoint(x, y))];
+            }
+        }
+    }
+
+    distance = distances[getDungeonIndex(dungeon, source)];
+    path = findFlowPath(field, source);
+    if (path == NULL)
+    {
+        isMatched &= distance == SCORE_MAX;
+    }
+    else
+    {
+        isMatched &= checkPath(dungeon, source, target, path,
+                               getPathLength(dungeon, target, path),
+                               distance);
+        free(path);
+    }
+
+    return isMatched;
+}
+
+
+/*
+@context
+    * Checks lookups of a path cache hit and miss as tiles of `dungeon` are
+      set, and prints the results.
+    * Query `a` is from the source to the target of `dungeon` and query `b`
+      between random walkable points with a path.
+        * A wall set away from both paths with `setCachedPoint` keeps both.
+        * A wall set next to the path of `b` evicts it.
+        * A wall set on the path of `a` evicts it.
+        * A tile set with `setDungeonPoint` evicts both.
+    * `dungeon` is left edited.
+
+@parameters
+    * name
+        * Name of the check printed with the results.
+    * dungeon
+        * Generated dungeon to edit.
+
+@return
+    * Indication every lookup matched the Dijkstra distances and hit or
+      missed as expected.
+*/
+static bool checkPathCache(const char *name,
+                           dungeon_t  *dungeon)
+{
+    bool isMatched;
+    int nLookups;
+    score_t *distances;
+    point_t away, near;
+    pathCache_t *cache;
+    aStarContext_t *context;
+    cacheQuery_t a, b;
+
+    distances = malloc(sizeof(score_t) * (size_t)getDungeonSize(dungeon));
+    assert(distances != NULL);
+
+    a.source = getDungeonSource(dungeon);
+    a.target = getDungeonTarget(dungeon);
+    a.path = malloc(sizeof(point_t) * (size_t)getDungeonSize(dungeon));
+    assert(a.path != NULL);
+
+    // `b` needs a path with a point before its target
+    b.path = malloc(sizeof(point_t) * (size_t)getDungeonSize(dungeon));
+    assert(b.path != NULL);
+    do
+    {
+        b.source = findRandomWalkable(dungeon);
+        b.target = findRandomWalkable(dungeon);
+        findDistances(dungeon, b.source, distances);
+    }
+    while (distances[getDungeonIndex(dungeon, b.target)] == SCORE_MAX
+           || distances[getDungeonIndex(dungeon, b.target)]
+              <= COST_DIAGONAL);
+
+    cache = initPathCache(dungeon, CACHE_MAX_BYTES);
+    context = initAStarContext(dungeon, OPEN_LIST_DEFAULT);
+
+    isMatched = checkCachedQuery(dungeon, cache, context, &a, distances, false)
+             && checkCachedQuery(dungeon, cache, context, &a, distances, true)
+             && checkCachedQuery(dungeon, cache, context, &b, distances, false)
+             && checkCachedQuery(dungeon, cache, context, &b, distances, true)
+             && a.result.length > 1;
+
+    // a wall away from both paths changes no move of either
+    do
+    {
+        away = findRandomWalkable(dungeon);
+    }
+    while (isNearPath(away, &a) || isNearPath(away, &b)
+           || isEqualPoints(away, a.target) || isEqualPoints(away, b.target));
+    setCachedPoint(cache, away, TILE_WALL);
+    isMatched = isMatched
+             && checkCachedQuery(dungeon, cache, context, &a, distances, true)
+             && checkCachedQuery(dungeon, cache, context, &b, distances, true);
+
+    // a wall next to a path can stop it cutting the corner of the wall
+    isMatched = isMatched && findNearPath(dungeon, &b, &a, &near);
+    if (isMatched)
+    {
+        setCachedPoint(cache, near, TILE_WALL);
+        isMatched = checkCachedQuery(dungeon, cache, context, &b, distances,
+                                     false);
+    }
+
+    clearPathCache(cache);
+    isMatched = isMatched
+             && checkCachedQuery(dungeon, cache, context, &a, distances,
+                                 false);
+    if (isMatched)
+    {
+        setCachedPoint(cache, a.path[a.result.length / 2], TILE_WALL);
+        isMatched = checkCachedQuery(dungeon, cache, context, &a, distances,
+                                     false);
+    }
+
+    // a change the cache did not see evicts every path
+    clearPathCache(cache);
+    isMatched = isMatched
+             && checkCachedQuery(dungeon, cache, context, &a, distances, false)
+             && checkCachedQuery(dungeon, cache, context, &b, distances,
+                                 false);
+    setDungeonPoint(dungeon, away, TILE_FLOOR);
+    isMatched = isMatched
+             && checkCachedQuery(dungeon, cache, context, &a, distances, false)
+             && checkCachedQuery(dungeon, cache, context, &b, distances,
+                                 false);
+
+    nLookups = (int)(getPathCacheHits(cache) + getPathCacheMisses(cache));
+    if (!isMatched)
+    {
+        fprintf(stderr, "mismatch test=%s lookup=%d\n", name, nLookups);
+    }
+
+    printf("test=%s width=%u height=%u lookups=%d hits=%llu misses=%llu"
+           " failed=%d\n",
+           name, getDungeonWidth(dungeon), getDungeonHeight(dungeon),
+           nLookups, (unsigned long long)getPathCacheHits(cache),
+           (unsigned long long)getPathCacheMisses(cache), !isMatched);
+
+    freeAStarContext(context);
+    freePathCache(cache);
+    free(b.path);
+    free(a.path);
+    free(distances);
+
+    return isMatched;
+}
+
+
+/*
+@context
+    * Looks up `query` in `cache` and checks the path found.
+        * It must only take valid moves, end at the target and cost the
+          Dijkstra distance.
+        * The lookup must hit or miss as expected.
+
+@parameters
+    * dungeon
+        * Dungeon of `cache`.
+    * cache
+        * Path cache to look up `query` in.
+    * context
+        * Search context of `dungeon` used on a miss.
+    * query
+        * Query to look up - its path and result are set.
+    * distances
+        * Distance of each cell - overwritten.
+    * isHit
+        * Indication the lookup should be answered from a cached path.
+
+@return
+    * Indication the lookup matched.
+*/
+static bool checkCachedQuery(dungeon_t      *dungeon,
+                             pathCache_t    *cache,
+                             aStarContext_t *context,
+                             cacheQuery_t   *query,
+                             score_t        *distances,
+                             bool            isHit)
+{
+    uint64_t nHits;
+    score_t distance;
+
+    findDistances(dungeon, query->source, distances);
+    distance = distances[getDungeonIndex(dungeon, query->target)];
+
+    nHits = getPathCacheHits(cache);
+    query->result = findCachedPath(cache, context, query->source,
+                                   query->target, query->path,
+                                   getDungeonSize(dungeon));
+    if ((getPathCacheHits(cache) > nHits) != isHit)
+    {
+        return false;
+    }
+
+    if (query->result.status == PATH_NOT_FOUND)
+    {
+        return distance == SCORE_MAX;
+    }
+
+    return query->result.status == PATH_FOUND
+        && query->result.cost == distance
+        && checkPath(dungeon, query->source, query->target, query->path,
+                     query->result.length, distance);
+}
+
+
+/*
+@context
+    * Checks if `point` is within 1 move of the source or a point of the path
+      of `query`.
+
+@parameters
+    * point
+        * Location to check.
+    * query
+        * Query holding the path last found for it.
+
+@return
+    * Indication `point` borders the path of `query`.
+*/
+static bool isNearPath(point_t       point,
+                       cacheQuery_t *query)
+{
+    cell_t i;
+
+    for (i = 0; i <= query->result.length; i += 1)
+    {
+        if (distancePoints(point,
+                           i == 0 ? query->source : query->path[i - 1],
+                           1, 1) <= 1)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+/*
+@context
+    * Finds a walkable point next to the path of `query` but not on it.
+    * Points of `other` and the target of either query are skipped so they
+      stay walkable.
+
+@parameters
+    * dungeon
+        * Dungeon of the queries.
+    * query
+        * Query holding the path to find a point next to.
+    * other
+        * Query whose source and target must not be found.
+    * near
+        * Point found.
+
+@return
+    * Indication a point was found.
+*/
+static bool findNearPath(dungeon_t    *dungeon,
+                         cacheQuery_t *query,
+                         cacheQuery_t *other,
+                         point_t      *near)
+{
+    int j;
+    cell_t i, k;
+    point_t point;
+    bool isOnPath;
+
+    for (i = 0; i < query->result.length; i += 1)
+    {
+        for (j = 0; j < N_MOVES; j += 1)
+        {
+            point = addPoints(query->path[i], MOVES[j]);
+            if (!isWalkable(dungeon, point.x, point.y)
+                || isEqualPoints(point, query->source)
+                || isEqualPoints(point, other->source)
+                || isEqualPoints(point, other->target))
+            {
+                continue;
+            }
+
+            isOnPath = false;
+            for (k = 0; k < query->result.length; k += 1)
+            {
+                isOnPath |= isEqualPoints(point, query->path[k]);
+            }
+            if (!isOnPath)
+            {
+                *near = point;
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+
+/*
+@context
+    * Checks the connected component labels of `dungeon` against a flood fill
+      as `dungeon` is edited, and prints the results.
+    * Each round sets `N_EDITS` squares with `setDungeonPoint` - the labels
+      before editing are checked too.
+        * Half are walls around random walkable points, which split the
+          components they cut.
+        * The others are floors around random points, which merge the
+          components they join.
+    * `dungeon` is left edited.
+
+@parameters
+    * name
+        * Name of the check printed with the results.
+    * dungeon
+        * Dungeon to edit.
+
+@return
+    * Indication the labels matched the flood fill after every round.
+*/
+static bool checkComponents(const char *name,
+                            dungeon_t  *dungeon)
+{
+    int i, j, nFailed;
+    bool isMatched;
+    cell_t *labels, *sizes;
+    point_t source, target, centre;
+
+    labels = malloc(sizeof(cell_t) * (size_t)getDungeonSize(dungeon));
+    assert(labels != NULL);
+    sizes = malloc(sizeof(cell_t) * ((size_t)getDungeonSize(dungeon) + 1));
+    assert(sizes != NULL);
+
+    nFailed = 0;
+    for (i = 0; i <= N_COMPONENT_UPDATES; i += 1)
+    {
+        findComponents(dungeon, labels, sizes);
+
+        isMatched = checkLabels(dungeon, labels, sizes);
+        for (j = 0; j < N_COMPONENT_QUERIES; j += 1)
+        {
+            source = initPoint(rand() % getDungeonWidth(dungeon),
+                               rand() % getDungeonHeight(dungeon));
+            target = findRandomWalkable(dungeon);
+            isMatched &= isDungeonConnected(dungeon, source, target)
+                      == isFloodConnected(dungeon, labels, source, target);
+        }
+
+        if (!isMatched)
+        {
+            nFailed += 1;
+            fprintf(stderr, "mismatch test=%s update=%d\n", name, i);
+        }
+
+        if (i == N_COMPONENT_UPDATES)
+        {
+            break;
+        }
+
+        for (j = 0; j < N_EDITS; j += 1)
+        {
+            if (rand() % 2 == 0)
+            {
+                editSquare(setDungeonTile, dungeon, dungeon,
+                           findRandomWalkable(dungeon),
+                           rand() % (EDIT_RADIUS_MAX + 1), TILE_WALL);
+            }
+            else
+            {
+                centre = initPoint(rand() % getDungeonWidth(dungeon),
+                                   rand() % getDungeonHeight(dungeon));
+                editSquare(setDungeonTile, dungeon, dungeon, centre,
+                           rand() % (EDIT_RADIUS_MAX + 1), TILE_FLOOR);
+            }
+        }
+    }
+
+    printf("test=%s width=%u height=%u updates=%d failed=%d\n",
+           name, getDungeonWidth(dungeon), getDungeonHeight(dungeon),
+           N_COMPONENT_UPDATES, nFailed);
+
+    free(sizes);
+    free(labels);
+
+    return nFailed == 0;
+}
+
+
+/*
+@context
+    * Checks the component labels of `dungeon` partition its walkable points
+      the same as the flood fill `labels`.
+        * Each flood fill component must have 1 label of `dungeon` not shared
+          with any other component.
+        * The component size of each point must match.
+
+@parameters
+    * dungeon
+        * Dungeon to check labels of.
+    * labels
+        * Flood fill component of each cell (`findComponents`).
+    * sizes
+        * Number of points in each flood fill component.
+
+@return
+    * Indication the labels matched.
+*/
+static bool checkLabels(dungeon_t *dungeon,
+                        cell_t    *labels,
+                        cell_t    *sizes)
+{
+    bool isMatched;
+    int64_t x, y;
+    cell_t cell, label, size;
+    cell_t *floodToDungeon, *dungeonToFlood;
+    point_t point;
+
+    size = getDungeonSize(dungeon);
+
+    // labels are within `[0, size]` as no more components than cells exist
+    floodToDungeon = calloc((size_t)size + 1, sizeof(cell_t));
+    assert(floodToDungeon != NULL);
+    dungeonToFlood = calloc((size_t)size + 1, sizeof(cell_t));
+    assert(dungeonToFlood != NULL);
+
+    isMatched = true;
+    for (y = 0; y < getDungeonHeight(dungeon) && isMatched; y += 1)
+    {
+        for (x = 0; x < getDungeonWidth(dungeon) && isMatched; x += 1)
+        {
+            point = initPoint(x, y);
+            cell = getDungeonIndex(dungeon, point);
+            label = getDungeonComponent(dungeon, point);
+
+            if (labels[cell] == 0 || label == 0 || label > size)
+            {
+                isMatched = labels[cell] == 0 && label == 0;
+                continue;
+            }
+
+            if (floodToDungeon[labels[cell]] == 0
+                && dungeonToFlood[label] == 0)
+            {
+                floodToDungeon[labels[cell]] = label;
+                dungeonToFlood[label] = labels[cell];
+            }
+
+            isMatched = floodToDungeon[labels[cell]] == label
+                     && dungeonToFlood[label] == labels[cell]
+                     && getDungeonComponentSize(dungeon, point)
+                        == sizes[labels[cell]];
+        }
+    }
+
+    free(dungeonToFlood);
+    free(floodToDungeon);
+
+    return isMatched;
+}
+
+
+/*
+@context
+    * Checks if a path from `source` to `target` is possible from the flood
+      fill `labels`.
+    * A path from a wall must leave it by a valid move into the component of
+      `target`.
+
+@parameters
+    * dungeon
+        * Dungeon of the query.
+    * labels
+        * Flood fill component of each cell (`findComponents`).
+    * source
+        * Location to start from - may be a wall.
+    * target
+        * Walkable location to find from `source`.
+
+@return
+    * Indication a path is possible.
+*/
+static bool isFloodConnected(dungeon_t *dungeon,
+                             cell_t    *labels,
+                             point_t    source,
+                             point_t    target)
+{
+    int i;
+    cell_t label;
+    point_t neighbour;
+
+    label = labels[getDungeonIndex(dungeon, target)];
+    if (isEqualPoints(source, target)
+        || labels[getDungeonIndex(dungeon, source)] != 0)
+    {
+        return isEqualPoints(source, target)
+            || labels[getDungeonIndex(dungeon, source)] == label;
+    }
+
+    for (i = 0; i < N_MOVES; i += 1)
+    {
+        neighbour = addPoints(source, MOVES[i]);
+        if (isWalkable(dungeon, neighbour.x, neighbour.y)
+            && isWalkable(dungeon, source.x, neighbour.y)
+            && isWalkable(dungeon, neighbour.x, source.y)
+            && labels[getDungeonIndex(dungeon, neighbour)] == label)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+/*
+@context
+    * Labels the connected components of `dungeon` with a flood fill.
+    * Neighbours are found from the tiles, not the labels or cached moves of
+      `dungeon`.
+
+@parameters
+    * dungeon
+        * Dungeon to label.
+    * labels
+        * Component of each cell from `1` - `0` for walls.
+    * sizes
+        * Number of points in each component - must hold 1 more than the
+          number of cells.
+*/
+static void findComponents(dungeon_t *dungeon,
+                           cell_t    *labels,
+                           cell_t    *sizes)
+{
+    int i;
+    int64_t x, y;
+    cell_t cell, nLabels, nStack;
+    cell_t *stack;
+    point_t point, neighbour;
+
+    stack = malloc(sizeof(cell_t) * (size_t)getDungeonSize(dungeon));
+    assert(stack != NULL);
+
+    for (cell = 0; cell < getDungeonSize(dungeon); cell += 1)
+    {
+        labels[cell] = 0;
+    }
+
+    nLabels = 0;
+    for (y = 0; y < getDungeonHeight(dungeon); y += 1)
+    {
+        for (x = 0; x < getDungeonWidth(dungeon); x += 1)
+        {
+            cell = getDungeonIndex(dungeon, initPoint(x, y));
+            if (!isWalkable(dungeon, x, y) || labels[cell] != 0)
+            {
+                continue;
+            }
+
+            nLabels += 1;
+            sizes[nLabels] = 1;
+            labels[cell] = nLabels;
+            stack[0] = cell;
+            nStack = 1;
+
+            while (nStack > 0)
+            {
+                nStack -= 1;
+                point = getDungeonIndexPoint(dungeon, stack[nStack]);
+
+                for (i = 0; i < N_MOVES; i += 1)
+                {
+                    neighbour = addPoints(point, MOVES[i]);
+                    if (!isWalkable(dungeon, neighbour.x, neighbour.y)
+                        || !isWalkable(dungeon, point.x, neighbour.y)
+                        || !isWalkable(dungeon, neighbour.x, point.y))
+                    {
+                        continue;
+                    }
+
+                    cell = getDungeonIndex(dungeon, neighbour);
+                    if (labels[cell] == 0)
+                    {
+                        labels[cell] = nLabels;
+                        sizes[nLabels] += 1;
+                        stack[nStack] = cell;
+                        nStack += 1;
+                    }
+                }
+            }
+        }
+    }
+
+    free(stack);
+}
+
+
+/*
+@context
+    * Sets every tile within `radius` of `centre` to `tile` through `editor`.
+    * The source and target of `dungeon` and points outside it are skipped.
+
+@parameters
+    * setTile
+        * Sets a tile through `editor`.
+    * editor
+        * Structure kept up to date with `dungeon` to set tiles through.
+    * dungeon
+        * Dungeon to edit.
+    * centre
+        * Location at the centre of the square.
+    * radius
+        * Distance from `centre` to the edges of the square.
+    * tile
+        * Character representation to set tiles to.
+*/
+static void editSquare(setTile_t  setTile,
+                       void      *editor,
+                       dungeon_t *dungeon,
+                       point_t    centre,
+                       int        radius,
+                       char       tile)
+{
+    int64_t x, y;
+    point_t point;
+
+    for (y = centre.y - radius; y <= centre.y + radius; y += 1)
+    {
+        for (x = centre.x - radius; x <= centre.x + radius; x += 1)
+        {
+            point = initPoint(x, y);
+            if (x >= 0 && x < getDungeonWidth(dungeon)
+                && y >= 0 && y < getDungeonHeight(dungeon)
+                && !isEqualPoints(point, getDungeonSource(dungeon))
+                && !isEqualPoints(point, getDungeonTarget(dungeon)))
+            {
+                setTile(editor, point, tile);
+            }
+        }
+    }
+}
+
+
+/*
+@context
+    * Sets a tile through an LPA* planner (`setLpaPoint`).
+
+@parameters
+    * planner
+        * Planner to set tile through.
+    * point
+        * Location of tile to set.
+    * tile
+        * Character representation to set tile to.
+*/
+static void setLpaTile(void   *planner,
+                       point_t point,
+                       char    tile)
+{
+    setLpaPoint(planner, point, tile);
+}
+
+
+/*
+@context
+    * Sets a tile through a flow field (`setFlowPoint`).
+
+@parameters
+    * field
+        * Flow field to set tile through.
+    * point
+        * Location of tile to set.
+    * tile
+        * Character representation to set tile to.
+*/
+static void setFlowTile(void   *field,
+                        point_t point,
+                        char    tile)
+{
+    setFlowPoint(field, point, tile);
+}
+
+
+/*
+@context
+    * Sets a tile of a dungeon directly (`setDungeonPoint`).
+
+@parameters
+    * dungeon
+        * Dungeon to set tile of.
+    * point
+        * Location of tile to set.
+    * tile
+        * Character representation to set tile to.
+*/
+static void setDungeonTile(void   *dungeon,
+                           point_t point,
+                           char    tile)
+{
+    setDungeonPoint(dungeon, point, tile);
+}
+
+
+/*
+@context
+    * Finds the number of points of a path ending at `target` without a
+      length (as returned by `findPath`).
+
+@parameters
+    * dungeon
+        * Dungeon of the path.
+    * target
+        * Last point of `path`.
+    * path
+        * Points of the path.
+
+@return
+    * Number of points in `path` - stops at the size of `dungeon`.
+*/
+static cell_t getPathLength(dungeon_t *dungeon,
+                            point_t    target,
+                            point_t   *path)
+{
+    cell_t length;
+
+    for (length = 1;
+         length < getDungeonSize(dungeon)
+         && !isEqualPoints(path[length - 1], target);
+         length += 1)
+    {
+    }
+
+    return length;
+}
+
+
+/*
+@context
+    * Checks `path` only takes valid moves from `source`, ends at `target`
+      and costs `distance`.
+    * Moves are checked from the tiles so the movement rules are not taken
+      from the search stack.
+
+@parameters
+    * dungeon
+        * Dungeon of the path.
+    * source
+        * Source of the path - not part of `path`.
+    * target
+        * Target of the path - the last point of `path`.
+    * path
+        * Points of the path.
+    * length
+        * Number of points in `path`.
+    * distance
+        * Dijkstra distance from `source` to `target`.
+
+@return
+    * Indication `path` is a shortest path from `source` to `target`.
+*/
+static bool checkPath(dungeon_t *dungeon,
+                      point_t    source,
+                      point_t    target,
+                      point_t   *path,
+                      cell_t     length,
+                      score_t    distance)
+{
+    cell_t i;
+    int64_t dx, dy;
+    score_t cost;
+    point_t from;
+
+    if (length == 0 || !isEqualPoints(path[length - 1], target))
+    {
+        return false;
+    }
+
+    cost = 0;
+    from = source;
+    for (i = 0; i < length; i += 1)
+    {
+        dx = (int64_t)path[i].x - from.x;
+        dy = (int64_t)path[i].y - from.y;
+
+        // adjacent, walkable and not cutting a wall corner
+        if (dx < -1 || dx > 1 || dy < -1 || dy > 1 || (dx == 0 && dy == 0)
+            || !isWalkable(dungeon, path[i].x, path[i].y)
+            || !isWalkable(dungeon, from.x, path[i].y)
+            || !isWalkable(dungeon, path[i].x, from.y))
+        {
+            return false;
+        }
+
+        cost += dx != 0 && dy != 0 ? COST_DIAGONAL : COST_CARDINAL;
+        from = path[i];
+    }
+
+    return cost == distance;
+}
+
+
+/*
+@context
+    * Checks every step of `path` from `source` passes `isValidMove`.
+
+@parameters
+    * dungeon
+        * Dungeon of the path.
+    * source
+        * Source of the path - not part of `path`.
+    * path
+        * Points of the path.
+    * length
+        * Number of points in `path`.
+
+@return
+    * Indication every step of `path` is a valid move.
+*/
+static bool isValidPath(dungeon_t *dungeon,
+                        point_t    source,
+                        point_t   *path,
+                        cell_t     length)
+{
+    cell_t i;
+
+    for (i = 0; i < length; i += 1)
+    {
+        if (!isValidMove(dungeon, i == 0 ? source : path[i - 1], path[i]))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+/*
+@context
+    * Finds the cost of the moves of `path` from `source`.
+
+@parameters
+    * source
+        * Source of the path - not part of `path`.
+    * path
+        * Points of the path - each adjacent to the last.
+    * length
+        * Number of points in `path`.
+
+@return
+    * Cost of the path.
+*/
+static score_t getPathCost(point_t  source,
+                           point_t *path,
+                           cell_t   length)
+{
+    cell_t i;
+    score_t cost;
+
+    cost = 0;
+    for (i = 0; i < length; i += 1)
+    {
+        cost += distancePoints(i == 0 ? source : path[i - 1], path[i],
+                               COST_CARDINAL, COST_DIAGONAL);
+    }
+
+    return cost;
+}
+
+
+/*
+@context
+    * Finds the distance from `source` of every cell of `dungeon` with a
+      Dijkstra search.
+    * Neighbours are found from the tiles, not the cached moves of
+      `dungeon`.
+
+@parameters
+    * dungeon
+        * Dungeon to search.
+    * source
+        * Point to find distances from.
+    * distances
+        * Distance of each cell - `SCORE_MAX` if it cannot be reached.
+*/
+static void findDistances(dungeon_t *dungeon,
+                          point_t    source,
+                          score_t   *distances)
+{
+    int i;
+    cell_t cell, size;
+    score_t distance;
+    heapEntry_t *heap;
+    heapEntry_t entry;
+    point_t point, neighbour;
+
+    // every cell is pushed at most once per move into it
+    heap = malloc(sizeof(heapEntry_t) * N_MOVES
+                  * (size_t)getDungeonSize(dungeon));
+    assert(heap != NULL);
+
+    for (cell = 0; cell < getDungeonSize(dungeon); cell += 1)
+    {
+        distances[cell] = SCORE_MAX;
+    }
+
+    size = 0;
+    distances[getDungeonIndex(dungeon, source)] = 0;
+    pushEntry(heap, &size,
+              (heapEntry_t){0, getDungeonIndex(dungeon, source)});
+
+    while (size > 0)
+    {
+        entry = popEntry(heap, &size);
+        if (entry.distance > distances[entry.cell])
+        {
+            continue;
+        }
+
+        point = getDungeonIndexPoint(dungeon, entry.cell);
+        for (i = 0; i < N_MOVES; i += 1)
+        {
+            neighbour = addPoints(point, MOVES[i]);
+            if (!isWalkable(dungeon, neighbour.x, neighbour.y)
+                || !isWalkable(dungeon, point.x, neighbour.y)
+                || !isWalkable(dungeon, neighbour.x, point.y))
+            {
+                continue;
+            }
+
+            distance = entry.distance
+                     + (MOVES[i].x != 0 && MOVES[i].y != 0
+                        ? COST_DIAGONAL
+                        : COST_CARDINAL);
+            cell = getDungeonIndex(dungeon, neighbour);
+            if (distance < distances[cell])
+            {
+                distances[cell] = distance;
+                pushEntry(heap, &size, (heapEntry_t){distance, cell});
+            }
+        }
+    }
+
+    free(heap);
+}
+
+
+/*
+@context
+    * Pushes `entry` onto the binary heap `heap` of `size` entries.
+
+@parameters
+    * heap
+        * Binary heap sorted by ascending distance.
+    * size
+        * Number of entries in `heap` - incremented.
+    * entry
+        * Entry to push.
+*/
+static void pushEntry(heapEntry_t *heap,
+                      cell_t      *size,
+                      heapEntry_t  entry)
+{
+    cell_t i;
+
+    for (i = *size; i > 0 && heap[(i - 1) / 2].distance > entry.distance;
+         i = (i - 1) / 2)
+    {
+        heap[i] = heap[(i - 1) / 2];
+    }
+    heap[i] = entry;
+
+    *size += 1;
+}
+
+
+/*
+@context
+    * Pops the entry of least distance from the binary heap `heap`.
+
+@parameters
+    * heap
+        * Binary heap sorted by ascending distance.
+    * size
+        * Number of entries in `heap` - must be `> 0` and is decremented.
+
+@return
+    * Entry of least distance.
+*/
+static heapEntry_t popEntry(heapEntry_t *heap,
+                            cell_t      *size)
+{
+    cell_t i, child;
+    heapEntry_t min, last;
+
+    min = heap[0];
+    *size -= 1;
+    last = heap[*size];
+
+    i = 0;
+    while (2 * i + 1 < *size)
+    {
+        child = 2 * i + 1;
+        if (child + 1 < *size
+            && heap[child + 1].distance < heap[child].distance)
+        {
+            child += 1;
+        }
+        if (heap[child].distance >= last.distance)
+        {
+            break;
+        }
+
+        heap[i] = heap[child];
+        i = child;
+    }
+    heap[i] = last;
+
+    return min;
+}
+
+
+/*
+@context
+    * Initialises a dungeon of a single corridor winding through every other
+      row.
+    * Rows between the corridors are walls except at alternating ends.
+
+@return
+    * Serpentine corridor dungeon.
+*/
+static dungeon_t *initSerpentDungeon(void)
+{
+    uint32_t x, y;
+    char *tiles;
+    dungeon_t *dungeon;
+
+    tiles = malloc(sizeof(char) * SERPENT_WIDTH * SERPENT_HEIGHT);
+    assert(tiles != NULL);
+
+    for (y = 0; y < SERPENT_HEIGHT; y += 1)
+    {
+        for (x = 0; x < SERPENT_WIDTH; x += 1)
+        {
+            tiles[y * SERPENT_WIDTH + x] = TILE_FLOOR;
+
+            // walls open on the right then the left in turn
+            if (y % 2 == 1
+                && x != (y % 4 == 1 ? SERPENT_WIDTH - 1 : 0))
+            {
+                tiles[y * SERPENT_WIDTH + x] = TILE_WALL;
+            }
+        }
+    }
+
+    dungeon = initDungeonMap(SERPENT_WIDTH, SERPENT_HEIGHT, tiles);
+    free(tiles);
+
+    return dungeon;
+}
+
+
+/*
+@context
+    * Finds a random walkable point of `dungeon`.
+
+@parameters
+    * dungeon
+        * Dungeon to find point in - must have a walkable point.
+
+@return
+    * Random walkable point.
+*/
+static point_t findRandomWalkable(dungeon_t *dungeon)
+{
+    point_t point;
+
+    do
+    {
+        point = initPoint(rand() % getDungeonWidth(dungeon),
+                          rand() % getDungeonHeight(dungeon));
+    }
+    while (!isWalkable(dungeon, point.x, point.y));
+
+    return point;
+}
+
+
+/*
+@context
+    * Checks if `(x, y)` is within `dungeon` and not a wall.
+
+@parameters
+    * dungeon
+        * Dungeon to check point of.
+    * x
+        * Horizontal coordinate - may be outside `dungeon`.
+    * y
+        * Vertical coordinate - may be outside `dungeon`.
+
+@return
+    * Indication the point is walkable.
+*/
+static bool isWalkable(dungeon_t *dungeon,
+                       int64_t    x,
+                       int64_t    y)
+{
+    return x >= 0 && x < getDungeonWidth(dungeon)
+        && y >= 0 && y < getDungeonHeight(dungeon)
+        && getDungeonPoint(dungeon, initPoint(x, y)) != TILE_WALL;
+}